@@ -116,11 +116,14 @@ static const gchar *brisk_all_items_section_get_backend_id(__brisk_unused__ Bris
 /**
  * Being the magical "all" filter, we return TRUE for everything.
  * Cuz we can show them all. :3
+ *
+ * Recent documents are the exception, they'd only drown out the launchers
+ * and already have their own section.
  */
 static gboolean brisk_all_items_section_can_show_item(__brisk_unused__ BriskSection *section,
-                                                      __brisk_unused__ BriskItem *item)
+                                                      BriskItem *item)
 {
-        return TRUE;
+        return g_strcmp0(brisk_item_get_backend_id(item), "recent") != 0;
 }
 
 /**
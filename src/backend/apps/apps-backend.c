@@ -51,12 +51,11 @@ struct _BriskAppsBackend {
         guint monitor_source_id;
         gboolean loaded;
         GSList *pending_sections;
+        gboolean transliterate;
 };
 
 G_DEFINE_TYPE(BriskAppsBackend, brisk_apps_backend, BRISK_TYPE_BACKEND)
 
-typedef gchar *gstrv;
-DEF_AUTOFREE(gstrv, g_strfreev)
 DEF_AUTOFREE(GSimpleAction, g_object_unref)
 
 static gboolean brisk_apps_backend_load(BriskBackend *backend);
@@ -116,46 +115,57 @@ static const gchar *brisk_apps_backend_get_display_name(__brisk_unused__ BriskBa
         return _("Applications");
 }
 
-static GMenu *brisk_apps_backend_get_item_actions(BriskBackend *backend, BriskItem *item,
-                                                  GActionGroup *group)
+/**
+ * Register our single parameterized action for launching desktop actions.
+ * The target is the (desktop ID, action name) pair.
+ */
+static void brisk_apps_backend_register_actions(BriskBackend *backend, GActionMap *map)
+{
+        autofree(GSimpleAction) *action = NULL;
+
+        action = g_simple_action_new("apps.launch-action", G_VARIANT_TYPE("(ss)"));
+        g_signal_connect(action,
+                         "activate",
+                         G_CALLBACK(brisk_apps_backend_launch_action),
+                         backend);
+        g_action_map_add_action(map, G_ACTION(action));
+}
+
+static GMenu *brisk_apps_backend_get_item_actions(__brisk_unused__ BriskBackend *backend,
+                                                  BriskItem *item)
 {
         GMenu *ret = NULL;
         GDesktopAppInfo *info = NULL;
+        const gchar *const *actions = NULL;
+        const gchar *id = NULL;
 
-        ret = g_menu_new();
+        if (!BRISK_IS_APPS_ITEM(item)) {
+                return NULL;
+        }
+
+        /* Reuse the item's info rather than parsing the .desktop file again */
+        info = brisk_apps_item_get_info(BRISK_APPS_ITEM(item));
+        id = g_app_info_get_id(G_APP_INFO(info));
+        actions = g_desktop_app_info_list_actions(info);
+        if (!id || !actions || !actions[0]) {
+                return NULL;
+        }
 
-        info = g_desktop_app_info_new(brisk_item_get_id(item));
-        const gchar *const *actions = g_desktop_app_info_list_actions(info);
+        ret = g_menu_new();
 
-        for (guint i = 0; i < g_strv_length((gstrv *)actions); i++) {
-                autofree(gchar) *action_id = NULL;
-                autofree(gchar) *menu_id = NULL;
+        for (guint i = 0; actions[i]; i++) {
+                GMenuItem *menu_item = NULL;
                 const gchar *action_name = NULL;
-                autofree(GSimpleAction) *action = NULL;
 
-                action_id = g_strdup_printf("apps.action-%d", i);
-                menu_id = g_strdup_printf("brisk-context-items.%s", action_id);
                 action_name = g_desktop_app_info_get_action_name(info, actions[i]);
-
-                /* Make the action now */
-                action = g_simple_action_new(action_id, NULL);
-                g_action_map_add_action(G_ACTION_MAP(group), G_ACTION(action));
-
-                g_object_set_data_full(G_OBJECT(action),
-                                       "__aname",
-                                       (gpointer)g_strdup(actions[i]),
-                                       g_free);
-                g_object_set_data_full(G_OBJECT(action),
-                                       "__appinfo",
-                                       (gpointer)info,
-                                       g_object_unref);
-                g_signal_connect(action,
-                                 "activate",
-                                 G_CALLBACK(brisk_apps_backend_launch_action),
-                                 backend);
+                menu_item = g_menu_item_new(action_name, NULL);
+                g_menu_item_set_action_and_target_value(menu_item,
+                                                        "brisk-context-items.apps.launch-action",
+                                                        g_variant_new("(ss)", id, actions[i]));
 
                 /* whack it in the menu */
-                g_menu_append(ret, action_name, menu_id);
+                g_menu_append_item(ret, menu_item);
+                g_object_unref(menu_item);
         }
 
         return ret;
@@ -191,6 +201,7 @@ static void brisk_apps_backend_class_init(BriskAppsBackendClass *klazz)
         b_class->get_id = brisk_apps_backend_get_id;
         b_class->get_display_name = brisk_apps_backend_get_display_name;
         b_class->load = brisk_apps_backend_load;
+        b_class->register_actions = brisk_apps_backend_register_actions;
         b_class->get_item_actions = brisk_apps_backend_get_item_actions;
 
         /* gobject vtable hookup */
@@ -204,6 +215,11 @@ static void brisk_apps_backend_class_init(BriskAppsBackendClass *klazz)
  */
 static void brisk_apps_backend_init(BriskAppsBackend *self)
 {
+        GSettings *settings = g_settings_new("com.solus-project.brisk-menu");
+
+        self->transliterate = g_settings_get_boolean(settings, "search-transliterate");
+        g_object_unref(settings);
+
         self->monitor = g_app_info_monitor_get();
         g_signal_connect_swapped(self->monitor,
                                  "changed",
@@ -308,13 +324,18 @@ static gboolean brisk_apps_backend_reload(BriskAppsBackend *self)
  *
  * Launch a GDesktopAppInfo action.
  */
-static void brisk_apps_backend_launch_action(GSimpleAction *action,
-                                             __brisk_unused__ GVariant *parameter,
-                                             BriskBackend *backend)
+static void brisk_apps_backend_launch_action(__brisk_unused__ GSimpleAction *action,
+                                             GVariant *parameter, BriskBackend *backend)
 {
-        autofree(GDesktopAppInfo) *app_info = g_object_get_data(G_OBJECT(action), "__appinfo");
-        const gchar *action_name = g_object_get_data(G_OBJECT(action), "__aname");
-        g_assert(app_info != NULL);
+        autofree(GDesktopAppInfo) *app_info = NULL;
+        const gchar *id = NULL;
+        const gchar *action_name = NULL;
+
+        g_variant_get(parameter, "(&s&s)", &id, &action_name);
+        app_info = g_desktop_app_info_new(id);
+        if (!app_info) {
+                return;
+        }
         brisk_backend_hide_menu(backend);
         g_desktop_app_info_launch_action(app_info, action_name, NULL);
 }
@@ -458,7 +479,7 @@ static void brisk_apps_backend_recurse_root(BriskAppsBackend *self,
                                 break;
                         }
                         /* If signal subscribers wish to keep it, they can ref it */
-                        app_item = brisk_apps_item_new(info, section_id);
+                        app_item = brisk_apps_item_new(info, section_id, self->transliterate);
                         brisk_backend_item_added(BRISK_BACKEND(self), app_item);
                 } break;
                 default:
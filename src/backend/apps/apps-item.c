@@ -15,6 +15,7 @@
 #include <string.h>
 
 BRISK_BEGIN_PEDANTIC
+#include "../search.h"
 #include "apps-item.h"
 BRISK_END_PEDANTIC
 
@@ -22,6 +23,10 @@ enum { PROP_INFO = 1, PROP_SECTION_ID, N_PROPS };
 
 DEF_AUTOFREE(gchar, g_free)
 
+/* Helper for g_strsplit */
+typedef gchar *gstrv;
+DEF_AUTOFREE(gstrv, g_strfreev)
+
 static GParamSpec *obj_properties[N_PROPS] = {
         NULL,
 };
@@ -38,6 +43,8 @@ struct _BriskAppsItem {
         BriskItem parent;
         GDesktopAppInfo *info;
         gchar *section_id;
+        GArray *search_keys; /**<Folded search fields, built along with the item */
+        gboolean transliterate;
 };
 
 G_DEFINE_TYPE(BriskAppsItem, brisk_apps_item, BRISK_TYPE_ITEM)
@@ -52,8 +59,11 @@ static const gchar *brisk_apps_item_get_summary(BriskItem *item);
 static const GIcon *brisk_apps_item_get_icon(BriskItem *item);
 static const char *brisk_apps_item_get_backend_id(BriskItem *item);
 static gboolean brisk_apps_item_matches_search(BriskItem *item, gchar *term);
+static gboolean brisk_apps_item_search(BriskItem *item, const gchar *term, const gint *weights,
+                                       BriskSearchMatch *match);
 static gboolean brisk_apps_item_launch(BriskItem *item, GAppLaunchContext *context);
 static gchar *brisk_apps_item_get_uri(BriskItem *item);
+static GAppInfo *brisk_apps_item_get_app_info(BriskItem *item);
 
 static void brisk_apps_item_set_property(GObject *object, guint id, const GValue *value,
                                          GParamSpec *spec)
@@ -102,6 +112,7 @@ static void brisk_apps_item_dispose(GObject *obj)
 
         g_clear_object(&self->info);
         g_clear_pointer(&self->section_id, g_free);
+        g_clear_pointer(&self->search_keys, g_array_unref);
 
         G_OBJECT_CLASS(brisk_apps_item_parent_class)->dispose(obj);
 }
@@ -124,8 +135,10 @@ static void brisk_apps_item_class_init(BriskAppsItemClass *klazz)
         i_class->get_icon = brisk_apps_item_get_icon;
         i_class->get_backend_id = brisk_apps_item_get_backend_id;
         i_class->matches_search = brisk_apps_item_matches_search;
+        i_class->search = brisk_apps_item_search;
         i_class->launch = brisk_apps_item_launch;
         i_class->get_uri = brisk_apps_item_get_uri;
+        i_class->get_app_info = brisk_apps_item_get_app_info;
 
         /* gobject vtable hookup */
         obj_class->dispose = brisk_apps_item_dispose;
@@ -190,22 +203,67 @@ static const char *brisk_apps_item_get_backend_id(__brisk_unused__ BriskItem *it
         return "apps";
 }
 
-__brisk_pure__ static gboolean brisk_apps_array_contains(const gchar **fields, size_t n_fields,
-                                                         const gchar *term)
+/**
+ * Fold every searchable field of the .desktop file exactly once, so that
+ * matching the term is nothing more than a handful of strstr calls. The
+ * name always comes first as it's what the label shows, and the frontend
+ * highlights matches within it.
+ */
+static GArray *brisk_apps_item_build_keys(BriskAppsItem *self)
 {
-        for (size_t i = 0; i < n_fields; i++) {
-                if (!fields[i]) {
-                        continue;
-                }
-                autofree(gchar) *contents = g_strstrip(g_ascii_strdown(fields[i], -1));
-                if (g_str_match_string(term, contents, TRUE)) {
-                        return TRUE;
+        GArray *keys = brisk_search_keys_new();
+        GAppInfo *info = G_APP_INFO(self->info);
+        const gchar *display_name = g_app_info_get_display_name(info);
+        const gchar *const *keywords = NULL;
+        const gchar *executable = NULL;
+        const gchar *categories = NULL;
+        gboolean tr = self->transliterate;
+
+        brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_NAME, g_app_info_get_name(info), tr);
+        brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_NAME, display_name, tr);
+        brisk_search_keys_add(keys,
+                              BRISK_SEARCH_FIELD_GENERIC_NAME,
+                              g_desktop_app_info_get_generic_name(self->info),
+                              tr);
+
+        keywords = g_desktop_app_info_get_keywords(self->info);
+        for (guint i = 0; keywords && keywords[i]; i++) {
+                brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_KEYWORDS, keywords[i], tr);
+        }
+
+        /* Categories are a ;-separated list of plain ASCII identifiers */
+        categories = g_desktop_app_info_get_categories(self->info);
+        if (categories) {
+                autofree(gstrv) *split = g_strsplit(categories, ";", -1);
+
+                for (guint i = 0; split[i]; i++) {
+                        brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_CATEGORIES, split[i], FALSE);
                 }
-                if (strstr(contents, term)) {
-                        return TRUE;
+        }
+
+        brisk_search_keys_add(keys,
+                              BRISK_SEARCH_FIELD_DESCRIPTION,
+                              g_app_info_get_description(info),
+                              tr);
+
+        executable = g_app_info_get_executable(info);
+        if (executable) {
+                autofree(gchar) *base = g_path_get_basename(executable);
+
+                brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_EXEC, base, FALSE);
+        }
+
+        /* Han names can't be romanised mechanically, but the untranslated
+         * Name is very often the Latin name the user is looking for */
+        if (tr) {
+                autofree(gchar) *name = g_desktop_app_info_get_string(self->info, "Name");
+
+                if (g_strcmp0(name, display_name) != 0) {
+                        brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_NAME, name, FALSE);
                 }
         }
-        return FALSE;
+
+        return keys;
 }
 
 /**
@@ -215,38 +273,26 @@ __brisk_pure__ static gboolean brisk_apps_array_contains(const gchar **fields, s
  * term. It looks for the string within a number of the entry's fields, and will
  * hide them if they don't turn up.
  *
- * Note: This function uses g_str_match_string so that ASCII alternatives are
- * searched. This allows searching for text containing accents, etc, so that
- * the menu can be more useful in more locales.
- *
- * This could probably be improved in future to generate internal state to allow
- * the search itself to be sorted based on the results, with the "most similar"
- * appearing near the top.
+ * The term has already been through brisk_search_fold, and so have our keys,
+ * so case and accents are ignored in every script without any per-call
+ * Unicode work.
  */
-__brisk_pure__ static gboolean brisk_apps_item_matches_search(BriskItem *item, gchar *term)
+static gboolean brisk_apps_item_matches_search(BriskItem *item, gchar *term)
 {
         BriskAppsItem *self = BRISK_APPS_ITEM(item);
 
-        const gchar *fields[] = {
-                g_app_info_get_display_name(G_APP_INFO(self->info)),
-                g_app_info_get_description(G_APP_INFO(self->info)),
-                g_app_info_get_name(G_APP_INFO(self->info)),
-                g_app_info_get_executable(G_APP_INFO(self->info)),
-        };
-
-        const gchar *const *keywords = g_desktop_app_info_get_keywords(self->info);
-
-        if (brisk_apps_array_contains(fields, G_N_ELEMENTS(fields), term)) {
-                return TRUE;
-        }
+        return brisk_search_keys_contains(brisk_apps_item_get_search_keys(self), term);
+}
 
-        if (!keywords) {
-                return FALSE;
-        }
+/**
+ * Match and score in a single pass over the keys
+ */
+static gboolean brisk_apps_item_search(BriskItem *item, const gchar *term, const gint *weights,
+                                       BriskSearchMatch *match)
+{
+        BriskAppsItem *self = BRISK_APPS_ITEM(item);
 
-        return brisk_apps_array_contains((const gchar **)keywords,
-                                         g_strv_length((gchar **)keywords),
-                                         term);
+        return brisk_search_keys_match(brisk_apps_item_get_search_keys(self), term, weights, match);
 }
 
 /**
@@ -271,14 +317,28 @@ static gchar *brisk_apps_item_get_uri(BriskItem *item)
         return g_filename_to_uri(desktop_fpath, NULL, NULL);
 }
 
+static GAppInfo *brisk_apps_item_get_app_info(BriskItem *item)
+{
+        BriskAppsItem *self = BRISK_APPS_ITEM(item);
+        return G_APP_INFO(self->info);
+}
+
 /**
  * brisk_apps_item_new:
  *
  * Return a new BriskAppsItem for the given desktop file
  */
-BriskItem *brisk_apps_item_new(GDesktopAppInfo *info, gchar *section_id)
+BriskItem *brisk_apps_item_new(GDesktopAppInfo *info, gchar *section_id, gboolean transliterate)
 {
-        return g_object_new(BRISK_TYPE_APPS_ITEM, "info", info, "section-id", section_id, NULL);
+        BriskAppsItem *self = NULL;
+
+        self = g_object_new(BRISK_TYPE_APPS_ITEM, "info", info, "section-id", section_id, NULL);
+        self->transliterate = transliterate;
+
+        /* Fold everything while the menu loads, not on the first keystroke */
+        self->search_keys = brisk_apps_item_build_keys(self);
+
+        return BRISK_ITEM(self);
 }
 
 /**
@@ -292,6 +352,27 @@ const gchar *brisk_apps_item_get_section_id(BriskAppsItem *self)
         return (const gchar *)self->section_id;
 }
 
+/**
+ * brisk_apps_item_get_info:
+ *
+ * Private API for the AppsBackend to reuse the already parsed .desktop file
+ */
+GDesktopAppInfo *brisk_apps_item_get_info(BriskAppsItem *self)
+{
+        return self->info;
+}
+
+/**
+ * brisk_apps_item_get_search_keys:
+ *
+ * Return the folded search keys for the item, as built when the item was
+ * created. The backend host sends these over as they are.
+ */
+GArray *brisk_apps_item_get_search_keys(BriskAppsItem *self)
+{
+        return self->search_keys;
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
@@ -33,9 +33,11 @@ typedef struct _BriskAppsItemClass BriskAppsItemClass;
 
 GType brisk_apps_item_get_type(void);
 
-BriskItem *brisk_apps_item_new(GDesktopAppInfo *info, gchar *section_id);
+BriskItem *brisk_apps_item_new(GDesktopAppInfo *info, gchar *section_id, gboolean transliterate);
 
 const gchar *brisk_apps_item_get_section_id(BriskAppsItem *item);
+GDesktopAppInfo *brisk_apps_item_get_info(BriskAppsItem *item);
+GArray *brisk_apps_item_get_search_keys(BriskAppsItem *item);
 
 G_END_DECLS
 
@@ -22,6 +22,8 @@ BRISK_END_PEDANTIC
  */
 enum { BACKEND_SIGNAL_ITEM_ADDED = 0,
        BACKEND_SIGNAL_ITEM_REMOVED,
+       BACKEND_SIGNAL_ITEM_CHANGED,
+       BACKEND_SIGNAL_ACTIONS_CHANGED,
        BACKEND_SIGNAL_SECTION_ADDED,
        BACKEND_SIGNAL_SECTION_REMOVED,
        BACKEND_SIGNAL_INVALIDATE_FILTER,
@@ -93,6 +95,46 @@ static void brisk_backend_class_init(BriskBackendClass *klazz)
                          1,
                          G_TYPE_STRING);
 
+        /**
+         * BriskBackend::item-changed
+         * @backend: The backend that owns the item
+         * @id: The item's ID that changed
+         *
+         * Used to notify the frontend that a single item's ordering or visibility
+         * changed, so that only that item needs to be sorted and filtered again
+         */
+        backend_signals[BACKEND_SIGNAL_ITEM_CHANGED] =
+            g_signal_new("item-changed",
+                         BRISK_TYPE_BACKEND,
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+                         G_STRUCT_OFFSET(BriskBackendClass, item_changed),
+                         NULL,
+                         NULL,
+                         NULL,
+                         G_TYPE_NONE,
+                         1,
+                         G_TYPE_STRING);
+
+        /**
+         * BriskBackend::actions-changed
+         * @backend: The backend whose actions changed
+         * @id: The item's ID whose actions changed, or NULL for all items
+         *
+         * Used to notify the frontend that any cached context menu for the item
+         * is now stale and must be rebuilt
+         */
+        backend_signals[BACKEND_SIGNAL_ACTIONS_CHANGED] =
+            g_signal_new("actions-changed",
+                         BRISK_TYPE_BACKEND,
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+                         G_STRUCT_OFFSET(BriskBackendClass, actions_changed),
+                         NULL,
+                         NULL,
+                         NULL,
+                         G_TYPE_NONE,
+                         1,
+                         G_TYPE_STRING);
+
         /**
          * BriskBackend::section-added
          * @backend: The backend that created the section
@@ -214,6 +256,28 @@ void brisk_backend_item_removed(BriskBackend *self, const gchar *id)
         g_signal_emit(self, backend_signals[BACKEND_SIGNAL_ITEM_REMOVED], 0, id);
 }
 
+/**
+ * brisk_backend_item_changed:
+ *
+ * Implementations may use this method to emit the signal item-changed
+ */
+void brisk_backend_item_changed(BriskBackend *self, const gchar *id)
+{
+        g_assert(self != NULL);
+        g_signal_emit(self, backend_signals[BACKEND_SIGNAL_ITEM_CHANGED], 0, id);
+}
+
+/**
+ * brisk_backend_actions_changed:
+ *
+ * Implementations may use this method to emit the signal actions-changed
+ */
+void brisk_backend_actions_changed(BriskBackend *self, const gchar *id)
+{
+        g_assert(self != NULL);
+        g_signal_emit(self, backend_signals[BACKEND_SIGNAL_ACTIONS_CHANGED], 0, id);
+}
+
 /**
  * brisk_backend_section_added:
  *
@@ -310,7 +374,22 @@ const gchar *brisk_backend_get_display_name(BriskBackend *backend)
         return klazz->get_display_name(backend);
 }
 
-GMenu *brisk_backend_get_item_actions(BriskBackend *backend, BriskItem *item, GActionGroup *group)
+/**
+ * brisk_backend_register_actions:
+ *
+ * Add the backend's context menu actions to the frontend's action map
+ */
+void brisk_backend_register_actions(BriskBackend *backend, GActionMap *map)
+{
+        g_assert(backend != NULL);
+        BriskBackendClass *klazz = BRISK_BACKEND_GET_CLASS(backend);
+        if (!klazz->register_actions) {
+                return;
+        }
+        klazz->register_actions(backend, map);
+}
+
+GMenu *brisk_backend_get_item_actions(BriskBackend *backend, BriskItem *item)
 {
         g_assert(backend != NULL);
         g_assert(item != NULL);
@@ -318,7 +397,7 @@ GMenu *brisk_backend_get_item_actions(BriskBackend *backend, BriskItem *item, GA
         if (!klazz->get_item_actions) {
                 return NULL;
         }
-        return klazz->get_item_actions(backend, item, group);
+        return klazz->get_item_actions(backend, item);
 }
 
 /**
@@ -335,6 +414,72 @@ gboolean brisk_backend_load(BriskBackend *backend)
         return klazz->load(backend);
 }
 
+/**
+ * brisk_backend_item_launched:
+ *
+ * Inform the backend that the given item was just launched by the user
+ */
+void brisk_backend_item_launched(BriskBackend *backend, BriskItem *item)
+{
+        g_assert(backend != NULL);
+        g_assert(item != NULL);
+        BriskBackendClass *klazz = BRISK_BACKEND_GET_CLASS(backend);
+        if (!klazz->item_launched) {
+                return;
+        }
+        klazz->item_launched(backend, item);
+}
+
+/**
+ * brisk_backend_get_item_boost:
+ *
+ * Return the ranking boost this backend wishes to apply to the item when
+ * searching. Backends that don't rank anything contribute nothing.
+ */
+gint brisk_backend_get_item_boost(BriskBackend *backend, BriskItem *item)
+{
+        g_assert(backend != NULL);
+        g_assert(item != NULL);
+        BriskBackendClass *klazz = BRISK_BACKEND_GET_CLASS(backend);
+        if (!klazz->get_item_boost) {
+                return 0;
+        }
+        return klazz->get_item_boost(backend, item);
+}
+
+/**
+ * brisk_backend_section_activated:
+ *
+ * Inform the backend that one of its sections was just opened by the user
+ */
+void brisk_backend_section_activated(BriskBackend *backend, BriskSection *section)
+{
+        g_assert(backend != NULL);
+        g_assert(section != NULL);
+        BriskBackendClass *klazz = BRISK_BACKEND_GET_CLASS(backend);
+        if (!klazz->section_activated) {
+                return;
+        }
+        klazz->section_activated(backend, section);
+}
+
+/**
+ * brisk_backend_search_changed:
+ *
+ * Inform the backend of the new search term, or NULL once searching ends.
+ * Backends that don't hold every item up front may use this to emit, and
+ * later remove, the items matching the term.
+ */
+void brisk_backend_search_changed(BriskBackend *backend, const gchar *term)
+{
+        g_assert(backend != NULL);
+        BriskBackendClass *klazz = BRISK_BACKEND_GET_CLASS(backend);
+        if (!klazz->search_changed) {
+                return;
+        }
+        klazz->search_changed(backend, term);
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
@@ -26,6 +26,7 @@ typedef struct _BriskBackendClass BriskBackendClass;
 typedef enum {
         BRISK_BACKEND_KEYBOARD = 1 << 0, /**<Supports keyboard shortcuts */
         BRISK_BACKEND_SOURCE = 1 << 1,   /**<Provides data which must be loaded */
+        BRISK_BACKEND_SEARCH = 1 << 2,   /**<Items only exist in answer to a search term */
 } BriskBackendFlags;
 
 struct _BriskBackendClass {
@@ -36,22 +37,38 @@ struct _BriskBackendClass {
         const gchar *(*get_id)(BriskBackend *);
         const gchar *(*get_display_name)(BriskBackend *);
 
-        /* Optional method for providing context menu items */
-        GMenu *(*get_item_actions)(BriskBackend *, BriskItem *, GActionGroup *);
+        /* Optional methods for providing context menu items. Actions are registered
+         * once per frontend and take the item as their target, so that the menus
+         * themselves may be cached. */
+        void (*register_actions)(BriskBackend *, GActionMap *);
+        GMenu *(*get_item_actions)(BriskBackend *, BriskItem *);
 
         /* All plugins given an opportunity to load later in life */
         gboolean (*load)(BriskBackend *);
 
+        /* Optional methods for learning from launches and ranking search results */
+        void (*item_launched)(BriskBackend *, BriskItem *);
+        gint (*get_item_boost)(BriskBackend *, BriskItem *);
+
         /* Signals, gtk-doc style with param names */
         void (*item_added)(BriskBackend *backend, BriskItem *item);
         void (*item_removed)(BriskBackend *backend, const gchar *id);
+        void (*item_changed)(BriskBackend *backend, const gchar *id);
+        void (*actions_changed)(BriskBackend *backend, const gchar *id);
         void (*section_added)(BriskBackend *backend, BriskSection *section);
         void (*section_removed)(BriskBackend *backend, const gchar *id);
         void (*invalidate_filter)(BriskBackend *backend);
         void (*hide_menu)(BriskBackend *backend);
         void (*reset)(BriskBackend *backend);
 
-        gpointer padding[12];
+        /* Optional notification that the user opened one of our sections,
+         * appended here to keep the signal slots above at stable offsets */
+        void (*section_activated)(BriskBackend *, BriskSection *);
+
+        /* Optional, for backends producing items on demand for a search term */
+        void (*search_changed)(BriskBackend *, const gchar *);
+
+        gpointer padding[5];
 };
 
 /**
@@ -78,16 +95,29 @@ GType brisk_backend_get_type(void);
 unsigned int brisk_backend_get_flags(BriskBackend *backend);
 const gchar *brisk_backend_get_id(BriskBackend *backend);
 const gchar *brisk_backend_get_display_name(BriskBackend *backend);
-GMenu *brisk_backend_get_item_actions(BriskBackend *backend, BriskItem *item, GActionGroup *group);
+void brisk_backend_register_actions(BriskBackend *backend, GActionMap *map);
+GMenu *brisk_backend_get_item_actions(BriskBackend *backend, BriskItem *item);
 
 /* Attempt to load for the first time */
 gboolean brisk_backend_load(BriskBackend *backend);
 
+/* Launch telemetry and search ranking */
+void brisk_backend_item_launched(BriskBackend *backend, BriskItem *item);
+gint brisk_backend_get_item_boost(BriskBackend *backend, BriskItem *item);
+
+/* Section was selected within the frontend */
+void brisk_backend_section_activated(BriskBackend *backend, BriskSection *section);
+
+/* Search term changed within the frontend, NULL when cleared */
+void brisk_backend_search_changed(BriskBackend *backend, const gchar *term);
+
 /**
  * Helpers for subclasses
  */
 void brisk_backend_item_added(BriskBackend *backend, BriskItem *item);
 void brisk_backend_item_removed(BriskBackend *backend, const gchar *id);
+void brisk_backend_item_changed(BriskBackend *backend, const gchar *id);
+void brisk_backend_actions_changed(BriskBackend *backend, const gchar *id);
 void brisk_backend_section_added(BriskBackend *backend, BriskSection *section);
 void brisk_backend_section_removed(BriskBackend *backend, const gchar *id);
 void brisk_backend_invalidate_filter(BriskBackend *backend);
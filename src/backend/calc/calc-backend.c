@@ -0,0 +1,167 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "calc-backend.h"
+#include "calc-item.h"
+#include <glib/gi18n.h>
+BRISK_END_PEDANTIC
+
+/**
+ * Enough to put a result above any textual match
+ */
+#define BRISK_CALC_BOOST 1000
+
+struct _BriskCalcBackendClass {
+        BriskBackendClass parent_class;
+};
+
+/**
+ * BriskCalcBackend evaluates the search term as arithmetic or a unit
+ * conversion, showing the outcome as a single result
+ */
+struct _BriskCalcBackend {
+        BriskBackend parent;
+        BriskItem *item; /**<Reused for every result */
+        gboolean shown;
+};
+
+G_DEFINE_TYPE(BriskCalcBackend, brisk_calc_backend, BRISK_TYPE_BACKEND)
+
+static void brisk_calc_backend_search_changed(BriskBackend *backend, const gchar *term);
+static gint brisk_calc_backend_get_item_boost(BriskBackend *backend, BriskItem *item);
+
+/**
+ * Tell the frontends what we are. Nothing to load, we only answer searches.
+ */
+static unsigned int brisk_calc_backend_get_flags(__brisk_unused__ BriskBackend *backend)
+{
+        return BRISK_BACKEND_SEARCH;
+}
+
+static const gchar *brisk_calc_backend_get_id(__brisk_unused__ BriskBackend *backend)
+{
+        return "calculator";
+}
+
+static const gchar *brisk_calc_backend_get_display_name(__brisk_unused__ BriskBackend *backend)
+{
+        return _("Calculator");
+}
+
+/**
+ * brisk_calc_backend_dispose:
+ *
+ * Clean up a BriskCalcBackend instance
+ */
+static void brisk_calc_backend_dispose(GObject *obj)
+{
+        BriskCalcBackend *self = BRISK_CALC_BACKEND(obj);
+
+        g_clear_object(&self->item);
+
+        G_OBJECT_CLASS(brisk_calc_backend_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_calc_backend_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_calc_backend_class_init(BriskCalcBackendClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskBackendClass *b_class = BRISK_BACKEND_CLASS(klazz);
+
+        /* Backend vtable hookup */
+        b_class->get_flags = brisk_calc_backend_get_flags;
+        b_class->get_id = brisk_calc_backend_get_id;
+        b_class->get_display_name = brisk_calc_backend_get_display_name;
+        b_class->search_changed = brisk_calc_backend_search_changed;
+        b_class->get_item_boost = brisk_calc_backend_get_item_boost;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_calc_backend_dispose;
+}
+
+/**
+ * brisk_calc_backend_init:
+ *
+ * Handle construction of the BriskCalcBackend
+ */
+static void brisk_calc_backend_init(BriskCalcBackend *self)
+{
+        self->item = g_object_ref_sink(brisk_calc_item_new());
+}
+
+/**
+ * Evaluate the new term. The row is only added when a result first appears
+ * and removed once it goes away, in between it's updated in place.
+ */
+static void brisk_calc_backend_search_changed(BriskBackend *backend, const gchar *term)
+{
+        BriskCalcBackend *self = BRISK_CALC_BACKEND(backend);
+        BriskCalcResult result = { 0 };
+        gboolean changed;
+
+        if (!term || !brisk_calc_evaluate(term, &result)) {
+                if (self->shown) {
+                        self->shown = FALSE;
+                        brisk_backend_item_removed(backend, brisk_item_get_id(self->item));
+                }
+                return;
+        }
+
+        changed = brisk_calc_item_set_result(BRISK_CALC_ITEM(self->item), &result);
+        if (!self->shown) {
+                self->shown = TRUE;
+                brisk_backend_item_added(backend, self->item);
+        } else if (changed) {
+                brisk_backend_item_changed(backend, brisk_item_get_id(self->item));
+        }
+}
+
+/**
+ * A term that evaluates is hardly going to be an application name
+ */
+static gint brisk_calc_backend_get_item_boost(BriskBackend *backend, BriskItem *item)
+{
+        BriskCalcBackend *self = BRISK_CALC_BACKEND(backend);
+
+        return item == self->item ? BRISK_CALC_BOOST : 0;
+}
+
+/**
+ * brisk_calc_backend_new:
+ *
+ * Return a newly created BriskCalcBackend
+ */
+BriskBackend *brisk_calc_backend_new(void)
+{
+        return g_object_new(BRISK_TYPE_CALC_BACKEND, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,359 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <math.h>
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "calc-eval.h"
+BRISK_END_PEDANTIC
+
+/**
+ * The evaluator runs on every keystroke, so it works directly on the search
+ * term and its state lives entirely on the stack. Anything that doesn't look
+ * like arithmetic is rejected at the first character.
+ *
+ *      input   := expr [unit ("in" | "to") unit]
+ *      expr    := term (("+" | "-") term)*
+ *      term    := unary (("*" | "/" | "%") unary)*
+ *      unary   := ("-" | "+") unary | power
+ *      power   := primary ["^" unary]
+ *      primary := number | "(" expr ")"
+ */
+
+enum {
+        BRISK_CALC_LENGTH = 0,
+        BRISK_CALC_MASS,
+        BRISK_CALC_VOLUME,
+        BRISK_CALC_TEMPERATURE,
+        BRISK_CALC_TIME,
+        BRISK_CALC_DATA,
+};
+
+static const BriskCalcUnit brisk_calc_units[] = {
+        /* Length, in metres */
+        { "m", "m", BRISK_CALC_LENGTH, 1.0, 0.0 },
+        { "km", "km", BRISK_CALC_LENGTH, 1000.0, 0.0 },
+        { "cm", "cm", BRISK_CALC_LENGTH, 0.01, 0.0 },
+        { "mm", "mm", BRISK_CALC_LENGTH, 0.001, 0.0 },
+        { "mi", "mi", BRISK_CALC_LENGTH, 1609.344, 0.0 },
+        { "miles", "mi", BRISK_CALC_LENGTH, 1609.344, 0.0 },
+        { "yd", "yd", BRISK_CALC_LENGTH, 0.9144, 0.0 },
+        { "ft", "ft", BRISK_CALC_LENGTH, 0.3048, 0.0 },
+        { "in", "in", BRISK_CALC_LENGTH, 0.0254, 0.0 },
+        { "nmi", "nmi", BRISK_CALC_LENGTH, 1852.0, 0.0 },
+
+        /* Mass, in grams */
+        { "g", "g", BRISK_CALC_MASS, 1.0, 0.0 },
+        { "kg", "kg", BRISK_CALC_MASS, 1000.0, 0.0 },
+        { "mg", "mg", BRISK_CALC_MASS, 0.001, 0.0 },
+        { "t", "t", BRISK_CALC_MASS, 1000000.0, 0.0 },
+        { "lb", "lb", BRISK_CALC_MASS, 453.59237, 0.0 },
+        { "lbs", "lb", BRISK_CALC_MASS, 453.59237, 0.0 },
+        { "oz", "oz", BRISK_CALC_MASS, 28.349523125, 0.0 },
+        { "st", "st", BRISK_CALC_MASS, 6350.29318, 0.0 },
+
+        /* Volume, in litres */
+        { "l", "l", BRISK_CALC_VOLUME, 1.0, 0.0 },
+        { "ml", "ml", BRISK_CALC_VOLUME, 0.001, 0.0 },
+        { "gal", "gal", BRISK_CALC_VOLUME, 3.785411784, 0.0 },
+        { "qt", "qt", BRISK_CALC_VOLUME, 0.946352946, 0.0 },
+        { "pt", "pt", BRISK_CALC_VOLUME, 0.473176473, 0.0 },
+
+        /* Temperature, in kelvin */
+        { "k", "K", BRISK_CALC_TEMPERATURE, 1.0, 0.0 },
+        { "c", "°C", BRISK_CALC_TEMPERATURE, 1.0, 273.15 },
+        { "f", "°F", BRISK_CALC_TEMPERATURE, 5.0 / 9.0, 273.15 - 32.0 * 5.0 / 9.0 },
+
+        /* Time, in seconds */
+        { "ms", "ms", BRISK_CALC_TIME, 0.001, 0.0 },
+        { "s", "s", BRISK_CALC_TIME, 1.0, 0.0 },
+        { "min", "min", BRISK_CALC_TIME, 60.0, 0.0 },
+        { "h", "h", BRISK_CALC_TIME, 3600.0, 0.0 },
+        { "d", "d", BRISK_CALC_TIME, 86400.0, 0.0 },
+
+        /* Data, in bytes */
+        { "b", "B", BRISK_CALC_DATA, 1.0, 0.0 },
+        { "kb", "kB", BRISK_CALC_DATA, 1e3, 0.0 },
+        { "mb", "MB", BRISK_CALC_DATA, 1e6, 0.0 },
+        { "gb", "GB", BRISK_CALC_DATA, 1e9, 0.0 },
+        { "tb", "TB", BRISK_CALC_DATA, 1e12, 0.0 },
+        { "kib", "KiB", BRISK_CALC_DATA, 1024.0, 0.0 },
+        { "mib", "MiB", BRISK_CALC_DATA, 1048576.0, 0.0 },
+        { "gib", "GiB", BRISK_CALC_DATA, 1073741824.0, 0.0 },
+};
+
+typedef struct BriskCalcParser {
+        const gchar *pos;
+        guint depth;
+        guint n_ops; /**<Binary operators seen, a bare number isn't a sum */
+        gboolean error;
+} BriskCalcParser;
+
+static gdouble brisk_calc_parse_expr(BriskCalcParser *parser);
+static gdouble brisk_calc_parse_unary(BriskCalcParser *parser);
+
+static inline void brisk_calc_skip_space(BriskCalcParser *parser)
+{
+        while (*parser->pos == ' ' || *parser->pos == '\t') {
+                ++parser->pos;
+        }
+}
+
+/**
+ * Consume the given character if it comes next
+ */
+static inline gboolean brisk_calc_accept(BriskCalcParser *parser, gchar c)
+{
+        brisk_calc_skip_space(parser);
+        if (*parser->pos != c) {
+                return FALSE;
+        }
+        ++parser->pos;
+        return TRUE;
+}
+
+/**
+ * Plain decimal numbers only, without going through the locale
+ */
+static gdouble brisk_calc_parse_number(BriskCalcParser *parser)
+{
+        gdouble value = 0.0;
+        gdouble scale = 1.0;
+        gboolean digits = FALSE;
+
+        while (g_ascii_isdigit(*parser->pos)) {
+                value = value * 10.0 + (*parser->pos++ - '0');
+                digits = TRUE;
+        }
+
+        if (*parser->pos == '.') {
+                ++parser->pos;
+                while (g_ascii_isdigit(*parser->pos)) {
+                        value = value * 10.0 + (*parser->pos++ - '0');
+                        scale *= 10.0;
+                        digits = TRUE;
+                }
+        }
+
+        if (!digits) {
+                parser->error = TRUE;
+                return 0.0;
+        }
+        return value / scale;
+}
+
+static gdouble brisk_calc_parse_primary(BriskCalcParser *parser)
+{
+        gdouble value;
+
+        if (!brisk_calc_accept(parser, '(')) {
+                return brisk_calc_parse_number(parser);
+        }
+
+        value = brisk_calc_parse_expr(parser);
+        if (!brisk_calc_accept(parser, ')')) {
+                parser->error = TRUE;
+        }
+        return value;
+}
+
+/**
+ * Exponentiation binds tighter than negation, and right to left
+ */
+static gdouble brisk_calc_parse_power(BriskCalcParser *parser)
+{
+        gdouble value = brisk_calc_parse_primary(parser);
+
+        if (parser->error || !brisk_calc_accept(parser, '^')) {
+                return value;
+        }
+
+        ++parser->n_ops;
+        return pow(value, brisk_calc_parse_unary(parser));
+}
+
+static gdouble brisk_calc_parse_unary(BriskCalcParser *parser)
+{
+        gdouble value;
+
+        if (++parser->depth > BRISK_CALC_MAX_DEPTH) {
+                parser->error = TRUE;
+                return 0.0;
+        }
+
+        if (brisk_calc_accept(parser, '-')) {
+                value = -brisk_calc_parse_unary(parser);
+        } else if (brisk_calc_accept(parser, '+')) {
+                value = brisk_calc_parse_unary(parser);
+        } else {
+                value = brisk_calc_parse_power(parser);
+        }
+
+        --parser->depth;
+        return value;
+}
+
+static gdouble brisk_calc_parse_term(BriskCalcParser *parser)
+{
+        gdouble value = brisk_calc_parse_unary(parser);
+
+        while (!parser->error) {
+                if (brisk_calc_accept(parser, '*')) {
+                        value *= brisk_calc_parse_unary(parser);
+                } else if (brisk_calc_accept(parser, '/')) {
+                        value /= brisk_calc_parse_unary(parser);
+                } else if (brisk_calc_accept(parser, '%')) {
+                        value = fmod(value, brisk_calc_parse_unary(parser));
+                } else {
+                        break;
+                }
+                ++parser->n_ops;
+        }
+
+        return value;
+}
+
+static gdouble brisk_calc_parse_expr(BriskCalcParser *parser)
+{
+        gdouble value = brisk_calc_parse_term(parser);
+
+        while (!parser->error) {
+                if (brisk_calc_accept(parser, '+')) {
+                        value += brisk_calc_parse_term(parser);
+                } else if (brisk_calc_accept(parser, '-')) {
+                        value -= brisk_calc_parse_term(parser);
+                } else {
+                        break;
+                }
+                ++parser->n_ops;
+        }
+
+        return value;
+}
+
+/**
+ * Consume the next word, returning its length
+ */
+static gsize brisk_calc_parse_word(BriskCalcParser *parser, const gchar **word)
+{
+        brisk_calc_skip_space(parser);
+
+        *word = parser->pos;
+        while (g_ascii_isalpha(*parser->pos)) {
+                ++parser->pos;
+        }
+        return (gsize)(parser->pos - *word);
+}
+
+static const BriskCalcUnit *brisk_calc_parse_unit(BriskCalcParser *parser)
+{
+        const gchar *word = NULL;
+        gsize len = brisk_calc_parse_word(parser, &word);
+
+        for (guint i = 0; len > 0 && i < G_N_ELEMENTS(brisk_calc_units); i++) {
+                const BriskCalcUnit *unit = &brisk_calc_units[i];
+
+                if (strncmp(unit->name, word, len) == 0 && unit->name[len] == '\0') {
+                        return unit;
+                }
+        }
+        return NULL;
+}
+
+/**
+ * Handle the optional "<unit> in <unit>" suffix
+ */
+static gboolean brisk_calc_parse_conversion(BriskCalcParser *parser, BriskCalcResult *result)
+{
+        const BriskCalcUnit *from = NULL;
+        const BriskCalcUnit *to = NULL;
+        const gchar *word = NULL;
+        gsize len;
+
+        from = brisk_calc_parse_unit(parser);
+        if (!from) {
+                return FALSE;
+        }
+
+        len = brisk_calc_parse_word(parser, &word);
+        if (!(len == 2 && (strncmp(word, "in", 2) == 0 || strncmp(word, "to", 2) == 0))) {
+                return FALSE;
+        }
+
+        to = brisk_calc_parse_unit(parser);
+        if (!to || to->kind != from->kind) {
+                return FALSE;
+        }
+
+        result->value = ((result->value * from->scale + from->offset) - to->offset) / to->scale;
+        result->unit = to;
+        return TRUE;
+}
+
+/**
+ * brisk_calc_evaluate:
+ *
+ * Evaluate the (lower case) search term as an arithmetic expression or unit
+ * conversion. Never allocates, so it's cheap enough to run on every keystroke.
+ *
+ * Returns TRUE if the term was understood and has a finite result
+ */
+gboolean brisk_calc_evaluate(const gchar *expression, BriskCalcResult *result)
+{
+        BriskCalcParser parser = {.pos = expression };
+
+        result->value = brisk_calc_parse_expr(&parser);
+        result->unit = NULL;
+        if (parser.error) {
+                return FALSE;
+        }
+
+        brisk_calc_skip_space(&parser);
+        if (*parser.pos != '\0') {
+                if (!brisk_calc_parse_conversion(&parser, result)) {
+                        return FALSE;
+                }
+                brisk_calc_skip_space(&parser);
+                if (*parser.pos != '\0') {
+                        return FALSE;
+                }
+        } else if (parser.n_ops == 0) {
+                return FALSE;
+        }
+
+        if (!isfinite(result->value)) {
+                return FALSE;
+        }
+
+        /* Nobody wants to see -0 */
+        if (result->value == 0.0) {
+                result->value = 0.0;
+        }
+        return TRUE;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,59 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Deepest nesting of parentheses and unary operators we'll follow
+ */
+#define BRISK_CALC_MAX_DEPTH 32
+
+/**
+ * A unit of measurement, converted to the base unit of its kind as
+ * (value * scale) + offset
+ */
+typedef struct BriskCalcUnit {
+        const gchar *name;   /**<As typed by the user */
+        const gchar *symbol; /**<As displayed */
+        guint kind;
+        gdouble scale;
+        gdouble offset;
+} BriskCalcUnit;
+
+/**
+ * Outcome of evaluating a single search term, unit is only set for
+ * conversions
+ */
+typedef struct BriskCalcResult {
+        gdouble value;
+        const BriskCalcUnit *unit;
+} BriskCalcResult;
+
+gboolean brisk_calc_evaluate(const gchar *expression, BriskCalcResult *result);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
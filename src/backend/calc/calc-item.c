@@ -0,0 +1,210 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "calc-item.h"
+#include <glib/gi18n.h>
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+/**
+ * Room for the longest result %.10g and a unit symbol can produce
+ */
+#define BRISK_CALC_ITEM_NAME_MAX 48
+
+struct _BriskCalcItemClass {
+        BriskItemClass parent_class;
+};
+
+/**
+ * BriskCalcItem is the one result row for whatever the user is calculating.
+ * It's updated in place for every search term, so the text lives in fixed
+ * buffers rather than being allocated each time.
+ */
+struct _BriskCalcItem {
+        BriskItem parent;
+        gchar name[BRISK_CALC_ITEM_NAME_MAX];
+        gchar value[G_ASCII_DTOSTR_BUF_SIZE]; /**<What we copy, without the unit */
+        GIcon *icon;
+};
+
+G_DEFINE_TYPE(BriskCalcItem, brisk_calc_item, BRISK_TYPE_ITEM)
+
+static const gchar *brisk_calc_item_get_id(BriskItem *item);
+static const gchar *brisk_calc_item_get_name(BriskItem *item);
+static const gchar *brisk_calc_item_get_summary(BriskItem *item);
+static const GIcon *brisk_calc_item_get_icon(BriskItem *item);
+static const gchar *brisk_calc_item_get_backend_id(BriskItem *item);
+static gboolean brisk_calc_item_matches_search(BriskItem *item, gchar *term);
+static gboolean brisk_calc_item_launch(BriskItem *item, GAppLaunchContext *context);
+static gchar *brisk_calc_item_get_uri(BriskItem *item);
+
+/**
+ * brisk_calc_item_dispose:
+ *
+ * Clean up a BriskCalcItem instance
+ */
+static void brisk_calc_item_dispose(GObject *obj)
+{
+        BriskCalcItem *self = BRISK_CALC_ITEM(obj);
+
+        g_clear_object(&self->icon);
+
+        G_OBJECT_CLASS(brisk_calc_item_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_calc_item_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_calc_item_class_init(BriskCalcItemClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskItemClass *i_class = BRISK_ITEM_CLASS(klazz);
+
+        /* item vtable hookup */
+        i_class->get_id = brisk_calc_item_get_id;
+        i_class->get_name = brisk_calc_item_get_name;
+        i_class->get_display_name = brisk_calc_item_get_name;
+        i_class->get_summary = brisk_calc_item_get_summary;
+        i_class->get_icon = brisk_calc_item_get_icon;
+        i_class->get_backend_id = brisk_calc_item_get_backend_id;
+        i_class->matches_search = brisk_calc_item_matches_search;
+        i_class->launch = brisk_calc_item_launch;
+        i_class->get_uri = brisk_calc_item_get_uri;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_calc_item_dispose;
+}
+
+/**
+ * brisk_calc_item_init:
+ *
+ * Handle construction of the BriskCalcItem
+ */
+static void brisk_calc_item_init(BriskCalcItem *self)
+{
+        self->icon = g_themed_icon_new_with_default_fallbacks("accessories-calculator");
+}
+
+/**
+ * There is only ever one result, so the ID is fixed
+ */
+static const gchar *brisk_calc_item_get_id(__brisk_unused__ BriskItem *item)
+{
+        return "calculator";
+}
+
+static const gchar *brisk_calc_item_get_name(BriskItem *item)
+{
+        BriskCalcItem *self = BRISK_CALC_ITEM(item);
+        return (const gchar *)self->name;
+}
+
+static const gchar *brisk_calc_item_get_summary(__brisk_unused__ BriskItem *item)
+{
+        return _("Copy the result to the clipboard");
+}
+
+static const GIcon *brisk_calc_item_get_icon(BriskItem *item)
+{
+        BriskCalcItem *self = BRISK_CALC_ITEM(item);
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_calc_item_get_backend_id(__brisk_unused__ BriskItem *item)
+{
+        return "calculator";
+}
+
+/**
+ * The backend evaluated the term before filtering, and only keeps us around
+ * while it has a result
+ */
+static gboolean brisk_calc_item_matches_search(__brisk_unused__ BriskItem *item,
+                                               __brisk_unused__ gchar *term)
+{
+        return TRUE;
+}
+
+/**
+ * Launching the result copies it, so it can be pasted elsewhere
+ */
+static gboolean brisk_calc_item_launch(BriskItem *item,
+                                       __brisk_unused__ GAppLaunchContext *context)
+{
+        BriskCalcItem *self = BRISK_CALC_ITEM(item);
+        GtkClipboard *clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+
+        gtk_clipboard_set_text(clipboard, self->value, -1);
+        return TRUE;
+}
+
+static gchar *brisk_calc_item_get_uri(__brisk_unused__ BriskItem *item)
+{
+        return NULL;
+}
+
+/**
+ * brisk_calc_item_set_result:
+ *
+ * Show the given result. This doesn't allocate, only the fixed buffers are
+ * rewritten.
+ *
+ * Returns TRUE if the displayed text changed
+ */
+gboolean brisk_calc_item_set_result(BriskCalcItem *self, const BriskCalcResult *result)
+{
+        gchar name[BRISK_CALC_ITEM_NAME_MAX] = { 0 };
+
+        g_ascii_formatd(self->value, sizeof(self->value), "%.10g", result->value);
+        if (result->unit) {
+                g_snprintf(name, sizeof(name), "%s %s", self->value, result->unit->symbol);
+        } else {
+                g_snprintf(name, sizeof(name), "= %s", self->value);
+        }
+
+        if (strcmp(name, self->name) == 0) {
+                return FALSE;
+        }
+        memcpy(self->name, name, sizeof(name));
+        return TRUE;
+}
+
+/**
+ * brisk_calc_item_new:
+ *
+ * Return a new BriskCalcItem, without a result
+ */
+BriskItem *brisk_calc_item_new(void)
+{
+        return g_object_new(BRISK_TYPE_CALC_ITEM, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,53 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+#include "../item.h"
+#include "calc-eval.h"
+
+G_BEGIN_DECLS
+
+typedef struct _BriskCalcItem BriskCalcItem;
+typedef struct _BriskCalcItemClass BriskCalcItemClass;
+
+#define BRISK_TYPE_CALC_ITEM brisk_calc_item_get_type()
+#define BRISK_CALC_ITEM(o) (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_CALC_ITEM, BriskCalcItem))
+#define BRISK_IS_CALC_ITEM(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_CALC_ITEM))
+#define BRISK_CALC_ITEM_CLASS(o)                                                                   \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_CALC_ITEM, BriskCalcItemClass))
+#define BRISK_IS_CALC_ITEM_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_CALC_ITEM))
+#define BRISK_CALC_ITEM_GET_CLASS(o)                                                               \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_CALC_ITEM, BriskCalcItemClass))
+
+GType brisk_calc_item_get_type(void);
+
+BriskItem *brisk_calc_item_new(void);
+
+gboolean brisk_calc_item_set_result(BriskCalcItem *self, const BriskCalcResult *result);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -21,16 +21,6 @@ BRISK_END_PEDANTIC
 
 G_DEFINE_TYPE(BriskFavouritesBackend, brisk_favourites_backend, BRISK_TYPE_BACKEND)
 
-/* Helper for gsettings */
-typedef gchar *gstrv;
-DEF_AUTOFREE(gstrv, g_strfreev)
-
-static inline void _g_array_clean(GArray *array)
-{
-        g_array_free(array, TRUE);
-}
-DEF_AUTOFREE(GArray, _g_array_clean)
-
 static gboolean brisk_favourites_backend_load(BriskBackend *backend);
 static void brisk_favourites_backend_pin_item(GSimpleAction *action, GVariant *parameter,
                                               BriskFavouritesBackend *self);
@@ -56,30 +46,56 @@ static const gchar *brisk_favourites_backend_get_display_name(
         return _("Favourites");
 }
 
-static GMenu *brisk_favourites_backend_get_item_actions(BriskBackend *backend, BriskItem *item,
-                                                        GActionGroup *group)
+/**
+ * brisk_favourites_backend_append_action:
+ *
+ * Append a menu entry for one of our actions, targeting the given string
+ */
+void brisk_favourites_backend_append_action(GMenu *menu, const gchar *label, const gchar *action,
+                                            const gchar *target)
+{
+        GMenuItem *item = g_menu_item_new(label, NULL);
+
+        g_menu_item_set_action_and_target_value(item, action, g_variant_new_string(target));
+        g_menu_append_item(menu, item);
+        g_object_unref(item);
+}
+
+static void brisk_favourites_backend_register_actions(BriskBackend *backend, GActionMap *map)
 {
-        GMenu *ret = NULL;
         BriskFavouritesBackend *self = BRISK_FAVOURITES_BACKEND(backend);
 
-        g_action_map_add_action(G_ACTION_MAP(group), G_ACTION(self->action_add));
-        g_action_map_add_action(G_ACTION_MAP(group), G_ACTION(self->action_remove));
+        g_action_map_add_action(map, G_ACTION(self->action_add));
+        g_action_map_add_action(map, G_ACTION(self->action_remove));
+        g_action_map_add_action(map, G_ACTION(self->action_add_desktop));
+        g_action_map_add_action(map, G_ACTION(self->action_remove_desktop));
+}
 
-        self->active_item = item;
+static GMenu *brisk_favourites_backend_get_item_actions(BriskBackend *backend, BriskItem *item)
+{
+        GMenu *ret = NULL;
+        BriskFavouritesBackend *self = BRISK_FAVOURITES_BACKEND(backend);
+        const gchar *id = brisk_item_get_id(item);
+
+        if (!id) {
+                return NULL;
+        }
 
         ret = g_menu_new();
 
         if (brisk_favourites_backend_is_pinned(self, item)) {
-                g_menu_append(ret,
-                              _("Unpin from favourites menu"),
-                              "brisk-context-items.favourites.unpin");
+                brisk_favourites_backend_append_action(ret,
+                                                       _("Unpin from favourites menu"),
+                                                       "brisk-context-items.favourites.unpin",
+                                                       id);
         } else {
-                g_menu_append(ret,
-                              _("Pin to favourites menu"),
-                              "brisk-context-items.favourites.pin");
+                brisk_favourites_backend_append_action(ret,
+                                                       _("Pin to favourites menu"),
+                                                       "brisk-context-items.favourites.pin",
+                                                       id);
         }
 
-        brisk_favourites_backend_menu_desktop(self, ret, group);
+        brisk_favourites_backend_menu_desktop(self, ret, item);
 
         return ret;
 }
@@ -96,8 +112,9 @@ static void brisk_favourites_backend_dispose(GObject *obj)
         g_clear_object(&self->action_remove);
         g_clear_object(&self->action_add_desktop);
         g_clear_object(&self->action_remove_desktop);
+        brisk_favourites_backend_free_desktop(self);
+        brisk_favourites_backend_free_store(self);
         g_clear_object(&self->settings);
-        g_clear_pointer(&self->favourites, g_hash_table_unref);
         G_OBJECT_CLASS(brisk_favourites_backend_parent_class)->dispose(obj);
 }
 
@@ -116,32 +133,13 @@ static void brisk_favourites_backend_class_init(BriskFavouritesBackendClass *kla
         b_class->get_id = brisk_favourites_backend_get_id;
         b_class->get_display_name = brisk_favourites_backend_get_display_name;
         b_class->load = brisk_favourites_backend_load;
+        b_class->register_actions = brisk_favourites_backend_register_actions;
         b_class->get_item_actions = brisk_favourites_backend_get_item_actions;
 
         /* gobject vtable hookup */
         obj_class->dispose = brisk_favourites_backend_dispose;
 }
 
-/**
- * Handle changes to the favourites schema. We'll reset our table and restore the
- * entries and retain the order within the list, which will come in useful in
- * future when we want to enable reordering of entries.
- */
-static void brisk_favourites_backend_changed(GSettings *settings, const gchar *key,
-                                             BriskFavouritesBackend *self)
-{
-        autofree(gstrv) *favs = g_settings_get_strv(settings, key);
-        g_hash_table_remove_all(self->favourites);
-
-        if (!favs) {
-                return;
-        }
-
-        for (guint i = 0; i < g_strv_length(favs); i++) {
-                g_hash_table_insert(self->favourites, g_strdup(favs[i]), GUINT_TO_POINTER(i));
-        }
-}
-
 /**
  * brisk_favourites_backend_init:
  *
@@ -150,17 +148,13 @@ static void brisk_favourites_backend_changed(GSettings *settings, const gchar *k
 static void brisk_favourites_backend_init(BriskFavouritesBackend *self)
 {
         self->settings = g_settings_new("com.solus-project.brisk-menu");
-        g_signal_connect(self->settings,
-                         "changed::favourites",
-                         G_CALLBACK(brisk_favourites_backend_changed),
-                         self);
 
-        self->action_add = g_simple_action_new("favourites.pin", NULL);
+        self->action_add = g_simple_action_new("favourites.pin", G_VARIANT_TYPE_STRING);
         g_signal_connect(self->action_add,
                          "activate",
                          G_CALLBACK(brisk_favourites_backend_pin_item),
                          self);
-        self->action_remove = g_simple_action_new("favourites.unpin", NULL);
+        self->action_remove = g_simple_action_new("favourites.unpin", G_VARIANT_TYPE_STRING);
         g_signal_connect(self->action_remove,
                          "activate",
                          G_CALLBACK(brisk_favourites_backend_unpin_item),
@@ -168,11 +162,8 @@ static void brisk_favourites_backend_init(BriskFavouritesBackend *self)
 
         brisk_favourites_backend_init_desktop(self);
 
-        /* Allow O(1) lookup for the "is pinned" logic */
-        self->favourites = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
-
-        /* Force load of the backend pinned items */
-        brisk_favourites_backend_changed(self->settings, "favourites", self);
+        /* Allow O(1) lookup for the "is pinned" and ordering logic */
+        brisk_favourites_backend_init_store(self);
 }
 
 /**
@@ -187,7 +178,7 @@ gboolean brisk_favourites_backend_is_pinned(BriskFavouritesBackend *self, BriskI
         }
 
         const gchar *id = brisk_item_get_id(item);
-        return g_hash_table_contains(self->favourites, id);
+        return g_hash_table_contains(self->lookup, id);
 }
 
 /**
@@ -203,87 +194,43 @@ static gboolean brisk_favourites_backend_load(BriskBackend *backend)
 }
 
 static void brisk_favourites_backend_pin_item(__brisk_unused__ GSimpleAction *action,
-                                              __brisk_unused__ GVariant *parameter,
-                                              BriskFavouritesBackend *self)
+                                              GVariant *parameter, BriskFavouritesBackend *self)
 {
-        autofree(gstrv) *old = NULL;
-        autofree(GArray) *array = NULL;
-
-        if (!self->active_item) {
-                return;
-        }
-
-        const gchar *item_id = brisk_item_get_id(self->active_item);
-        self->active_item = NULL;
+        const gchar *item_id = g_variant_get_string(parameter, NULL);
 
-        /* prevent duping.. */
-        if (g_hash_table_contains(self->favourites, item_id)) {
-                return;
+        if (brisk_favourites_backend_pin(self, item_id)) {
+                brisk_backend_actions_changed(BRISK_BACKEND(self), item_id);
+                brisk_backend_invalidate_filter(BRISK_BACKEND(self));
         }
-
-        old = g_settings_get_strv(self->settings, "favourites");
-        array = g_array_new(TRUE, TRUE, sizeof(gchar *));
-
-        for (guint i = 0; i < g_strv_length(old); i++) {
-                if (!old[i] || g_str_equal(old[i], "")) {
-                        continue;
-                }
-                array = g_array_append_val(array, old[i]);
-        }
-
-        array = g_array_append_val(array, item_id);
-        g_settings_set_strv(self->settings, "favourites", (const gchar **)array->data);
 }
 
 static void brisk_favourites_backend_unpin_item(__brisk_unused__ GSimpleAction *action,
-                                                __brisk_unused__ GVariant *parameter,
-                                                BriskFavouritesBackend *self)
+                                                GVariant *parameter, BriskFavouritesBackend *self)
 {
-        autofree(gstrv) *old = NULL;
-        autofree(GArray) *array = NULL;
-
-        if (!self->active_item) {
-                return;
-        }
-
-        const gchar *item_id = brisk_item_get_id(self->active_item);
-        self->active_item = NULL;
-
-        old = g_settings_get_strv(self->settings, "favourites");
-        array = g_array_new(TRUE, TRUE, sizeof(gchar *));
+        const gchar *item_id = g_variant_get_string(parameter, NULL);
 
-        for (guint i = 0; i < g_strv_length(old); i++) {
-                if (!old[i] || g_str_equal(old[i], "")) {
-                        continue;
-                }
-                if (!g_str_equal(old[i], item_id)) {
-                        array = g_array_append_val(array, old[i]);
-                }
+        if (brisk_favourites_backend_unpin(self, item_id)) {
+                brisk_backend_actions_changed(BRISK_BACKEND(self), item_id);
+                brisk_backend_invalidate_filter(BRISK_BACKEND(self));
         }
-
-        g_settings_set_strv(self->settings, "favourites", (const gchar **)array->data);
-
-        brisk_backend_invalidate_filter(BRISK_BACKEND(self));
 }
 
 /**
  * brisk_favourites_backend_get_item_order:
  *
  * Return the pin priority for any given item, if its known as pinned.
- * We may be storing `0` as a value for a pin priority, which when using glibc,
- * is equivalent to NULL, so we add checks that there is really something stored.
+ * Order keys are sparse, so only their relative order is meaningful.
  */
 gint brisk_favourites_backend_get_item_order(BriskFavouritesBackend *self, BriskItem *item)
 {
-        const gchar *item_id = brisk_item_get_id(item);
-        __brisk_unused__ void *key = NULL;
-        void *val = NULL;
+        GList *link = NULL;
 
-        if (!g_hash_table_lookup_extended(self->favourites, item_id, &key, &val)) {
+        link = g_hash_table_lookup(self->lookup, brisk_item_get_id(item));
+        if (!link) {
                 return -1;
         }
 
-        return GPOINTER_TO_INT(val);
+        return ((BriskFavourite *)link->data)->order;
 }
 
 /**
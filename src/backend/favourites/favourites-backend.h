@@ -19,6 +19,20 @@ G_BEGIN_DECLS
 typedef struct _BriskFavouritesBackend BriskFavouritesBackend;
 typedef struct _BriskFavouritesBackendClass BriskFavouritesBackendClass;
 
+/**
+ * Gap between the order keys of neighbouring favourites, leaving room to
+ * move items between each other without touching anyone else.
+ */
+#define BRISK_FAVOURITES_ORDER_GAP 1024
+
+/**
+ * A single pinned item within the ordered favourites model
+ */
+typedef struct BriskFavourite {
+        gchar *id;
+        gint order;
+} BriskFavourite;
+
 struct _BriskFavouritesBackendClass {
         BriskBackendClass parent_class;
 };
@@ -29,14 +43,24 @@ struct _BriskFavouritesBackendClass {
 struct _BriskFavouritesBackend {
         BriskBackend parent;
         GSettings *settings;
-        GHashTable *favourites;
 
-        /* Action management */
-        BriskItem *active_item;
+        /* Ordered model, written through to GSettings in batches */
+        GQueue favourites;
+        GHashTable *lookup;
+        guint flush_id;
+        gchar **synced; /**<List as last read from or written to GSettings */
+
+        /* Action management, every action takes the item as its target */
         GSimpleAction *action_remove;
         GSimpleAction *action_add;
         GSimpleAction *action_add_desktop;
         GSimpleAction *action_remove_desktop;
+
+        /* Cached view of the desktop directory */
+        GFile *desktop_dir;
+        GFileMonitor *desktop_monitor;
+        GHashTable *desktop_files;
+        GCancellable *desktop_cancel;
 };
 
 #define BRISK_TYPE_FAVOURITES_BACKEND brisk_favourites_backend_get_type()
@@ -57,9 +81,23 @@ BriskBackend *brisk_favourites_backend_new(void);
 
 gboolean brisk_favourites_backend_is_pinned(BriskFavouritesBackend *self, BriskItem *item);
 gint brisk_favourites_backend_get_item_order(BriskFavouritesBackend *self, BriskItem *item);
+
+/* Favourites model, see favourites-store.c */
+void brisk_favourites_backend_init_store(BriskFavouritesBackend *self);
+void brisk_favourites_backend_free_store(BriskFavouritesBackend *self);
+gboolean brisk_favourites_backend_pin(BriskFavouritesBackend *self, const gchar *id);
+gboolean brisk_favourites_backend_unpin(BriskFavouritesBackend *self, const gchar *id);
+gboolean brisk_favourites_backend_move(BriskFavouritesBackend *self, const gchar *id,
+                                       const gchar *target_id, gboolean after);
+const gchar *brisk_favourites_backend_get_nth(BriskFavouritesBackend *self, guint n);
+
+void brisk_favourites_backend_append_action(GMenu *menu, const gchar *label, const gchar *action,
+                                            const gchar *target);
+
 void brisk_favourites_backend_init_desktop(BriskFavouritesBackend *backend);
+void brisk_favourites_backend_free_desktop(BriskFavouritesBackend *backend);
 void brisk_favourites_backend_menu_desktop(BriskFavouritesBackend *backend, GMenu *menu,
-                                           GActionGroup *group);
+                                           BriskItem *item);
 
 G_END_DECLS
 
@@ -16,115 +16,296 @@
 BRISK_BEGIN_PEDANTIC
 #include "favourites-backend.h"
 #include <glib/gi18n.h>
-#include <glib/gstdio.h>
 BRISK_END_PEDANTIC
 
-#include <errno.h>
-#include <string.h>
-
 DEF_AUTOFREE(GFile, g_object_unref)
+DEF_AUTOFREE(GFileInfo, g_object_unref)
 DEF_AUTOFREE(gchar, g_free)
 DEF_AUTOFREE(GError, g_error_free)
 
+/**
+ * How many directory entries we'll ask for in a single go
+ */
+#define BRISK_DESKTOP_BATCH_SIZE 64
+
 typedef enum {
         PIN_STATUS_UNPINNABLE = 0,
         PIN_STATUS_PINNED = 1,
         PIN_STATUS_UNPINNED = 2,
 } DesktopPinStatus;
 
+static void brisk_favourites_backend_desktop_next_files(GFileEnumerator *enumerator,
+                                                        GAsyncResult *result,
+                                                        BriskFavouritesBackend *self);
+
 /**
- * get_desktop_item_source:
+ * get_desktop_item_basename:
  *
- * Get a GFile for the BriskItem's source
+ * Return the name the item would have when pinned to the desktop, or NULL if
+ * it can't be pinned at all. This is purely string work, no I/O is performed.
  */
-static GFile *get_desktop_item_source(BriskItem *item)
+static gchar *get_desktop_item_basename(GFile *source)
 {
-        autofree(gchar) *uri = NULL;
+        gchar *basename = NULL;
 
-        if (!item) {
+        basename = g_file_get_basename(source);
+        if (!basename || !g_str_has_suffix(basename, ".desktop")) {
+                g_free(basename);
                 return NULL;
         }
+        return basename;
+}
 
-        uri = brisk_item_get_uri(item);
-        if (!uri) {
-                return NULL;
-        }
-        return g_file_new_for_uri(uri);
+/**
+ * Whether the error only tells us that we're shutting down
+ */
+static inline gboolean brisk_favourites_backend_desktop_cancelled(GError *error)
+{
+        return g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
 }
 
 /**
- * get_item_path will return the path that would be pinned on the desktop
+ * Our view of the desktop was updated. Only launchers affect the context menus,
+ * so we only ask for those to be rebuilt when a launcher comes or goes.
  */
-static gchar *get_desktop_item_target_path(GFile *file)
+static void brisk_favourites_backend_desktop_add(BriskFavouritesBackend *self, GFile *file)
 {
-        if (!g_file_query_exists(file, NULL)) {
-                return NULL;
+        gchar *basename = g_file_get_basename(file);
+
+        if (!basename) {
+                return;
         }
+        if (g_hash_table_add(self->desktop_files, basename) &&
+            g_str_has_suffix(basename, ".desktop")) {
+                brisk_backend_actions_changed(BRISK_BACKEND(self), NULL);
+        }
+}
+
+static void brisk_favourites_backend_desktop_remove(BriskFavouritesBackend *self, GFile *file)
+{
         autofree(gchar) *basename = g_file_get_basename(file);
 
-        return g_build_path(G_DIR_SEPARATOR_S,
-                            g_get_user_special_dir(G_USER_DIRECTORY_DESKTOP),
-                            basename,
-                            NULL);
+        if (!basename) {
+                return;
+        }
+        if (g_hash_table_remove(self->desktop_files, basename) &&
+            g_str_has_suffix(basename, ".desktop")) {
+                brisk_backend_actions_changed(BRISK_BACKEND(self), NULL);
+        }
 }
 
 /**
- * get_desktop_item_target:
- *
- * Get the target GFile on the desktop
+ * The desktop directory changed on disk, keep our cache in sync
  */
-static GFile *get_desktop_item_target(GFile *file)
+static void brisk_favourites_backend_desktop_changed(__brisk_unused__ GFileMonitor *monitor,
+                                                     GFile *file, GFile *other,
+                                                     GFileMonitorEvent event,
+                                                     BriskFavouritesBackend *self)
 {
-        autofree(gchar) *path = NULL;
+        switch (event) {
+        case G_FILE_MONITOR_EVENT_CREATED:
+                brisk_favourites_backend_desktop_add(self, file);
+                break;
+        case G_FILE_MONITOR_EVENT_DELETED:
+                brisk_favourites_backend_desktop_remove(self, file);
+                break;
+        case G_FILE_MONITOR_EVENT_MOVED:
+                brisk_favourites_backend_desktop_remove(self, file);
+                if (other) {
+                        brisk_favourites_backend_desktop_add(self, other);
+                }
+                break;
+        default:
+                break;
+        }
+}
 
-        path = get_desktop_item_target_path(file);
-        return g_file_new_for_path(path);
+static void brisk_favourites_backend_desktop_closed(GFileEnumerator *enumerator,
+                                                    GAsyncResult *result,
+                                                    __brisk_unused__ gpointer v)
+{
+        g_file_enumerator_close_finish(enumerator, result, NULL);
+        g_object_unref(enumerator);
 }
 
 /**
- * brisk_favourites_backend_action_desktop_pin will pin the item to the desktop
- * by copying the source file to the target
+ * Handle a batch of desktop entries and ask for more until we run dry
  */
-static void brisk_favourites_backend_action_desktop_pin(__brisk_unused__ GSimpleAction *action,
-                                                        __brisk_unused__ GVariant *parameter,
+static void brisk_favourites_backend_desktop_next_files(GFileEnumerator *enumerator,
+                                                        GAsyncResult *result,
                                                         BriskFavouritesBackend *self)
 {
-        autofree(GFile) *source = NULL;
-        autofree(GFile) *dest = NULL;
         autofree(GError) *error = NULL;
-        autofree(gchar) *path = NULL;
+        GList *files = NULL;
 
-        source = get_desktop_item_source(self->active_item);
-        if (!source) {
+        files = g_file_enumerator_next_files_finish(enumerator, result, &error);
+        if (error && brisk_favourites_backend_desktop_cancelled(error)) {
+                g_object_unref(enumerator);
                 return;
         }
-        dest = get_desktop_item_target(source);
-        if (!dest) {
+
+        if (!files) {
+                if (error) {
+                        g_message("Failed to list desktop: %s", error->message);
+                }
+                g_file_enumerator_close_async(enumerator,
+                                              G_PRIORITY_LOW,
+                                              NULL,
+                                              (GAsyncReadyCallback)
+                                                  brisk_favourites_backend_desktop_closed,
+                                              NULL);
                 return;
         }
 
-        path = g_file_get_path(dest);
-        if (!path) {
+        for (GList *elem = files; elem; elem = elem->next) {
+                GFileInfo *info = elem->data;
+                g_hash_table_add(self->desktop_files, g_strdup(g_file_info_get_name(info)));
+        }
+        g_list_free_full(files, g_object_unref);
+
+        /* Menus built before this batch arrived may be wrong */
+        brisk_backend_actions_changed(BRISK_BACKEND(self), NULL);
+
+        g_file_enumerator_next_files_async(enumerator,
+                                           BRISK_DESKTOP_BATCH_SIZE,
+                                           G_PRIORITY_LOW,
+                                           self->desktop_cancel,
+                                           (GAsyncReadyCallback)
+                                               brisk_favourites_backend_desktop_next_files,
+                                           self);
+}
+
+static void brisk_favourites_backend_desktop_enumerated(GFile *dir, GAsyncResult *result,
+                                                        BriskFavouritesBackend *self)
+{
+        autofree(GError) *error = NULL;
+        GFileEnumerator *enumerator = NULL;
+
+        enumerator = g_file_enumerate_children_finish(dir, result, &error);
+        if (!enumerator) {
+                if (!brisk_favourites_backend_desktop_cancelled(error)) {
+                        g_message("Failed to list desktop: %s", error->message);
+                }
                 return;
         }
 
-        /* Consider making async. */
-        if (!g_file_copy(source,
-                         dest,
-                         G_FILE_COPY_ALL_METADATA | G_FILE_COPY_OVERWRITE,
-                         NULL,
-                         NULL,
-                         NULL,
-                         &error)) {
-                /* Consider using libnotify */
-                g_message("Failed to pin desktop item: %s", error->message);
+        g_file_enumerator_next_files_async(enumerator,
+                                           BRISK_DESKTOP_BATCH_SIZE,
+                                           G_PRIORITY_LOW,
+                                           self->desktop_cancel,
+                                           (GAsyncReadyCallback)
+                                               brisk_favourites_backend_desktop_next_files,
+                                           self);
+}
+
+/**
+ * The copy finished, now mark the launcher as executable
+ */
+static void brisk_favourites_backend_desktop_chmod_done(GFile *dest, GAsyncResult *result,
+                                                        __brisk_unused__ gpointer v)
+{
+        autofree(GError) *error = NULL;
+
+        if (!g_file_set_attributes_finish(dest, result, NULL, &error)) {
+                if (!brisk_favourites_backend_desktop_cancelled(error)) {
+                        g_message("Failed to chmod desktop item: %s", error->message);
+                }
+        }
+}
+
+/**
+ * A pin in flight. The backend may be gone by the time the copy completes, so
+ * only its cancellable comes along for the chmod.
+ */
+typedef struct BriskDesktopPin {
+        GFile *dest;
+        GCancellable *cancel;
+} BriskDesktopPin;
+
+static void brisk_desktop_pin_free(BriskDesktopPin *pin)
+{
+        g_object_unref(pin->dest);
+        g_object_unref(pin->cancel);
+        g_slice_free(BriskDesktopPin, pin);
+}
+
+static void brisk_favourites_backend_desktop_copy_done(GFile *source, GAsyncResult *result,
+                                                       BriskDesktopPin *pin)
+{
+        autofree(GError) *error = NULL;
+        autofree(GFileInfo) *info = NULL;
+
+        if (!g_file_copy_finish(source, result, &error)) {
+                if (!brisk_favourites_backend_desktop_cancelled(error)) {
+                        /* Consider using libnotify */
+                        g_message("Failed to pin desktop item: %s", error->message);
+                }
+                brisk_desktop_pin_free(pin);
+                return;
         }
 
         /* MATE will sanitize .desktop files that are chmod +x */
-        int r = g_chmod(path, 00755);
-        if (r != 0) {
-                g_message("Failed to chmod desktop item: %s", strerror(errno));
+        info = g_file_info_new();
+        g_file_info_set_attribute_uint32(info, G_FILE_ATTRIBUTE_UNIX_MODE, 00755);
+        g_file_set_attributes_async(pin->dest,
+                                    info,
+                                    G_FILE_QUERY_INFO_NONE,
+                                    G_PRIORITY_DEFAULT,
+                                    pin->cancel,
+                                    (GAsyncReadyCallback)
+                                        brisk_favourites_backend_desktop_chmod_done,
+                                    NULL);
+        brisk_desktop_pin_free(pin);
+}
+
+static void brisk_favourites_backend_desktop_delete_done(GFile *dest, GAsyncResult *result,
+                                                         __brisk_unused__ gpointer v)
+{
+        autofree(GError) *error = NULL;
+
+        if (!g_file_delete_finish(dest, result, &error)) {
+                if (!brisk_favourites_backend_desktop_cancelled(error)) {
+                        /* Consider using libnotify */
+                        g_message("Unable to unpin desktop item: %s", error->message);
+                }
+        }
+}
+
+/**
+ * brisk_favourites_backend_action_desktop_pin will pin the item to the desktop
+ * by copying the source file to the target
+ */
+static void brisk_favourites_backend_action_desktop_pin(__brisk_unused__ GSimpleAction *action,
+                                                        GVariant *parameter,
+                                                        BriskFavouritesBackend *self)
+{
+        autofree(GFile) *source = NULL;
+        autofree(gchar) *basename = NULL;
+        BriskDesktopPin *pin = NULL;
+
+        if (!self->desktop_dir) {
+                return;
         }
+
+        source = g_file_new_for_uri(g_variant_get_string(parameter, NULL));
+        basename = get_desktop_item_basename(source);
+        if (!basename) {
+                return;
+        }
+
+        /* Owned by the callback */
+        pin = g_slice_new0(BriskDesktopPin);
+        pin->dest = g_file_get_child(self->desktop_dir, basename);
+        pin->cancel = g_object_ref(self->desktop_cancel);
+        g_file_copy_async(source,
+                          pin->dest,
+                          G_FILE_COPY_ALL_METADATA | G_FILE_COPY_OVERWRITE,
+                          G_PRIORITY_DEFAULT,
+                          pin->cancel,
+                          NULL,
+                          NULL,
+                          (GAsyncReadyCallback)brisk_favourites_backend_desktop_copy_done,
+                          pin);
 }
 
 /**
@@ -132,76 +313,135 @@ static void brisk_favourites_backend_action_desktop_pin(__brisk_unused__ GSimple
  * from the desktop by removing the .desktop file
  */
 static void brisk_favourites_backend_action_desktop_unpin(__brisk_unused__ GSimpleAction *action,
-                                                          __brisk_unused__ GVariant *parameter,
+                                                          GVariant *parameter,
                                                           BriskFavouritesBackend *self)
 {
         autofree(GFile) *source = NULL;
         autofree(GFile) *dest = NULL;
-        autofree(GError) *error = NULL;
+        autofree(gchar) *basename = NULL;
 
-        source = get_desktop_item_source(self->active_item);
-        if (!source) {
+        if (!self->desktop_dir) {
                 return;
         }
 
-        dest = get_desktop_item_target(source);
-        if (!dest || !g_file_query_exists(dest, NULL)) {
+        source = g_file_new_for_uri(g_variant_get_string(parameter, NULL));
+        basename = get_desktop_item_basename(source);
+        if (!basename || !g_hash_table_contains(self->desktop_files, basename)) {
                 return;
         }
 
-        if (!g_file_delete(dest, NULL, &error)) {
-                /* Consider using libnotify */
-                g_message("Unable to unpin desktop item: %s", error->message);
-        }
+        dest = g_file_get_child(self->desktop_dir, basename);
+        g_file_delete_async(dest,
+                            G_PRIORITY_DEFAULT,
+                            self->desktop_cancel,
+                            (GAsyncReadyCallback)brisk_favourites_backend_desktop_delete_done,
+                            NULL);
 }
 
 /**
- * brisk_favourites_backend_is_desktop_pinned:
+ * brisk_favourites_backend_get_desktop_pin_status:
  *
- * Determine if the source file is actually pinned to the desktop or not
+ * Determine if the source file is actually pinned to the desktop or not, using
+ * only our cached view of the desktop.
  */
-static DesktopPinStatus brisk_favourites_backend_get_desktop_pin_status(BriskItem *item)
+static DesktopPinStatus brisk_favourites_backend_get_desktop_pin_status(
+    BriskFavouritesBackend *self, const gchar *uri)
 {
         autofree(GFile) *source = NULL;
-        autofree(GFile) *dest = NULL;
-        autofree(gchar) *base = NULL;
+        autofree(gchar) *basename = NULL;
 
-        source = get_desktop_item_source(item);
-        if (!source) {
+        if (!self->desktop_dir || !uri) {
                 return PIN_STATUS_UNPINNABLE;
         }
 
-        /* .desktop .. */
-        base = g_file_get_basename(source);
-        if (!g_str_has_suffix(base, ".desktop")) {
+        source = g_file_new_for_uri(uri);
+        basename = get_desktop_item_basename(source);
+        if (!basename) {
                 return PIN_STATUS_UNPINNABLE;
         }
 
-        dest = get_desktop_item_target(source);
-        if (!dest || !g_file_query_exists(dest, NULL)) {
-                return PIN_STATUS_UNPINNED;
+        if (g_hash_table_contains(self->desktop_files, basename)) {
+                return PIN_STATUS_PINNED;
         }
-
-        return PIN_STATUS_PINNED;
+        return PIN_STATUS_UNPINNED;
 }
 
 /**
  * brisk_favourites_backend_init_desktop:
  *
- * Initialise actions for the favourite backend's .desktop functionality
+ * Initialise actions for the favourite backend's .desktop functionality, and
+ * start building our view of the desktop directory in the background
  */
 void brisk_favourites_backend_init_desktop(BriskFavouritesBackend *self)
 {
-        self->action_add_desktop = g_simple_action_new("favourites.pin-desktop", NULL);
+        autofree(GError) *error = NULL;
+        const gchar *desktop_path = NULL;
+
+        self->action_add_desktop =
+            g_simple_action_new("favourites.pin-desktop", G_VARIANT_TYPE_STRING);
         g_signal_connect(self->action_add_desktop,
                          "activate",
                          G_CALLBACK(brisk_favourites_backend_action_desktop_pin),
                          self);
-        self->action_remove_desktop = g_simple_action_new("favourites.unpin-desktop", NULL);
+        self->action_remove_desktop =
+            g_simple_action_new("favourites.unpin-desktop", G_VARIANT_TYPE_STRING);
         g_signal_connect(self->action_remove_desktop,
                          "activate",
                          G_CALLBACK(brisk_favourites_backend_action_desktop_unpin),
                          self);
+
+        self->desktop_files = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+        desktop_path = g_get_user_special_dir(G_USER_DIRECTORY_DESKTOP);
+        if (!desktop_path) {
+                return;
+        }
+
+        self->desktop_dir = g_file_new_for_path(desktop_path);
+        self->desktop_cancel = g_cancellable_new();
+
+        /* Watch before listing so that we can't miss anything in between */
+        self->desktop_monitor = g_file_monitor_directory(self->desktop_dir,
+                                                         G_FILE_MONITOR_SEND_MOVED,
+                                                         self->desktop_cancel,
+                                                         &error);
+        if (!self->desktop_monitor) {
+                g_message("Unable to monitor desktop: %s", error->message);
+        } else {
+                g_signal_connect(self->desktop_monitor,
+                                 "changed",
+                                 G_CALLBACK(brisk_favourites_backend_desktop_changed),
+                                 self);
+        }
+
+        g_file_enumerate_children_async(self->desktop_dir,
+                                        G_FILE_ATTRIBUTE_STANDARD_NAME,
+                                        G_FILE_QUERY_INFO_NONE,
+                                        G_PRIORITY_LOW,
+                                        self->desktop_cancel,
+                                        (GAsyncReadyCallback)
+                                            brisk_favourites_backend_desktop_enumerated,
+                                        self);
+}
+
+/**
+ * brisk_favourites_backend_free_desktop:
+ *
+ * Stop any pending listing of the desktop and tear down our view of it
+ */
+void brisk_favourites_backend_free_desktop(BriskFavouritesBackend *self)
+{
+        if (self->desktop_cancel) {
+                g_cancellable_cancel(self->desktop_cancel);
+        }
+        if (self->desktop_monitor) {
+                g_signal_handlers_disconnect_by_data(self->desktop_monitor, self);
+                g_file_monitor_cancel(self->desktop_monitor);
+        }
+        g_clear_object(&self->desktop_monitor);
+        g_clear_object(&self->desktop_cancel);
+        g_clear_object(&self->desktop_dir);
+        g_clear_pointer(&self->desktop_files, g_hash_table_unref);
 }
 
 /**
@@ -210,27 +450,28 @@ void brisk_favourites_backend_init_desktop(BriskFavouritesBackend *self)
  * Add relevant entries to the context menu pertaining to .desktop handling
  */
 void brisk_favourites_backend_menu_desktop(BriskFavouritesBackend *self, GMenu *menu,
-                                           GActionGroup *group)
+                                           BriskItem *item)
 {
-        g_action_map_add_action(G_ACTION_MAP(group), G_ACTION(self->action_add_desktop));
-        g_action_map_add_action(G_ACTION_MAP(group), G_ACTION(self->action_remove_desktop));
-        DesktopPinStatus t = brisk_favourites_backend_get_desktop_pin_status(self->active_item);
+        autofree(gchar) *uri = brisk_item_get_uri(item);
+        DesktopPinStatus t = brisk_favourites_backend_get_desktop_pin_status(self, uri);
+        const gchar *label = NULL;
+        const gchar *action = NULL;
 
         switch (t) {
         case PIN_STATUS_PINNED:
-                g_menu_append(menu,
-                              _("Unpin from desktop"),
-                              "brisk-context-items.favourites.unpin-desktop");
+                label = _("Unpin from desktop");
+                action = "brisk-context-items.favourites.unpin-desktop";
                 break;
         case PIN_STATUS_UNPINNED:
-                g_menu_append(menu,
-                              _("Pin to desktop"),
-                              "brisk-context-items.favourites.pin-desktop");
+                label = _("Pin to desktop");
+                action = "brisk-context-items.favourites.pin-desktop";
                 break;
         case PIN_STATUS_UNPINNABLE:
         default:
                 return;
         }
+
+        brisk_favourites_backend_append_action(menu, label, action, uri);
 }
 
 /*
@@ -0,0 +1,484 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "favourites-backend.h"
+BRISK_END_PEDANTIC
+
+/* Helper for gsettings */
+typedef gchar *gstrv;
+DEF_AUTOFREE(gstrv, g_strfreev)
+DEF_AUTOFREE(GHashTable, g_hash_table_unref)
+
+/**
+ * How long we'll batch up local changes before writing them out (ms)
+ */
+#define BRISK_FAVOURITES_FLUSH_TIME 250
+
+static void brisk_favourites_backend_changed(GSettings *settings, const gchar *key,
+                                             BriskFavouritesBackend *self);
+
+static BriskFavourite *brisk_favourite_new(const gchar *id)
+{
+        BriskFavourite *fav = g_slice_new0(BriskFavourite);
+        fav->id = g_strdup(id);
+        return fav;
+}
+
+static void brisk_favourite_free(BriskFavourite *fav)
+{
+        g_free(fav->id);
+        g_slice_free(BriskFavourite, fav);
+}
+
+static inline gint brisk_favourite_order(GList *link)
+{
+        return link ? ((BriskFavourite *)link->data)->order : 0;
+}
+
+/**
+ * Evenly renumber every order key. This only happens once the gap between two
+ * neighbours has been used up by repeated moves.
+ */
+static void brisk_favourites_backend_rebalance(BriskFavouritesBackend *self)
+{
+        gint order = 0;
+
+        for (GList *elem = self->favourites.head; elem; elem = elem->next) {
+                order += BRISK_FAVOURITES_ORDER_GAP;
+                ((BriskFavourite *)elem->data)->order = order;
+        }
+}
+
+/**
+ * Insert the favourite before the sibling, or at the end of the list when
+ * sibling is NULL, and give it an order key between its new neighbours.
+ *
+ * Returns the new link for the favourite
+ */
+static GList *brisk_favourites_backend_insert(BriskFavouritesBackend *self, BriskFavourite *fav,
+                                              GList *sibling)
+{
+        GList *prev = sibling ? sibling->prev : self->favourites.tail;
+        gint lo = brisk_favourite_order(prev);
+        gint hi;
+
+        if (!sibling) {
+                if (lo > G_MAXINT - BRISK_FAVOURITES_ORDER_GAP) {
+                        brisk_favourites_backend_rebalance(self);
+                        lo = brisk_favourite_order(prev);
+                }
+                fav->order = lo + BRISK_FAVOURITES_ORDER_GAP;
+                g_queue_push_tail(&self->favourites, fav);
+                return self->favourites.tail;
+        }
+
+        hi = brisk_favourite_order(sibling);
+        if (hi - lo < 2) {
+                brisk_favourites_backend_rebalance(self);
+                lo = brisk_favourite_order(prev);
+                hi = brisk_favourite_order(sibling);
+        }
+
+        fav->order = lo + (hi - lo) / 2;
+        g_queue_insert_before(&self->favourites, sibling, fav);
+        return sibling->prev;
+}
+
+/**
+ * Write the current model out to GSettings in one go
+ */
+static gboolean brisk_favourites_backend_flush(BriskFavouritesBackend *self)
+{
+        GPtrArray *array = NULL;
+
+        self->flush_id = 0;
+
+        array = g_ptr_array_sized_new(self->favourites.length + 1);
+        for (GList *elem = self->favourites.head; elem; elem = elem->next) {
+                g_ptr_array_add(array, ((BriskFavourite *)elem->data)->id);
+        }
+        g_ptr_array_add(array, NULL);
+
+        g_strfreev(self->synced);
+        self->synced = g_strdupv((gchar **)array->pdata);
+
+        /* Our own change notification will diff to nothing */
+        g_settings_set_strv(self->settings, "favourites", (const gchar *const *)array->pdata);
+        g_ptr_array_free(array, TRUE);
+
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * Coalesce local changes into a single write
+ */
+static void brisk_favourites_backend_queue_flush(BriskFavouritesBackend *self)
+{
+        if (self->flush_id > 0) {
+                return;
+        }
+        self->flush_id = g_timeout_add(BRISK_FAVOURITES_FLUSH_TIME,
+                                       (GSourceFunc)brisk_favourites_backend_flush,
+                                       self);
+}
+
+/**
+ * Apply the list from GSettings to our model as a diff, only touching those
+ * entries that were added, removed or moved.
+ *
+ * Returns TRUE if the model changed
+ */
+static gboolean brisk_favourites_backend_apply(BriskFavouritesBackend *self, gchar **favs)
+{
+        autofree(GHashTable) *wanted = NULL;
+        GList *elem = NULL;
+        GList *cursor = NULL;
+        gboolean changed = FALSE;
+
+        wanted = g_hash_table_new(g_str_hash, g_str_equal);
+        for (guint i = 0; favs && favs[i]; i++) {
+                if (favs[i][0] != '\0') {
+                        g_hash_table_add(wanted, favs[i]);
+                }
+        }
+
+        /* Drop anything that is no longer pinned */
+        elem = self->favourites.head;
+        while (elem) {
+                GList *next = elem->next;
+                BriskFavourite *fav = elem->data;
+
+                if (!g_hash_table_contains(wanted, fav->id)) {
+                        g_hash_table_remove(self->lookup, fav->id);
+                        g_queue_delete_link(&self->favourites, elem);
+                        brisk_favourite_free(fav);
+                        changed = TRUE;
+                }
+                elem = next;
+        }
+
+        /* Walk the new order, everything before the cursor is already in place */
+        cursor = self->favourites.head;
+        for (guint i = 0; favs && favs[i]; i++) {
+                BriskFavourite *fav = NULL;
+                GList *link = NULL;
+
+                /* Skips blanks and duplicates */
+                if (!g_hash_table_remove(wanted, favs[i])) {
+                        continue;
+                }
+
+                if (cursor && g_str_equal(((BriskFavourite *)cursor->data)->id, favs[i])) {
+                        cursor = cursor->next;
+                        continue;
+                }
+
+                link = g_hash_table_lookup(self->lookup, favs[i]);
+                if (link) {
+                        fav = link->data;
+                        g_queue_delete_link(&self->favourites, link);
+                } else {
+                        fav = brisk_favourite_new(favs[i]);
+                }
+
+                link = brisk_favourites_backend_insert(self, fav, cursor);
+                g_hash_table_insert(self->lookup, fav->id, link);
+                changed = TRUE;
+        }
+
+        return changed;
+}
+
+/**
+ * Add the pins they made after the given anchor to the merged list
+ */
+static void brisk_favourites_merge_followers(GHashTable *followers, const gchar *anchor,
+                                             GPtrArray *merged)
+{
+        GPtrArray *ids = g_hash_table_lookup(followers, anchor);
+
+        for (guint i = 0; ids && i < ids->len; i++) {
+                g_ptr_array_add(merged, g_strdup(ids->pdata[i]));
+        }
+}
+
+/**
+ * Merge our unflushed changes into a list written by someone else. Whatever
+ * we pinned or unpinned since the last sync is replayed on top of theirs, and
+ * so is anything they pinned or unpinned. Everything we still hold keeps our
+ * order, which may be a reorder they haven't seen, and their new pins follow
+ * whichever of ours they came after in their list.
+ *
+ * Returns a newly allocated list
+ */
+static gchar **brisk_favourites_backend_merge(BriskFavouritesBackend *self, gchar **favs)
+{
+        autofree(GHashTable) *synced = NULL;
+        autofree(GHashTable) *theirs = NULL;
+        autofree(GHashTable) *followers = NULL;
+        const gchar *anchor = "";
+        GPtrArray *merged = NULL;
+
+        synced = g_hash_table_new(g_str_hash, g_str_equal);
+        for (guint i = 0; self->synced && self->synced[i]; i++) {
+                g_hash_table_add(synced, self->synced[i]);
+        }
+
+        /* Their new pins hang off the last of ours before them, "" is the start */
+        theirs = g_hash_table_new(g_str_hash, g_str_equal);
+        followers = g_hash_table_new_full(g_str_hash,
+                                          g_str_equal,
+                                          NULL,
+                                          (GDestroyNotify)g_ptr_array_unref);
+        for (guint i = 0; favs && favs[i]; i++) {
+                GPtrArray *ids = NULL;
+
+                if (!g_hash_table_add(theirs, favs[i])) {
+                        continue;
+                }
+                if (g_hash_table_contains(self->lookup, favs[i])) {
+                        anchor = favs[i];
+                        continue;
+                }
+
+                /* We unpinned it meanwhile */
+                if (g_hash_table_contains(synced, favs[i])) {
+                        continue;
+                }
+
+                ids = g_hash_table_lookup(followers, anchor);
+                if (!ids) {
+                        ids = g_ptr_array_new();
+                        g_hash_table_insert(followers, (gchar *)anchor, ids);
+                }
+                g_ptr_array_add(ids, favs[i]);
+        }
+
+        merged = g_ptr_array_new();
+        brisk_favourites_merge_followers(followers, "", merged);
+
+        /* Ours in our order, minus anything they unpinned meanwhile */
+        for (GList *elem = self->favourites.head; elem; elem = elem->next) {
+                const gchar *id = ((BriskFavourite *)elem->data)->id;
+
+                if (g_hash_table_contains(synced, id) && !g_hash_table_contains(theirs, id)) {
+                        continue;
+                }
+                g_ptr_array_add(merged, g_strdup(id));
+                brisk_favourites_merge_followers(followers, id, merged);
+        }
+
+        g_ptr_array_add(merged, NULL);
+        return (gchar **)g_ptr_array_free(merged, FALSE);
+}
+
+/**
+ * Handle changes to the favourites schema, which may be our own writes or
+ * may have come from another process. With a write of our own still pending
+ * the two are merged and written back straight away, so neither is lost.
+ */
+static void brisk_favourites_backend_changed(GSettings *settings, const gchar *key,
+                                             BriskFavouritesBackend *self)
+{
+        autofree(gstrv) *favs = g_settings_get_strv(settings, key);
+        gboolean pending = self->flush_id > 0;
+
+        if (pending) {
+                gchar **merged = brisk_favourites_backend_merge(self, favs);
+
+                g_source_remove(self->flush_id);
+                self->flush_id = 0;
+                g_strfreev(favs);
+                favs = merged;
+        } else {
+                g_strfreev(self->synced);
+                self->synced = g_strdupv(favs);
+        }
+
+        if (brisk_favourites_backend_apply(self, favs)) {
+                /* Pin state of any number of items may have flipped */
+                brisk_backend_actions_changed(BRISK_BACKEND(self), NULL);
+                brisk_backend_invalidate_filter(BRISK_BACKEND(self));
+        }
+
+        if (pending) {
+                brisk_favourites_backend_flush(self);
+        }
+}
+
+/**
+ * brisk_favourites_backend_init_store:
+ *
+ * Set up the favourites model and populate it from GSettings
+ */
+void brisk_favourites_backend_init_store(BriskFavouritesBackend *self)
+{
+        g_queue_init(&self->favourites);
+
+        /* Keys are owned by the BriskFavourite within the link */
+        self->lookup = g_hash_table_new(g_str_hash, g_str_equal);
+
+        g_signal_connect(self->settings,
+                         "changed::favourites",
+                         G_CALLBACK(brisk_favourites_backend_changed),
+                         self);
+
+        /* Force load of the backend pinned items */
+        brisk_favourites_backend_changed(self->settings, "favourites", self);
+}
+
+/**
+ * brisk_favourites_backend_free_store:
+ *
+ * Write out any pending changes and tear down the model
+ */
+void brisk_favourites_backend_free_store(BriskFavouritesBackend *self)
+{
+        if (self->flush_id > 0) {
+                g_source_remove(self->flush_id);
+                brisk_favourites_backend_flush(self);
+        }
+
+        if (self->settings) {
+                g_signal_handlers_disconnect_by_data(self->settings, self);
+        }
+
+        g_queue_foreach(&self->favourites, (GFunc)brisk_favourite_free, NULL);
+        g_queue_clear(&self->favourites);
+        g_clear_pointer(&self->lookup, g_hash_table_unref);
+        g_clear_pointer(&self->synced, g_strfreev);
+}
+
+/**
+ * brisk_favourites_backend_pin:
+ *
+ * Append the item ID to the end of the favourites
+ *
+ * Returns TRUE if the model changed
+ */
+gboolean brisk_favourites_backend_pin(BriskFavouritesBackend *self, const gchar *id)
+{
+        BriskFavourite *fav = NULL;
+        GList *link = NULL;
+
+        if (!id || g_hash_table_contains(self->lookup, id)) {
+                return FALSE;
+        }
+
+        fav = brisk_favourite_new(id);
+        link = brisk_favourites_backend_insert(self, fav, NULL);
+        g_hash_table_insert(self->lookup, fav->id, link);
+
+        brisk_favourites_backend_queue_flush(self);
+        return TRUE;
+}
+
+/**
+ * brisk_favourites_backend_unpin:
+ *
+ * Remove the item ID from the favourites
+ *
+ * Returns TRUE if the model changed
+ */
+gboolean brisk_favourites_backend_unpin(BriskFavouritesBackend *self, const gchar *id)
+{
+        BriskFavourite *fav = NULL;
+        GList *link = NULL;
+
+        if (!id) {
+                return FALSE;
+        }
+
+        link = g_hash_table_lookup(self->lookup, id);
+        if (!link) {
+                return FALSE;
+        }
+
+        fav = link->data;
+        g_hash_table_remove(self->lookup, fav->id);
+        g_queue_delete_link(&self->favourites, link);
+        brisk_favourite_free(fav);
+
+        brisk_favourites_backend_queue_flush(self);
+        return TRUE;
+}
+
+/**
+ * brisk_favourites_backend_move:
+ *
+ * Move the favourite with the given ID so that it sits directly before, or
+ * after, the favourite identified by target_id. Only the moved favourite has
+ * its order key changed, and frontends are told to re-sort just that item.
+ *
+ * Returns TRUE if the model changed
+ */
+gboolean brisk_favourites_backend_move(BriskFavouritesBackend *self, const gchar *id,
+                                       const gchar *target_id, gboolean after)
+{
+        BriskFavourite *fav = NULL;
+        GList *link = NULL;
+        GList *sibling = NULL;
+
+        link = g_hash_table_lookup(self->lookup, id);
+        sibling = g_hash_table_lookup(self->lookup, target_id);
+        if (!link || !sibling || link == sibling) {
+                return FALSE;
+        }
+
+        /* Inserting after the target is inserting before its successor */
+        if (after) {
+                sibling = sibling->next;
+        }
+
+        /* Already in place */
+        if (link->next == sibling) {
+                return FALSE;
+        }
+
+        fav = link->data;
+        g_queue_delete_link(&self->favourites, link);
+        link = brisk_favourites_backend_insert(self, fav, sibling);
+        g_hash_table_insert(self->lookup, fav->id, link);
+
+        brisk_favourites_backend_queue_flush(self);
+        brisk_backend_item_changed(BRISK_BACKEND(self), fav->id);
+        return TRUE;
+}
+
+/**
+ * brisk_favourites_backend_get_nth:
+ *
+ * Return the ID of the favourite at the given position, or NULL
+ */
+const gchar *brisk_favourites_backend_get_nth(BriskFavouritesBackend *self, guint n)
+{
+        BriskFavourite *fav = g_queue_peek_nth(&self->favourites, n);
+
+        return fav ? fav->id : NULL;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
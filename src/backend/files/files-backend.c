@@ -0,0 +1,586 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "../search.h"
+#include "files-backend.h"
+#include "files-item.h"
+#include <glib/gi18n.h>
+#include <errno.h>
+#include <glib/gstdio.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GBytes, g_bytes_unref)
+DEF_AUTOFREE(GFile, g_object_unref)
+DEF_AUTOFREE(GPtrArray, g_ptr_array_unref)
+DEF_AUTOFREE(GHashTable, g_hash_table_unref)
+
+/* Helper for gsettings */
+typedef gchar *gstrv;
+DEF_AUTOFREE(gstrv, g_strfreev)
+
+G_DEFINE_TYPE(BriskFilesBackend, brisk_files_backend, BRISK_TYPE_BACKEND)
+
+static gboolean brisk_files_backend_load(BriskBackend *backend);
+static void brisk_files_backend_search_changed(BriskBackend *backend, const gchar *term);
+static void brisk_files_backend_roots_changed(GSettings *settings, const gchar *key,
+                                              BriskFilesBackend *self);
+static void brisk_files_backend_save(BriskFilesBackend *self);
+static void brisk_files_backend_save_final(BriskFilesBackend *self);
+
+/**
+ * Tell the frontends what we are
+ */
+static unsigned int brisk_files_backend_get_flags(__brisk_unused__ BriskBackend *backend)
+{
+        return BRISK_BACKEND_SOURCE | BRISK_BACKEND_SEARCH;
+}
+
+static const gchar *brisk_files_backend_get_id(__brisk_unused__ BriskBackend *backend)
+{
+        return "files";
+}
+
+static const gchar *brisk_files_backend_get_display_name(__brisk_unused__ BriskBackend *backend)
+{
+        return _("Files");
+}
+
+/**
+ * Stop watching and cancel any pending events for the directory
+ */
+static void brisk_files_backend_monitor_free(GFileMonitor *monitor)
+{
+        g_file_monitor_cancel(monitor);
+        g_object_unref(monitor);
+}
+
+/**
+ * brisk_files_backend_dispose:
+ *
+ * Clean up a BriskFilesBackend instance, writing out the index if needed
+ */
+static void brisk_files_backend_dispose(GObject *obj)
+{
+        BriskFilesBackend *self = BRISK_FILES_BACKEND(obj);
+
+        brisk_files_backend_cancel_crawl(self);
+        g_queue_foreach(&self->queued, (GFunc)g_free, NULL);
+        g_queue_clear(&self->queued);
+
+        if (self->save_id > 0) {
+                g_source_remove(self->save_id);
+                self->save_id = 0;
+        }
+        if (self->dirty) {
+                brisk_files_backend_save_final(self);
+        }
+
+        if (self->settings) {
+                g_signal_handlers_disconnect_by_data(self->settings, self);
+                g_clear_object(&self->settings);
+        }
+        if (self->recent_monitor) {
+                brisk_files_backend_monitor_free(self->recent_monitor);
+                self->recent_monitor = NULL;
+        }
+
+        g_clear_pointer(&self->monitors, g_hash_table_unref);
+        g_clear_pointer(&self->results, g_hash_table_unref);
+        g_clear_pointer(&self->index, brisk_files_index_free);
+        g_clear_pointer(&self->pending, g_strfreev);
+        g_clear_pointer(&self->roots, g_strfreev);
+        g_clear_pointer(&self->index_path, g_free);
+        g_clear_pointer(&self->term, g_free);
+
+        G_OBJECT_CLASS(brisk_files_backend_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_files_backend_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_files_backend_class_init(BriskFilesBackendClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskBackendClass *b_class = BRISK_BACKEND_CLASS(klazz);
+
+        /* Backend vtable hookup */
+        b_class->get_flags = brisk_files_backend_get_flags;
+        b_class->get_id = brisk_files_backend_get_id;
+        b_class->get_display_name = brisk_files_backend_get_display_name;
+        b_class->load = brisk_files_backend_load;
+        b_class->search_changed = brisk_files_backend_search_changed;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_files_backend_dispose;
+}
+
+/**
+ * Turn the configured directories into absolute paths, relative to home
+ */
+static gchar **brisk_files_backend_expand_roots(gchar **dirs)
+{
+        GPtrArray *roots = g_ptr_array_new();
+
+        for (guint i = 0; dirs && dirs[i]; i++) {
+                const gchar *dir = dirs[i];
+
+                if (dir[0] == '\0') {
+                        continue;
+                }
+                if (dir[0] == '~') {
+                        dir += dir[1] == G_DIR_SEPARATOR ? 2 : 1;
+                }
+
+                if (g_path_is_absolute(dir)) {
+                        g_ptr_array_add(roots, g_strdup(dir));
+                } else {
+                        g_ptr_array_add(roots, g_build_filename(g_get_home_dir(), dir, NULL));
+                }
+        }
+
+        g_ptr_array_add(roots, NULL);
+        return (gchar **)g_ptr_array_free(roots, FALSE);
+}
+
+/**
+ * brisk_files_backend_init:
+ *
+ * Handle construction of the BriskFilesBackend
+ */
+static void brisk_files_backend_init(BriskFilesBackend *self)
+{
+        autofree(gstrv) *dirs = NULL;
+
+        g_queue_init(&self->queued);
+
+        self->monitors = g_hash_table_new_full(g_str_hash,
+                                               g_str_equal,
+                                               g_free,
+                                               (GDestroyNotify)brisk_files_backend_monitor_free);
+        self->results = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+        self->index_path =
+            g_build_filename(g_get_user_cache_dir(), "brisk-menu", "files.index", NULL);
+
+        self->settings = g_settings_new("com.solus-project.brisk-menu");
+        dirs = g_settings_get_strv(self->settings, "file-search-directories");
+        self->roots = brisk_files_backend_expand_roots(dirs);
+
+        g_signal_connect(self->settings,
+                         "changed::file-search-directories",
+                         G_CALLBACK(brisk_files_backend_roots_changed),
+                         self);
+}
+
+/**
+ * What a save worker needs, none of which is shared with the backend
+ */
+typedef struct BriskFilesSave {
+        BriskFilesIndexSnapshot *snapshot;
+        gchar *path;
+} BriskFilesSave;
+
+static void brisk_files_save_free(BriskFilesSave *save)
+{
+        brisk_files_index_snapshot_free(save->snapshot);
+        g_free(save->path);
+        g_slice_free(BriskFilesSave, save);
+}
+
+static BriskFilesSave *brisk_files_save_new(BriskFilesBackend *self)
+{
+        BriskFilesSave *save = g_slice_new0(BriskFilesSave);
+
+        save->snapshot =
+            brisk_files_index_snapshot(self->index, self->generation, self->roots, self->pending);
+        save->path = g_strdup(self->index_path);
+        return save;
+}
+
+/**
+ * Serialise and write the snapshot out, from whichever thread we're on
+ */
+static gboolean brisk_files_save_write(BriskFilesSave *save, GError **error)
+{
+        autofree(GBytes) *bytes = NULL;
+        autofree(gchar) *dir = NULL;
+
+        dir = g_path_get_dirname(save->path);
+        if (g_mkdir_with_parents(dir, 00700) != 0) {
+                g_set_error(error,
+                            G_FILE_ERROR,
+                            g_file_error_from_errno(errno),
+                            "Failed to create %s",
+                            dir);
+                return FALSE;
+        }
+
+        bytes = brisk_files_index_serialize(save->snapshot);
+        return g_file_set_contents(save->path,
+                                   g_bytes_get_data(bytes, NULL),
+                                   (gssize)g_bytes_get_size(bytes),
+                                   error);
+}
+
+static void brisk_files_backend_save_thread(GTask *task, __brisk_unused__ gpointer source,
+                                            gpointer v, __brisk_unused__ GCancellable *cancel)
+{
+        GError *error = NULL;
+
+        if (!brisk_files_save_write(v, &error)) {
+                g_task_return_error(task, error);
+                return;
+        }
+        g_task_return_boolean(task, TRUE);
+}
+
+static void brisk_files_backend_save_done(GObject *source, GAsyncResult *result,
+                                          __brisk_unused__ gpointer v)
+{
+        BriskFilesBackend *self = BRISK_FILES_BACKEND(source);
+        autofree(GError) *error = NULL;
+
+        self->saving = FALSE;
+
+        /* Still dirty, so the next change or dispose tries again */
+        if (!g_task_propagate_boolean(G_TASK(result), &error)) {
+                g_warning("Failed to write file index: %s", error->message);
+                self->dirty = TRUE;
+                return;
+        }
+
+        /* Changed again while we were writing */
+        if (self->dirty) {
+                brisk_files_backend_queue_save(self);
+        }
+}
+
+/**
+ * Take a snapshot of the index here, where it is modified, and leave the
+ * serialising and writing to a worker. Only one save is in flight at a time.
+ */
+static void brisk_files_backend_save(BriskFilesBackend *self)
+{
+        BriskFilesSave *save = NULL;
+        GTask *task = NULL;
+
+        /* save_done picks up whatever changed in the meantime */
+        if (!self->index || self->saving) {
+                return;
+        }
+
+        save = brisk_files_save_new(self);
+        self->dirty = FALSE;
+
+        task = g_task_new(self, NULL, brisk_files_backend_save_done, NULL);
+        g_task_set_task_data(task, save, (GDestroyNotify)brisk_files_save_free);
+        self->saving = TRUE;
+        g_task_run_in_thread(task, brisk_files_backend_save_thread);
+        g_object_unref(task);
+}
+
+/**
+ * The backend is going away, so write out what's left right here rather
+ * than leave it to a worker nobody will hear back from. Any save still in
+ * flight holds a reference to us, so it can't be racing this one.
+ */
+static void brisk_files_backend_save_final(BriskFilesBackend *self)
+{
+        BriskFilesSave *save = NULL;
+        autofree(GError) *error = NULL;
+
+        if (!self->index) {
+                return;
+        }
+
+        save = brisk_files_save_new(self);
+        if (brisk_files_save_write(save, &error)) {
+                self->dirty = FALSE;
+        } else {
+                g_warning("Failed to write file index: %s", error->message);
+        }
+        brisk_files_save_free(save);
+}
+
+static gboolean brisk_files_backend_save_timeout(BriskFilesBackend *self)
+{
+        self->save_id = 0;
+        brisk_files_backend_save(self);
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * brisk_files_backend_queue_save:
+ *
+ * Coalesce index changes into a single write every so often
+ */
+void brisk_files_backend_queue_save(BriskFilesBackend *self)
+{
+        self->dirty = TRUE;
+        if (self->save_id > 0) {
+                return;
+        }
+        self->save_id = g_timeout_add_seconds(BRISK_FILES_SAVE_INTERVAL,
+                                              (GSourceFunc)brisk_files_backend_save_timeout,
+                                              self);
+}
+
+/**
+ * Query the index for the current term and apply the difference to the
+ * results we've already emitted
+ */
+static void brisk_files_backend_update_results(BriskFilesBackend *self)
+{
+        autofree(GHashTable) *previous = self->results;
+        autofree(GPtrArray) *matches = NULL;
+        autofree(GPtrArray) *added = NULL;
+        GHashTableIter iter;
+        BriskItem *item = NULL;
+
+        self->results = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+        added = g_ptr_array_new();
+
+        if (self->term && self->index) {
+                gint64 deadline = g_get_monotonic_time() + BRISK_FILES_SEARCH_BUDGET;
+
+                matches = brisk_files_index_query(self->index,
+                                                  self->term,
+                                                  BRISK_FILES_MAX_RESULTS,
+                                                  deadline);
+
+                for (guint i = 0; i < matches->len; i++) {
+                        const gchar *path = matches->pdata[i];
+
+                        item = g_hash_table_lookup(previous, path);
+                        if (item) {
+                                g_object_ref(item);
+                                g_hash_table_remove(previous, path);
+                        } else {
+                                item = g_object_ref_sink(brisk_files_item_new(path));
+                                g_ptr_array_add(added, item);
+                        }
+                        g_hash_table_insert(self->results, g_strdup(path), item);
+                }
+        }
+
+        /* Whatever is left no longer matches */
+        g_hash_table_iter_init(&iter, previous);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&item)) {
+                brisk_backend_item_removed(BRISK_BACKEND(self), brisk_item_get_id(item));
+        }
+
+        for (guint i = 0; i < added->len; i++) {
+                brisk_backend_item_added(BRISK_BACKEND(self), added->pdata[i]);
+        }
+}
+
+/**
+ * brisk_files_backend_index_changed:
+ *
+ * The index gained or lost files, so the results may have changed too
+ */
+void brisk_files_backend_index_changed(BriskFilesBackend *self)
+{
+        brisk_files_backend_queue_save(self);
+        if (self->term) {
+                brisk_files_backend_update_results(self);
+        }
+}
+
+/**
+ * New search term from the frontend. We keep our own folded copy, folded
+ * the same way as the names within the index.
+ */
+static void brisk_files_backend_search_changed(BriskBackend *backend, const gchar *term)
+{
+        BriskFilesBackend *self = BRISK_FILES_BACKEND(backend);
+
+        g_clear_pointer(&self->term, g_free);
+        if (term && g_utf8_strlen(term, -1) >= BRISK_FILES_MIN_TERM) {
+                self->term = brisk_search_fold(term);
+        }
+
+        brisk_files_backend_update_results(self);
+}
+
+/**
+ * Forget the monitors for the directory and everything below it
+ */
+static void brisk_files_backend_unwatch(BriskFilesBackend *self, const gchar *dir)
+{
+        autofree(gchar) *prefix = g_strconcat(dir, G_DIR_SEPARATOR_S, NULL);
+        GHashTableIter iter;
+        const gchar *key = NULL;
+
+        g_hash_table_iter_init(&iter, self->monitors);
+        while (g_hash_table_iter_next(&iter, (void **)&key, NULL)) {
+                if (g_str_equal(key, dir) || g_str_has_prefix(key, prefix)) {
+                        g_hash_table_iter_remove(&iter);
+                }
+        }
+}
+
+/**
+ * Something changed within a directory we're watching
+ */
+static void brisk_files_backend_dir_changed(BriskFilesBackend *self, GFile *file,
+                                            __brisk_unused__ GFile *other, GFileMonitorEvent event,
+                                            __brisk_unused__ GFileMonitor *monitor)
+{
+        autofree(gchar) *path = g_file_get_path(file);
+        autofree(gchar) *name = g_file_get_basename(file);
+        gboolean changed = FALSE;
+        GFileType type;
+
+        if (!path || !name || name[0] == '.' || !self->index) {
+                return;
+        }
+
+        switch (event) {
+        case G_FILE_MONITOR_EVENT_CREATED:
+                type = g_file_query_file_type(file, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, NULL);
+                if (type == G_FILE_TYPE_DIRECTORY) {
+                        brisk_files_backend_queue_crawl(self, path);
+                } else if (type == G_FILE_TYPE_REGULAR &&
+                           brisk_files_index_size(self->index) < BRISK_FILES_MAX_ENTRIES) {
+                        changed = brisk_files_index_add(self->index, path, self->generation);
+                }
+                break;
+        case G_FILE_MONITOR_EVENT_DELETED:
+                changed = brisk_files_index_remove(self->index, path);
+                if (!changed && g_hash_table_contains(self->monitors, path)) {
+                        changed = brisk_files_index_remove_prefix(self->index, path) > 0;
+                        brisk_files_backend_unwatch(self, path);
+                }
+                break;
+        default:
+                return;
+        }
+
+        if (changed) {
+                brisk_files_backend_index_changed(self);
+        }
+}
+
+/**
+ * brisk_files_backend_watch:
+ *
+ * Keep the index up to date with changes to the directory via inotify
+ */
+void brisk_files_backend_watch(BriskFilesBackend *self, const gchar *dir)
+{
+        autofree(GFile) *file = NULL;
+        GFileMonitor *monitor = NULL;
+
+        if (g_hash_table_contains(self->monitors, dir) ||
+            g_hash_table_size(self->monitors) >= BRISK_FILES_MAX_MONITORS) {
+                return;
+        }
+
+        file = g_file_new_for_path(dir);
+        monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, NULL);
+        if (!monitor) {
+                return;
+        }
+
+        g_signal_connect_swapped(monitor,
+                                 "changed",
+                                 G_CALLBACK(brisk_files_backend_dir_changed),
+                                 self);
+        g_hash_table_insert(self->monitors, g_strdup(dir), monitor);
+}
+
+/**
+ * Recently used files changed, so import them again
+ */
+static void brisk_files_backend_recent_changed(BriskFilesBackend *self,
+                                               __brisk_unused__ GFile *file,
+                                               __brisk_unused__ GFile *other,
+                                               GFileMonitorEvent event,
+                                               __brisk_unused__ GFileMonitor *monitor)
+{
+        if (event == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT ||
+            event == G_FILE_MONITOR_EVENT_CREATED) {
+                brisk_files_backend_queue_recent(self);
+        }
+}
+
+/**
+ * The set of indexed directories changed, so start over with a full crawl.
+ * Anything no longer covered is swept from the index once it completes.
+ */
+static void brisk_files_backend_roots_changed(GSettings *settings, const gchar *key,
+                                              BriskFilesBackend *self)
+{
+        autofree(gstrv) *dirs = g_settings_get_strv(settings, key);
+
+        g_strfreev(self->roots);
+        self->roots = brisk_files_backend_expand_roots(dirs);
+
+        g_hash_table_remove_all(self->monitors);
+        brisk_files_backend_start_crawl(self, TRUE);
+}
+
+/**
+ * brisk_files_backend_load:
+ *
+ * Start loading the index, and bringing it up to date, in the background
+ */
+static gboolean brisk_files_backend_load(BriskBackend *backend)
+{
+        BriskFilesBackend *self = BRISK_FILES_BACKEND(backend);
+        autofree(gchar) *path = NULL;
+        autofree(GFile) *file = NULL;
+
+        path = g_build_filename(g_get_user_data_dir(), "recently-used.xbel", NULL);
+        file = g_file_new_for_path(path);
+        self->recent_monitor = g_file_monitor_file(file, G_FILE_MONITOR_NONE, NULL, NULL);
+        if (self->recent_monitor) {
+                g_signal_connect_swapped(self->recent_monitor,
+                                         "changed",
+                                         G_CALLBACK(brisk_files_backend_recent_changed),
+                                         self);
+        }
+
+        brisk_files_backend_start_crawl(self, TRUE);
+        return TRUE;
+}
+
+/**
+ * brisk_files_backend_new:
+ *
+ * Return a newly created BriskFilesBackend
+ */
+BriskBackend *brisk_files_backend_new(void)
+{
+        return g_object_new(BRISK_TYPE_FILES_BACKEND, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,128 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include "../backend.h"
+#include "files-index.h"
+#include <gio/gio.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Most results we'll show for a single search term
+ */
+#define BRISK_FILES_MAX_RESULTS 20
+
+/**
+ * Time we're allowed to spend querying the index per keystroke (µs)
+ */
+#define BRISK_FILES_SEARCH_BUDGET 4000
+
+/**
+ * Shorter terms would match far too much to be useful
+ */
+#define BRISK_FILES_MIN_TERM 2
+
+/**
+ * Upper bound on the number of files we'll index
+ */
+#define BRISK_FILES_MAX_ENTRIES 250000
+
+/**
+ * Upper bound on the number of directories we'll watch via inotify
+ */
+#define BRISK_FILES_MAX_MONITORS 2048
+
+/**
+ * How long changes may sit in memory before the index is written out (s)
+ */
+#define BRISK_FILES_SAVE_INTERVAL 30
+
+typedef struct _BriskFilesBackend BriskFilesBackend;
+typedef struct _BriskFilesBackendClass BriskFilesBackendClass;
+
+struct _BriskFilesBackendClass {
+        BriskBackendClass parent_class;
+};
+
+/**
+ * BriskFilesBackend searches local files through a persistent trigram index,
+ * which is built and kept up to date away from the main thread
+ */
+struct _BriskFilesBackend {
+        BriskBackend parent;
+        GSettings *settings;
+        gchar **roots;    /**<Absolute paths of the indexed directories */
+        gchar *index_path;
+
+        /* Index state, index is NULL until loaded by the first crawl */
+        BriskFilesIndex *index;
+        guint generation;
+        gchar **pending; /**<Directories left to crawl, for resuming */
+        gboolean dirty;
+        gboolean saving; /**<A worker is writing the index out */
+        guint save_id;
+
+        /* Only one crawl runs at a time, the rest wait in the queue */
+        GCancellable *crawl;
+        GQueue queued;
+        gboolean queued_recent;
+
+        /* inotify */
+        GHashTable *monitors;
+        GFileMonitor *recent_monitor;
+
+        /* Current results, by path */
+        gchar *term;
+        GHashTable *results;
+};
+
+#define BRISK_TYPE_FILES_BACKEND brisk_files_backend_get_type()
+#define BRISK_FILES_BACKEND(o)                                                                     \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_FILES_BACKEND, BriskFilesBackend))
+#define BRISK_IS_FILES_BACKEND(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_FILES_BACKEND))
+#define BRISK_FILES_BACKEND_CLASS(o)                                                               \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_FILES_BACKEND, BriskFilesBackendClass))
+#define BRISK_IS_FILES_BACKEND_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_FILES_BACKEND))
+#define BRISK_FILES_BACKEND_GET_CLASS(o)                                                           \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_FILES_BACKEND, BriskFilesBackendClass))
+
+GType brisk_files_backend_get_type(void);
+
+BriskBackend *brisk_files_backend_new(void);
+
+/* Shared with the crawler */
+void brisk_files_backend_watch(BriskFilesBackend *self, const gchar *dir);
+void brisk_files_backend_index_changed(BriskFilesBackend *self);
+void brisk_files_backend_queue_save(BriskFilesBackend *self);
+
+/* Crawling, see files-crawler.c */
+void brisk_files_backend_start_crawl(BriskFilesBackend *self, gboolean full);
+void brisk_files_backend_queue_crawl(BriskFilesBackend *self, const gchar *dir);
+void brisk_files_backend_queue_recent(BriskFilesBackend *self);
+void brisk_files_backend_cancel_crawl(BriskFilesBackend *self);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
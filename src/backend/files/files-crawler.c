@@ -0,0 +1,501 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "files-backend.h"
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GBookmarkFile, g_bookmark_file_free)
+
+/* Helper for string vectors */
+typedef gchar *gstrv;
+DEF_AUTOFREE(gstrv, g_strfreev)
+
+/**
+ * Crawls hand their findings to the main thread in batches of this many
+ * files or directories, whichever comes first
+ */
+#define BRISK_FILES_BATCH_FILES 512
+#define BRISK_FILES_BATCH_DIRS 64
+
+/**
+ * Pause between batches so that we never hog the disk (µs)
+ */
+#define BRISK_FILES_CRAWL_PAUSE (5 * 1000)
+
+/**
+ * A single crawl, owned by the worker thread
+ */
+typedef struct BriskFilesCrawl {
+        BriskFilesBackend *backend; /**<Not a reference, see brisk_files_batch_apply */
+        GMainContext *context;
+        GCancellable *cancel;
+        GQueue pending;
+        gchar **roots;
+        gchar *index_path;
+        guint generation;
+        gboolean full;   /**<Covers every root, so unseen files may be swept */
+        gboolean load;   /**<Index must first be loaded from disk */
+        gboolean recent; /**<Import recently used files */
+} BriskFilesCrawl;
+
+/**
+ * Findings of the crawl, applied to the index on the main thread
+ */
+typedef struct BriskFilesBatch {
+        BriskFilesBackend *backend;
+        GCancellable *cancel;
+        BriskFilesIndex *index; /**<Freshly loaded index to adopt */
+        guint generation;
+        GPtrArray *files;
+        GPtrArray *dirs;
+        gchar **pending; /**<Resume state, only for full crawls */
+        gboolean full;
+        gboolean done;
+} BriskFilesBatch;
+
+static void brisk_files_crawl_free(BriskFilesCrawl *crawl)
+{
+        g_queue_foreach(&crawl->pending, (GFunc)g_free, NULL);
+        g_queue_clear(&crawl->pending);
+        g_main_context_unref(crawl->context);
+        g_object_unref(crawl->cancel);
+        g_strfreev(crawl->roots);
+        g_free(crawl->index_path);
+        g_slice_free(BriskFilesCrawl, crawl);
+}
+
+static BriskFilesBatch *brisk_files_batch_new(BriskFilesCrawl *crawl)
+{
+        BriskFilesBatch *batch = g_slice_new0(BriskFilesBatch);
+
+        batch->backend = crawl->backend;
+        batch->cancel = g_object_ref(crawl->cancel);
+        batch->generation = crawl->generation;
+        batch->files = g_ptr_array_new_with_free_func(g_free);
+        batch->dirs = g_ptr_array_new_with_free_func(g_free);
+        batch->full = crawl->full;
+
+        return batch;
+}
+
+static void brisk_files_batch_free(BriskFilesBatch *batch)
+{
+        brisk_files_index_free(batch->index);
+        g_ptr_array_unref(batch->files);
+        g_ptr_array_unref(batch->dirs);
+        g_strfreev(batch->pending);
+        g_object_unref(batch->cancel);
+        g_slice_free(BriskFilesBatch, batch);
+}
+
+static void brisk_files_backend_run_crawl(BriskFilesBackend *self, BriskFilesCrawl *crawl);
+
+/**
+ * Start on whatever was queued up during the last crawl
+ */
+static void brisk_files_backend_crawl_queued(BriskFilesBackend *self)
+{
+        BriskFilesCrawl *crawl = NULL;
+        gchar *dir = NULL;
+
+        /* Waits for the index to be loaded first */
+        if (!self->index || (g_queue_is_empty(&self->queued) && !self->queued_recent)) {
+                return;
+        }
+
+        crawl = g_slice_new0(BriskFilesCrawl);
+        g_queue_init(&crawl->pending);
+        while ((dir = g_queue_pop_head(&self->queued)) != NULL) {
+                g_queue_push_tail(&crawl->pending, dir);
+        }
+        crawl->recent = self->queued_recent;
+        self->queued_recent = FALSE;
+
+        brisk_files_backend_run_crawl(self, crawl);
+}
+
+/**
+ * Main thread: fold the batch into the index
+ */
+static gboolean brisk_files_batch_apply(BriskFilesBatch *batch)
+{
+        BriskFilesBackend *self = batch->backend;
+        gboolean changed = FALSE;
+
+        /* Superseded by a newer crawl, or the backend went away. Disposing the
+         * backend cancels the crawl on this thread, so it's safe to check */
+        if (g_cancellable_is_cancelled(batch->cancel)) {
+                return G_SOURCE_REMOVE;
+        }
+
+        if (batch->index) {
+                brisk_files_index_free(self->index);
+                self->index = batch->index;
+                self->generation = batch->generation;
+                batch->index = NULL;
+                changed = TRUE;
+        }
+
+        for (guint i = 0; i < batch->files->len; i++) {
+                if (brisk_files_index_size(self->index) >= BRISK_FILES_MAX_ENTRIES) {
+                        break;
+                }
+                changed |= brisk_files_index_add(self->index,
+                                                 batch->files->pdata[i],
+                                                 batch->generation);
+        }
+
+        for (guint i = 0; i < batch->dirs->len; i++) {
+                brisk_files_backend_watch(self, batch->dirs->pdata[i]);
+        }
+
+        /* Only full crawls know what's left of the whole tree */
+        if (batch->full) {
+                g_strfreev(self->pending);
+                self->pending = batch->pending;
+                batch->pending = NULL;
+        }
+
+        if (batch->done) {
+                if (batch->full && brisk_files_index_sweep(self->index, batch->generation) > 0) {
+                        changed = TRUE;
+                }
+                g_clear_object(&self->crawl);
+        }
+
+        if (changed) {
+                brisk_files_backend_index_changed(self);
+        } else if (batch->full) {
+                brisk_files_backend_queue_save(self);
+        }
+
+        if (batch->done) {
+                brisk_files_backend_crawl_queued(self);
+        }
+
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * Worker thread: hand the batch over to the main thread
+ */
+static void brisk_files_crawl_post(BriskFilesCrawl *crawl, BriskFilesBatch *batch)
+{
+        if (crawl->full) {
+                guint n = 0;
+
+                batch->pending = g_new0(gchar *, g_queue_get_length(&crawl->pending) + 1);
+                for (GList *elem = crawl->pending.head; elem; elem = elem->next) {
+                        batch->pending[n++] = g_strdup(elem->data);
+                }
+        }
+
+        g_main_context_invoke_full(crawl->context,
+                                   G_PRIORITY_LOW,
+                                   (GSourceFunc)brisk_files_batch_apply,
+                                   batch,
+                                   (GDestroyNotify)brisk_files_batch_free);
+}
+
+static gboolean brisk_files_crawl_same_roots(gchar **a, gchar **b)
+{
+        if (!a || !b || g_strv_length(a) != g_strv_length(b)) {
+                return FALSE;
+        }
+        for (guint i = 0; a[i]; i++) {
+                if (g_strcmp0(a[i], b[i]) != 0) {
+                        return FALSE;
+                }
+        }
+        return TRUE;
+}
+
+/**
+ * Worker thread: load the index from disk, working out whether we resume the
+ * last crawl or need to start a new one
+ */
+static void brisk_files_crawl_load(BriskFilesCrawl *crawl)
+{
+        autofree(GError) *error = NULL;
+        autofree(gstrv) *roots = NULL;
+        autofree(gstrv) *pending = NULL;
+        BriskFilesBatch *batch = NULL;
+        BriskFilesIndex *index = NULL;
+        guint generation = 0;
+
+        index =
+            brisk_files_index_load(crawl->index_path, &generation, &roots, &pending, &error);
+        if (!index) {
+                if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+                        g_message("Rebuilding file index: %s", error->message);
+                }
+                index = brisk_files_index_new();
+        }
+
+        /* Pick up where we left off when nothing changed in between */
+        if (pending && pending[0] && brisk_files_crawl_same_roots(roots, crawl->roots)) {
+                g_queue_foreach(&crawl->pending, (GFunc)g_free, NULL);
+                g_queue_clear(&crawl->pending);
+                for (guint i = 0; pending[i]; i++) {
+                        g_queue_push_tail(&crawl->pending, g_strdup(pending[i]));
+                }
+                crawl->generation = generation;
+        } else {
+                crawl->generation = generation + 1;
+        }
+
+        batch = brisk_files_batch_new(crawl);
+        batch->index = index;
+        brisk_files_crawl_post(crawl, batch);
+}
+
+/**
+ * Worker thread: pick up local files from the recently used list
+ */
+static void brisk_files_crawl_recent(__brisk_unused__ BriskFilesCrawl *crawl,
+                                     BriskFilesBatch *batch)
+{
+        autofree(GBookmarkFile) *bookmarks = g_bookmark_file_new();
+        autofree(gchar) *path = NULL;
+        autofree(gstrv) *uris = NULL;
+
+        path = g_build_filename(g_get_user_data_dir(), "recently-used.xbel", NULL);
+        if (!g_bookmark_file_load_from_file(bookmarks, path, NULL)) {
+                return;
+        }
+
+        uris = g_bookmark_file_get_uris(bookmarks, NULL);
+        for (guint i = 0; uris[i]; i++) {
+                gchar *filename = NULL;
+
+                if (!g_str_has_prefix(uris[i], "file://")) {
+                        continue;
+                }
+
+                filename = g_filename_from_uri(uris[i], NULL, NULL);
+                if (filename && g_file_test(filename, G_FILE_TEST_IS_REGULAR)) {
+                        g_ptr_array_add(batch->files, filename);
+                } else {
+                        g_free(filename);
+                }
+        }
+}
+
+/**
+ * Worker thread: list a single directory, queueing up any children. We skip
+ * hidden entries and never follow symlinks, so loops can't happen.
+ */
+static void brisk_files_crawl_dir(BriskFilesCrawl *crawl, gchar *dir, BriskFilesBatch *batch)
+{
+        DIR *handle = NULL;
+        struct dirent *ent = NULL;
+
+        handle = opendir(dir);
+        if (!handle) {
+                g_free(dir);
+                return;
+        }
+
+        while ((ent = readdir(handle)) != NULL) {
+                unsigned char type = ent->d_type;
+                struct stat st = { 0 };
+                gchar *path = NULL;
+
+                if (ent->d_name[0] == '.') {
+                        continue;
+                }
+
+                path = g_build_filename(dir, ent->d_name, NULL);
+
+                /* Not every file system fills in the type */
+                if (type == DT_UNKNOWN && lstat(path, &st) == 0) {
+                        if (S_ISDIR(st.st_mode)) {
+                                type = DT_DIR;
+                        } else if (S_ISREG(st.st_mode)) {
+                                type = DT_REG;
+                        }
+                }
+
+                if (type == DT_DIR) {
+                        g_queue_push_head(&crawl->pending, path);
+                } else if (type == DT_REG) {
+                        g_ptr_array_add(batch->files, path);
+                } else {
+                        g_free(path);
+                }
+        }
+
+        closedir(handle);
+        g_ptr_array_add(batch->dirs, dir);
+}
+
+/**
+ * Worker thread: walk the tree depth first, keeping the queue short
+ */
+static void brisk_files_crawl_thread(GTask *task, __brisk_unused__ gpointer source, gpointer data,
+                                     GCancellable *cancel)
+{
+        BriskFilesCrawl *crawl = data;
+        BriskFilesBatch *batch = NULL;
+        gchar *dir = NULL;
+
+        if (crawl->load) {
+                brisk_files_crawl_load(crawl);
+        }
+
+        batch = brisk_files_batch_new(crawl);
+        if (crawl->recent) {
+                brisk_files_crawl_recent(crawl, batch);
+        }
+
+        while (!g_cancellable_is_cancelled(cancel) &&
+               (dir = g_queue_pop_head(&crawl->pending)) != NULL) {
+                brisk_files_crawl_dir(crawl, dir, batch);
+
+                if (batch->files->len < BRISK_FILES_BATCH_FILES &&
+                    batch->dirs->len < BRISK_FILES_BATCH_DIRS) {
+                        continue;
+                }
+
+                brisk_files_crawl_post(crawl, batch);
+                batch = brisk_files_batch_new(crawl);
+                g_usleep(BRISK_FILES_CRAWL_PAUSE);
+        }
+
+        if (g_cancellable_is_cancelled(cancel)) {
+                brisk_files_batch_free(batch);
+                g_task_return_boolean(task, FALSE);
+                return;
+        }
+
+        batch->done = TRUE;
+        brisk_files_crawl_post(crawl, batch);
+        g_task_return_boolean(task, TRUE);
+}
+
+/**
+ * Kick off the crawl within a worker thread
+ */
+static void brisk_files_backend_run_crawl(BriskFilesBackend *self, BriskFilesCrawl *crawl)
+{
+        GTask *task = NULL;
+
+        self->crawl = g_cancellable_new();
+
+        crawl->backend = self;
+        crawl->context = g_main_context_ref_thread_default();
+        crawl->cancel = g_object_ref(self->crawl);
+        crawl->index_path = g_strdup(self->index_path);
+        crawl->roots = g_strdupv(self->roots);
+        if (!crawl->load) {
+                crawl->generation = self->generation;
+        }
+
+        task = g_task_new(NULL, self->crawl, NULL, NULL);
+        g_task_set_task_data(task, crawl, (GDestroyNotify)brisk_files_crawl_free);
+        g_task_set_priority(task, G_PRIORITY_LOW);
+        g_task_run_in_thread(task, brisk_files_crawl_thread);
+        g_object_unref(task);
+}
+
+/**
+ * brisk_files_backend_start_crawl:
+ *
+ * Replace any running crawl with one covering every root. The first crawl
+ * also loads the index from disk, and resumes the previous crawl if it never
+ * completed. Later ones start a new generation, so that anything not seen
+ * again is swept from the index once they complete.
+ */
+void brisk_files_backend_start_crawl(BriskFilesBackend *self, gboolean full)
+{
+        BriskFilesCrawl *crawl = NULL;
+
+        brisk_files_backend_cancel_crawl(self);
+
+        crawl = g_slice_new0(BriskFilesCrawl);
+        g_queue_init(&crawl->pending);
+        for (guint i = 0; self->roots && self->roots[i]; i++) {
+                g_queue_push_tail(&crawl->pending, g_strdup(self->roots[i]));
+        }
+        crawl->recent = TRUE;
+        crawl->full = full;
+        crawl->load = self->index == NULL;
+
+        if (!crawl->load && full) {
+                ++self->generation;
+        }
+
+        brisk_files_backend_run_crawl(self, crawl);
+}
+
+/**
+ * brisk_files_backend_queue_crawl:
+ *
+ * Crawl a single new directory, once any running crawl is done
+ */
+void brisk_files_backend_queue_crawl(BriskFilesBackend *self, const gchar *dir)
+{
+        g_queue_push_tail(&self->queued, g_strdup(dir));
+        if (!self->crawl) {
+                brisk_files_backend_crawl_queued(self);
+        }
+}
+
+/**
+ * brisk_files_backend_queue_recent:
+ *
+ * Import the recently used files again, once any running crawl is done
+ */
+void brisk_files_backend_queue_recent(BriskFilesBackend *self)
+{
+        self->queued_recent = TRUE;
+        if (!self->crawl) {
+                brisk_files_backend_crawl_queued(self);
+        }
+}
+
+/**
+ * brisk_files_backend_cancel_crawl:
+ *
+ * Stop the running crawl, dropping anything it has yet to deliver
+ */
+void brisk_files_backend_cancel_crawl(BriskFilesBackend *self)
+{
+        if (!self->crawl) {
+                return;
+        }
+        g_cancellable_cancel(self->crawl);
+        g_clear_object(&self->crawl);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,709 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "../search.h"
+#include "files-index.h"
+#include <gio/gio.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GVariant, g_variant_unref)
+DEF_AUTOFREE(GPtrArray, g_ptr_array_unref)
+
+/**
+ * version, generation, roots, pending, paths, generations, postings
+ */
+#define BRISK_FILES_INDEX_FORMAT "(uuasasasaua(uau))"
+
+/**
+ * How many documents we look at between checks of the deadline
+ */
+#define BRISK_FILES_INDEX_CHECK_INTERVAL 256
+
+static inline guint32 brisk_files_index_trigram(const gchar *s)
+{
+        return (guint32)(guchar)s[0] << 16 | (guint32)(guchar)s[1] << 8 | (guint32)(guchar)s[2];
+}
+
+static void brisk_files_index_free_list(gpointer list)
+{
+        g_array_unref(list);
+}
+
+/**
+ * Fold the basename of the path down for case insensitive matching
+ */
+static gchar *brisk_files_index_fold(const gchar *path)
+{
+        autofree(gchar) *name = g_path_get_basename(path);
+        autofree(gchar) *display = g_filename_display_name(name);
+
+        return brisk_search_fold(display);
+}
+
+/**
+ * brisk_files_index_new:
+ *
+ * Construct a new, empty, index
+ */
+BriskFilesIndex *brisk_files_index_new(void)
+{
+        BriskFilesIndex *index = g_slice_new0(BriskFilesIndex);
+
+        index->paths = g_ptr_array_new_with_free_func(g_free);
+        index->names = g_ptr_array_new_with_free_func(g_free);
+        index->generations = g_array_new(FALSE, FALSE, sizeof(guint32));
+        index->lookup = g_hash_table_new(g_str_hash, g_str_equal);
+        index->trigrams =
+            g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, brisk_files_index_free_list);
+
+        return index;
+}
+
+/**
+ * brisk_files_index_free:
+ *
+ * Free the index and every document within it
+ */
+void brisk_files_index_free(BriskFilesIndex *index)
+{
+        if (!index) {
+                return;
+        }
+
+        /* Keys are owned by the paths array */
+        g_hash_table_unref(index->lookup);
+        g_hash_table_unref(index->trigrams);
+        g_ptr_array_unref(index->paths);
+        g_ptr_array_unref(index->names);
+        g_array_unref(index->generations);
+        g_slice_free(BriskFilesIndex, index);
+}
+
+/**
+ * brisk_files_index_size:
+ *
+ * Return the number of live documents
+ */
+guint brisk_files_index_size(BriskFilesIndex *index)
+{
+        return g_hash_table_size(index->lookup);
+}
+
+/**
+ * Record every distinct trigram of the name against the new document
+ */
+static void brisk_files_index_add_trigrams(BriskFilesIndex *index, const gchar *name, guint32 doc)
+{
+        gsize len = strlen(name);
+
+        for (gsize i = 0; i + 3 <= len; i++) {
+                gpointer key = GUINT_TO_POINTER(brisk_files_index_trigram(name + i));
+                GArray *list = g_hash_table_lookup(index->trigrams, key);
+
+                if (!list) {
+                        list = g_array_sized_new(FALSE, FALSE, sizeof(guint32), 4);
+                        g_hash_table_insert(index->trigrams, key, list);
+                }
+
+                /* New documents always sort last, so repeats are adjacent */
+                if (list->len > 0 && g_array_index(list, guint32, list->len - 1) == doc) {
+                        continue;
+                }
+                g_array_append_val(list, doc);
+        }
+}
+
+/**
+ * brisk_files_index_add:
+ *
+ * Add the path to the index if it isn't already known, and mark it as seen
+ * by the given crawl generation.
+ *
+ * Returns TRUE if the path was new
+ */
+gboolean brisk_files_index_add(BriskFilesIndex *index, const gchar *path, guint generation)
+{
+        gpointer value = NULL;
+        guint32 doc;
+        gchar *copy = NULL;
+        gchar *name = NULL;
+
+        value = g_hash_table_lookup(index->lookup, path);
+        if (value) {
+                doc = GPOINTER_TO_UINT(value) - 1;
+                g_array_index(index->generations, guint32, doc) = generation;
+                return FALSE;
+        }
+
+        doc = index->paths->len;
+        copy = g_strdup(path);
+        name = brisk_files_index_fold(path);
+
+        g_ptr_array_add(index->paths, copy);
+        g_ptr_array_add(index->names, name);
+        g_array_append_val(index->generations, generation);
+        g_hash_table_insert(index->lookup, copy, GUINT_TO_POINTER(doc + 1));
+        brisk_files_index_add_trigrams(index, name, doc);
+
+        return TRUE;
+}
+
+/**
+ * Leave a hole where the document used to be
+ */
+static void brisk_files_index_remove_doc(BriskFilesIndex *index, guint doc)
+{
+        g_hash_table_remove(index->lookup, index->paths->pdata[doc]);
+        g_clear_pointer(&index->paths->pdata[doc], g_free);
+        g_clear_pointer(&index->names->pdata[doc], g_free);
+        ++index->n_removed;
+}
+
+/**
+ * brisk_files_index_remove:
+ *
+ * Remove the path from the index, returning TRUE if it was known
+ */
+gboolean brisk_files_index_remove(BriskFilesIndex *index, const gchar *path)
+{
+        gpointer value = g_hash_table_lookup(index->lookup, path);
+
+        if (!value) {
+                return FALSE;
+        }
+        brisk_files_index_remove_doc(index, GPOINTER_TO_UINT(value) - 1);
+        return TRUE;
+}
+
+/**
+ * brisk_files_index_remove_prefix:
+ *
+ * Remove every document below the given directory
+ *
+ * Returns the number of documents removed
+ */
+guint brisk_files_index_remove_prefix(BriskFilesIndex *index, const gchar *prefix)
+{
+        autofree(gchar) *dir = g_str_has_suffix(prefix, G_DIR_SEPARATOR_S)
+                                   ? g_strdup(prefix)
+                                   : g_strconcat(prefix, G_DIR_SEPARATOR_S, NULL);
+        guint n_removed = 0;
+
+        for (guint i = 0; i < index->paths->len; i++) {
+                const gchar *path = index->paths->pdata[i];
+
+                if (path && g_str_has_prefix(path, dir)) {
+                        brisk_files_index_remove_doc(index, i);
+                        ++n_removed;
+                }
+        }
+
+        return n_removed;
+}
+
+/**
+ * brisk_files_index_sweep:
+ *
+ * Remove every document which wasn't seen by the given crawl generation, as
+ * the crawl has since completed without finding it
+ *
+ * Returns the number of documents removed
+ */
+guint brisk_files_index_sweep(BriskFilesIndex *index, guint generation)
+{
+        guint n_removed = 0;
+
+        for (guint i = 0; i < index->paths->len; i++) {
+                if (!index->paths->pdata[i]) {
+                        continue;
+                }
+                if (g_array_index(index->generations, guint32, i) < generation) {
+                        brisk_files_index_remove_doc(index, i);
+                        ++n_removed;
+                }
+        }
+
+        return n_removed;
+}
+
+/**
+ * Renumber the live documents, closing the holes left by removals
+ */
+static void brisk_files_index_compact(BriskFilesIndex *index)
+{
+        GHashTableIter iter;
+        GArray *list = NULL;
+        guint32 *remap = NULL;
+        guint32 next = 0;
+
+        if (index->n_removed == 0) {
+                return;
+        }
+
+        remap = g_new(guint32, index->paths->len);
+        for (guint i = 0; i < index->paths->len; i++) {
+                if (!index->paths->pdata[i]) {
+                        remap[i] = G_MAXUINT32;
+                        continue;
+                }
+
+                remap[i] = next;
+                index->paths->pdata[next] = index->paths->pdata[i];
+                index->names->pdata[next] = index->names->pdata[i];
+                g_array_index(index->generations, guint32, next) =
+                    g_array_index(index->generations, guint32, i);
+                g_hash_table_insert(index->lookup,
+                                    index->paths->pdata[next],
+                                    GUINT_TO_POINTER(next + 1));
+                ++next;
+        }
+
+        /* Everything past next was moved, don't free it */
+        for (guint i = next; i < index->paths->len; i++) {
+                index->paths->pdata[i] = NULL;
+                index->names->pdata[i] = NULL;
+        }
+        g_ptr_array_set_size(index->paths, next);
+        g_ptr_array_set_size(index->names, next);
+        g_array_set_size(index->generations, next);
+
+        /* Order is preserved by renumbering, so lists stay sorted */
+        g_hash_table_iter_init(&iter, index->trigrams);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&list)) {
+                guint n = 0;
+
+                for (guint i = 0; i < list->len; i++) {
+                        guint32 doc = remap[g_array_index(list, guint32, i)];
+                        if (doc != G_MAXUINT32) {
+                                g_array_index(list, guint32, n++) = doc;
+                        }
+                }
+
+                if (n == 0) {
+                        g_hash_table_iter_remove(&iter);
+                } else {
+                        g_array_set_size(list, n);
+                }
+        }
+
+        g_free(remap);
+        index->n_removed = 0;
+}
+
+static gboolean brisk_files_index_list_contains(GArray *list, guint32 doc)
+{
+        guint lo = 0;
+        guint hi = list->len;
+
+        while (lo < hi) {
+                guint mid = lo + (hi - lo) / 2;
+                guint32 value = g_array_index(list, guint32, mid);
+
+                if (value == doc) {
+                        return TRUE;
+                } else if (value < doc) {
+                        lo = mid + 1;
+                } else {
+                        hi = mid;
+                }
+        }
+
+        return FALSE;
+}
+
+static gint brisk_files_index_list_compare(gconstpointer a, gconstpointer b)
+{
+        const GArray *list_a = *(GArray *const *)a;
+        const GArray *list_b = *(GArray *const *)b;
+
+        return (list_a->len > list_b->len) - (list_a->len < list_b->len);
+}
+
+/**
+ * Add the document to the results if its name really contains the term
+ */
+static inline void brisk_files_index_verify(BriskFilesIndex *index, guint32 doc, const gchar *term,
+                                            GPtrArray *results)
+{
+        const gchar *name = index->names->pdata[doc];
+
+        if (name && strstr(name, term)) {
+                g_ptr_array_add(results, index->paths->pdata[doc]);
+        }
+}
+
+/**
+ * Terms too short for a trigram have to look at every name
+ */
+static void brisk_files_index_scan(BriskFilesIndex *index, const gchar *term, guint max_results,
+                                   gint64 deadline, GPtrArray *results)
+{
+        for (guint32 doc = 0; doc < index->names->len && results->len < max_results; doc++) {
+                if (doc % BRISK_FILES_INDEX_CHECK_INTERVAL == 0 &&
+                    g_get_monotonic_time() > deadline) {
+                        return;
+                }
+                brisk_files_index_verify(index, doc, term, results);
+        }
+}
+
+/**
+ * brisk_files_index_query:
+ *
+ * Find up to max_results paths whose folded name contains the folded term.
+ * We give up once the monotonic deadline has passed, returning whatever was
+ * found so far.
+ *
+ * Returns a new array of paths owned by the index, valid until it changes
+ */
+GPtrArray *brisk_files_index_query(BriskFilesIndex *index, const gchar *term, guint max_results,
+                                   gint64 deadline)
+{
+        autofree(GPtrArray) *lists = NULL;
+        GPtrArray *results = g_ptr_array_new();
+        gsize len = strlen(term);
+        GArray *shortest = NULL;
+
+        if (len < 3) {
+                brisk_files_index_scan(index, term, max_results, deadline, results);
+                return results;
+        }
+
+        lists = g_ptr_array_new();
+        for (gsize i = 0; i + 3 <= len; i++) {
+                gpointer key = GUINT_TO_POINTER(brisk_files_index_trigram(term + i));
+                GArray *list = g_hash_table_lookup(index->trigrams, key);
+
+                /* Nothing can contain the whole term */
+                if (!list) {
+                        return results;
+                }
+                g_ptr_array_add(lists, list);
+        }
+
+        /* Walk the rarest trigram, probing the others */
+        g_ptr_array_sort(lists, brisk_files_index_list_compare);
+        shortest = lists->pdata[0];
+
+        for (guint i = 0; i < shortest->len && results->len < max_results; i++) {
+                guint32 doc = g_array_index(shortest, guint32, i);
+                gboolean found = TRUE;
+
+                if (i % BRISK_FILES_INDEX_CHECK_INTERVAL == 0 &&
+                    g_get_monotonic_time() > deadline) {
+                        break;
+                }
+
+                for (guint j = 1; j < lists->len && found; j++) {
+                        found = brisk_files_index_list_contains(lists->pdata[j], doc);
+                }
+
+                if (found) {
+                        brisk_files_index_verify(index, doc, term, results);
+                }
+        }
+
+        return results;
+}
+
+/**
+ * A copy of everything that goes on disk, already renumbered so that it has
+ * no holes. It shares nothing with the index, so it can be serialised in a
+ * worker thread while the index keeps changing.
+ */
+struct BriskFilesIndexSnapshot {
+        guint generation;
+        gchar **roots;
+        gchar **pending;
+        GPtrArray *paths;
+        GArray *generations;
+        GArray *keys;    /**<Packed trigrams */
+        GPtrArray *lists; /**<Renumbered documents for each of the keys */
+};
+
+/**
+ * Holes are only worth closing in the live index once there are plenty of
+ * them, the snapshot skips them either way
+ */
+#define BRISK_FILES_INDEX_COMPACT_RATIO 4
+
+/**
+ * brisk_files_index_snapshot:
+ *
+ * Copy the index and the crawl state for serialising elsewhere. This only
+ * copies memory around, building the variant is left to the worker.
+ */
+BriskFilesIndexSnapshot *brisk_files_index_snapshot(BriskFilesIndex *index, guint generation,
+                                                    gchar **roots, gchar **pending)
+{
+        BriskFilesIndexSnapshot *snapshot = g_slice_new0(BriskFilesIndexSnapshot);
+        guint n_live = index->paths->len - index->n_removed;
+        GHashTableIter iter;
+        gpointer key = NULL;
+        GArray *list = NULL;
+        guint32 *remap = NULL;
+        guint32 next = 0;
+
+        if (index->n_removed > index->paths->len / BRISK_FILES_INDEX_COMPACT_RATIO) {
+                brisk_files_index_compact(index);
+                n_live = index->paths->len;
+        }
+
+        snapshot->generation = generation;
+        snapshot->roots = g_strdupv(roots);
+        snapshot->pending = g_strdupv(pending);
+        snapshot->paths = g_ptr_array_new_full(n_live, g_free);
+        snapshot->generations = g_array_sized_new(FALSE, FALSE, sizeof(guint32), n_live);
+        snapshot->keys = g_array_sized_new(FALSE,
+                                           FALSE,
+                                           sizeof(guint32),
+                                           g_hash_table_size(index->trigrams));
+        snapshot->lists = g_ptr_array_new_full(g_hash_table_size(index->trigrams),
+                                               brisk_files_index_free_list);
+
+        remap = g_new(guint32, index->paths->len);
+        for (guint i = 0; i < index->paths->len; i++) {
+                if (!index->paths->pdata[i]) {
+                        remap[i] = G_MAXUINT32;
+                        continue;
+                }
+                remap[i] = next++;
+                g_ptr_array_add(snapshot->paths, g_strdup(index->paths->pdata[i]));
+                g_array_append_val(snapshot->generations,
+                                   g_array_index(index->generations, guint32, i));
+        }
+
+        g_hash_table_iter_init(&iter, index->trigrams);
+        while (g_hash_table_iter_next(&iter, &key, (void **)&list)) {
+                GArray *copy = g_array_sized_new(FALSE, FALSE, sizeof(guint32), list->len);
+                guint32 packed = GPOINTER_TO_UINT(key);
+
+                /* Renumbering preserves the order, so the copy stays sorted */
+                for (guint i = 0; i < list->len; i++) {
+                        guint32 doc = remap[g_array_index(list, guint32, i)];
+                        if (doc != G_MAXUINT32) {
+                                g_array_append_val(copy, doc);
+                        }
+                }
+                if (copy->len == 0) {
+                        g_array_unref(copy);
+                        continue;
+                }
+                g_array_append_val(snapshot->keys, packed);
+                g_ptr_array_add(snapshot->lists, copy);
+        }
+
+        g_free(remap);
+        return snapshot;
+}
+
+/**
+ * brisk_files_index_snapshot_free:
+ *
+ * Free a snapshot taken with brisk_files_index_snapshot
+ */
+void brisk_files_index_snapshot_free(BriskFilesIndexSnapshot *snapshot)
+{
+        g_strfreev(snapshot->roots);
+        g_strfreev(snapshot->pending);
+        g_ptr_array_unref(snapshot->paths);
+        g_array_unref(snapshot->generations);
+        g_array_unref(snapshot->keys);
+        g_ptr_array_unref(snapshot->lists);
+        g_slice_free(BriskFilesIndexSnapshot, snapshot);
+}
+
+/**
+ * brisk_files_index_serialize:
+ *
+ * Serialise a snapshot of the index along with the crawl state. Safe to
+ * call from any thread, as the snapshot is owned by the caller.
+ */
+GBytes *brisk_files_index_serialize(BriskFilesIndexSnapshot *snapshot)
+{
+        autofree(GVariant) *data = NULL;
+        GVariantBuilder builder;
+        GVariant *paths = NULL;
+        GVariant *generations = NULL;
+        gchar *empty[] = { NULL };
+
+        paths = g_variant_new_strv((const gchar *const *)snapshot->paths->pdata,
+                                   (gssize)snapshot->paths->len);
+        generations = g_variant_new_fixed_array(G_VARIANT_TYPE_UINT32,
+                                                snapshot->generations->data,
+                                                snapshot->generations->len,
+                                                sizeof(guint32));
+
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a(uau)"));
+        for (guint i = 0; i < snapshot->keys->len; i++) {
+                GArray *list = snapshot->lists->pdata[i];
+
+                g_variant_builder_add_value(
+                    &builder,
+                    g_variant_new("(u@au)",
+                                  g_array_index(snapshot->keys, guint32, i),
+                                  g_variant_new_fixed_array(G_VARIANT_TYPE_UINT32,
+                                                            list->data,
+                                                            list->len,
+                                                            sizeof(guint32))));
+        }
+
+        data = g_variant_ref_sink(g_variant_new("(uu^as^as@as@aua(uau))",
+                                                BRISK_FILES_INDEX_VERSION,
+                                                snapshot->generation,
+                                                snapshot->roots ? snapshot->roots : empty,
+                                                snapshot->pending ? snapshot->pending : empty,
+                                                paths,
+                                                generations,
+                                                &builder));
+
+        return g_variant_get_data_as_bytes(data);
+}
+
+/**
+ * Fill in an index from the serialised form, which we don't trust
+ */
+static gboolean brisk_files_index_deserialize(BriskFilesIndex *index, GVariant *paths,
+                                              GVariant *generations, GVariant *postings,
+                                              GError **error)
+{
+        const guint32 *gens = NULL;
+        gsize n_gens = 0;
+        GVariantIter iter;
+        const gchar *path = NULL;
+        guint32 key;
+        GVariant *docs = NULL;
+
+        gens = g_variant_get_fixed_array(generations, &n_gens, sizeof(guint32));
+        if (n_gens != g_variant_n_children(paths)) {
+                g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Mismatched generations");
+                return FALSE;
+        }
+
+        g_variant_iter_init(&iter, paths);
+        while (g_variant_iter_next(&iter, "&s", &path)) {
+                guint32 doc = index->paths->len;
+                gchar *copy = g_strdup(path);
+
+                g_ptr_array_add(index->paths, copy);
+                g_ptr_array_add(index->names, brisk_files_index_fold(path));
+                g_hash_table_insert(index->lookup, copy, GUINT_TO_POINTER(doc + 1));
+        }
+        g_array_append_vals(index->generations, gens, (guint)n_gens);
+
+        g_variant_iter_init(&iter, postings);
+        while (g_variant_iter_next(&iter, "(u@au)", &key, &docs)) {
+                const guint32 *values = NULL;
+                gsize n_values = 0;
+                GArray *list = NULL;
+
+                values = g_variant_get_fixed_array(docs, &n_values, sizeof(guint32));
+                for (gsize i = 0; i < n_values; i++) {
+                        if (values[i] >= n_gens || (i > 0 && values[i] <= values[i - 1])) {
+                                g_set_error(error,
+                                            G_IO_ERROR,
+                                            G_IO_ERROR_INVALID_DATA,
+                                            "Corrupt posting list");
+                                g_variant_unref(docs);
+                                return FALSE;
+                        }
+                }
+
+                list = g_array_sized_new(FALSE, FALSE, sizeof(guint32), (guint)n_values);
+                g_array_append_vals(list, values, (guint)n_values);
+                g_hash_table_insert(index->trigrams, GUINT_TO_POINTER(key), list);
+                g_variant_unref(docs);
+        }
+
+        return TRUE;
+}
+
+/**
+ * brisk_files_index_load:
+ *
+ * Load a previously serialised index, along with its crawl state
+ *
+ * Returns a new index, or NULL with error set
+ */
+BriskFilesIndex *brisk_files_index_load(const gchar *filename, guint *generation, gchar ***roots,
+                                        gchar ***pending, GError **error)
+{
+        autofree(GVariant) *data = NULL;
+        autofree(GVariant) *paths = NULL;
+        autofree(GVariant) *generations = NULL;
+        autofree(GVariant) *postings = NULL;
+        BriskFilesIndex *index = NULL;
+        GMappedFile *file = NULL;
+        GBytes *bytes = NULL;
+        guint32 version = 0;
+
+        file = g_mapped_file_new(filename, FALSE, error);
+        if (!file) {
+                return NULL;
+        }
+        bytes = g_mapped_file_get_bytes(file);
+        g_mapped_file_unref(file);
+
+        data = g_variant_ref_sink(
+            g_variant_new_from_bytes(G_VARIANT_TYPE(BRISK_FILES_INDEX_FORMAT), bytes, FALSE));
+        g_bytes_unref(bytes);
+
+        g_variant_get_child(data, 0, "u", &version);
+        if (version != BRISK_FILES_INDEX_VERSION) {
+                g_set_error(error,
+                            G_IO_ERROR,
+                            G_IO_ERROR_INVALID_DATA,
+                            "Unsupported index version %u",
+                            version);
+                return NULL;
+        }
+
+        g_variant_get(data,
+                      "(uu^as^as@as@au@a(uau))",
+                      NULL,
+                      generation,
+                      roots,
+                      pending,
+                      &paths,
+                      &generations,
+                      &postings);
+
+        index = brisk_files_index_new();
+        if (!brisk_files_index_deserialize(index, paths, generations, postings, error)) {
+                brisk_files_index_free(index);
+                g_clear_pointer(roots, g_strfreev);
+                g_clear_pointer(pending, g_strfreev);
+                return NULL;
+        }
+
+        return index;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
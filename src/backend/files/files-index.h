@@ -0,0 +1,77 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Bump whenever the on-disk layout changes, older indexes are then rebuilt
+ */
+#define BRISK_FILES_INDEX_VERSION 3
+
+/**
+ * BriskFilesIndex maps every trigram of a folded file name to the sorted list
+ * of documents containing it. A query only has to verify the documents found
+ * in all posting lists for its own trigrams.
+ *
+ * Removed documents leave a hole behind until the index is compacted, which
+ * keeps posting lists sorted without ever having to search them for removal.
+ */
+typedef struct BriskFilesIndex {
+        GPtrArray *paths;     /**<Document to path, NULL once removed */
+        GPtrArray *names;     /**<Document to folded basename */
+        GArray *generations;  /**<Document to the last crawl that saw it */
+        GHashTable *lookup;   /**<Path to document + 1 */
+        GHashTable *trigrams; /**<Packed trigram to GArray of documents */
+        guint n_removed;
+} BriskFilesIndex;
+
+BriskFilesIndex *brisk_files_index_new(void);
+void brisk_files_index_free(BriskFilesIndex *index);
+
+guint brisk_files_index_size(BriskFilesIndex *index);
+gboolean brisk_files_index_add(BriskFilesIndex *index, const gchar *path, guint generation);
+gboolean brisk_files_index_remove(BriskFilesIndex *index, const gchar *path);
+guint brisk_files_index_remove_prefix(BriskFilesIndex *index, const gchar *prefix);
+guint brisk_files_index_sweep(BriskFilesIndex *index, guint generation);
+
+GPtrArray *brisk_files_index_query(BriskFilesIndex *index, const gchar *term, guint max_results,
+                                   gint64 deadline);
+
+/**
+ * Persistence, alongside the state needed to resume an interrupted crawl
+ */
+typedef struct BriskFilesIndexSnapshot BriskFilesIndexSnapshot;
+
+BriskFilesIndexSnapshot *brisk_files_index_snapshot(BriskFilesIndex *index, guint generation,
+                                                    gchar **roots, gchar **pending);
+void brisk_files_index_snapshot_free(BriskFilesIndexSnapshot *snapshot);
+GBytes *brisk_files_index_serialize(BriskFilesIndexSnapshot *snapshot);
+BriskFilesIndex *brisk_files_index_load(const gchar *filename, guint *generation, gchar ***roots,
+                                        gchar ***pending, GError **error);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,216 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "files-item.h"
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+
+struct _BriskFilesItemClass {
+        BriskItemClass parent_class;
+};
+
+/**
+ * BriskFilesItem is a single file found by searching the file index
+ */
+struct _BriskFilesItem {
+        BriskItem parent;
+        gchar *uri;     /**<Our ID, unique and never a .desktop ID */
+        gchar *name;    /**<Display form of the basename */
+        gchar *summary; /**<Containing directory, relative to home */
+        GIcon *icon;    /**<Only guessed once we're displayed */
+};
+
+G_DEFINE_TYPE(BriskFilesItem, brisk_files_item, BRISK_TYPE_ITEM)
+
+static const gchar *brisk_files_item_get_id(BriskItem *item);
+static const gchar *brisk_files_item_get_name(BriskItem *item);
+static const gchar *brisk_files_item_get_summary(BriskItem *item);
+static const GIcon *brisk_files_item_get_icon(BriskItem *item);
+static const gchar *brisk_files_item_get_backend_id(BriskItem *item);
+static gboolean brisk_files_item_matches_search(BriskItem *item, gchar *term);
+static gboolean brisk_files_item_launch(BriskItem *item, GAppLaunchContext *context);
+static gchar *brisk_files_item_get_uri(BriskItem *item);
+
+/**
+ * brisk_files_item_dispose:
+ *
+ * Clean up a BriskFilesItem instance
+ */
+static void brisk_files_item_dispose(GObject *obj)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(obj);
+
+        g_clear_object(&self->icon);
+        g_clear_pointer(&self->uri, g_free);
+        g_clear_pointer(&self->name, g_free);
+        g_clear_pointer(&self->summary, g_free);
+
+        G_OBJECT_CLASS(brisk_files_item_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_files_item_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_files_item_class_init(BriskFilesItemClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskItemClass *i_class = BRISK_ITEM_CLASS(klazz);
+
+        /* item vtable hookup */
+        i_class->get_id = brisk_files_item_get_id;
+        i_class->get_name = brisk_files_item_get_name;
+        i_class->get_display_name = brisk_files_item_get_name;
+        i_class->get_summary = brisk_files_item_get_summary;
+        i_class->get_icon = brisk_files_item_get_icon;
+        i_class->get_backend_id = brisk_files_item_get_backend_id;
+        i_class->matches_search = brisk_files_item_matches_search;
+        i_class->launch = brisk_files_item_launch;
+        i_class->get_uri = brisk_files_item_get_uri;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_files_item_dispose;
+}
+
+/**
+ * brisk_files_item_init:
+ *
+ * Handle construction of the BriskFilesItem
+ */
+static void brisk_files_item_init(__brisk_unused__ BriskFilesItem *self)
+{
+}
+
+static const gchar *brisk_files_item_get_id(BriskItem *item)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(item);
+        return (const gchar *)self->uri;
+}
+
+static const gchar *brisk_files_item_get_name(BriskItem *item)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(item);
+        return (const gchar *)self->name;
+}
+
+static const gchar *brisk_files_item_get_summary(BriskItem *item)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(item);
+        return (const gchar *)self->summary;
+}
+
+/**
+ * Guess the type from the name alone, so that showing a result never has
+ * to touch the disk
+ */
+static const GIcon *brisk_files_item_get_icon(BriskItem *item)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(item);
+        autofree(gchar) *content_type = NULL;
+
+        if (!self->icon) {
+                content_type = g_content_type_guess(self->name, NULL, 0, NULL);
+                self->icon = g_content_type_get_icon(content_type);
+        }
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_files_item_get_backend_id(__brisk_unused__ BriskItem *item)
+{
+        return "files";
+}
+
+/**
+ * The backend only keeps results for the current term around
+ */
+static gboolean brisk_files_item_matches_search(__brisk_unused__ BriskItem *item,
+                                                __brisk_unused__ gchar *term)
+{
+        return TRUE;
+}
+
+/**
+ * Open the file with the default handler for its type
+ */
+static gboolean brisk_files_item_launch(BriskItem *item, GAppLaunchContext *context)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(item);
+        autofree(GError) *error = NULL;
+
+        if (!g_app_info_launch_default_for_uri(self->uri, context, &error)) {
+                g_message("Failed to open %s: %s", self->uri, error->message);
+                return FALSE;
+        }
+        return TRUE;
+}
+
+static gchar *brisk_files_item_get_uri(BriskItem *item)
+{
+        BriskFilesItem *self = BRISK_FILES_ITEM(item);
+        return g_strdup(self->uri);
+}
+
+/**
+ * Show the containing directory relative to home where we can
+ */
+static gchar *brisk_files_item_summarise(const gchar *path)
+{
+        autofree(gchar) *dir = g_path_get_dirname(path);
+        const gchar *home = g_get_home_dir();
+        gsize len = strlen(home);
+
+        if (g_str_has_prefix(dir, home) && (dir[len] == G_DIR_SEPARATOR || dir[len] == '\0')) {
+                autofree(gchar) *relative = g_strconcat("~", dir + len, NULL);
+                return g_filename_display_name(relative);
+        }
+        return g_filename_display_name(dir);
+}
+
+/**
+ * brisk_files_item_new:
+ *
+ * Return a new BriskFilesItem for the given path
+ */
+BriskItem *brisk_files_item_new(const gchar *path)
+{
+        BriskFilesItem *self = NULL;
+        autofree(gchar) *basename = g_path_get_basename(path);
+
+        self = g_object_new(BRISK_TYPE_FILES_ITEM, NULL);
+        self->uri = g_filename_to_uri(path, NULL, NULL);
+        self->name = g_filename_display_name(basename);
+        self->summary = brisk_files_item_summarise(path);
+
+        return BRISK_ITEM(self);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
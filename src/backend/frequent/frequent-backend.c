@@ -0,0 +1,302 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <math.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "frequent-backend.h"
+#include "frequent-section.h"
+#include <glib/gi18n.h>
+BRISK_END_PEDANTIC
+
+G_DEFINE_TYPE(BriskFrequentBackend, brisk_frequent_backend, BRISK_TYPE_BACKEND)
+
+/**
+ * Upper limit on the boost given to search results, so that a frequently
+ * launched item can't outrank a much better textual match
+ */
+#define BRISK_FREQUENT_BOOST_MAX 40
+
+static gboolean brisk_frequent_backend_load(BriskBackend *backend);
+static void brisk_frequent_backend_item_launched(BriskBackend *backend, BriskItem *item);
+static gint brisk_frequent_backend_get_item_boost(BriskBackend *backend, BriskItem *item);
+
+/**
+ * Tell the frontends what we are
+ */
+static unsigned int brisk_frequent_backend_get_flags(__brisk_unused__ BriskBackend *backend)
+{
+        return BRISK_BACKEND_SOURCE;
+}
+
+static const gchar *brisk_frequent_backend_get_id(__brisk_unused__ BriskBackend *backend)
+{
+        return "frequent";
+}
+
+static const gchar *brisk_frequent_backend_get_display_name(__brisk_unused__ BriskBackend *backend)
+{
+        return _("Frequent");
+}
+
+static void brisk_frequent_entry_free(BriskFrequentEntry *entry)
+{
+        g_free(entry->id);
+        g_slice_free(BriskFrequentEntry, entry);
+}
+
+/**
+ * brisk_frequent_backend_dispose:
+ *
+ * Clean up a BriskFrequentBackend instance
+ */
+static void brisk_frequent_backend_dispose(GObject *obj)
+{
+        BriskFrequentBackend *self = BRISK_FREQUENT_BACKEND(obj);
+
+        if (self->compact_id > 0) {
+                g_source_remove(self->compact_id);
+                self->compact_id = 0;
+        }
+        if (self->pending) {
+                brisk_frequent_backend_flush_log(self);
+                g_string_free(self->pending, TRUE);
+                self->pending = NULL;
+        }
+        self->n_top = 0;
+        g_clear_pointer(&self->entries, g_hash_table_unref);
+        g_clear_pointer(&self->log_path, g_free);
+
+        G_OBJECT_CLASS(brisk_frequent_backend_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_frequent_backend_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_frequent_backend_class_init(BriskFrequentBackendClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskBackendClass *b_class = BRISK_BACKEND_CLASS(klazz);
+
+        /* Backend vtable hookup */
+        b_class->get_flags = brisk_frequent_backend_get_flags;
+        b_class->get_id = brisk_frequent_backend_get_id;
+        b_class->get_display_name = brisk_frequent_backend_get_display_name;
+        b_class->load = brisk_frequent_backend_load;
+        b_class->item_launched = brisk_frequent_backend_item_launched;
+        b_class->get_item_boost = brisk_frequent_backend_get_item_boost;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_frequent_backend_dispose;
+}
+
+/**
+ * brisk_frequent_backend_init:
+ *
+ * Handle construction of the BriskFrequentBackend
+ */
+static void brisk_frequent_backend_init(BriskFrequentBackend *self)
+{
+        self->entries = g_hash_table_new_full(g_str_hash,
+                                              g_str_equal,
+                                              NULL,
+                                              (GDestroyNotify)brisk_frequent_entry_free);
+        self->log_path =
+            g_build_filename(g_get_user_data_dir(), "brisk-menu", "launches.log", NULL);
+        self->pending = g_string_new("");
+}
+
+/**
+ * brisk_frequent_backend_load:
+ *
+ * Replay the launch log and then emit our section
+ */
+static gboolean brisk_frequent_backend_load(BriskBackend *backend)
+{
+        BriskFrequentBackend *self = BRISK_FREQUENT_BACKEND(backend);
+
+        brisk_frequent_backend_load_log(self);
+        brisk_backend_section_added(backend, brisk_frequent_section_new(self));
+        return TRUE;
+}
+
+/**
+ * Move the entry up through the top list after its score increased.
+ * Scores only ever grow, so we never need to look downwards.
+ *
+ * Returns TRUE if the visible ranking changed
+ */
+static gboolean brisk_frequent_backend_promote(BriskFrequentBackend *self,
+                                               BriskFrequentEntry *entry)
+{
+        gint pos = entry->rank;
+
+        if (pos < 0) {
+                if (self->n_top < BRISK_FREQUENT_MAX) {
+                        pos = (gint)self->n_top++;
+                } else if (entry->score > self->top[BRISK_FREQUENT_MAX - 1]->score) {
+                        pos = BRISK_FREQUENT_MAX - 1;
+                        self->top[pos]->rank = -1;
+                } else {
+                        return FALSE;
+                }
+                self->top[pos] = entry;
+                entry->rank = pos;
+        } else if (pos == 0 || self->top[pos - 1]->score >= entry->score) {
+                /* Already a member and still in the right place */
+                return FALSE;
+        }
+
+        while (pos > 0 && self->top[pos - 1]->score < entry->score) {
+                self->top[pos] = self->top[pos - 1];
+                self->top[pos]->rank = pos;
+                --pos;
+        }
+        self->top[pos] = entry;
+        entry->rank = pos;
+
+        return TRUE;
+}
+
+/**
+ * brisk_frequent_backend_record:
+ *
+ * Merge a (log2) launch weight into the entry for the given ID, creating it
+ * if needed. Returns TRUE if the top list changed as a result.
+ */
+gboolean brisk_frequent_backend_record(BriskFrequentBackend *self, const gchar *id, gdouble score)
+{
+        BriskFrequentEntry *entry = NULL;
+        gdouble hi, lo;
+
+        entry = g_hash_table_lookup(self->entries, id);
+        if (!entry) {
+                entry = g_slice_new0(BriskFrequentEntry);
+                entry->id = g_strdup(id);
+                entry->score = score;
+                entry->rank = -1;
+                g_hash_table_insert(self->entries, entry->id, entry);
+                return brisk_frequent_backend_promote(self, entry);
+        }
+
+        /* Add the weights without leaving log space */
+        hi = MAX(entry->score, score);
+        lo = MIN(entry->score, score);
+        entry->score = hi + log2(1.0 + exp2(lo - hi));
+
+        return brisk_frequent_backend_promote(self, entry);
+}
+
+/**
+ * Current log2 weight of a launch happening right now
+ */
+static inline gdouble brisk_frequent_backend_now(void)
+{
+        return ((gdouble)g_get_real_time() / G_USEC_PER_SEC) / BRISK_FREQUENT_HALF_LIFE;
+}
+
+/**
+ * An item was launched by the user, so bump it and keep the log up to date
+ */
+static void brisk_frequent_backend_item_launched(BriskBackend *backend, BriskItem *item)
+{
+        BriskFrequentBackend *self = BRISK_FREQUENT_BACKEND(backend);
+        const gchar *id = brisk_item_get_id(item);
+        gdouble score = brisk_frequent_backend_now();
+
+        if (!id) {
+                return;
+        }
+
+        brisk_frequent_backend_append_log(self, id, score);
+        if (brisk_frequent_backend_record(self, id, score)) {
+                brisk_backend_invalidate_filter(backend);
+        }
+}
+
+/**
+ * Convert the decayed weight of the item into a small bonus for search ranking.
+ * A single launch today is worth a handful of points, a daily driver maxes out.
+ */
+static gint brisk_frequent_backend_get_item_boost(BriskBackend *backend, BriskItem *item)
+{
+        BriskFrequentBackend *self = BRISK_FREQUENT_BACKEND(backend);
+        BriskFrequentEntry *entry = NULL;
+        gdouble weight;
+
+        entry = g_hash_table_lookup(self->entries, brisk_item_get_id(item));
+        if (!entry) {
+                return 0;
+        }
+
+        weight = exp2(entry->score - brisk_frequent_backend_now());
+        return (gint)MIN(weight * 8.0, BRISK_FREQUENT_BOOST_MAX);
+}
+
+/**
+ * brisk_frequent_backend_get_item_order:
+ *
+ * Return the position of the item within the Frequent section, or -1 if it
+ * isn't considered frequent.
+ */
+gint brisk_frequent_backend_get_item_order(BriskFrequentBackend *self, BriskItem *item)
+{
+        BriskFrequentEntry *entry = NULL;
+
+        entry = g_hash_table_lookup(self->entries, brisk_item_get_id(item));
+        if (!entry) {
+                return -1;
+        }
+        return entry->rank;
+}
+
+/**
+ * brisk_frequent_backend_get_top_id:
+ *
+ * Return the ID of the item at the given position within the Frequent
+ * section, or NULL if the section holds fewer items than that.
+ */
+const gchar *brisk_frequent_backend_get_top_id(BriskFrequentBackend *self, guint index)
+{
+        if (index >= self->n_top) {
+                return NULL;
+        }
+        return self->top[index]->id;
+}
+
+/**
+ * brisk_frequent_backend_new:
+ *
+ * Return a newly created BriskFrequentBackend
+ */
+BriskBackend *brisk_frequent_backend_new(void)
+{
+        return g_object_new(BRISK_TYPE_FREQUENT_BACKEND, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
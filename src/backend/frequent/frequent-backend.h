@@ -0,0 +1,113 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include "../backend.h"
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * How many items we'll show in the Frequent section
+ */
+#define BRISK_FREQUENT_MAX 12
+
+/**
+ * Launches lose half of their weight over this many seconds (3 days)
+ */
+#define BRISK_FREQUENT_HALF_LIFE 259200.0
+
+/**
+ * How long launch records may sit in memory before they're appended (s)
+ */
+#define BRISK_FREQUENT_FLUSH_INTERVAL 5
+
+typedef struct _BriskFrequentBackend BriskFrequentBackend;
+typedef struct _BriskFrequentBackendClass BriskFrequentBackendClass;
+
+/**
+ * A single item known to the launch log.
+ *
+ * The score is stored as log2 of the sum of all launch weights, where each
+ * launch weighs 2^(timestamp / half-life). As every entry decays at the same
+ * rate, the relative order never changes with time and only the item being
+ * launched has to move within the ranking.
+ */
+typedef struct BriskFrequentEntry {
+        gchar *id;
+        gdouble score;
+        gint rank; /**<Position within the top list, or -1 */
+} BriskFrequentEntry;
+
+struct _BriskFrequentBackendClass {
+        BriskBackendClass parent_class;
+};
+
+/**
+ * BriskFrequentBackend tracks launches and exposes the most used items
+ */
+struct _BriskFrequentBackend {
+        BriskBackend parent;
+        GHashTable *entries;
+        BriskFrequentEntry *top[BRISK_FREQUENT_MAX];
+        guint n_top;
+
+        /* Launch log management */
+        gchar *log_path;
+        guint n_records;
+        guint compact_id;
+        GString *pending; /**<Records not yet appended to the log */
+        guint flush_id;
+        gboolean flushing; /**<A worker is appending to the log */
+};
+
+#define BRISK_TYPE_FREQUENT_BACKEND brisk_frequent_backend_get_type()
+#define BRISK_FREQUENT_BACKEND(o)                                                                  \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_FREQUENT_BACKEND, BriskFrequentBackend))
+#define BRISK_IS_FREQUENT_BACKEND(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_FREQUENT_BACKEND))
+#define BRISK_FREQUENT_BACKEND_CLASS(o)                                                            \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_FREQUENT_BACKEND, BriskFrequentBackendClass))
+#define BRISK_IS_FREQUENT_BACKEND_CLASS(o)                                                         \
+        (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_FREQUENT_BACKEND))
+#define BRISK_FREQUENT_BACKEND_GET_CLASS(o)                                                        \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_FREQUENT_BACKEND, BriskFrequentBackendClass))
+
+GType brisk_frequent_backend_get_type(void);
+
+BriskBackend *brisk_frequent_backend_new(void);
+
+gint brisk_frequent_backend_get_item_order(BriskFrequentBackend *self, BriskItem *item);
+const gchar *brisk_frequent_backend_get_top_id(BriskFrequentBackend *self, guint index);
+gboolean brisk_frequent_backend_record(BriskFrequentBackend *self, const gchar *id,
+                                       gdouble score);
+
+/* Launch log, see frequent-log.c */
+void brisk_frequent_backend_load_log(BriskFrequentBackend *self);
+void brisk_frequent_backend_append_log(BriskFrequentBackend *self, const gchar *id,
+                                       gdouble score);
+void brisk_frequent_backend_queue_compact(BriskFrequentBackend *self);
+void brisk_frequent_backend_flush_log(BriskFrequentBackend *self);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,369 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "frequent-backend.h"
+#include <glib/gstdio.h>
+BRISK_END_PEDANTIC
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+
+static inline void _g_string_clean(GString *str)
+{
+        g_string_free(str, TRUE);
+}
+DEF_AUTOFREE(GString, _g_string_clean)
+
+/**
+ * The launch log is a plain text file with one record per line:
+ *
+ *      <log2 weight> <item id>
+ *
+ * Every launch appends a single record. Records are batched up in memory and
+ * appended from a worker, so launching never waits on the disk. Compaction
+ * folds all records for an item into one, so the file stays proportional to
+ * the number of items rather than the number of launches.
+ */
+
+/**
+ * Allow this many redundant records before we rewrite the log
+ */
+#define BRISK_FREQUENT_COMPACT_SLACK 64
+
+/**
+ * Items that decayed this many half-lives are forgotten on compaction
+ */
+#define BRISK_FREQUENT_FORGET_AFTER 16.0
+
+/**
+ * Determine whether the log has grown enough to warrant compaction
+ */
+static inline gboolean brisk_frequent_backend_needs_compact(BriskFrequentBackend *self)
+{
+        return self->n_records > g_hash_table_size(self->entries) + BRISK_FREQUENT_COMPACT_SLACK;
+}
+
+/**
+ * brisk_frequent_backend_load_log:
+ *
+ * Replay the on-disk log into the entries table and ranking
+ */
+void brisk_frequent_backend_load_log(BriskFrequentBackend *self)
+{
+        autofree(gchar) *contents = NULL;
+        autofree(GError) *error = NULL;
+        gchar *line = NULL;
+        gchar *next = NULL;
+
+        if (!g_file_get_contents(self->log_path, &contents, NULL, &error)) {
+                if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+                        g_warning("Failed to read launch log: %s", error->message);
+                }
+                return;
+        }
+
+        for (line = contents; line && *line != '\0'; line = next) {
+                gchar *end = NULL;
+                gdouble score;
+
+                next = strchr(line, '\n');
+                if (next) {
+                        *next++ = '\0';
+                }
+
+                score = g_ascii_strtod(line, &end);
+                if (end == line || *end != ' ' || *(end + 1) == '\0') {
+                        continue;
+                }
+
+                brisk_frequent_backend_record(self, end + 1, score);
+                ++self->n_records;
+        }
+
+        if (brisk_frequent_backend_needs_compact(self)) {
+                brisk_frequent_backend_queue_compact(self);
+        }
+}
+
+/**
+ * What a flush worker needs, none of which is shared with the backend
+ */
+typedef struct BriskFrequentFlush {
+        gchar *path;
+        gchar *records;
+} BriskFrequentFlush;
+
+static void brisk_frequent_flush_free(BriskFrequentFlush *flush)
+{
+        g_free(flush->path);
+        g_free(flush->records);
+        g_slice_free(BriskFrequentFlush, flush);
+}
+
+/**
+ * Append the records to the log, from whichever thread we're on
+ */
+static gboolean brisk_frequent_log_append(const gchar *path, const gchar *records, GError **error)
+{
+        autofree(gchar) *dir = NULL;
+        FILE *fp = NULL;
+        gboolean ok;
+
+        dir = g_path_get_dirname(path);
+        if (g_mkdir_with_parents(dir, 00700) != 0) {
+                g_set_error(error,
+                            G_FILE_ERROR,
+                            g_file_error_from_errno(errno),
+                            "Failed to create %s",
+                            dir);
+                return FALSE;
+        }
+
+        fp = g_fopen(path, "a");
+        if (!fp) {
+                g_set_error(error,
+                            G_FILE_ERROR,
+                            g_file_error_from_errno(errno),
+                            "Failed to open %s",
+                            path);
+                return FALSE;
+        }
+
+        ok = fputs(records, fp) >= 0;
+        ok = fclose(fp) == 0 && ok;
+        if (!ok) {
+                g_set_error(error,
+                            G_FILE_ERROR,
+                            g_file_error_from_errno(errno),
+                            "Failed to write %s",
+                            path);
+        }
+        return ok;
+}
+
+static void brisk_frequent_backend_flush_thread(GTask *task, __brisk_unused__ gpointer source,
+                                                gpointer v, __brisk_unused__ GCancellable *cancel)
+{
+        BriskFrequentFlush *flush = v;
+        GError *error = NULL;
+
+        if (!brisk_frequent_log_append(flush->path, flush->records, &error)) {
+                g_task_return_error(task, error);
+                return;
+        }
+        g_task_return_boolean(task, TRUE);
+}
+
+static void brisk_frequent_backend_queue_flush(BriskFrequentBackend *self);
+
+/**
+ * The entries already hold every launch, so a failed append is made good
+ * by the next compaction
+ */
+static void brisk_frequent_backend_flush_done(GObject *source, GAsyncResult *result,
+                                              __brisk_unused__ gpointer v)
+{
+        BriskFrequentBackend *self = BRISK_FREQUENT_BACKEND(source);
+        autofree(GError) *error = NULL;
+
+        self->flushing = FALSE;
+        if (!g_task_propagate_boolean(G_TASK(result), &error)) {
+                g_warning("Failed to append to launch log: %s", error->message);
+        }
+
+        /* Compaction waits for us, so that it never races the append */
+        if (brisk_frequent_backend_needs_compact(self)) {
+                brisk_frequent_backend_queue_compact(self);
+        } else if (self->pending->len > 0) {
+                brisk_frequent_backend_queue_flush(self);
+        }
+}
+
+/**
+ * Hand everything recorded since the last flush over to a worker. Only one
+ * flush is in flight at a time, so records land in launch order.
+ */
+static gboolean brisk_frequent_backend_flush(BriskFrequentBackend *self)
+{
+        BriskFrequentFlush *flush = NULL;
+        GTask *task = NULL;
+
+        self->flush_id = 0;
+
+        /* flush_done picks up whatever was recorded in the meantime */
+        if (self->flushing || self->pending->len == 0) {
+                return G_SOURCE_REMOVE;
+        }
+
+        flush = g_slice_new0(BriskFrequentFlush);
+        flush->path = g_strdup(self->log_path);
+        flush->records = g_strdup(self->pending->str);
+        g_string_truncate(self->pending, 0);
+
+        task = g_task_new(self, NULL, brisk_frequent_backend_flush_done, NULL);
+        g_task_set_task_data(task, flush, (GDestroyNotify)brisk_frequent_flush_free);
+        self->flushing = TRUE;
+        g_task_run_in_thread(task, brisk_frequent_backend_flush_thread);
+        g_object_unref(task);
+
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * Coalesce launches into a single append every so often
+ */
+static void brisk_frequent_backend_queue_flush(BriskFrequentBackend *self)
+{
+        if (self->flush_id > 0) {
+                return;
+        }
+        self->flush_id = g_timeout_add_seconds(BRISK_FREQUENT_FLUSH_INTERVAL,
+                                               (GSourceFunc)brisk_frequent_backend_flush,
+                                               self);
+}
+
+/**
+ * brisk_frequent_backend_flush_log:
+ *
+ * The backend is going away, so append what's left right here rather than
+ * leave it to a worker nobody will hear back from. Any flush still in flight
+ * holds a reference to us, so it can't be racing this one.
+ */
+void brisk_frequent_backend_flush_log(BriskFrequentBackend *self)
+{
+        autofree(GError) *error = NULL;
+
+        if (self->flush_id > 0) {
+                g_source_remove(self->flush_id);
+                self->flush_id = 0;
+        }
+        if (self->pending->len == 0) {
+                return;
+        }
+
+        if (!brisk_frequent_log_append(self->log_path, self->pending->str, &error)) {
+                g_warning("Failed to append to launch log: %s", error->message);
+        }
+        g_string_truncate(self->pending, 0);
+}
+
+/**
+ * brisk_frequent_backend_append_log:
+ *
+ * Record a single launch, to be appended to the log shortly
+ */
+void brisk_frequent_backend_append_log(BriskFrequentBackend *self, const gchar *id, gdouble score)
+{
+        gchar buf[G_ASCII_DTOSTR_BUF_SIZE] = { 0 };
+
+        g_string_append_printf(self->pending,
+                               "%s %s\n",
+                               g_ascii_formatd(buf, sizeof(buf), "%.6f", score),
+                               id);
+
+        ++self->n_records;
+        if (brisk_frequent_backend_needs_compact(self)) {
+                brisk_frequent_backend_queue_compact(self);
+                return;
+        }
+        brisk_frequent_backend_queue_flush(self);
+}
+
+/**
+ * Rewrite the log with a single record per entry, dropping anything that
+ * hasn't been launched in a very long time.
+ */
+static gboolean brisk_frequent_backend_compact(BriskFrequentBackend *self)
+{
+        autofree(GString) *str = NULL;
+        autofree(GError) *error = NULL;
+        GHashTableIter iter;
+        BriskFrequentEntry *entry = NULL;
+        gchar buf[G_ASCII_DTOSTR_BUF_SIZE] = { 0 };
+        gdouble now, cutoff;
+
+        self->compact_id = 0;
+
+        /* Picked up again once the append is done */
+        if (self->flushing) {
+                return G_SOURCE_REMOVE;
+        }
+
+        now = ((gdouble)g_get_real_time() / G_USEC_PER_SEC) / BRISK_FREQUENT_HALF_LIFE;
+        cutoff = now - BRISK_FREQUENT_FORGET_AFTER;
+        str = g_string_new("");
+
+        g_hash_table_iter_init(&iter, self->entries);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&entry)) {
+                /* Forgotten entries can't be ranked, nothing points at them */
+                if (entry->score < cutoff && entry->rank < 0) {
+                        g_hash_table_iter_remove(&iter);
+                        continue;
+                }
+                g_string_append_printf(str,
+                                       "%s %s\n",
+                                       g_ascii_formatd(buf, sizeof(buf), "%.6f", entry->score),
+                                       entry->id);
+        }
+
+        if (!g_file_set_contents(self->log_path, str->str, (gssize)str->len, &error)) {
+                g_warning("Failed to compact launch log: %s", error->message);
+                brisk_frequent_backend_queue_flush(self);
+                return G_SOURCE_REMOVE;
+        }
+
+        /* Anything still waiting to be appended is in there already */
+        g_string_truncate(self->pending, 0);
+        if (self->flush_id > 0) {
+                g_source_remove(self->flush_id);
+                self->flush_id = 0;
+        }
+        self->n_records = g_hash_table_size(self->entries);
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * brisk_frequent_backend_queue_compact:
+ *
+ * Schedule a compaction of the log for when we're idle
+ */
+void brisk_frequent_backend_queue_compact(BriskFrequentBackend *self)
+{
+        if (self->compact_id > 0) {
+                return;
+        }
+        self->compact_id = g_idle_add_full(G_PRIORITY_LOW,
+                                           (GSourceFunc)brisk_frequent_backend_compact,
+                                           self,
+                                           NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,194 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "frequent-backend.h"
+#include "frequent-section.h"
+#include <gio/gio.h>
+#include <glib/gi18n.h>
+BRISK_END_PEDANTIC
+
+struct _BriskFrequentSectionClass {
+        BriskSectionClass parent_class;
+};
+
+struct _BriskFrequentSection {
+        BriskSection parent;
+        GIcon *icon; /**<Display icon */
+        BriskFrequentBackend *backend;
+};
+
+G_DEFINE_TYPE(BriskFrequentSection, brisk_frequent_section, BRISK_TYPE_SECTION)
+
+enum { PROP_BACKEND = 1, N_PROPS };
+
+static GParamSpec *obj_properties[N_PROPS] = {
+        NULL,
+};
+
+static void brisk_frequent_section_set_property(GObject *object, guint id, const GValue *value,
+                                                GParamSpec *spec)
+{
+        BriskFrequentSection *self = BRISK_FREQUENT_SECTION(object);
+
+        switch (id) {
+        case PROP_BACKEND:
+                self->backend = g_value_get_pointer(value);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID(object, id, spec);
+                break;
+        }
+}
+
+static void brisk_frequent_section_get_property(GObject *object, guint id, GValue *value,
+                                                GParamSpec *spec)
+{
+        BriskFrequentSection *self = BRISK_FREQUENT_SECTION(object);
+
+        switch (id) {
+        case PROP_BACKEND:
+                g_value_set_pointer(value, self->backend);
+                break;
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID(object, id, spec);
+                break;
+        }
+}
+
+/**
+ * Basic subclassing
+ */
+static const gchar *brisk_frequent_section_get_id(BriskSection *section);
+static const gchar *brisk_frequent_section_get_name(BriskSection *section);
+static const GIcon *brisk_frequent_section_get_icon(BriskSection *section);
+static const gchar *brisk_frequent_section_get_backend_id(BriskSection *section);
+static gint brisk_frequent_section_get_sort_order(BriskSection *section, BriskItem *item);
+static gboolean brisk_frequent_section_can_show_item(BriskSection *section, BriskItem *item);
+
+/**
+ * brisk_frequent_section_dispose:
+ *
+ * Clean up a BriskFrequentSection instance
+ */
+static void brisk_frequent_section_dispose(GObject *obj)
+{
+        BriskFrequentSection *self = BRISK_FREQUENT_SECTION(obj);
+
+        g_clear_object(&self->icon);
+
+        G_OBJECT_CLASS(brisk_frequent_section_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_frequent_section_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_frequent_section_class_init(BriskFrequentSectionClass *klazz)
+{
+        BriskSectionClass *s_class = BRISK_SECTION_CLASS(klazz);
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+
+        /* item vtable hookup */
+        s_class->get_id = brisk_frequent_section_get_id;
+        s_class->get_name = brisk_frequent_section_get_name;
+        s_class->get_icon = brisk_frequent_section_get_icon;
+        s_class->get_backend_id = brisk_frequent_section_get_backend_id;
+        s_class->can_show_item = brisk_frequent_section_can_show_item;
+        s_class->get_sort_order = brisk_frequent_section_get_sort_order;
+
+        obj_class->dispose = brisk_frequent_section_dispose;
+        obj_class->set_property = brisk_frequent_section_set_property;
+        obj_class->get_property = brisk_frequent_section_get_property;
+
+        obj_properties[PROP_BACKEND] = g_param_spec_pointer("backend",
+                                                            "The BriskBackend",
+                                                            "Owning backend for this section",
+                                                            G_PARAM_CONSTRUCT | G_PARAM_READWRITE);
+        g_object_class_install_properties(obj_class, N_PROPS, obj_properties);
+}
+
+/**
+ * brisk_frequent_section_init:
+ *
+ * Handle construction of the BriskFrequentSection. Does absolutely nothing
+ * special outside of creating our icon.
+ */
+static void brisk_frequent_section_init(BriskFrequentSection *self)
+{
+        self->icon = g_themed_icon_new_with_default_fallbacks("document-open-recent");
+}
+
+static const gchar *brisk_frequent_section_get_id(__brisk_unused__ BriskSection *section)
+{
+        return "frequent";
+}
+
+static const gchar *brisk_frequent_section_get_name(__brisk_unused__ BriskSection *section)
+{
+        return _("Frequent");
+}
+
+static const GIcon *brisk_frequent_section_get_icon(BriskSection *section)
+{
+        BriskFrequentSection *self = BRISK_FREQUENT_SECTION(section);
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_frequent_section_get_backend_id(__brisk_unused__ BriskSection *item)
+{
+        return "frequent";
+}
+
+/**
+ * Only items currently within the top list are shown
+ */
+static gboolean brisk_frequent_section_can_show_item(BriskSection *section, BriskItem *item)
+{
+        BriskFrequentSection *self = BRISK_FREQUENT_SECTION(section);
+
+        return brisk_frequent_backend_get_item_order(self->backend, item) >= 0;
+}
+
+static gint brisk_frequent_section_get_sort_order(BriskSection *section, BriskItem *item)
+{
+        BriskFrequentSection *self = BRISK_FREQUENT_SECTION(section);
+
+        return brisk_frequent_backend_get_item_order(self->backend, item);
+}
+
+/**
+ * brisk_frequent_section_new:
+ *
+ * Return a new BriskFrequentSection
+ */
+BriskSection *brisk_frequent_section_new(BriskFrequentBackend *backend)
+{
+        return g_object_new(BRISK_TYPE_FREQUENT_SECTION, "backend", backend, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -148,6 +148,35 @@ gboolean brisk_item_matches_search(BriskItem *item, gchar *term)
         return klazz->matches_search(item, term);
 }
 
+/**
+ * brisk_item_search:
+ *
+ * Match the item against the folded term and score it with the per-field
+ * weights, so that results can be ranked without matching them again.
+ *
+ * Returns TRUE if the item matches the given search term
+ */
+gboolean brisk_item_search(BriskItem *item, const gchar *term, const gint *weights,
+                           BriskSearchMatch *match)
+{
+        g_assert(item != NULL);
+        BriskItemClass *klazz = BRISK_ITEM_GET_CLASS(item);
+
+        if (klazz->search) {
+                return klazz->search(item, term, weights, match);
+        }
+        if (!brisk_item_matches_search(item, (gchar *)term)) {
+                return FALSE;
+        }
+
+        match->score = weights[BRISK_SEARCH_FIELD_OTHER];
+        match->field = BRISK_SEARCH_FIELD_OTHER;
+        match->key = -1;
+        match->offset = 0;
+        match->length = 0;
+        return TRUE;
+}
+
 /**
  * brisk_item_launch:
  *
@@ -176,6 +205,23 @@ gchar *brisk_item_get_uri(BriskItem *item)
         return klazz->get_uri(item);
 }
 
+/**
+ * brisk_item_get_app_info:
+ *
+ * Return the GAppInfo backing this item, if any. The GAppInfo is owned by
+ * the item and may be launched from a worker thread, so implementations must
+ * not hand out anything that is tied to the main thread.
+ */
+GAppInfo *brisk_item_get_app_info(BriskItem *item)
+{
+        g_assert(item != NULL);
+        BriskItemClass *klazz = BRISK_ITEM_GET_CLASS(item);
+        if (!klazz->get_app_info) {
+                return NULL;
+        }
+        return klazz->get_app_info(item);
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
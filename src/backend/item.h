@@ -14,6 +14,8 @@
 #include <gio/gio.h>
 #include <glib-object.h>
 
+#include "search.h"
+
 G_BEGIN_DECLS
 
 typedef struct _BriskItem BriskItem;
@@ -39,7 +41,15 @@ struct _BriskItemClass {
         /* For drag & drop */
         gchar *(*get_uri)(BriskItem *);
 
-        gpointer padding[12];
+        /* Optional, items backed by a GAppInfo return it here so that the frontend
+         * can launch them away from the main thread */
+        GAppInfo *(*get_app_info)(BriskItem *);
+
+        /* Optional, items that know which field matched return a weighted match
+         * here, everything else is scored as BRISK_SEARCH_FIELD_OTHER */
+        gboolean (*search)(BriskItem *, const gchar *, const gint *, BriskSearchMatch *);
+
+        gpointer padding[10];
 };
 
 /**
@@ -69,11 +79,14 @@ const gchar *brisk_item_get_summary(BriskItem *item);
 const GIcon *brisk_item_get_icon(BriskItem *item);
 const gchar *brisk_item_get_backend_id(BriskItem *item);
 gboolean brisk_item_matches_search(BriskItem *item, gchar *term);
+gboolean brisk_item_search(BriskItem *item, const gchar *term, const gint *weights,
+                           BriskSearchMatch *match);
 
 /* Attempt to launch this item */
 gboolean brisk_item_launch(BriskItem *item, GAppLaunchContext *context);
 
 gchar *brisk_item_get_uri(BriskItem *item);
+GAppInfo *brisk_item_get_app_info(BriskItem *item);
 
 G_END_DECLS
 
@@ -0,0 +1,588 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "config.h"
+#include "plugin-backend.h"
+#include "plugin-section.h"
+#include <gmodule.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GKeyFile, g_key_file_unref)
+
+/* Helper for search path splitting */
+typedef gchar *gstrv;
+DEF_AUTOFREE(gstrv, g_strfreev)
+
+struct _BriskPluginBackendClass {
+        BriskBackendClass parent_class;
+};
+
+/**
+ * BriskPluginBackend stands in for a backend living in a shared module.
+ *
+ * Until the user opens our placeholder section, the plugin costs nothing more
+ * than its description. After that every call and signal is forwarded to and
+ * from the real backend.
+ */
+struct _BriskPluginBackend {
+        BriskBackend parent;
+
+        gchar *id;
+        gchar *name;
+        GIcon *icon;
+        gchar *module_path;
+
+        BriskSection *section; /**<Placeholder within the sidebar */
+        GPtrArray *maps;       /**<Action maps to hand to the real backend, held weakly */
+
+        GModule *module;
+        BriskBackend *backend; /**<Real backend, once loaded */
+        gboolean failed;       /**<Don't keep retrying broken plugins */
+};
+
+G_DEFINE_TYPE(BriskPluginBackend, brisk_plugin_backend, BRISK_TYPE_BACKEND)
+
+static gboolean brisk_plugin_backend_load(BriskBackend *backend);
+static void brisk_plugin_backend_register_actions(BriskBackend *backend, GActionMap *map);
+static GMenu *brisk_plugin_backend_get_item_actions(BriskBackend *backend, BriskItem *item);
+static void brisk_plugin_backend_item_launched(BriskBackend *backend, BriskItem *item);
+static gint brisk_plugin_backend_get_item_boost(BriskBackend *backend, BriskItem *item);
+static void brisk_plugin_backend_section_activated(BriskBackend *backend, BriskSection *section);
+static void brisk_plugin_backend_search_changed(BriskBackend *backend, const gchar *term);
+static void brisk_plugin_backend_map_gone(BriskPluginBackend *self, GObject *map);
+
+/**
+ * We always need load() so that the placeholder can be added
+ */
+static unsigned int brisk_plugin_backend_get_flags(__brisk_unused__ BriskBackend *backend)
+{
+        return BRISK_BACKEND_SOURCE;
+}
+
+static const gchar *brisk_plugin_backend_get_id(BriskBackend *backend)
+{
+        return BRISK_PLUGIN_BACKEND(backend)->id;
+}
+
+static const gchar *brisk_plugin_backend_get_display_name(BriskBackend *backend)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        if (self->backend) {
+                return brisk_backend_get_display_name(self->backend);
+        }
+        return self->name;
+}
+
+/**
+ * brisk_plugin_backend_dispose:
+ *
+ * Clean up a BriskPluginBackend instance
+ */
+static void brisk_plugin_backend_dispose(GObject *obj)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(obj);
+
+        if (self->backend) {
+                g_signal_handlers_disconnect_by_data(self->backend, self);
+                g_clear_object(&self->backend);
+        }
+
+        /* Resident, so this only drops our handle on it */
+        if (self->module) {
+                g_module_close(self->module);
+                self->module = NULL;
+        }
+
+        g_clear_object(&self->section);
+        g_clear_object(&self->icon);
+        for (guint i = 0; self->maps && i < self->maps->len; i++) {
+                g_object_weak_unref(self->maps->pdata[i],
+                                    (GWeakNotify)brisk_plugin_backend_map_gone,
+                                    self);
+        }
+        g_clear_pointer(&self->maps, g_ptr_array_unref);
+        g_clear_pointer(&self->id, g_free);
+        g_clear_pointer(&self->name, g_free);
+        g_clear_pointer(&self->module_path, g_free);
+
+        G_OBJECT_CLASS(brisk_plugin_backend_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_plugin_backend_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_plugin_backend_class_init(BriskPluginBackendClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskBackendClass *b_class = BRISK_BACKEND_CLASS(klazz);
+
+        /* Backend vtable hookup */
+        b_class->get_flags = brisk_plugin_backend_get_flags;
+        b_class->get_id = brisk_plugin_backend_get_id;
+        b_class->get_display_name = brisk_plugin_backend_get_display_name;
+        b_class->load = brisk_plugin_backend_load;
+        b_class->register_actions = brisk_plugin_backend_register_actions;
+        b_class->get_item_actions = brisk_plugin_backend_get_item_actions;
+        b_class->item_launched = brisk_plugin_backend_item_launched;
+        b_class->get_item_boost = brisk_plugin_backend_get_item_boost;
+        b_class->section_activated = brisk_plugin_backend_section_activated;
+        b_class->search_changed = brisk_plugin_backend_search_changed;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_plugin_backend_dispose;
+}
+
+/**
+ * brisk_plugin_backend_init:
+ *
+ * Handle construction of the BriskPluginBackend
+ */
+static void brisk_plugin_backend_init(BriskPluginBackend *self)
+{
+        self->maps = g_ptr_array_new();
+}
+
+/**
+ * Put our placeholder (back) into the sidebar
+ */
+static void brisk_plugin_backend_add_placeholder(BriskPluginBackend *self)
+{
+        brisk_plugin_section_set_delegate(BRISK_PLUGIN_SECTION(self->section), NULL);
+        brisk_backend_section_added(BRISK_BACKEND(self), self->section);
+}
+
+/**
+ * brisk_plugin_backend_load:
+ *
+ * Only the placeholder is emitted here, the module stays on disk
+ */
+static gboolean brisk_plugin_backend_load(BriskBackend *backend)
+{
+        brisk_plugin_backend_add_placeholder(BRISK_PLUGIN_BACKEND(backend));
+        return TRUE;
+}
+
+/**
+ * Signal forwarding from the real backend, so that frontends only ever deal
+ * with us
+ */
+static void brisk_plugin_backend_forward_item_added(__brisk_unused__ BriskBackend *backend,
+                                                    BriskItem *item, BriskPluginBackend *self)
+{
+        brisk_backend_item_added(BRISK_BACKEND(self), item);
+}
+
+static void brisk_plugin_backend_forward_item_removed(__brisk_unused__ BriskBackend *backend,
+                                                      const gchar *id, BriskPluginBackend *self)
+{
+        brisk_backend_item_removed(BRISK_BACKEND(self), id);
+}
+
+static void brisk_plugin_backend_forward_item_changed(__brisk_unused__ BriskBackend *backend,
+                                                      const gchar *id, BriskPluginBackend *self)
+{
+        brisk_backend_item_changed(BRISK_BACKEND(self), id);
+}
+
+static void brisk_plugin_backend_forward_actions_changed(__brisk_unused__ BriskBackend *backend,
+                                                         const gchar *id, BriskPluginBackend *self)
+{
+        brisk_backend_actions_changed(BRISK_BACKEND(self), id);
+}
+
+/**
+ * The first section of the plugin takes over our placeholder, so that the
+ * button the user just clicked stays put. Any others get their own buttons.
+ */
+static void brisk_plugin_backend_forward_section_added(__brisk_unused__ BriskBackend *backend,
+                                                       BriskSection *section,
+                                                       BriskPluginBackend *self)
+{
+        BriskPluginSection *placeholder = BRISK_PLUGIN_SECTION(self->section);
+
+        if (!brisk_plugin_section_get_delegate(placeholder)) {
+                brisk_plugin_section_set_delegate(placeholder, section);
+                brisk_backend_invalidate_filter(BRISK_BACKEND(self));
+                return;
+        }
+        brisk_backend_section_added(BRISK_BACKEND(self), section);
+}
+
+static void brisk_plugin_backend_forward_section_removed(__brisk_unused__ BriskBackend *backend,
+                                                         const gchar *id, BriskPluginBackend *self)
+{
+        brisk_backend_section_removed(BRISK_BACKEND(self), id);
+}
+
+static void brisk_plugin_backend_forward_invalidate_filter(__brisk_unused__ BriskBackend *backend,
+                                                           BriskPluginBackend *self)
+{
+        brisk_backend_invalidate_filter(BRISK_BACKEND(self));
+}
+
+static void brisk_plugin_backend_forward_hide_menu(__brisk_unused__ BriskBackend *backend,
+                                                   BriskPluginBackend *self)
+{
+        brisk_backend_hide_menu(BRISK_BACKEND(self));
+}
+
+/**
+ * Frontends drop every section of ours on reset, so the placeholder has to
+ * go back in before the plugin emits its sections again
+ */
+static void brisk_plugin_backend_forward_reset(__brisk_unused__ BriskBackend *backend,
+                                               BriskPluginBackend *self)
+{
+        brisk_backend_reset(BRISK_BACKEND(self));
+        brisk_plugin_backend_add_placeholder(self);
+}
+
+/**
+ * Hook up the real backend after construction
+ */
+static void brisk_plugin_backend_adopt(BriskPluginBackend *self, BriskBackend *backend)
+{
+        self->backend = backend;
+
+        g_signal_connect(backend,
+                         "item-added",
+                         G_CALLBACK(brisk_plugin_backend_forward_item_added),
+                         self);
+        g_signal_connect(backend,
+                         "item-removed",
+                         G_CALLBACK(brisk_plugin_backend_forward_item_removed),
+                         self);
+        g_signal_connect(backend,
+                         "item-changed",
+                         G_CALLBACK(brisk_plugin_backend_forward_item_changed),
+                         self);
+        g_signal_connect(backend,
+                         "actions-changed",
+                         G_CALLBACK(brisk_plugin_backend_forward_actions_changed),
+                         self);
+        g_signal_connect(backend,
+                         "section-added",
+                         G_CALLBACK(brisk_plugin_backend_forward_section_added),
+                         self);
+        g_signal_connect(backend,
+                         "section-removed",
+                         G_CALLBACK(brisk_plugin_backend_forward_section_removed),
+                         self);
+        g_signal_connect(backend,
+                         "invalidate-filter",
+                         G_CALLBACK(brisk_plugin_backend_forward_invalidate_filter),
+                         self);
+        g_signal_connect(backend,
+                         "hide-menu",
+                         G_CALLBACK(brisk_plugin_backend_forward_hide_menu),
+                         self);
+        g_signal_connect(backend, "reset", G_CALLBACK(brisk_plugin_backend_forward_reset), self);
+
+        for (guint i = 0; i < self->maps->len; i++) {
+                brisk_backend_register_actions(backend, self->maps->pdata[i]);
+        }
+}
+
+/**
+ * Open the module and construct the real backend. We only ever try this once,
+ * a broken plugin simply leaves an empty section behind.
+ */
+static gboolean brisk_plugin_backend_instantiate(BriskPluginBackend *self)
+{
+        BriskPluginCreateFunc create = NULL;
+        BriskBackend *backend = NULL;
+
+        if (self->backend) {
+                return TRUE;
+        }
+        if (self->failed) {
+                return FALSE;
+        }
+        self->failed = TRUE;
+
+        self->module = g_module_open(self->module_path, G_MODULE_BIND_LAZY | G_MODULE_BIND_LOCAL);
+        if (!self->module) {
+                g_warning("Failed to open plugin '%s': %s", self->id, g_module_error());
+                return FALSE;
+        }
+
+        if (!g_module_symbol(self->module, BRISK_PLUGIN_ENTRY_POINT, (gpointer *)&create) ||
+            !create) {
+                g_warning("Plugin '%s' does not export %s", self->id, BRISK_PLUGIN_ENTRY_POINT);
+                g_module_close(self->module);
+                self->module = NULL;
+                return FALSE;
+        }
+
+        /* Types registered by the plugin can never be unregistered again */
+        g_module_make_resident(self->module);
+
+        backend = create();
+        if (!backend || !BRISK_IS_BACKEND(backend)) {
+                g_warning("Plugin '%s' failed to construct a backend", self->id);
+                if (backend && G_IS_OBJECT(backend)) {
+                        g_object_unref(backend);
+                }
+                return FALSE;
+        }
+
+        if (g_strcmp0(brisk_backend_get_id(backend), self->id) != 0) {
+                g_warning("Plugin '%s' provided backend '%s'",
+                          self->id,
+                          brisk_backend_get_id(backend));
+                g_object_unref(backend);
+                return FALSE;
+        }
+
+        self->failed = FALSE;
+        brisk_plugin_backend_adopt(self, backend);
+
+        if ((brisk_backend_get_flags(backend) & BRISK_BACKEND_SOURCE) == BRISK_BACKEND_SOURCE &&
+            !brisk_backend_load(backend)) {
+                g_warning("Failed to load plugin backend: '%s'", self->id);
+        }
+
+        return TRUE;
+}
+
+/**
+ * First use of the placeholder brings the plugin to life
+ */
+static void brisk_plugin_backend_section_activated(BriskBackend *backend, BriskSection *section)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        if (section == self->section && !brisk_plugin_backend_instantiate(self)) {
+                return;
+        }
+        if (!self->backend) {
+                return;
+        }
+
+        /* The plugin only knows about its own sections */
+        if (section == self->section) {
+                section = brisk_plugin_section_get_delegate(BRISK_PLUGIN_SECTION(section));
+                if (!section) {
+                        return;
+                }
+        }
+        brisk_backend_section_activated(self->backend, section);
+}
+
+/**
+ * The window owning the map went away, so the plugin must never see it
+ */
+static void brisk_plugin_backend_map_gone(BriskPluginBackend *self, GObject *map)
+{
+        g_ptr_array_remove_fast(self->maps, map);
+}
+
+/**
+ * Remember the map until the plugin is around to use it, without keeping the
+ * window it belongs to alive
+ */
+static void brisk_plugin_backend_register_actions(BriskBackend *backend, GActionMap *map)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        g_object_weak_ref(G_OBJECT(map), (GWeakNotify)brisk_plugin_backend_map_gone, self);
+        g_ptr_array_add(self->maps, map);
+        if (self->backend) {
+                brisk_backend_register_actions(self->backend, map);
+        }
+}
+
+static GMenu *brisk_plugin_backend_get_item_actions(BriskBackend *backend, BriskItem *item)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        if (!self->backend) {
+                return NULL;
+        }
+        return brisk_backend_get_item_actions(self->backend, item);
+}
+
+static void brisk_plugin_backend_item_launched(BriskBackend *backend, BriskItem *item)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        if (self->backend) {
+                brisk_backend_item_launched(self->backend, item);
+        }
+}
+
+static gint brisk_plugin_backend_get_item_boost(BriskBackend *backend, BriskItem *item)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        if (!self->backend) {
+                return 0;
+        }
+        return brisk_backend_get_item_boost(self->backend, item);
+}
+
+static void brisk_plugin_backend_search_changed(BriskBackend *backend, const gchar *term)
+{
+        BriskPluginBackend *self = BRISK_PLUGIN_BACKEND(backend);
+
+        if (self->backend) {
+                brisk_backend_search_changed(self->backend, term);
+        }
+}
+
+/**
+ * brisk_plugin_backend_new:
+ *
+ * Parse the plugin description without touching the module itself
+ */
+BriskBackend *brisk_plugin_backend_new(const gchar *path, GError **error)
+{
+        autofree(GKeyFile) *keyfile = NULL;
+        autofree(gchar) *dir = NULL;
+        autofree(gchar) *module = NULL;
+        autofree(gchar) *icon = NULL;
+        BriskPluginBackend *self = NULL;
+        gchar *id = NULL;
+
+        keyfile = g_key_file_new();
+        if (!g_key_file_load_from_file(keyfile, path, G_KEY_FILE_NONE, error)) {
+                return NULL;
+        }
+
+        id = g_key_file_get_string(keyfile, BRISK_PLUGIN_GROUP, "Id", error);
+        if (!id) {
+                return NULL;
+        }
+
+        module = g_key_file_get_string(keyfile, BRISK_PLUGIN_GROUP, "Module", error);
+        if (!module) {
+                g_free(id);
+                return NULL;
+        }
+
+        self = g_object_new(BRISK_TYPE_PLUGIN_BACKEND, NULL);
+        self->id = id;
+        self->name = g_key_file_get_locale_string(keyfile, BRISK_PLUGIN_GROUP, "Name", NULL, NULL);
+        if (!self->name) {
+                self->name = g_strdup(id);
+        }
+
+        icon = g_key_file_get_string(keyfile, BRISK_PLUGIN_GROUP, "Icon", NULL);
+        if (icon) {
+                self->icon = g_themed_icon_new_with_default_fallbacks(icon);
+        }
+
+        /* Modules are relative to their description */
+        dir = g_path_get_dirname(path);
+        self->module_path = g_module_build_path(dir, module);
+
+        self->section = g_object_ref_sink(brisk_plugin_section_new(id, self->name, self->icon));
+
+        return BRISK_BACKEND(self);
+}
+
+/**
+ * Pick up every plugin within the directory that we haven't already seen
+ */
+static void brisk_plugin_backend_scan(const gchar *path, GHashTable *seen, GList **plugins)
+{
+        GDir *dir = NULL;
+        const gchar *name = NULL;
+
+        dir = g_dir_open(path, 0, NULL);
+        if (!dir) {
+                return;
+        }
+
+        while ((name = g_dir_read_name(dir)) != NULL) {
+                autofree(gchar) *filename = NULL;
+                autofree(GError) *error = NULL;
+                BriskBackend *backend = NULL;
+                const gchar *id = NULL;
+
+                if (!g_str_has_suffix(name, BRISK_PLUGIN_SUFFIX)) {
+                        continue;
+                }
+
+                filename = g_build_filename(path, name, NULL);
+                backend = brisk_plugin_backend_new(filename, &error);
+                if (!backend) {
+                        g_warning("Failed to read plugin %s: %s", filename, error->message);
+                        continue;
+                }
+
+                /* Earlier directories take precedence */
+                id = brisk_backend_get_id(backend);
+                if (g_hash_table_contains(seen, id)) {
+                        g_object_unref(backend);
+                        continue;
+                }
+
+                g_hash_table_add(seen, g_strdup(id));
+                *plugins = g_list_append(*plugins, backend);
+        }
+
+        g_dir_close(dir);
+}
+
+/**
+ * brisk_plugin_backend_discover:
+ *
+ * Walk the plugin search path, with any directories from the environment
+ * ahead of the system plugin directory
+ */
+GList *brisk_plugin_backend_discover(void)
+{
+        autofree(gstrv) *paths = NULL;
+        GHashTable *seen = NULL;
+        GList *plugins = NULL;
+        const gchar *env = NULL;
+
+        seen = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+        env = g_getenv(BRISK_PLUGIN_PATH_ENV);
+        if (env) {
+                paths = g_strsplit(env, G_SEARCHPATH_SEPARATOR_S, -1);
+                for (guint i = 0; paths[i]; i++) {
+                        if (paths[i][0] != '\0') {
+                                brisk_plugin_backend_scan(paths[i], seen, &plugins);
+                        }
+                }
+        }
+
+        brisk_plugin_backend_scan(PACKAGE_PLUGINDIR, seen, &plugins);
+
+        g_hash_table_unref(seen);
+        return plugins;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
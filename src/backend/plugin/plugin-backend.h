@@ -0,0 +1,87 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#include "../backend.h"
+
+G_BEGIN_DECLS
+
+/**
+ * Plugins are described by a key file ending in BRISK_PLUGIN_SUFFIX, which
+ * is all we read at startup:
+ *
+ *      [Brisk Plugin]
+ *      Id=example
+ *      Name=Example
+ *      Icon=applications-other
+ *      Module=libbrisk-example.so
+ *
+ * The module itself is only opened when the user first opens the section we
+ * create on behalf of the plugin, at which point BRISK_PLUGIN_ENTRY_POINT is
+ * called to construct the real backend. Its ID must match the one above.
+ */
+#define BRISK_PLUGIN_GROUP "Brisk Plugin"
+#define BRISK_PLUGIN_SUFFIX ".plugin"
+#define BRISK_PLUGIN_ENTRY_POINT "brisk_plugin_create_backend"
+
+/**
+ * Colon separated list of extra directories searched ahead of the system one
+ */
+#define BRISK_PLUGIN_PATH_ENV "BRISK_PLUGIN_PATH"
+
+/**
+ * Signature of the BRISK_PLUGIN_ENTRY_POINT exported by every plugin
+ */
+typedef BriskBackend *(*BriskPluginCreateFunc)(void);
+
+typedef struct _BriskPluginBackend BriskPluginBackend;
+typedef struct _BriskPluginBackendClass BriskPluginBackendClass;
+
+#define BRISK_TYPE_PLUGIN_BACKEND brisk_plugin_backend_get_type()
+#define BRISK_PLUGIN_BACKEND(o)                                                                    \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_PLUGIN_BACKEND, BriskPluginBackend))
+#define BRISK_IS_PLUGIN_BACKEND(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_PLUGIN_BACKEND))
+#define BRISK_PLUGIN_BACKEND_CLASS(o)                                                              \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_PLUGIN_BACKEND, BriskPluginBackendClass))
+#define BRISK_IS_PLUGIN_BACKEND_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_PLUGIN_BACKEND))
+#define BRISK_PLUGIN_BACKEND_GET_CLASS(o)                                                          \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_PLUGIN_BACKEND, BriskPluginBackendClass))
+
+GType brisk_plugin_backend_get_type(void);
+
+/**
+ * Construct a new BriskPluginBackend from the plugin description at path
+ */
+BriskBackend *brisk_plugin_backend_new(const gchar *path, GError **error);
+
+/**
+ * Return a list of newly created BriskPluginBackend instances for every
+ * plugin found on the search path. The caller owns the list and backends.
+ */
+GList *brisk_plugin_backend_discover(void);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,203 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "plugin-section.h"
+BRISK_END_PEDANTIC
+
+struct _BriskPluginSectionClass {
+        BriskSectionClass parent_class;
+};
+
+/**
+ * BriskPluginSection stands in for a plugin within the sidebar until the user
+ * first opens it. Once the plugin is loaded, its first section becomes our
+ * delegate and decides which items we show, and in which order.
+ */
+struct _BriskPluginSection {
+        BriskSection parent;
+
+        gchar *backend_id;
+        gchar *name;
+        GIcon *icon;
+        BriskSection *delegate;
+};
+
+G_DEFINE_TYPE(BriskPluginSection, brisk_plugin_section, BRISK_TYPE_SECTION)
+
+static const gchar *brisk_plugin_section_get_id(BriskSection *section);
+static const gchar *brisk_plugin_section_get_name(BriskSection *section);
+static const GIcon *brisk_plugin_section_get_icon(BriskSection *section);
+static const gchar *brisk_plugin_section_get_backend_id(BriskSection *section);
+static gboolean brisk_plugin_section_can_show_item(BriskSection *section, BriskItem *item);
+static gint brisk_plugin_section_get_sort_order(BriskSection *section, BriskItem *item);
+
+/**
+ * brisk_plugin_section_dispose:
+ *
+ * Clean up a BriskPluginSection instance
+ */
+static void brisk_plugin_section_dispose(GObject *obj)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(obj);
+
+        g_clear_object(&self->icon);
+        g_clear_object(&self->delegate);
+        g_clear_pointer(&self->name, g_free);
+        g_clear_pointer(&self->backend_id, g_free);
+
+        G_OBJECT_CLASS(brisk_plugin_section_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_plugin_section_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_plugin_section_class_init(BriskPluginSectionClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskSectionClass *s_class = BRISK_SECTION_CLASS(klazz);
+
+        /* section vtable hookup */
+        s_class->get_id = brisk_plugin_section_get_id;
+        s_class->get_name = brisk_plugin_section_get_name;
+        s_class->get_icon = brisk_plugin_section_get_icon;
+        s_class->get_backend_id = brisk_plugin_section_get_backend_id;
+        s_class->can_show_item = brisk_plugin_section_can_show_item;
+        s_class->get_sort_order = brisk_plugin_section_get_sort_order;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_plugin_section_dispose;
+}
+
+/**
+ * brisk_plugin_section_init:
+ *
+ * Handle construction of the BriskPluginSection
+ */
+static void brisk_plugin_section_init(__brisk_unused__ BriskPluginSection *self)
+{
+}
+
+/**
+ * We share the ID of the plugin, which is unique amongst all backends
+ */
+static const gchar *brisk_plugin_section_get_id(BriskSection *section)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(section);
+        return (const gchar *)self->backend_id;
+}
+
+static const gchar *brisk_plugin_section_get_name(BriskSection *section)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(section);
+        return (const gchar *)self->name;
+}
+
+static const GIcon *brisk_plugin_section_get_icon(BriskSection *section)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(section);
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_plugin_section_get_backend_id(BriskSection *section)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(section);
+        return (const gchar *)self->backend_id;
+}
+
+/**
+ * Defer to the plugin when it has a section of its own, otherwise show
+ * everything the plugin produced
+ */
+static gboolean brisk_plugin_section_can_show_item(BriskSection *section, BriskItem *item)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(section);
+
+        if (G_UNLIKELY(item == NULL)) {
+                return FALSE;
+        }
+
+        if (self->delegate) {
+                return brisk_section_can_show_item(self->delegate, item);
+        }
+
+        return g_strcmp0(brisk_item_get_backend_id(item), self->backend_id) == 0;
+}
+
+static gint brisk_plugin_section_get_sort_order(BriskSection *section, BriskItem *item)
+{
+        BriskPluginSection *self = BRISK_PLUGIN_SECTION(section);
+
+        if (!self->delegate) {
+                return -1;
+        }
+        return brisk_section_get_sort_order(self->delegate, item);
+}
+
+/**
+ * brisk_plugin_section_set_delegate:
+ *
+ * Hand filtering and sorting over to the given section from the plugin.
+ * We take ownership of a floating reference.
+ */
+void brisk_plugin_section_set_delegate(BriskPluginSection *self, BriskSection *delegate)
+{
+        g_clear_object(&self->delegate);
+        if (delegate) {
+                self->delegate = g_object_ref_sink(delegate);
+        }
+}
+
+/**
+ * brisk_plugin_section_get_delegate:
+ *
+ * Return the section we're currently deferring to, if any
+ */
+BriskSection *brisk_plugin_section_get_delegate(BriskPluginSection *self)
+{
+        return self->delegate;
+}
+
+/**
+ * brisk_plugin_section_new:
+ *
+ * Construct a new placeholder section for the plugin with the given ID
+ */
+BriskSection *brisk_plugin_section_new(const gchar *backend_id, const gchar *name, GIcon *icon)
+{
+        BriskPluginSection *self = NULL;
+
+        self = g_object_new(BRISK_TYPE_PLUGIN_SECTION, NULL);
+        self->backend_id = g_strdup(backend_id);
+        self->name = g_strdup(name);
+        self->icon = icon ? g_object_ref(icon) : NULL;
+
+        return BRISK_SECTION(self);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
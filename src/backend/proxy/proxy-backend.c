@@ -0,0 +1,707 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "config.h"
+#include "util.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "libhost-glue.h"
+#include "proxy-backend.h"
+#include "proxy-item.h"
+#include "proxy-protocol.h"
+#include "proxy-section.h"
+#include <gio/gio.h>
+BRISK_END_PEDANTIC
+
+/**
+ * How long we wait before bringing the host back after it went away (ms)
+ */
+#define BRISK_PROXY_RECONNECT_TIME 2000
+
+/**
+ * Give up on the host after it went away this many times
+ */
+#define BRISK_PROXY_MAX_RECONNECTS 3
+
+struct _BriskProxyBackendClass {
+        BriskBackendClass parent_class;
+};
+
+/**
+ * BriskProxyBackend stands in for a backend running in brisk-backend-host,
+ * so that its loading and monitoring never blocks the panel
+ */
+struct _BriskProxyBackend {
+        BriskBackend parent;
+        gchar *id;
+        gchar *display_name;
+
+        /* Only set while connected */
+        BriskBackendHost *host;
+        GDBusActionGroup *remote_actions;
+
+        /* Action maps registered by the frontends, held weakly */
+        GPtrArray *maps;
+
+        GCancellable *cancel;
+        guint reconnect_id;
+        guint n_reconnects;
+};
+
+G_DEFINE_TYPE(BriskProxyBackend, brisk_proxy_backend, BRISK_TYPE_BACKEND)
+
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GSubprocess, g_object_unref)
+DEF_AUTOFREE(GSubprocessLauncher, g_object_unref)
+DEF_AUTOFREE(GSimpleAction, g_object_unref)
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GVariant, g_variant_unref)
+typedef gchar *gstrv;
+DEF_AUTOFREE(gstrv, g_strfreev)
+
+/**
+ * Every proxy within the process shares a single host, so that one warm
+ * host serves every panel and screen
+ */
+static BriskBackendHost *brisk_proxy_host = NULL;
+static GSList *brisk_proxy_waiting = NULL;
+static gboolean brisk_proxy_connecting = FALSE;
+
+static gboolean brisk_proxy_backend_load(BriskBackend *backend);
+static void brisk_proxy_backend_connect(BriskProxyBackend *self);
+static void brisk_proxy_backend_attach(BriskProxyBackend *self, BriskBackendHost *host);
+static void brisk_proxy_backend_register_actions(BriskBackend *backend, GActionMap *map);
+static GMenu *brisk_proxy_backend_get_item_actions(BriskBackend *backend, BriskItem *item);
+static void brisk_proxy_backend_item_launched(BriskBackend *backend, BriskItem *item);
+static void brisk_proxy_backend_map_gone(BriskProxyBackend *self, GObject *map);
+
+/**
+ * Tell the frontends what we are
+ */
+static unsigned int brisk_proxy_backend_get_flags(__brisk_unused__ BriskBackend *backend)
+{
+        return BRISK_BACKEND_SOURCE;
+}
+
+static const gchar *brisk_proxy_backend_get_id(BriskBackend *backend)
+{
+        return BRISK_PROXY_BACKEND(backend)->id;
+}
+
+static const gchar *brisk_proxy_backend_get_display_name(BriskBackend *backend)
+{
+        BriskProxyBackend *self = BRISK_PROXY_BACKEND(backend);
+
+        /* Only known once the host sent us a snapshot */
+        return self->display_name ? self->display_name : self->id;
+}
+
+/**
+ * Stop listening to the host, i.e. because it went away or we're going away
+ */
+static void brisk_proxy_backend_detach(BriskProxyBackend *self)
+{
+        if (self->host) {
+                GDBusConnection *connection = g_dbus_proxy_get_connection(G_DBUS_PROXY(self->host));
+
+                g_signal_handlers_disconnect_by_data(connection, self);
+                g_signal_handlers_disconnect_by_data(self->host, self);
+        }
+        if (self->remote_actions) {
+                g_signal_handlers_disconnect_by_data(self->remote_actions, self);
+        }
+        g_clear_object(&self->remote_actions);
+        g_clear_object(&self->host);
+}
+
+/**
+ * brisk_proxy_backend_dispose:
+ *
+ * Clean up a BriskProxyBackend instance
+ */
+static void brisk_proxy_backend_dispose(GObject *obj)
+{
+        BriskProxyBackend *self = BRISK_PROXY_BACKEND(obj);
+
+        if (self->cancel) {
+                g_cancellable_cancel(self->cancel);
+        }
+        if (self->reconnect_id > 0) {
+                g_source_remove(self->reconnect_id);
+                self->reconnect_id = 0;
+        }
+        brisk_proxy_backend_detach(self);
+        g_clear_object(&self->cancel);
+        for (guint i = 0; self->maps && i < self->maps->len; i++) {
+                g_object_weak_unref(self->maps->pdata[i],
+                                    (GWeakNotify)brisk_proxy_backend_map_gone,
+                                    self);
+        }
+        g_clear_pointer(&self->maps, g_ptr_array_unref);
+        g_clear_pointer(&self->id, g_free);
+        g_clear_pointer(&self->display_name, g_free);
+
+        G_OBJECT_CLASS(brisk_proxy_backend_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_proxy_backend_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_proxy_backend_class_init(BriskProxyBackendClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskBackendClass *b_class = BRISK_BACKEND_CLASS(klazz);
+
+        /* Backend vtable hookup */
+        b_class->get_flags = brisk_proxy_backend_get_flags;
+        b_class->get_id = brisk_proxy_backend_get_id;
+        b_class->get_display_name = brisk_proxy_backend_get_display_name;
+        b_class->load = brisk_proxy_backend_load;
+        b_class->register_actions = brisk_proxy_backend_register_actions;
+        b_class->get_item_actions = brisk_proxy_backend_get_item_actions;
+        b_class->item_launched = brisk_proxy_backend_item_launched;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_proxy_backend_dispose;
+}
+
+/**
+ * brisk_proxy_backend_init:
+ *
+ * Handle construction of the BriskProxyBackend
+ */
+static void brisk_proxy_backend_init(BriskProxyBackend *self)
+{
+        self->maps = g_ptr_array_new();
+        self->cancel = g_cancellable_new();
+}
+
+/**
+ * Start the host with one end of a socket pair as fd 3, returning our end
+ */
+static GIOStream *brisk_proxy_spawn_host(GError **error)
+{
+        autofree(GSubprocessLauncher) *launcher = NULL;
+        autofree(GSubprocess) *process = NULL;
+        autofree(gchar) *path = NULL;
+        GSocket *socket = NULL;
+        GIOStream *stream = NULL;
+        int fds[2] = { -1, -1 };
+
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+                g_set_error(error,
+                            G_IO_ERROR,
+                            g_io_error_from_errno(errno),
+                            "Failed to create socket pair: %s",
+                            strerror(errno));
+                return NULL;
+        }
+
+        /* The launcher closes the child end for us */
+        launcher = g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_NONE);
+        g_subprocess_launcher_take_fd(launcher, fds[1], 3);
+
+        path = g_build_filename(PACKAGE_LIBEXECDIR, BRISK_HOST_EXECUTABLE, NULL);
+        process = g_subprocess_launcher_spawn(launcher, error, path, "--fd", "3", NULL);
+        if (!process) {
+                close(fds[0]);
+                return NULL;
+        }
+
+        socket = g_socket_new_from_fd(fds[0], error);
+        if (!socket) {
+                close(fds[0]);
+                return NULL;
+        }
+
+        stream = G_IO_STREAM(g_socket_connection_factory_create_connection(socket));
+        g_object_unref(socket);
+        return stream;
+}
+
+/**
+ * Hand the host, or the reason we don't have one, to everyone waiting on it
+ */
+static void brisk_proxy_flush_waiting(const GError *error)
+{
+        GSList *waiting = brisk_proxy_waiting;
+
+        brisk_proxy_waiting = NULL;
+        brisk_proxy_connecting = FALSE;
+
+        for (GSList *elem = waiting; elem; elem = elem->next) {
+                BriskProxyBackend *self = elem->data;
+
+                if (brisk_proxy_host) {
+                        brisk_proxy_backend_attach(self, brisk_proxy_host);
+                } else {
+                        g_warning("Failed to start backend host for '%s': %s",
+                                  self->id,
+                                  error ? error->message : "unknown error");
+                }
+                g_object_unref(self);
+        }
+        g_slist_free(waiting);
+}
+
+/**
+ * The host went away, the next proxy to connect will start a new one
+ */
+static void brisk_proxy_host_closed(__brisk_unused__ GDBusConnection *connection,
+                                    __brisk_unused__ gboolean remote_peer_vanished,
+                                    __brisk_unused__ GError *error, __brisk_unused__ gpointer v)
+{
+        g_clear_object(&brisk_proxy_host);
+}
+
+static void brisk_proxy_host_ready(__brisk_unused__ GObject *source, GAsyncResult *result,
+                                   __brisk_unused__ gpointer v)
+{
+        autofree(GError) *error = NULL;
+
+        brisk_proxy_host = brisk_backend_host_proxy_new_finish(result, &error);
+        brisk_proxy_flush_waiting(error);
+}
+
+static void brisk_proxy_connection_ready(__brisk_unused__ GObject *source, GAsyncResult *result,
+                                         __brisk_unused__ gpointer v)
+{
+        autofree(GError) *error = NULL;
+        GDBusConnection *connection = NULL;
+
+        connection = g_dbus_connection_new_finish(result, &error);
+        if (!connection) {
+                brisk_proxy_flush_waiting(error);
+                return;
+        }
+
+        g_signal_connect(connection, "closed", G_CALLBACK(brisk_proxy_host_closed), NULL);
+
+        /* Peer to peer, so there is no bus name */
+        brisk_backend_host_proxy_new(connection,
+                                     G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES,
+                                     NULL,
+                                     BRISK_HOST_OBJECT_PATH,
+                                     NULL,
+                                     brisk_proxy_host_ready,
+                                     NULL);
+        g_object_unref(connection);
+}
+
+/**
+ * Attach to the shared host, starting it if nobody else did yet
+ */
+static void brisk_proxy_backend_connect(BriskProxyBackend *self)
+{
+        GIOStream *stream = NULL;
+        autofree(GError) *error = NULL;
+
+        if (brisk_proxy_host) {
+                brisk_proxy_backend_attach(self, brisk_proxy_host);
+                return;
+        }
+
+        brisk_proxy_waiting = g_slist_append(brisk_proxy_waiting, g_object_ref(self));
+        if (brisk_proxy_connecting) {
+                return;
+        }
+
+        stream = brisk_proxy_spawn_host(&error);
+        if (!stream) {
+                brisk_proxy_flush_waiting(error);
+                return;
+        }
+
+        brisk_proxy_connecting = TRUE;
+        g_dbus_connection_new(stream,
+                              NULL,
+                              G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT,
+                              NULL,
+                              NULL,
+                              brisk_proxy_connection_ready,
+                              NULL);
+        g_object_unref(stream);
+}
+
+/**
+ * brisk_proxy_backend_load:
+ *
+ * Bring up the host in the background, the items follow once it's loaded
+ */
+static gboolean brisk_proxy_backend_load(BriskBackend *backend)
+{
+        brisk_proxy_backend_connect(BRISK_PROXY_BACKEND(backend));
+        return TRUE;
+}
+
+/**
+ * Replace everything we have with the host's current view of the backend
+ */
+static void brisk_proxy_backend_apply(BriskProxyBackend *self, GVariant *sections, GVariant *items)
+{
+        GVariantIter iter = { 0 };
+        GVariant *child = NULL;
+
+        brisk_backend_reset(BRISK_BACKEND(self));
+
+        /* If signal subscribers wish to keep them, they can ref them */
+        g_variant_iter_init(&iter, sections);
+        while ((child = g_variant_iter_next_value(&iter))) {
+                brisk_backend_section_added(BRISK_BACKEND(self),
+                                            brisk_proxy_section_new(self->id, child));
+                g_variant_unref(child);
+        }
+
+        g_variant_iter_init(&iter, items);
+        while ((child = g_variant_iter_next_value(&iter))) {
+                brisk_backend_item_added(BRISK_BACKEND(self),
+                                         brisk_proxy_item_new(self->id, child));
+                g_variant_unref(child);
+        }
+}
+
+static void brisk_proxy_backend_snapshot(GObject *source, GAsyncResult *result, gpointer v)
+{
+        autofree(GError) *error = NULL;
+        autofree(GVariant) *sections = NULL;
+        autofree(GVariant) *items = NULL;
+        gchar *display_name = NULL;
+        BriskProxyBackend *self = NULL;
+
+        if (!brisk_backend_host_call_get_snapshot_finish(BRISK_BACKEND_HOST(source),
+                                                         &display_name,
+                                                         &sections,
+                                                         &items,
+                                                         result,
+                                                         &error)) {
+                /* We may no longer exist */
+                if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                        g_warning("Failed to fetch items from backend host: %s", error->message);
+                }
+                return;
+        }
+
+        self = BRISK_PROXY_BACKEND(v);
+        g_free(self->display_name);
+        self->display_name = display_name;
+
+        brisk_proxy_backend_apply(self, sections, items);
+}
+
+/**
+ * Fetch a fresh snapshot from the host. Replies arrive in order, so the
+ * last one we apply is always the latest.
+ */
+static void brisk_proxy_backend_refresh(BriskProxyBackend *self)
+{
+        if (!self->host) {
+                return;
+        }
+        brisk_backend_host_call_get_snapshot(self->host,
+                                             self->id,
+                                             self->cancel,
+                                             brisk_proxy_backend_snapshot,
+                                             self);
+}
+
+static void brisk_proxy_backend_loaded(GObject *source, GAsyncResult *result, gpointer v)
+{
+        autofree(GError) *error = NULL;
+        gboolean loaded = FALSE;
+        BriskProxyBackend *self = NULL;
+
+        if (!brisk_backend_host_call_load_finish(BRISK_BACKEND_HOST(source),
+                                                 &loaded,
+                                                 result,
+                                                 &error)) {
+                if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                        g_warning("Backend host failed to load: %s", error->message);
+                }
+                return;
+        }
+
+        self = BRISK_PROXY_BACKEND(v);
+        if (!loaded) {
+                g_warning("Backend host doesn't know about backend '%s'", self->id);
+                return;
+        }
+
+        /* Healthy again */
+        self->n_reconnects = 0;
+
+        /* Picks up anything the host already had, i.e. for a second panel */
+        brisk_proxy_backend_refresh(self);
+}
+
+/**
+ * Host signals are broadcast to every proxy, so filter them by our ID
+ */
+static void brisk_proxy_backend_host_changed(__brisk_unused__ BriskBackendHost *host,
+                                             const gchar *backend_id, BriskProxyBackend *self)
+{
+        if (g_str_equal(backend_id, self->id)) {
+                brisk_proxy_backend_refresh(self);
+        }
+}
+
+static void brisk_proxy_backend_host_item_changed(__brisk_unused__ BriskBackendHost *host,
+                                                  const gchar *backend_id, const gchar *item_id,
+                                                  BriskProxyBackend *self)
+{
+        if (g_str_equal(backend_id, self->id)) {
+                brisk_backend_item_changed(BRISK_BACKEND(self), item_id);
+        }
+}
+
+static void brisk_proxy_backend_host_invalidate_filter(__brisk_unused__ BriskBackendHost *host,
+                                                       const gchar *backend_id,
+                                                       BriskProxyBackend *self)
+{
+        if (g_str_equal(backend_id, self->id)) {
+                brisk_backend_invalidate_filter(BRISK_BACKEND(self));
+        }
+}
+
+static void brisk_proxy_backend_host_hide_menu(__brisk_unused__ BriskBackendHost *host,
+                                               const gchar *backend_id, BriskProxyBackend *self)
+{
+        if (g_str_equal(backend_id, self->id)) {
+                brisk_backend_hide_menu(BRISK_BACKEND(self));
+        }
+}
+
+static gboolean brisk_proxy_backend_reconnect(BriskProxyBackend *self)
+{
+        self->reconnect_id = 0;
+        brisk_proxy_backend_connect(self);
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * The host went away, most likely because it crashed. Drop everything we got
+ * from it and try to bring it back a little later.
+ */
+static void brisk_proxy_backend_closed(BriskProxyBackend *self,
+                                       __brisk_unused__ gboolean remote_peer_vanished,
+                                       __brisk_unused__ GError *error)
+{
+        brisk_proxy_backend_detach(self);
+        brisk_backend_reset(BRISK_BACKEND(self));
+
+        if (++self->n_reconnects > BRISK_PROXY_MAX_RECONNECTS) {
+                g_warning("Backend host keeps going away, giving up on '%s'", self->id);
+                return;
+        }
+
+        self->reconnect_id = g_timeout_add(BRISK_PROXY_RECONNECT_TIME,
+                                           (GSourceFunc)brisk_proxy_backend_reconnect,
+                                           self);
+}
+
+/**
+ * Forward activation of a local action to the host
+ */
+static void brisk_proxy_backend_activate(GSimpleAction *action, GVariant *parameter,
+                                         BriskProxyBackend *self)
+{
+        if (!self->remote_actions) {
+                return;
+        }
+        g_action_group_activate_action(G_ACTION_GROUP(self->remote_actions),
+                                       g_action_get_name(G_ACTION(action)),
+                                       parameter);
+}
+
+/**
+ * Our actions are namespaced by the backend ID, i.e. "apps.launch-action"
+ */
+static gboolean brisk_proxy_backend_owns_action(BriskProxyBackend *self, const gchar *name)
+{
+        size_t len = strlen(self->id);
+
+        return strncmp(name, self->id, len) == 0 && name[len] == '.';
+}
+
+/**
+ * Mirror a remote action into the frontend's action map
+ */
+static void brisk_proxy_backend_add_action(BriskProxyBackend *self, GActionMap *map,
+                                           const gchar *name)
+{
+        autofree(GSimpleAction) *action = NULL;
+        const GVariantType *type = NULL;
+
+        if (!brisk_proxy_backend_owns_action(self, name)) {
+                return;
+        }
+
+        type = g_action_group_get_action_parameter_type(G_ACTION_GROUP(self->remote_actions),
+                                                        name);
+        action = g_simple_action_new(name, type);
+        g_signal_connect(action, "activate", G_CALLBACK(brisk_proxy_backend_activate), self);
+        g_action_map_add_action(map, G_ACTION(action));
+}
+
+static void brisk_proxy_backend_action_added(__brisk_unused__ GActionGroup *group,
+                                             const gchar *name, BriskProxyBackend *self)
+{
+        for (guint i = 0; i < self->maps->len; i++) {
+                brisk_proxy_backend_add_action(self, self->maps->pdata[i], name);
+        }
+}
+
+static void brisk_proxy_backend_action_removed(__brisk_unused__ GActionGroup *group,
+                                               const gchar *name, BriskProxyBackend *self)
+{
+        if (!brisk_proxy_backend_owns_action(self, name)) {
+                return;
+        }
+        for (guint i = 0; i < self->maps->len; i++) {
+                g_action_map_remove_action(self->maps->pdata[i], name);
+        }
+}
+
+/**
+ * Start listening to the host and ask it to load our backend
+ */
+static void brisk_proxy_backend_attach(BriskProxyBackend *self, BriskBackendHost *host)
+{
+        GDBusConnection *connection = NULL;
+
+        self->host = g_object_ref(host);
+        connection = g_dbus_proxy_get_connection(G_DBUS_PROXY(host));
+
+        g_signal_connect(host, "changed", G_CALLBACK(brisk_proxy_backend_host_changed), self);
+        g_signal_connect(host,
+                         "item-changed",
+                         G_CALLBACK(brisk_proxy_backend_host_item_changed),
+                         self);
+        g_signal_connect(host,
+                         "invalidate-filter",
+                         G_CALLBACK(brisk_proxy_backend_host_invalidate_filter),
+                         self);
+        g_signal_connect(host, "hide-menu", G_CALLBACK(brisk_proxy_backend_host_hide_menu), self);
+        g_signal_connect_swapped(connection,
+                                 "closed",
+                                 G_CALLBACK(brisk_proxy_backend_closed),
+                                 self);
+
+        self->remote_actions = g_dbus_action_group_get(connection, NULL, BRISK_HOST_ACTIONS_PATH);
+        g_signal_connect(self->remote_actions,
+                         "action-added",
+                         G_CALLBACK(brisk_proxy_backend_action_added),
+                         self);
+        g_signal_connect(self->remote_actions,
+                         "action-removed",
+                         G_CALLBACK(brisk_proxy_backend_action_removed),
+                         self);
+
+        /* The group only subscribes once asked for its actions. Nothing has
+         * arrived yet, they come through action-added. */
+        g_strfreev(g_action_group_list_actions(G_ACTION_GROUP(self->remote_actions)));
+
+        brisk_backend_host_call_load(self->host,
+                                     self->id,
+                                     self->cancel,
+                                     brisk_proxy_backend_loaded,
+                                     self);
+}
+
+/**
+ * The window owning the map was finalized, stop forwarding into it
+ */
+static void brisk_proxy_backend_map_gone(BriskProxyBackend *self, GObject *map)
+{
+        g_ptr_array_remove_fast(self->maps, map);
+}
+
+/**
+ * Frontends register their action map once, which we'll keep populated with
+ * forwarders for the host's actions as they come and go. The backend outlives
+ * the windows, so the map is only held weakly.
+ */
+static void brisk_proxy_backend_register_actions(BriskBackend *backend, GActionMap *map)
+{
+        BriskProxyBackend *self = BRISK_PROXY_BACKEND(backend);
+        autofree(gstrv) *actions = NULL;
+
+        g_object_weak_ref(G_OBJECT(map), (GWeakNotify)brisk_proxy_backend_map_gone, self);
+        g_ptr_array_add(self->maps, map);
+
+        if (!self->remote_actions) {
+                return;
+        }
+
+        actions = g_action_group_list_actions(G_ACTION_GROUP(self->remote_actions));
+        for (guint i = 0; actions[i]; i++) {
+                brisk_proxy_backend_add_action(self, map, actions[i]);
+        }
+}
+
+static GMenu *brisk_proxy_backend_get_item_actions(BriskBackend *backend, BriskItem *item)
+{
+        BriskProxyBackend *self = BRISK_PROXY_BACKEND(backend);
+
+        if (!BRISK_IS_PROXY_ITEM(item) ||
+            g_strcmp0(brisk_item_get_backend_id(item), self->id) != 0) {
+                return NULL;
+        }
+        return brisk_proxy_item_get_actions(BRISK_PROXY_ITEM(item));
+}
+
+/**
+ * Let the real backend learn from launches of its own items
+ */
+static void brisk_proxy_backend_item_launched(BriskBackend *backend, BriskItem *item)
+{
+        BriskProxyBackend *self = BRISK_PROXY_BACKEND(backend);
+        const gchar *id = brisk_item_get_id(item);
+
+        if (!self->host || !id || g_strcmp0(brisk_item_get_backend_id(item), self->id) != 0) {
+                return;
+        }
+        brisk_backend_host_call_item_launched(self->host, self->id, id, NULL, NULL, NULL);
+}
+
+/**
+ * brisk_proxy_backend_new:
+ *
+ * Return a newly created BriskProxyBackend
+ */
+BriskBackend *brisk_proxy_backend_new(const gchar *backend_id)
+{
+        BriskProxyBackend *self = g_object_new(BRISK_TYPE_PROXY_BACKEND, NULL);
+
+        self->id = g_strdup(backend_id);
+        return BRISK_BACKEND(self);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
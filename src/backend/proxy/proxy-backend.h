@@ -0,0 +1,54 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#include "../backend.h"
+
+G_BEGIN_DECLS
+
+typedef struct _BriskProxyBackend BriskProxyBackend;
+typedef struct _BriskProxyBackendClass BriskProxyBackendClass;
+
+#define BRISK_TYPE_PROXY_BACKEND brisk_proxy_backend_get_type()
+#define BRISK_PROXY_BACKEND(o)                                                                     \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_PROXY_BACKEND, BriskProxyBackend))
+#define BRISK_IS_PROXY_BACKEND(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_PROXY_BACKEND))
+#define BRISK_PROXY_BACKEND_CLASS(o)                                                               \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_PROXY_BACKEND, BriskProxyBackendClass))
+#define BRISK_IS_PROXY_BACKEND_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_PROXY_BACKEND))
+#define BRISK_PROXY_BACKEND_GET_CLASS(o)                                                           \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_PROXY_BACKEND, BriskProxyBackendClass))
+
+GType brisk_proxy_backend_get_type(void);
+
+/**
+ * Construct a new BriskProxyBackend standing in for the backend with the
+ * given ID, which actually runs within brisk-backend-host
+ */
+BriskBackend *brisk_proxy_backend_new(const gchar *backend_id);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
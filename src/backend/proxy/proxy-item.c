@@ -0,0 +1,329 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "../search.h"
+#include "proxy-item.h"
+#include "proxy-protocol.h"
+#include "proxy-section.h"
+#include <gio/gdesktopappinfo.h>
+BRISK_END_PEDANTIC
+
+struct _BriskProxyItemClass {
+        BriskItemClass parent_class;
+};
+
+/**
+ * BriskProxyItem is a local copy of an item living in brisk-backend-host.
+ * Everything needed to display, search and sort it is sent up front, the
+ * .desktop file is only parsed in-process once the item is launched.
+ */
+struct _BriskProxyItem {
+        BriskItem parent;
+
+        gchar *id;
+        gchar *name;
+        gchar *display_name;
+        gchar *summary;
+        gchar *uri;
+        GIcon *icon;
+        GArray *search;
+        gchar **sections;
+        GVariant *actions;
+        gchar *filename;
+        gchar *backend_id;
+
+        GAppInfo *info;
+};
+
+G_DEFINE_TYPE(BriskProxyItem, brisk_proxy_item, BRISK_TYPE_ITEM)
+
+static const gchar *brisk_proxy_item_get_id(BriskItem *item);
+static const gchar *brisk_proxy_item_get_name(BriskItem *item);
+static const gchar *brisk_proxy_item_get_display_name(BriskItem *item);
+static const gchar *brisk_proxy_item_get_summary(BriskItem *item);
+static const GIcon *brisk_proxy_item_get_icon(BriskItem *item);
+static const gchar *brisk_proxy_item_get_backend_id(BriskItem *item);
+static gboolean brisk_proxy_item_matches_search(BriskItem *item, gchar *term);
+static gboolean brisk_proxy_item_search(BriskItem *item, const gchar *term, const gint *weights,
+                                        BriskSearchMatch *match);
+static gboolean brisk_proxy_item_launch(BriskItem *item, GAppLaunchContext *context);
+static gchar *brisk_proxy_item_get_uri(BriskItem *item);
+static GAppInfo *brisk_proxy_item_get_app_info(BriskItem *item);
+
+/**
+ * brisk_proxy_item_dispose:
+ *
+ * Clean up a BriskProxyItem instance
+ */
+static void brisk_proxy_item_dispose(GObject *obj)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(obj);
+
+        g_clear_object(&self->icon);
+        g_clear_object(&self->info);
+        g_clear_pointer(&self->actions, g_variant_unref);
+        g_clear_pointer(&self->search, g_array_unref);
+        g_clear_pointer(&self->sections, g_strfreev);
+        g_clear_pointer(&self->id, g_free);
+        g_clear_pointer(&self->name, g_free);
+        g_clear_pointer(&self->display_name, g_free);
+        g_clear_pointer(&self->summary, g_free);
+        g_clear_pointer(&self->uri, g_free);
+        g_clear_pointer(&self->filename, g_free);
+        g_clear_pointer(&self->backend_id, g_free);
+
+        G_OBJECT_CLASS(brisk_proxy_item_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_proxy_item_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_proxy_item_class_init(BriskProxyItemClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskItemClass *i_class = BRISK_ITEM_CLASS(klazz);
+
+        /* item vtable hookup */
+        i_class->get_id = brisk_proxy_item_get_id;
+        i_class->get_name = brisk_proxy_item_get_name;
+        i_class->get_display_name = brisk_proxy_item_get_display_name;
+        i_class->get_summary = brisk_proxy_item_get_summary;
+        i_class->get_icon = brisk_proxy_item_get_icon;
+        i_class->get_backend_id = brisk_proxy_item_get_backend_id;
+        i_class->matches_search = brisk_proxy_item_matches_search;
+        i_class->search = brisk_proxy_item_search;
+        i_class->launch = brisk_proxy_item_launch;
+        i_class->get_uri = brisk_proxy_item_get_uri;
+        i_class->get_app_info = brisk_proxy_item_get_app_info;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_proxy_item_dispose;
+}
+
+/**
+ * brisk_proxy_item_init:
+ *
+ * Handle construction of the BriskProxyItem
+ */
+static void brisk_proxy_item_init(__brisk_unused__ BriskProxyItem *self)
+{
+}
+
+/**
+ * The host sends empty strings in place of NULL
+ */
+static inline const gchar *brisk_proxy_item_nullable(const gchar *str)
+{
+        return str && *str ? str : NULL;
+}
+
+static const gchar *brisk_proxy_item_get_id(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return brisk_proxy_item_nullable(self->id);
+}
+
+static const gchar *brisk_proxy_item_get_name(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return brisk_proxy_item_nullable(self->name);
+}
+
+static const gchar *brisk_proxy_item_get_display_name(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return brisk_proxy_item_nullable(self->display_name);
+}
+
+static const gchar *brisk_proxy_item_get_summary(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return brisk_proxy_item_nullable(self->summary);
+}
+
+static const GIcon *brisk_proxy_item_get_icon(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_proxy_item_get_backend_id(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return (const gchar *)self->backend_id;
+}
+
+/**
+ * Same matching rules as the in-process backends use. The host already
+ * folded every field for us.
+ */
+__brisk_pure__ static gboolean brisk_proxy_item_matches_search(BriskItem *item, gchar *term)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+
+        return brisk_search_keys_contains(self->search, term);
+}
+
+static gboolean brisk_proxy_item_search(BriskItem *item, const gchar *term, const gint *weights,
+                                        BriskSearchMatch *match)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+
+        return brisk_search_keys_match(self->search, term, weights, match);
+}
+
+/**
+ * Only .desktop file backed items can be launched locally
+ */
+static GAppInfo *brisk_proxy_item_get_app_info(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+
+        if (!self->info && self->filename[0] != '\0') {
+                self->info = G_APP_INFO(g_desktop_app_info_new_from_filename(self->filename));
+        }
+        return self->info;
+}
+
+static gboolean brisk_proxy_item_launch(BriskItem *item, GAppLaunchContext *context)
+{
+        GAppInfo *info = brisk_proxy_item_get_app_info(item);
+
+        if (!info) {
+                return FALSE;
+        }
+        return g_app_info_launch(info, NULL, context, NULL);
+}
+
+static gchar *brisk_proxy_item_get_uri(BriskItem *item)
+{
+        BriskProxyItem *self = BRISK_PROXY_ITEM(item);
+        return g_strdup(brisk_proxy_item_nullable(self->uri));
+}
+
+/**
+ * brisk_proxy_item_in_section:
+ *
+ * Determine whether the host placed this item within the given section
+ */
+gboolean brisk_proxy_item_in_section(BriskProxyItem *self, const gchar *section_id)
+{
+        for (guint i = 0; self->sections[i]; i++) {
+                if (g_str_equal(self->sections[i], section_id)) {
+                        return TRUE;
+                }
+        }
+        return FALSE;
+}
+
+/**
+ * brisk_proxy_item_get_actions:
+ *
+ * Rebuild the context menu that the host backend provided for this item.
+ * The actions themselves are forwarded to the host by the proxy backend.
+ */
+GMenu *brisk_proxy_item_get_actions(BriskProxyItem *self)
+{
+        GMenu *ret = NULL;
+        GVariantIter iter = { 0 };
+        const gchar *label = NULL;
+        const gchar *action = NULL;
+        GVariant *target = NULL;
+
+        if (g_variant_n_children(self->actions) < 1) {
+                return NULL;
+        }
+
+        ret = g_menu_new();
+
+        g_variant_iter_init(&iter, self->actions);
+        while (g_variant_iter_next(&iter, "(&s&sv)", &label, &action, &target)) {
+                GMenuItem *menu_item = g_menu_item_new(label, NULL);
+
+                /* Unit stands in for actions without a parameter */
+                if (g_variant_is_of_type(target, G_VARIANT_TYPE_UNIT)) {
+                        g_menu_item_set_action_and_target_value(menu_item, action, NULL);
+                } else {
+                        g_menu_item_set_action_and_target_value(menu_item, action, target);
+                }
+                g_menu_append_item(ret, menu_item);
+                g_object_unref(menu_item);
+                g_variant_unref(target);
+        }
+
+        return ret;
+}
+
+/**
+ * brisk_proxy_item_new:
+ *
+ * Construct a new BriskProxyItem from its serialised form
+ */
+BriskItem *brisk_proxy_item_new(const gchar *backend_id, GVariant *data)
+{
+        BriskProxyItem *self = NULL;
+        GVariant *icon = NULL;
+        GVariantIter *search = NULL;
+        const gchar *key = NULL;
+        guint32 field = 0;
+
+        self = g_object_new(BRISK_TYPE_PROXY_ITEM, NULL);
+        self->backend_id = g_strdup(backend_id);
+
+        g_variant_get(data,
+                      "(sssssv" BRISK_HOST_SEARCH_TYPE "^as@" BRISK_HOST_ACTIONS_TYPE "s)",
+                      &self->id,
+                      &self->name,
+                      &self->display_name,
+                      &self->summary,
+                      &self->uri,
+                      &icon,
+                      &search,
+                      &self->sections,
+                      &self->actions,
+                      &self->filename);
+
+        self->icon = brisk_proxy_deserialize_icon(icon);
+        g_variant_unref(icon);
+
+        /* Don't trust the host with our array bounds */
+        self->search = brisk_search_keys_new();
+        while (g_variant_iter_next(search, "(u&s)", &field, &key)) {
+                brisk_search_keys_add_folded(self->search,
+                                             MIN(field, BRISK_SEARCH_FIELD_OTHER),
+                                             key);
+        }
+        g_variant_iter_free(search);
+
+        return BRISK_ITEM(self);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
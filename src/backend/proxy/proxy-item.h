@@ -0,0 +1,53 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+#include "../item.h"
+
+G_BEGIN_DECLS
+
+typedef struct _BriskProxyItem BriskProxyItem;
+typedef struct _BriskProxyItemClass BriskProxyItemClass;
+
+#define BRISK_TYPE_PROXY_ITEM brisk_proxy_item_get_type()
+#define BRISK_PROXY_ITEM(o) (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_PROXY_ITEM, BriskProxyItem))
+#define BRISK_IS_PROXY_ITEM(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_PROXY_ITEM))
+#define BRISK_PROXY_ITEM_CLASS(o)                                                                  \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_PROXY_ITEM, BriskProxyItemClass))
+#define BRISK_IS_PROXY_ITEM_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_PROXY_ITEM))
+#define BRISK_PROXY_ITEM_GET_CLASS(o)                                                              \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_PROXY_ITEM, BriskProxyItemClass))
+
+GType brisk_proxy_item_get_type(void);
+
+BriskItem *brisk_proxy_item_new(const gchar *backend_id, GVariant *data);
+
+gboolean brisk_proxy_item_in_section(BriskProxyItem *item, const gchar *section_id);
+GMenu *brisk_proxy_item_get_actions(BriskProxyItem *item);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,67 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+/**
+ * Shared between the proxy backend and brisk-backend-host, see
+ * data/com.solus_project.Brisk.BackendHost.xml for the interface itself.
+ */
+
+/**
+ * Where the host exports the BackendHost interface
+ */
+#define BRISK_HOST_OBJECT_PATH "/com/solus_project/Brisk/BackendHost"
+
+/**
+ * Where the host exports the actions registered by its backends
+ */
+#define BRISK_HOST_ACTIONS_PATH "/com/solus_project/Brisk/BackendHost/Actions"
+
+/**
+ * Name of the host executable within PACKAGE_LIBEXECDIR
+ */
+#define BRISK_HOST_EXECUTABLE "brisk-backend-host"
+
+/**
+ * (id, name, icon)
+ */
+#define BRISK_HOST_SECTION_TYPE "(ssv)"
+
+/**
+ * A context menu as a list of (label, action, target), where the target is
+ * the unit type for actions without a parameter
+ */
+#define BRISK_HOST_ACTIONS_TYPE "a(ssv)"
+
+/**
+ * Folded search keys as (BriskSearchField, key)
+ */
+#define BRISK_HOST_SEARCH_TYPE "a(us)"
+
+/**
+ * (id, name, display name, summary, uri, icon, search keys, section IDs,
+ *  context actions, .desktop filename)
+ */
+#define BRISK_HOST_ITEM_TYPE "(sssssv" BRISK_HOST_SEARCH_TYPE "as" BRISK_HOST_ACTIONS_TYPE "s)"
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
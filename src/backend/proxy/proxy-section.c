@@ -0,0 +1,177 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "proxy-item.h"
+#include "proxy-protocol.h"
+#include "proxy-section.h"
+BRISK_END_PEDANTIC
+
+struct _BriskProxySectionClass {
+        BriskSectionClass parent_class;
+};
+
+/**
+ * BriskProxySection is a local copy of a section living in brisk-backend-host
+ */
+struct _BriskProxySection {
+        BriskSection parent;
+
+        gchar *id;
+        gchar *name;
+        GIcon *icon;
+        gchar *backend_id;
+};
+
+G_DEFINE_TYPE(BriskProxySection, brisk_proxy_section, BRISK_TYPE_SECTION)
+
+static const gchar *brisk_proxy_section_get_id(BriskSection *section);
+static const gchar *brisk_proxy_section_get_name(BriskSection *section);
+static const GIcon *brisk_proxy_section_get_icon(BriskSection *section);
+static const gchar *brisk_proxy_section_get_backend_id(BriskSection *section);
+static gboolean brisk_proxy_section_can_show_item(BriskSection *section, BriskItem *item);
+
+/**
+ * brisk_proxy_section_dispose:
+ *
+ * Clean up a BriskProxySection instance
+ */
+static void brisk_proxy_section_dispose(GObject *obj)
+{
+        BriskProxySection *self = BRISK_PROXY_SECTION(obj);
+
+        g_clear_object(&self->icon);
+        g_clear_pointer(&self->id, g_free);
+        g_clear_pointer(&self->name, g_free);
+        g_clear_pointer(&self->backend_id, g_free);
+
+        G_OBJECT_CLASS(brisk_proxy_section_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_proxy_section_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_proxy_section_class_init(BriskProxySectionClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskSectionClass *s_class = BRISK_SECTION_CLASS(klazz);
+
+        /* section vtable hookup */
+        s_class->get_id = brisk_proxy_section_get_id;
+        s_class->get_name = brisk_proxy_section_get_name;
+        s_class->get_icon = brisk_proxy_section_get_icon;
+        s_class->get_backend_id = brisk_proxy_section_get_backend_id;
+        s_class->can_show_item = brisk_proxy_section_can_show_item;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_proxy_section_dispose;
+}
+
+/**
+ * brisk_proxy_section_init:
+ *
+ * Handle construction of the BriskProxySection
+ */
+static void brisk_proxy_section_init(__brisk_unused__ BriskProxySection *self)
+{
+}
+
+static const gchar *brisk_proxy_section_get_id(BriskSection *section)
+{
+        BriskProxySection *self = BRISK_PROXY_SECTION(section);
+        return (const gchar *)self->id;
+}
+
+static const gchar *brisk_proxy_section_get_name(BriskSection *section)
+{
+        BriskProxySection *self = BRISK_PROXY_SECTION(section);
+        return (const gchar *)self->name;
+}
+
+static const GIcon *brisk_proxy_section_get_icon(BriskSection *section)
+{
+        BriskProxySection *self = BRISK_PROXY_SECTION(section);
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_proxy_section_get_backend_id(BriskSection *section)
+{
+        BriskProxySection *self = BRISK_PROXY_SECTION(section);
+        return (const gchar *)self->backend_id;
+}
+
+/**
+ * The host already worked out which sections every item belongs to
+ */
+static gboolean brisk_proxy_section_can_show_item(BriskSection *section, BriskItem *item)
+{
+        BriskProxySection *self = BRISK_PROXY_SECTION(section);
+
+        if (G_UNLIKELY(item == NULL) || G_UNLIKELY(!BRISK_IS_PROXY_ITEM(item))) {
+                return FALSE;
+        }
+
+        return brisk_proxy_item_in_section(BRISK_PROXY_ITEM(item), self->id);
+}
+
+/**
+ * brisk_proxy_deserialize_icon:
+ *
+ * Turn a serialised icon from the host back into a GIcon, or NULL when the
+ * host sent us an empty string
+ */
+GIcon *brisk_proxy_deserialize_icon(GVariant *icon)
+{
+        if (g_variant_is_of_type(icon, G_VARIANT_TYPE_STRING) &&
+            g_variant_get_string(icon, NULL)[0] == '\0') {
+                return NULL;
+        }
+        return g_icon_deserialize(icon);
+}
+
+/**
+ * brisk_proxy_section_new:
+ *
+ * Construct a new BriskProxySection from its serialised form
+ */
+BriskSection *brisk_proxy_section_new(const gchar *backend_id, GVariant *data)
+{
+        BriskProxySection *self = NULL;
+        GVariant *icon = NULL;
+
+        self = g_object_new(BRISK_TYPE_PROXY_SECTION, NULL);
+        self->backend_id = g_strdup(backend_id);
+
+        g_variant_get(data, BRISK_HOST_SECTION_TYPE, &self->id, &self->name, &icon);
+        self->icon = brisk_proxy_deserialize_icon(icon);
+        g_variant_unref(icon);
+
+        return BRISK_SECTION(self);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
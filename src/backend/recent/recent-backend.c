@@ -0,0 +1,279 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "recent-backend.h"
+#include "recent-item.h"
+#include "recent-section.h"
+#include <glib/gi18n.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(GHashTable, g_hash_table_unref)
+
+G_DEFINE_TYPE(BriskRecentBackend, brisk_recent_backend, BRISK_TYPE_BACKEND)
+
+static gboolean brisk_recent_backend_load(BriskBackend *backend);
+static void brisk_recent_backend_changed(GtkRecentManager *manager, BriskRecentBackend *self);
+
+/**
+ * Tell the frontends what we are
+ */
+static unsigned int brisk_recent_backend_get_flags(__brisk_unused__ BriskBackend *backend)
+{
+        return BRISK_BACKEND_SOURCE;
+}
+
+static const gchar *brisk_recent_backend_get_id(__brisk_unused__ BriskBackend *backend)
+{
+        return "recent";
+}
+
+static const gchar *brisk_recent_backend_get_display_name(__brisk_unused__ BriskBackend *backend)
+{
+        return _("Recent");
+}
+
+/**
+ * brisk_recent_backend_dispose:
+ *
+ * Clean up a BriskRecentBackend instance
+ */
+static void brisk_recent_backend_dispose(GObject *obj)
+{
+        BriskRecentBackend *self = BRISK_RECENT_BACKEND(obj);
+
+        if (self->refresh_id > 0) {
+                g_source_remove(self->refresh_id);
+                self->refresh_id = 0;
+        }
+        if (self->manager) {
+                g_signal_handlers_disconnect_by_data(self->manager, self);
+                self->manager = NULL;
+        }
+        g_clear_pointer(&self->items, g_hash_table_unref);
+        g_queue_foreach(&self->pool, (GFunc)g_object_unref, NULL);
+        g_queue_clear(&self->pool);
+
+        G_OBJECT_CLASS(brisk_recent_backend_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_recent_backend_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_recent_backend_class_init(BriskRecentBackendClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskBackendClass *b_class = BRISK_BACKEND_CLASS(klazz);
+
+        /* Backend vtable hookup */
+        b_class->get_flags = brisk_recent_backend_get_flags;
+        b_class->get_id = brisk_recent_backend_get_id;
+        b_class->get_display_name = brisk_recent_backend_get_display_name;
+        b_class->load = brisk_recent_backend_load;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_recent_backend_dispose;
+}
+
+/**
+ * brisk_recent_backend_init:
+ *
+ * Handle construction of the BriskRecentBackend
+ */
+static void brisk_recent_backend_init(BriskRecentBackend *self)
+{
+        /* Keys are owned by the item */
+        self->items = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_object_unref);
+        g_queue_init(&self->pool);
+
+        /* The default manager is owned by GTK */
+        self->manager = gtk_recent_manager_get_default();
+        g_signal_connect(self->manager,
+                         "changed",
+                         G_CALLBACK(brisk_recent_backend_changed),
+                         self);
+}
+
+/**
+ * Most recently modified first
+ */
+static gint brisk_recent_backend_compare(gconstpointer a, gconstpointer b)
+{
+        time_t ma = gtk_recent_info_get_modified((GtkRecentInfo *)a);
+        time_t mb = gtk_recent_info_get_modified((GtkRecentInfo *)b);
+
+        if (ma == mb) {
+                return 0;
+        }
+        return ma > mb ? -1 : 1;
+}
+
+/**
+ * Only local documents that still exist are worth showing, as they're the
+ * only ones we can reliably open again.
+ */
+static gboolean brisk_recent_backend_wants(GtkRecentInfo *info)
+{
+        if (gtk_recent_info_get_private_hint(info)) {
+                return FALSE;
+        }
+        if (!gtk_recent_info_is_local(info)) {
+                return FALSE;
+        }
+        return gtk_recent_info_exists(info);
+}
+
+/**
+ * Return an item for reuse, falling back to a new one if the pool is empty.
+ * The returned item is always owned by the caller.
+ */
+static BriskItem *brisk_recent_backend_take_item(BriskRecentBackend *self)
+{
+        BriskItem *item = g_queue_pop_head(&self->pool);
+
+        if (item) {
+                return item;
+        }
+        return g_object_ref_sink(brisk_recent_item_new());
+}
+
+/**
+ * Give the item back to the pool, unless a frontend still holds on to it in
+ * which case we simply drop our reference.
+ */
+static void brisk_recent_backend_recycle_item(BriskRecentBackend *self, BriskItem *item)
+{
+        if (G_OBJECT(item)->ref_count == 1 && self->pool.length < BRISK_RECENT_MAX) {
+                g_queue_push_tail(&self->pool, item);
+                return;
+        }
+        g_object_unref(item);
+}
+
+/**
+ * Compare the current state of the recent manager against what we're showing,
+ * and only tell the frontends about the entries that were added, removed or
+ * moved.
+ */
+static gboolean brisk_recent_backend_refresh(BriskRecentBackend *self)
+{
+        autofree(GHashTable) *previous = self->items;
+        GList *infos = NULL;
+        GHashTableIter iter;
+        BriskItem *item = NULL;
+        gint rank = 0;
+
+        self->refresh_id = 0;
+        self->items = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_object_unref);
+
+        infos = g_list_sort(gtk_recent_manager_get_items(self->manager),
+                            brisk_recent_backend_compare);
+
+        for (GList *elem = infos; elem && rank < BRISK_RECENT_MAX; elem = elem->next) {
+                GtkRecentInfo *info = elem->data;
+                const gchar *uri = gtk_recent_info_get_uri(info);
+
+                if (!brisk_recent_backend_wants(info) || g_hash_table_contains(self->items, uri)) {
+                        continue;
+                }
+
+                if (g_hash_table_lookup_extended(previous, uri, NULL, (void **)&item)) {
+                        /* Steal our reference from the old table */
+                        g_hash_table_steal(previous, uri);
+                        g_hash_table_insert(self->items, (gpointer)brisk_item_get_id(item), item);
+                        if (brisk_recent_item_get_rank(BRISK_RECENT_ITEM(item)) != rank) {
+                                brisk_recent_item_set_rank(BRISK_RECENT_ITEM(item), rank);
+                                brisk_backend_item_changed(BRISK_BACKEND(self), uri);
+                        }
+                } else {
+                        item = brisk_recent_backend_take_item(self);
+                        brisk_recent_item_set_info(BRISK_RECENT_ITEM(item), info);
+                        brisk_recent_item_set_rank(BRISK_RECENT_ITEM(item), rank);
+                        g_hash_table_insert(self->items, (gpointer)brisk_item_get_id(item), item);
+                        brisk_backend_item_added(BRISK_BACKEND(self), item);
+                }
+                ++rank;
+        }
+
+        g_list_free_full(infos, (GDestroyNotify)gtk_recent_info_unref);
+
+        /* Whatever is left dropped out of the list */
+        g_hash_table_iter_init(&iter, previous);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&item)) {
+                brisk_backend_item_removed(BRISK_BACKEND(self), brisk_item_get_id(item));
+                g_hash_table_iter_steal(&iter);
+                brisk_recent_backend_recycle_item(self, item);
+        }
+
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * The recent manager tends to fire in bursts, so coalesce them into a single
+ * refresh once things have calmed down.
+ */
+static void brisk_recent_backend_changed(__brisk_unused__ GtkRecentManager *manager,
+                                         BriskRecentBackend *self)
+{
+        if (self->refresh_id > 0) {
+                return;
+        }
+        self->refresh_id = g_idle_add_full(G_PRIORITY_LOW,
+                                           (GSourceFunc)brisk_recent_backend_refresh,
+                                           self,
+                                           NULL);
+}
+
+/**
+ * brisk_recent_backend_load:
+ *
+ * Emit our section and the initial set of documents
+ */
+static gboolean brisk_recent_backend_load(BriskBackend *backend)
+{
+        BriskRecentBackend *self = BRISK_RECENT_BACKEND(backend);
+
+        if (self->refresh_id > 0) {
+                g_source_remove(self->refresh_id);
+        }
+        brisk_backend_section_added(backend, brisk_recent_section_new());
+        brisk_recent_backend_refresh(self);
+        return TRUE;
+}
+
+/**
+ * brisk_recent_backend_new:
+ *
+ * Return a newly created BriskRecentBackend
+ */
+BriskBackend *brisk_recent_backend_new(void)
+{
+        return g_object_new(BRISK_TYPE_RECENT_BACKEND, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,71 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include "../backend.h"
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/**
+ * How many documents we'll show in the Recent section
+ */
+#define BRISK_RECENT_MAX 20
+
+typedef struct _BriskRecentBackend BriskRecentBackend;
+typedef struct _BriskRecentBackendClass BriskRecentBackendClass;
+
+struct _BriskRecentBackendClass {
+        BriskBackendClass parent_class;
+};
+
+/**
+ * BriskRecentBackend exposes the most recently used documents, as tracked by
+ * the GtkRecentManager
+ */
+struct _BriskRecentBackend {
+        BriskBackend parent;
+        GtkRecentManager *manager;
+        GHashTable *items; /**<URI to BriskRecentItem currently shown */
+        GQueue pool;       /**<Spare items no longer referenced by any frontend */
+        guint refresh_id;
+};
+
+#define BRISK_TYPE_RECENT_BACKEND brisk_recent_backend_get_type()
+#define BRISK_RECENT_BACKEND(o)                                                                    \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_RECENT_BACKEND, BriskRecentBackend))
+#define BRISK_IS_RECENT_BACKEND(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_RECENT_BACKEND))
+#define BRISK_RECENT_BACKEND_CLASS(o)                                                              \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_RECENT_BACKEND, BriskRecentBackendClass))
+#define BRISK_IS_RECENT_BACKEND_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_RECENT_BACKEND))
+#define BRISK_RECENT_BACKEND_GET_CLASS(o)                                                          \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_RECENT_BACKEND, BriskRecentBackendClass))
+
+GType brisk_recent_backend_get_type(void);
+
+BriskBackend *brisk_recent_backend_new(void);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
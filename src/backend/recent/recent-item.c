@@ -0,0 +1,226 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "../search.h"
+#include "recent-item.h"
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(GError, g_error_free)
+
+struct _BriskRecentItemClass {
+        BriskItemClass parent_class;
+};
+
+/**
+ * BriskRecentItem is a single recently used document
+ */
+struct _BriskRecentItem {
+        BriskItem parent;
+        gchar *uri;          /**<Our ID */
+        gchar *name;         /**<Display name, as chosen by the application */
+        gchar *summary;      /**<Where the document lives */
+        gchar *folded_name;  /**<For searching */
+        gchar *content_type; /**<Only turned into an icon once displayed */
+        GIcon *icon;
+        gint rank; /**<Position within the recent list */
+};
+
+G_DEFINE_TYPE(BriskRecentItem, brisk_recent_item, BRISK_TYPE_ITEM)
+
+static const gchar *brisk_recent_item_get_id(BriskItem *item);
+static const gchar *brisk_recent_item_get_name(BriskItem *item);
+static const gchar *brisk_recent_item_get_summary(BriskItem *item);
+static const GIcon *brisk_recent_item_get_icon(BriskItem *item);
+static const gchar *brisk_recent_item_get_backend_id(BriskItem *item);
+static gboolean brisk_recent_item_matches_search(BriskItem *item, gchar *term);
+static gboolean brisk_recent_item_launch(BriskItem *item, GAppLaunchContext *context);
+static gchar *brisk_recent_item_get_uri(BriskItem *item);
+
+/**
+ * Drop everything describing the current document
+ */
+static void brisk_recent_item_clear(BriskRecentItem *self)
+{
+        g_clear_object(&self->icon);
+        g_clear_pointer(&self->uri, g_free);
+        g_clear_pointer(&self->name, g_free);
+        g_clear_pointer(&self->summary, g_free);
+        g_clear_pointer(&self->folded_name, g_free);
+        g_clear_pointer(&self->content_type, g_free);
+}
+
+/**
+ * brisk_recent_item_dispose:
+ *
+ * Clean up a BriskRecentItem instance
+ */
+static void brisk_recent_item_dispose(GObject *obj)
+{
+        brisk_recent_item_clear(BRISK_RECENT_ITEM(obj));
+
+        G_OBJECT_CLASS(brisk_recent_item_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_recent_item_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_recent_item_class_init(BriskRecentItemClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskItemClass *i_class = BRISK_ITEM_CLASS(klazz);
+
+        /* item vtable hookup */
+        i_class->get_id = brisk_recent_item_get_id;
+        i_class->get_name = brisk_recent_item_get_name;
+        i_class->get_display_name = brisk_recent_item_get_name;
+        i_class->get_summary = brisk_recent_item_get_summary;
+        i_class->get_icon = brisk_recent_item_get_icon;
+        i_class->get_backend_id = brisk_recent_item_get_backend_id;
+        i_class->matches_search = brisk_recent_item_matches_search;
+        i_class->launch = brisk_recent_item_launch;
+        i_class->get_uri = brisk_recent_item_get_uri;
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_recent_item_dispose;
+}
+
+/**
+ * brisk_recent_item_init:
+ *
+ * Handle construction of the BriskRecentItem
+ */
+static void brisk_recent_item_init(BriskRecentItem *self)
+{
+        self->rank = -1;
+}
+
+static const gchar *brisk_recent_item_get_id(BriskItem *item)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+        return (const gchar *)self->uri;
+}
+
+static const gchar *brisk_recent_item_get_name(BriskItem *item)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+        return (const gchar *)self->name;
+}
+
+static const gchar *brisk_recent_item_get_summary(BriskItem *item)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+        return (const gchar *)self->summary;
+}
+
+/**
+ * Resolve the icon for the MIME type the first time we're displayed
+ */
+static const GIcon *brisk_recent_item_get_icon(BriskItem *item)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+
+        if (!self->icon && self->content_type) {
+                self->icon = g_content_type_get_icon(self->content_type);
+        }
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_recent_item_get_backend_id(__brisk_unused__ BriskItem *item)
+{
+        return "recent";
+}
+
+static gboolean brisk_recent_item_matches_search(BriskItem *item, gchar *term)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+
+        return brisk_search_text_contains(self->folded_name, term);
+}
+
+/**
+ * Open the document with the default handler for its type
+ */
+static gboolean brisk_recent_item_launch(BriskItem *item, GAppLaunchContext *context)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+        autofree(GError) *error = NULL;
+
+        if (!g_app_info_launch_default_for_uri(self->uri, context, &error)) {
+                g_message("Failed to open %s: %s", self->uri, error->message);
+                return FALSE;
+        }
+        return TRUE;
+}
+
+static gchar *brisk_recent_item_get_uri(BriskItem *item)
+{
+        BriskRecentItem *self = BRISK_RECENT_ITEM(item);
+        return g_strdup(self->uri);
+}
+
+/**
+ * brisk_recent_item_set_info:
+ *
+ * Point the item at a (possibly different) recently used document. The icon
+ * is left for get_icon to resolve again.
+ */
+void brisk_recent_item_set_info(BriskRecentItem *self, GtkRecentInfo *info)
+{
+        brisk_recent_item_clear(self);
+
+        self->uri = g_strdup(gtk_recent_info_get_uri(info));
+        self->name = g_strdup(gtk_recent_info_get_display_name(info));
+        self->summary = gtk_recent_info_get_uri_display(info);
+        self->folded_name = brisk_search_fold(self->name);
+        self->content_type = g_content_type_from_mime_type(gtk_recent_info_get_mime_type(info));
+}
+
+gint brisk_recent_item_get_rank(BriskRecentItem *self)
+{
+        return self->rank;
+}
+
+void brisk_recent_item_set_rank(BriskRecentItem *self, gint rank)
+{
+        self->rank = rank;
+}
+
+/**
+ * brisk_recent_item_new:
+ *
+ * Return a new, empty, BriskRecentItem
+ */
+BriskItem *brisk_recent_item_new(void)
+{
+        return g_object_new(BRISK_TYPE_RECENT_ITEM, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
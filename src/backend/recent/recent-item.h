@@ -0,0 +1,57 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+#include <gtk/gtk.h>
+
+#include "../item.h"
+
+G_BEGIN_DECLS
+
+typedef struct _BriskRecentItem BriskRecentItem;
+typedef struct _BriskRecentItemClass BriskRecentItemClass;
+
+#define BRISK_TYPE_RECENT_ITEM brisk_recent_item_get_type()
+#define BRISK_RECENT_ITEM(o)                                                                       \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_RECENT_ITEM, BriskRecentItem))
+#define BRISK_IS_RECENT_ITEM(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_RECENT_ITEM))
+#define BRISK_RECENT_ITEM_CLASS(o)                                                                 \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_RECENT_ITEM, BriskRecentItemClass))
+#define BRISK_IS_RECENT_ITEM_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_RECENT_ITEM))
+#define BRISK_RECENT_ITEM_GET_CLASS(o)                                                             \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_RECENT_ITEM, BriskRecentItemClass))
+
+GType brisk_recent_item_get_type(void);
+
+BriskItem *brisk_recent_item_new(void);
+
+/* Items are recycled, so all state comes from here rather than construction */
+void brisk_recent_item_set_info(BriskRecentItem *self, GtkRecentInfo *info);
+gint brisk_recent_item_get_rank(BriskRecentItem *self);
+void brisk_recent_item_set_rank(BriskRecentItem *self, gint rank);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,146 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "recent-item.h"
+#include "recent-section.h"
+#include <glib/gi18n.h>
+BRISK_END_PEDANTIC
+
+struct _BriskRecentSectionClass {
+        BriskSectionClass parent_class;
+};
+
+struct _BriskRecentSection {
+        BriskSection parent;
+        GIcon *icon; /**<Display icon */
+};
+
+G_DEFINE_TYPE(BriskRecentSection, brisk_recent_section, BRISK_TYPE_SECTION)
+
+static const gchar *brisk_recent_section_get_id(BriskSection *section);
+static const gchar *brisk_recent_section_get_name(BriskSection *section);
+static const GIcon *brisk_recent_section_get_icon(BriskSection *section);
+static const gchar *brisk_recent_section_get_backend_id(BriskSection *section);
+static gint brisk_recent_section_get_sort_order(BriskSection *section, BriskItem *item);
+static gboolean brisk_recent_section_can_show_item(BriskSection *section, BriskItem *item);
+
+/**
+ * brisk_recent_section_dispose:
+ *
+ * Clean up a BriskRecentSection instance
+ */
+static void brisk_recent_section_dispose(GObject *obj)
+{
+        BriskRecentSection *self = BRISK_RECENT_SECTION(obj);
+
+        g_clear_object(&self->icon);
+
+        G_OBJECT_CLASS(brisk_recent_section_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_recent_section_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_recent_section_class_init(BriskRecentSectionClass *klazz)
+{
+        BriskSectionClass *s_class = BRISK_SECTION_CLASS(klazz);
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+
+        /* section vtable hookup */
+        s_class->get_id = brisk_recent_section_get_id;
+        s_class->get_name = brisk_recent_section_get_name;
+        s_class->get_icon = brisk_recent_section_get_icon;
+        s_class->get_backend_id = brisk_recent_section_get_backend_id;
+        s_class->can_show_item = brisk_recent_section_can_show_item;
+        s_class->get_sort_order = brisk_recent_section_get_sort_order;
+
+        obj_class->dispose = brisk_recent_section_dispose;
+}
+
+/**
+ * brisk_recent_section_init:
+ *
+ * Handle construction of the BriskRecentSection. Does absolutely nothing
+ * special outside of creating our icon.
+ */
+static void brisk_recent_section_init(BriskRecentSection *self)
+{
+        self->icon = g_themed_icon_new_with_default_fallbacks("folder-recent");
+}
+
+static const gchar *brisk_recent_section_get_id(__brisk_unused__ BriskSection *section)
+{
+        return "recent";
+}
+
+static const gchar *brisk_recent_section_get_name(__brisk_unused__ BriskSection *section)
+{
+        return _("Recent");
+}
+
+static const GIcon *brisk_recent_section_get_icon(BriskSection *section)
+{
+        BriskRecentSection *self = BRISK_RECENT_SECTION(section);
+        return (const GIcon *)self->icon;
+}
+
+static const gchar *brisk_recent_section_get_backend_id(__brisk_unused__ BriskSection *item)
+{
+        return "recent";
+}
+
+static gboolean brisk_recent_section_can_show_item(__brisk_unused__ BriskSection *section,
+                                                   BriskItem *item)
+{
+        return BRISK_IS_RECENT_ITEM(item);
+}
+
+/**
+ * Most recently used documents come first
+ */
+static gint brisk_recent_section_get_sort_order(__brisk_unused__ BriskSection *section,
+                                                BriskItem *item)
+{
+        if (!BRISK_IS_RECENT_ITEM(item)) {
+                return -1;
+        }
+        return brisk_recent_item_get_rank(BRISK_RECENT_ITEM(item));
+}
+
+/**
+ * brisk_recent_section_new:
+ *
+ * Return a new BriskRecentSection
+ */
+BriskSection *brisk_recent_section_new(void)
+{
+        return g_object_new(BRISK_TYPE_RECENT_SECTION, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
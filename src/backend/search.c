@@ -0,0 +1,613 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <string.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "search.h"
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GVariant, g_variant_unref)
+
+/**
+ * Names of the fields within the search-weights key, and the weights used
+ * for any field the key leaves out
+ */
+static const struct {
+        const gchar *name;
+        gint weight;
+} brisk_search_fields[BRISK_SEARCH_N_FIELDS] = {
+        [BRISK_SEARCH_FIELD_NAME] = { "name", 100 },
+        [BRISK_SEARCH_FIELD_GENERIC_NAME] = { "generic-name", 60 },
+        [BRISK_SEARCH_FIELD_KEYWORDS] = { "keywords", 40 },
+        [BRISK_SEARCH_FIELD_CATEGORIES] = { "categories", 20 },
+        [BRISK_SEARCH_FIELD_DESCRIPTION] = { "description", 10 },
+        [BRISK_SEARCH_FIELD_EXEC] = { "exec", 30 },
+        [BRISK_SEARCH_FIELD_OTHER] = { "other", 50 },
+};
+
+/**
+ * Nothing to decompose or strip for plain ASCII, which is what most of the
+ * search terms and a good chunk of the .desktop names turn out to be
+ */
+__brisk_pure__ static gboolean brisk_search_is_ascii(const gchar *str)
+{
+        for (const gchar *c = str; *c; c++) {
+                if ((guchar)*c >= 0x80) {
+                        return FALSE;
+                }
+        }
+        return TRUE;
+}
+
+/**
+ * Combining diacritics only, i.e. accents on Latin, Greek and Cyrillic. Other
+ * non-spacing marks such as dakuten, Thai vowels or Devanagari matras are
+ * letters in their own right and must survive folding.
+ */
+__brisk_pure__ static inline gboolean brisk_search_is_diacritic(gunichar uc)
+{
+        return (uc >= 0x0300 && uc <= 0x036F) || (uc >= 0x1AB0 && uc <= 0x1AFF) ||
+               (uc >= 0x1DC0 && uc <= 0x1DFF) || (uc >= 0x20D0 && uc <= 0x20FF) ||
+               (uc >= 0xFE20 && uc <= 0xFE2F);
+}
+
+/**
+ * brisk_search_fold_unstripped:
+ *
+ * As brisk_search_fold, but keeping any leading and trailing whitespace. The
+ * label highlighting folds one character at a time through here, so that a
+ * lone no-break space still folds to a space and not to nothing.
+ *
+ * Returns a newly allocated string, or NULL if str is NULL
+ */
+gchar *brisk_search_fold_unstripped(const gchar *str)
+{
+        autofree(gchar) *folded = NULL;
+        autofree(gchar) *normal = NULL;
+        autofree(gchar) *stripped = NULL;
+        GString *ret = NULL;
+
+        if (!str) {
+                return NULL;
+        }
+
+        if (brisk_search_is_ascii(str) || !g_utf8_validate(str, -1, NULL)) {
+                return g_ascii_strdown(str, -1);
+        }
+
+        folded = g_utf8_casefold(str, -1);
+        normal = g_utf8_normalize(folded, -1, G_NORMALIZE_ALL);
+
+        ret = g_string_sized_new(strlen(normal));
+        for (const gchar *c = normal; *c; c = g_utf8_next_char(c)) {
+                gunichar uc = g_utf8_get_char(c);
+
+                /* Accents end up as their own code point after NFKD */
+                if (brisk_search_is_diacritic(uc)) {
+                        continue;
+                }
+                g_string_append_unichar(ret, uc);
+        }
+
+        /* Put back together whatever kept its marks, i.e. voiced kana */
+        stripped = g_string_free(ret, FALSE);
+        return g_utf8_normalize(stripped, -1, G_NORMALIZE_ALL_COMPOSE);
+}
+
+/**
+ * brisk_search_fold:
+ *
+ * Fold the string down to the form used for matching: casefolded, stripped
+ * of diacritics and leading/trailing whitespace, then NFKC normalized. Both
+ * the search keys and the term go through here, so "Écran" is found by
+ * typing "ecran" and "ΒΙΒΛΊΑ" by typing "βιβλια", while "ガ" stays "ガ".
+ *
+ * Returns a newly allocated string, or NULL if str is NULL
+ */
+gchar *brisk_search_fold(const gchar *str)
+{
+        gchar *folded = brisk_search_fold_unstripped(str);
+
+        return folded ? g_strstrip(folded) : NULL;
+}
+
+/**
+ * Hepburn romanisation of the hiragana block, starting at U+3041. Katakana
+ * sits exactly 0x60 code points further along and shares the table.
+ */
+static const gchar *brisk_search_kana[] = {
+        "a", "a", "i", "i", "u", "u", "e", "e", "o", "o", "ka", "ga", "ki", "gi", "ku", "gu", "ke",
+        "ge", "ko", "go", "sa", "za", "shi", "ji", "su", "zu", "se", "ze", "so", "zo", "ta", "da",
+        "chi", "ji", "", "tsu", "zu", "te", "de", "to", "do", "na", "ni", "nu", "ne", "no", "ha",
+        "ba", "pa", "hi", "bi", "pi", "fu", "bu", "pu", "he", "be", "pe", "ho", "bo", "po", "ma",
+        "mi", "mu", "me", "mo", "ya", "ya", "yu", "yu", "yo", "yo", "ra", "ri", "ru", "re", "ro",
+        "wa", "wa", "wi", "we", "wo", "n", "vu", "ka", "ke",
+};
+
+#define BRISK_SEARCH_HIRAGANA_FIRST 0x3041
+#define BRISK_SEARCH_HIRAGANA_LAST 0x3096
+#define BRISK_SEARCH_KATAKANA_OFFSET 0x60
+
+/* Small vowels, ya, yu, yo and tsu modify their neighbours */
+#define BRISK_SEARCH_KANA_SMALL_VOWELS "\x01\x03\x05\x07\x09"
+#define BRISK_SEARCH_KANA_SMALL_Y "\x43\x45\x47"
+#define BRISK_SEARCH_KANA_SMALL_TSU 0x3063
+#define BRISK_SEARCH_KANA_LONG 0x30FC
+#define BRISK_SEARCH_KANA_DOT 0x30FB
+
+/**
+ * Revised Romanisation of Korean, applied per jamo without any of the
+ * assimilation rules between syllables
+ */
+static const gchar *brisk_search_hangul_initial[] = {
+        "g", "kk", "n", "d", "tt", "r", "m", "b", "pp", "s", "ss", "", "j", "jj", "ch", "k", "t",
+        "p", "h",
+};
+
+static const gchar *brisk_search_hangul_medial[] = {
+        "a", "ae", "ya", "yae", "eo", "e", "yeo", "ye", "o", "wa", "wae", "oe", "yo", "u", "wo",
+        "we", "wi", "yu", "eu", "ui", "i",
+};
+
+static const gchar *brisk_search_hangul_final[] = {
+        "", "k", "k", "k", "n", "n", "n", "t", "l", "k", "m", "l", "l", "l", "p", "l", "m", "p",
+        "p", "t", "t", "ng", "t", "t", "k", "t", "p", "t",
+};
+
+#define BRISK_SEARCH_HANGUL_FIRST 0xAC00
+#define BRISK_SEARCH_HANGUL_LAST 0xD7A3
+
+/**
+ * Look up the romanisation of a single kana, or NULL if it isn't one
+ */
+static const gchar *brisk_search_kana_lookup(gunichar uc, gunichar *hiragana)
+{
+        if (uc >= BRISK_SEARCH_HIRAGANA_FIRST + BRISK_SEARCH_KATAKANA_OFFSET &&
+            uc <= BRISK_SEARCH_HIRAGANA_LAST + BRISK_SEARCH_KATAKANA_OFFSET) {
+                uc -= BRISK_SEARCH_KATAKANA_OFFSET;
+        }
+        if (uc < BRISK_SEARCH_HIRAGANA_FIRST || uc > BRISK_SEARCH_HIRAGANA_LAST) {
+                return NULL;
+        }
+        *hiragana = uc;
+        return brisk_search_kana[uc - BRISK_SEARCH_HIRAGANA_FIRST];
+}
+
+/**
+ * Append a single kana to the romanised output. prev is the romanisation of
+ * the kana before it, which small kana combine with.
+ */
+static void brisk_search_append_kana(GString *out, gunichar hiragana, const gchar *romaji,
+                                     const gchar *prev, gboolean *geminate)
+{
+        guchar offset = (guchar)(hiragana - BRISK_SEARCH_HIRAGANA_FIRST + 1);
+        gsize len = out->len;
+
+        if (hiragana == BRISK_SEARCH_KANA_SMALL_TSU) {
+                *geminate = TRUE;
+                return;
+        }
+
+        /* kya, sha, cho: the small y kana replace the trailing i */
+        if (prev && strchr(BRISK_SEARCH_KANA_SMALL_Y, offset) && len > 0 &&
+            out->str[len - 1] == 'i' && prev[1] != '\0') {
+                g_string_truncate(out, len - 1);
+                if (g_str_equal(prev, "shi") || g_str_equal(prev, "chi") ||
+                    g_str_equal(prev, "ji")) {
+                        ++romaji;
+                }
+                g_string_append(out, romaji);
+                return;
+        }
+
+        /* fa, ti, va: small vowels replace the vowel before them */
+        if (prev && strchr(BRISK_SEARCH_KANA_SMALL_VOWELS, offset) && len > 0 &&
+            prev[1] != '\0') {
+                g_string_truncate(out, len - 1);
+                g_string_append(out, romaji);
+                return;
+        }
+
+        if (*geminate && g_ascii_isalpha(romaji[0]) && !strchr("aeiou", romaji[0])) {
+                g_string_append_c(out, romaji[0] == 'c' ? 't' : romaji[0]);
+        }
+        *geminate = FALSE;
+        g_string_append(out, romaji);
+}
+
+static void brisk_search_append_hangul(GString *out, gunichar uc)
+{
+        guint s = uc - BRISK_SEARCH_HANGUL_FIRST;
+
+        g_string_append(out, brisk_search_hangul_initial[s / 588]);
+        g_string_append(out, brisk_search_hangul_medial[(s % 588) / 28]);
+        g_string_append(out, brisk_search_hangul_final[s % 28]);
+}
+
+/**
+ * Anything else that has an obvious ASCII form, such as "ø" or "ł", gets
+ * that. Otherwise the character is kept, so a name mixing kanji and kana
+ * still finds the kanji.
+ *
+ * Returns TRUE if the character was replaced
+ */
+static gboolean brisk_search_append_other(GString *out, const gchar *c, gunichar uc)
+{
+        autofree(gchar) *ascii = NULL;
+        gchar buf[7] = { 0 };
+
+        g_unichar_to_utf8(uc, buf);
+        if (uc >= 0x80) {
+                ascii = g_str_to_ascii(buf, "C");
+        }
+        if (ascii && !strchr(ascii, '?')) {
+                g_string_append(out, ascii);
+                return TRUE;
+        }
+
+        g_string_append_len(out, c, (gssize)(g_utf8_next_char(c) - c));
+        return FALSE;
+}
+
+/**
+ * brisk_search_transliterate:
+ *
+ * Romanise the string so that it can be found by typing Latin letters.
+ * Kana become Hepburn romaji and Hangul become Revised Romanisation, which
+ * are both mechanical. Letters such as "ł" or "ø", which have no
+ * decomposition to fold away, get their ASCII form. Han characters would
+ * need a dictionary, so they are left as they are.
+ *
+ * Returns a newly allocated, folded, string, or NULL if there was nothing
+ * to romanise
+ */
+gchar *brisk_search_transliterate(const gchar *str)
+{
+        autofree(gchar) *normal = NULL;
+        GString *out = NULL;
+        const gchar *prev = NULL;
+        gboolean geminate = FALSE;
+        gboolean changed = FALSE;
+        gchar *ret = NULL;
+
+        if (!str || brisk_search_is_ascii(str) || !g_utf8_validate(str, -1, NULL)) {
+                return NULL;
+        }
+
+        /* Composed, so that voiced kana don't lose their dakuten in folding */
+        normal = g_utf8_normalize(str, -1, G_NORMALIZE_ALL_COMPOSE);
+        out = g_string_sized_new(strlen(normal));
+
+        for (const gchar *c = normal; *c; c = g_utf8_next_char(c)) {
+                gunichar uc = g_utf8_get_char(c);
+                gunichar hiragana = 0;
+                const gchar *romaji = brisk_search_kana_lookup(uc, &hiragana);
+
+                if (romaji) {
+                        brisk_search_append_kana(out, hiragana, romaji, prev, &geminate);
+                        prev = *romaji ? romaji : NULL;
+                        changed = TRUE;
+                        continue;
+                }
+
+                prev = NULL;
+                geminate = FALSE;
+
+                if (uc == BRISK_SEARCH_KANA_LONG && out->len > 0) {
+                        /* Lengthen the vowel before it */
+                        g_string_append_c(out, out->str[out->len - 1]);
+                        changed = TRUE;
+                } else if (uc == BRISK_SEARCH_KANA_DOT) {
+                        g_string_append_c(out, ' ');
+                        changed = TRUE;
+                } else if (uc >= BRISK_SEARCH_HANGUL_FIRST && uc <= BRISK_SEARCH_HANGUL_LAST) {
+                        brisk_search_append_hangul(out, uc);
+                        changed = TRUE;
+                } else if (brisk_search_append_other(out, c, uc)) {
+                        changed = TRUE;
+                }
+        }
+
+        if (changed) {
+                ret = brisk_search_fold(out->str);
+        }
+        g_string_free(out, TRUE);
+
+        if (ret && *ret == '\0') {
+                g_clear_pointer(&ret, g_free);
+        }
+        return ret;
+}
+
+static void brisk_search_key_clear(BriskSearchKey *key)
+{
+        g_free(key->text);
+}
+
+/**
+ * brisk_search_keys_new:
+ *
+ * Construct a new, empty, set of search keys
+ */
+GArray *brisk_search_keys_new(void)
+{
+        GArray *keys = g_array_new(FALSE, FALSE, sizeof(BriskSearchKey));
+
+        g_array_set_clear_func(keys, (GDestroyNotify)brisk_search_key_clear);
+        return keys;
+}
+
+/**
+ * brisk_search_keys_add_folded:
+ *
+ * Add a key that has already been through brisk_search_fold
+ */
+void brisk_search_keys_add_folded(GArray *keys, BriskSearchField field, const gchar *text)
+{
+        BriskSearchKey key = { 0 };
+
+        if (!text || *text == '\0') {
+                return;
+        }
+        key.text = g_strdup(text);
+        key.length = strlen(text);
+        key.field = field;
+        g_array_append_val(keys, key);
+}
+
+/**
+ * brisk_search_keys_add:
+ *
+ * Fold the text and add it as a key for the field, skipping anything empty.
+ * The romanised form is added alongside when transliterate is set.
+ */
+void brisk_search_keys_add(GArray *keys, BriskSearchField field, const gchar *text,
+                           gboolean transliterate)
+{
+        autofree(gchar) *folded = NULL;
+        autofree(gchar) *romanised = NULL;
+
+        folded = brisk_search_fold(text);
+        brisk_search_keys_add_folded(keys, field, folded);
+
+        if (transliterate && folded && *folded != '\0') {
+                romanised = brisk_search_transliterate(text);
+                /* Plain accents already fold away to the same thing */
+                if (romanised && !g_str_equal(romanised, folded)) {
+                        brisk_search_keys_add_folded(keys, field, romanised);
+                }
+        }
+}
+
+/**
+ * Step to the next whitespace separated word of the term, without copying
+ * it out. Returns the start of the word and sets its length, or NULL once
+ * the term is exhausted.
+ */
+static const gchar *brisk_search_next_token(const gchar **term, gsize *length)
+{
+        const gchar *start = *term;
+        const gchar *end = NULL;
+
+        while (*start == ' ') {
+                ++start;
+        }
+        if (*start == '\0') {
+                return NULL;
+        }
+
+        end = strchr(start, ' ');
+        if (!end) {
+                end = start + strlen(start);
+        }
+
+        *term = end;
+        *length = (gsize)(end - start);
+        return start;
+}
+
+static inline const gchar *brisk_search_key_find(BriskSearchKey *key, const gchar *token,
+                                                 gsize length)
+{
+        return memmem(key->text, key->length, token, length);
+}
+
+/**
+ * brisk_search_text_contains:
+ *
+ * Determine whether every word of the folded term is found within the
+ * folded text, in any order
+ */
+__brisk_pure__ gboolean brisk_search_text_contains(const gchar *text, const gchar *term)
+{
+        const gchar *token = NULL;
+        gsize text_len = 0;
+        gsize length = 0;
+
+        if (!text) {
+                return FALSE;
+        }
+
+        text_len = strlen(text);
+        while ((token = brisk_search_next_token(&term, &length))) {
+                if (!memmem(text, text_len, token, length)) {
+                        return FALSE;
+                }
+        }
+        return TRUE;
+}
+
+/**
+ * brisk_search_keys_contains:
+ *
+ * Determine whether every word of the folded term is found within the keys,
+ * in any order
+ */
+__brisk_pure__ gboolean brisk_search_keys_contains(GArray *keys, const gchar *term)
+{
+        const gchar *token = NULL;
+        gsize length = 0;
+
+        if (!keys) {
+                return FALSE;
+        }
+
+        while ((token = brisk_search_next_token(&term, &length))) {
+                gboolean found = FALSE;
+
+                for (guint i = 0; i < keys->len && !found; i++) {
+                        found = brisk_search_key_find(&g_array_index(keys, BriskSearchKey, i),
+                                                      token,
+                                                      length) != NULL;
+                }
+                if (!found) {
+                        return FALSE;
+                }
+        }
+        return TRUE;
+}
+
+/**
+ * Words within a key are worth more when the term lines up with them
+ */
+static inline gboolean brisk_search_is_word_start(const gchar *key, const gchar *hit)
+{
+        return hit == key || strchr(" -_./", *(hit - 1)) != NULL;
+}
+
+/**
+ * Find the best hit of a single word of the term within the keys. The score
+ * is the weight of the field, scaled by how well the word lines up with the
+ * key: a whole key beats a prefix, which beats the start of a word, which
+ * beats anywhere at all.
+ */
+static gboolean brisk_search_keys_match_token(GArray *keys, const gchar *token, gsize term_len,
+                                              const gint *weights, BriskSearchMatch *match)
+{
+        gboolean found = FALSE;
+
+        for (guint i = 0; i < keys->len; i++) {
+                BriskSearchKey *key = &g_array_index(keys, BriskSearchKey, i);
+                const gchar *hit = brisk_search_key_find(key, token, term_len);
+                gint score = 0;
+
+                if (!hit) {
+                        continue;
+                }
+
+                if (hit == key->text && key->length == term_len) {
+                        score = weights[key->field] * 3;
+                } else if (hit == key->text) {
+                        score = weights[key->field] * 2;
+                } else if (brisk_search_is_word_start(key->text, hit)) {
+                        score = weights[key->field] * 3 / 2;
+                } else {
+                        score = weights[key->field];
+                }
+
+                if (found && score <= match->score) {
+                        continue;
+                }
+                found = TRUE;
+                match->score = score;
+                match->field = key->field;
+                match->key = (gint)i;
+                match->offset = (guint)(hit - key->text);
+                match->length = (guint)term_len;
+        }
+
+        return found;
+}
+
+/**
+ * brisk_search_keys_match:
+ *
+ * Match the folded term against the keys. Every word of the term has to be
+ * found, in any order and in any of the keys, so "browser web" still finds
+ * "Web Browser". The score is the sum of the best score for each word, and
+ * the match describes the best scoring word so it can be highlighted.
+ *
+ * Returns TRUE if every word of the term was found
+ */
+gboolean brisk_search_keys_match(GArray *keys, const gchar *term, const gint *weights,
+                                 BriskSearchMatch *match)
+{
+        const gchar *token = NULL;
+        gsize length = 0;
+        gint64 total = 0;
+        gboolean found = FALSE;
+
+        if (!keys) {
+                return FALSE;
+        }
+
+        while ((token = brisk_search_next_token(&term, &length))) {
+                BriskSearchMatch hit = { 0 };
+
+                if (!brisk_search_keys_match_token(keys, token, length, weights, &hit)) {
+                        return FALSE;
+                }
+
+                total += hit.score;
+                if (!found || hit.score > match->score) {
+                        *match = hit;
+                }
+                found = TRUE;
+        }
+
+        /* Leave plenty of headroom for the boosts added on top */
+        if (found) {
+                match->score = (gint)MIN(total, G_MAXINT / 2);
+        }
+        return found;
+}
+
+/**
+ * brisk_search_weights_load:
+ *
+ * Fill in the weights for every field from the search-weights key, falling
+ * back to the built in weight for any field it doesn't mention
+ */
+void brisk_search_weights_load(GSettings *settings, gint *weights)
+{
+        autofree(GVariant) *value = NULL;
+
+        value = g_settings_get_value(settings, "search-weights");
+
+        for (guint i = 0; i < BRISK_SEARCH_N_FIELDS; i++) {
+                guint32 weight = 0;
+
+                if (g_variant_lookup(value, brisk_search_fields[i].name, "u", &weight)) {
+                        weights[i] = (gint)MIN(weight, (guint32)G_MAXINT / 3);
+                } else {
+                        weights[i] = brisk_search_fields[i].weight;
+                }
+        }
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,81 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/**
+ * The fields of an item that are searched, each with its own weight
+ */
+typedef enum {
+        BRISK_SEARCH_FIELD_NAME = 0,
+        BRISK_SEARCH_FIELD_GENERIC_NAME,
+        BRISK_SEARCH_FIELD_KEYWORDS,
+        BRISK_SEARCH_FIELD_CATEGORIES,
+        BRISK_SEARCH_FIELD_DESCRIPTION,
+        BRISK_SEARCH_FIELD_EXEC,
+        BRISK_SEARCH_FIELD_OTHER, /**<Items that don't know their fields */
+        BRISK_SEARCH_N_FIELDS,
+} BriskSearchField;
+
+/**
+ * A single folded key, tagged with the field it came from
+ */
+typedef struct BriskSearchKey {
+        gchar *text;
+        gsize length;
+        BriskSearchField field;
+} BriskSearchKey;
+
+/**
+ * The best hit of the term within the keys of an item. Computed once per
+ * term, so that sorting and highlighting don't have to match again.
+ */
+typedef struct BriskSearchMatch {
+        gint score;
+        BriskSearchField field;
+        gint key;     /**<Index of the key that matched, or -1 */
+        guint offset; /**<Byte offset of the term within the folded key */
+        guint length; /**<Byte length of the term */
+} BriskSearchMatch;
+
+gchar *brisk_search_fold(const gchar *str);
+gchar *brisk_search_fold_unstripped(const gchar *str);
+gchar *brisk_search_transliterate(const gchar *str);
+gboolean brisk_search_text_contains(const gchar *text, const gchar *term);
+
+GArray *brisk_search_keys_new(void);
+void brisk_search_keys_add(GArray *keys, BriskSearchField field, const gchar *text,
+                           gboolean transliterate);
+void brisk_search_keys_add_folded(GArray *keys, BriskSearchField field, const gchar *text);
+gboolean brisk_search_keys_contains(GArray *keys, const gchar *term);
+gboolean brisk_search_keys_match(GArray *keys, const gchar *term, const gint *weights,
+                                 BriskSearchMatch *match);
+
+void brisk_search_weights_load(GSettings *settings, gint *weights);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
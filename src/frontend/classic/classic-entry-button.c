@@ -23,16 +23,14 @@ BRISK_END_PEDANTIC
 G_DEFINE_TYPE(BriskClassicEntryButton, brisk_classic_entry_button, BRISK_TYPE_MENU_ENTRY_BUTTON)
 
 /**
- * Handle constructor specifics for our button
+ * Display the icon and name of our item
  */
-static void brisk_classic_entry_button_constructed(GObject *obj)
+static void brisk_classic_entry_button_update(BriskMenuEntryButton *button)
 {
-        BriskClassicEntryButton *self = NULL;
+        BriskClassicEntryButton *self = BRISK_CLASSIC_ENTRY_BUTTON(button);
         const GIcon *icon = NULL;
 
-        self = BRISK_CLASSIC_ENTRY_BUTTON(obj);
-
-        icon = brisk_item_get_icon(BRISK_MENU_ENTRY_BUTTON(self)->item);
+        icon = brisk_item_get_icon(button->item);
         if (icon) {
                 gtk_image_set_from_gicon(GTK_IMAGE(self->image),
                                          (GIcon *)icon,
@@ -46,10 +44,16 @@ static void brisk_classic_entry_button_constructed(GObject *obj)
         gtk_image_set_pixel_size(GTK_IMAGE(self->image), 24);
 
         /* Determine our label based on the app */
-        gtk_label_set_label(GTK_LABEL(self->label),
-                            brisk_item_get_name(BRISK_MENU_ENTRY_BUTTON(self)->item));
-        gtk_widget_set_tooltip_text(GTK_WIDGET(self),
-                                    brisk_item_get_summary(BRISK_MENU_ENTRY_BUTTON(self)->item));
+        brisk_menu_entry_button_set_label(button, brisk_item_get_name(button->item));
+        gtk_widget_set_tooltip_text(GTK_WIDGET(self), brisk_item_get_summary(button->item));
+}
+
+/**
+ * Handle constructor specifics for our button
+ */
+static void brisk_classic_entry_button_constructed(GObject *obj)
+{
+        brisk_classic_entry_button_update(BRISK_MENU_ENTRY_BUTTON(obj));
 
         G_OBJECT_CLASS(brisk_classic_entry_button_parent_class)->constructed(obj);
 }
@@ -67,6 +71,10 @@ static void brisk_classic_entry_button_dispose(GObject *obj)
 static void brisk_classic_entry_button_class_init(BriskClassicEntryButtonClass *klazz)
 {
         GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskMenuEntryButtonClass *e_class = BRISK_MENU_ENTRY_BUTTON_CLASS(klazz);
+
+        /* entry button vtable hookup */
+        e_class->update = brisk_classic_entry_button_update;
 
         /* gobject vtable hookup */
         obj_class->constructed = brisk_classic_entry_button_constructed;
@@ -101,6 +109,7 @@ static void brisk_classic_entry_button_init(BriskClassicEntryButton *self)
         gtk_label_set_max_width_chars(GTK_LABEL(label), 25);
         gtk_label_set_width_chars(GTK_LABEL(label), 25);
         self->label = label;
+        BRISK_MENU_ENTRY_BUTTON(self)->highlight_label = GTK_LABEL(label);
         g_object_set(self->label, "halign", GTK_ALIGN_START, "valign", GTK_ALIGN_CENTER, NULL);
         gtk_box_pack_start(GTK_BOX(layout), label, TRUE, TRUE, 0);
         G_GNUC_BEGIN_IGNORE_DEPRECATIONS
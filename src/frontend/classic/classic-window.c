@@ -16,6 +16,7 @@
 
 BRISK_BEGIN_PEDANTIC
 #include "../menu-private.h"
+#include "../monitor-cache.h"
 #include "category-button.h"
 #include "classic-entry-button.h"
 #include "classic-window.h"
@@ -73,13 +74,12 @@ static const gchar *brisk_classic_window_get_display_name(__brisk_unused__ Brisk
 
 static void brisk_classic_window_update_screen_position(BriskMenuWindow *self)
 {
-        GdkScreen *screen = NULL;
+        const BriskMenuMonitor *monitor = NULL;
         GtkAllocation relative_alloc = { 0 };
         GdkWindow *window = NULL;
         GdkRectangle geom = { 0 };
         gint relative_x, relative_y = 0;      /* Real X, Y of the applet, on screen */
         gint window_width, window_height = 0; /* Window width & height */
-        gint mon = 0;                         /* Monitor to display on */
         gint window_x, window_y = 0;          /* Target X, Y */
 
         if (!self->relative_to) {
@@ -107,9 +107,8 @@ static void brisk_classic_window_update_screen_position(BriskMenuWindow *self)
         gtk_window_get_size(GTK_WINDOW(self), &window_width, &window_height);
 
         /* Grab the geometry for the monitor we're currently on */
-        screen = gtk_widget_get_screen(self->relative_to);
-        mon = gdk_screen_get_monitor_at_point(screen, relative_x, relative_y);
-        gdk_screen_get_monitor_geometry(screen, mon, &geom);
+        monitor = brisk_menu_monitor_get_at_point(GTK_WIDGET(self), relative_x, relative_y);
+        geom = monitor->geometry;
 
         switch (self->position) {
         case GTK_POS_LEFT:
@@ -202,6 +201,7 @@ static void brisk_classic_window_add_item(BriskMenuWindow *self, BriskItem *item
                                  self);
         gtk_container_add(GTK_CONTAINER(BRISK_CLASSIC_WINDOW(self)->apps), button);
         gtk_widget_show_all(button);
+        g_ptr_array_add(self->entries, button);
 
         g_hash_table_insert(self->item_store, g_strdup(item_id), button);
 }
@@ -229,6 +229,7 @@ static void brisk_classic_window_add_section(BriskMenuWindow *self, BriskSection
         gtk_box_pack_start(GTK_BOX(box_target), button, FALSE, FALSE, 0);
         brisk_classic_window_associate_category(self, button);
         gtk_widget_show_all(button);
+        g_ptr_array_add(self->categories, button);
 
         /* Avoid new dupes */
         g_hash_table_insert(self->item_store, g_strdup(section_id), button);
@@ -242,6 +243,7 @@ static void brisk_classic_window_add_section(BriskMenuWindow *self, BriskSection
 static void brisk_classic_window_invalidate_filter(BriskMenuWindow *self,
                                                    __brisk_unused__ BriskBackend *backend)
 {
+        brisk_menu_window_reset_results(self);
         gtk_list_box_invalidate_filter(GTK_LIST_BOX(BRISK_CLASSIC_WINDOW(self)->apps));
         gtk_list_box_invalidate_sort(GTK_LIST_BOX(BRISK_CLASSIC_WINDOW(self)->apps));
 }
@@ -251,50 +253,7 @@ static void brisk_classic_window_invalidate_filter(BriskMenuWindow *self,
  */
 static void brisk_classic_window_reset(BriskMenuWindow *self, BriskBackend *backend)
 {
-        GtkWidget *box_target = NULL;
-        GList *kids = NULL, *elem = NULL;
-        const gchar *backend_id = NULL;
-
-        backend_id = brisk_backend_get_id(backend);
-
-        box_target = brisk_menu_window_get_section_box(self, backend);
-        gtk_container_foreach(GTK_CONTAINER(box_target),
-                              (GtkCallback)brisk_menu_window_remove_category,
-                              self);
-
-        /* Manual work for the items */
-        kids = gtk_container_get_children(GTK_CONTAINER(BRISK_CLASSIC_WINDOW(self)->apps));
-        for (elem = kids; elem; elem = elem->next) {
-                GtkWidget *row = elem->data;
-                GtkWidget *child = NULL;
-                BriskItem *item = NULL;
-                const gchar *local_backend_id = NULL;
-                const gchar *local_id = NULL;
-
-                if (!GTK_IS_BIN(GTK_BIN(row))) {
-                        continue;
-                }
-
-                child = gtk_bin_get_child(GTK_BIN(row));
-                if (!BRISK_IS_MENU_ENTRY_BUTTON(child)) {
-                        continue;
-                }
-
-                g_object_get(child, "item", &item, NULL);
-                if (!item) {
-                        g_warning("missing item for entry in backend '%s'", backend_id);
-                        continue;
-                }
-
-                local_backend_id = brisk_item_get_backend_id(item);
-                if (!g_str_equal(backend_id, local_backend_id)) {
-                        continue;
-                }
-                local_id = brisk_item_get_id(item);
-                g_hash_table_remove(self->item_store, local_id);
-                gtk_widget_destroy(row);
-        }
-        g_list_free(kids);
+        brisk_menu_window_purge_backend(self, backend);
 }
 
 /**
@@ -535,6 +494,7 @@ static void brisk_classic_window_on_toggled(BriskMenuWindow *self, GtkWidget *bu
 
         cat = BRISK_CLASSIC_CATEGORY_BUTTON(button);
         g_object_get(cat, "section", &self->active_section, NULL);
+        brisk_menu_window_section_activated(self);
 
         /* Start the filter. */
         brisk_classic_window_invalidate_filter(self, NULL);
@@ -594,26 +554,7 @@ static void brisk_classic_window_load_css(BriskClassicWindow *self)
 
 static void brisk_classic_window_key_activate(BriskClassicWindow *self, __brisk_unused__ gpointer v)
 {
-        autofree(GList) *kids = NULL;
-        GList *elem = NULL;
-        BriskMenuEntryButton *button = NULL;
-
-        kids = gtk_container_get_children(GTK_CONTAINER(self->apps));
-
-        for (elem = kids; elem; elem = elem->next) {
-                GtkWidget *widget = elem->data;
-
-                if (!gtk_widget_get_visible(widget) || !gtk_widget_get_child_visible(widget)) {
-                        continue;
-                }
-
-                button = BRISK_MENU_ENTRY_BUTTON(gtk_bin_get_child(GTK_BIN(widget)));
-                break;
-        }
-        if (!button) {
-                return;
-        }
-        brisk_menu_entry_button_launch(button);
+        brisk_menu_window_launch_result(BRISK_MENU_WINDOW(self), 0);
 }
 
 static void brisk_classic_window_activated(__brisk_unused__ BriskMenuWindow *self,
@@ -752,6 +693,7 @@ static void brisk_classic_window_add_shortcut(BriskMenuWindow *self, const gchar
 static void brisk_classic_window_set_filters_enabled(BriskClassicWindow *self, gboolean enabled)
 {
         BRISK_MENU_WINDOW(self)->filtering = enabled;
+        brisk_menu_window_reset_results(BRISK_MENU_WINDOW(self));
         if (enabled) {
                 gtk_list_box_set_filter_func(GTK_LIST_BOX(self->apps),
                                              brisk_classic_window_filter_apps,
@@ -773,10 +715,11 @@ static void brisk_classic_window_set_filters_enabled(BriskClassicWindow *self, g
  * Responsible for filtering the selection based on active group or search
  * term.
  */
-__brisk_pure__ static gboolean brisk_classic_window_filter_apps(GtkListBoxRow *row, gpointer v)
+static gboolean brisk_classic_window_filter_apps(GtkListBoxRow *row, gpointer v)
 {
         BriskMenuWindow *self = NULL;
         GtkWidget *child = NULL;
+        gboolean visible = FALSE;
 
         self = BRISK_MENU_WINDOW(v);
 
@@ -786,16 +729,16 @@ __brisk_pure__ static gboolean brisk_classic_window_filter_apps(GtkListBoxRow *r
 
         /* Grab our Entry widget */
         child = gtk_bin_get_child(GTK_BIN(row));
+        visible = brisk_menu_window_filter_apps(self, child);
 
-        return brisk_menu_window_filter_apps(self, child);
+        /* Keep the visible results up to date for keyboard navigation */
+        brisk_menu_window_track_result(self, BRISK_MENU_ENTRY_BUTTON(child), visible);
+        return visible;
 }
 
 static gint brisk_classic_window_sort(GtkListBoxRow *row1, GtkListBoxRow *row2, gpointer v)
 {
         GtkWidget *child1, *child2 = NULL;
-        BriskItem *itemA, *itemB = NULL;
-        autofree(gchar) *nameA = NULL;
-        autofree(gchar) *nameB = NULL;
         BriskMenuWindow *self = NULL;
 
         self = BRISK_MENU_WINDOW(v);
@@ -803,10 +746,9 @@ static gint brisk_classic_window_sort(GtkListBoxRow *row1, GtkListBoxRow *row2,
         child1 = gtk_bin_get_child(GTK_BIN(row1));
         child2 = gtk_bin_get_child(GTK_BIN(row2));
 
-        g_object_get(child1, "item", &itemA, NULL);
-        g_object_get(child2, "item", &itemB, NULL);
-
-        return brisk_menu_window_sort(self, itemA, itemB);
+        return brisk_menu_window_sort(self,
+                                      BRISK_MENU_ENTRY_BUTTON(child1),
+                                      BRISK_MENU_ENTRY_BUTTON(child2));
 }
 
 /*
@@ -14,6 +14,7 @@
 #include "util.h"
 
 BRISK_BEGIN_PEDANTIC
+#include "../monitor-cache.h"
 #include "sidebar-scroller.h"
 #include <gtk/gtk.h>
 
@@ -74,22 +75,12 @@ static void brisk_menu_sidebar_scroller_init(BriskMenuSidebarScroller *self)
 static void brisk_menu_sidebar_scroller_get_preferred_height(GtkWidget *widget, gint *min_height,
                                                              gint *nat_height)
 {
-        GdkScreen *screen = NULL;
-        GdkWindow *window = NULL;
-        GdkRectangle geom = { 0 };
-        gint applet_x, applet_y = 0;
-        gint mon = 0;
-
-        /* Find out where we are on screen */
-        window = gtk_widget_get_window(widget);
-        gdk_window_get_origin(window, &applet_x, &applet_y);
-
-        /* Grab the geometry for the monitor we're currently on */
-        screen = gtk_widget_get_screen(widget);
-        mon = gdk_screen_get_monitor_at_point(screen, applet_x, applet_y);
-        gdk_screen_get_monitor_geometry(screen, mon, &geom);
-
-        gint max_height = geom.height - 200;
+        const BriskMenuMonitor *monitor = NULL;
+
+        /* Grab the geometry for the monitor the menu was placed on */
+        monitor = brisk_menu_monitor_get_for_widget(widget);
+
+        gint max_height = monitor->geometry.height - 200;
 
         GtkBin *bin = NULL;
         GtkWidget *child = NULL;
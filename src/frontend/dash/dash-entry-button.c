@@ -22,16 +22,14 @@ BRISK_END_PEDANTIC
 G_DEFINE_TYPE(BriskDashEntryButton, brisk_dash_entry_button, BRISK_TYPE_MENU_ENTRY_BUTTON)
 
 /**
- * Handle constructor specifics for our button
+ * Display the icon and name of our item
  */
-static void brisk_dash_entry_button_constructed(GObject *obj)
+static void brisk_dash_entry_button_update(BriskMenuEntryButton *button)
 {
-        BriskDashEntryButton *self = NULL;
+        BriskDashEntryButton *self = BRISK_DASH_ENTRY_BUTTON(button);
         const GIcon *icon = NULL;
 
-        self = BRISK_DASH_ENTRY_BUTTON(obj);
-
-        icon = brisk_item_get_icon(BRISK_MENU_ENTRY_BUTTON(self)->item);
+        icon = brisk_item_get_icon(button->item);
         if (icon) {
                 gtk_image_set_from_gicon(GTK_IMAGE(self->image),
                                          (GIcon *)icon,
@@ -45,10 +43,16 @@ static void brisk_dash_entry_button_constructed(GObject *obj)
         gtk_image_set_pixel_size(GTK_IMAGE(self->image), 64);
 
         /* Determine our label based on the app */
-        gtk_label_set_label(GTK_LABEL(self->label),
-                            brisk_item_get_name(BRISK_MENU_ENTRY_BUTTON(self)->item));
-        gtk_widget_set_tooltip_text(GTK_WIDGET(self),
-                                    brisk_item_get_summary(BRISK_MENU_ENTRY_BUTTON(self)->item));
+        brisk_menu_entry_button_set_label(button, brisk_item_get_name(button->item));
+        gtk_widget_set_tooltip_text(GTK_WIDGET(self), brisk_item_get_summary(button->item));
+}
+
+/**
+ * Handle constructor specifics for our button
+ */
+static void brisk_dash_entry_button_constructed(GObject *obj)
+{
+        brisk_dash_entry_button_update(BRISK_MENU_ENTRY_BUTTON(obj));
 
         G_OBJECT_CLASS(brisk_dash_entry_button_parent_class)->constructed(obj);
 }
@@ -66,6 +70,10 @@ static void brisk_dash_entry_button_dispose(GObject *obj)
 static void brisk_dash_entry_button_class_init(BriskDashEntryButtonClass *klazz)
 {
         GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+        BriskMenuEntryButtonClass *e_class = BRISK_MENU_ENTRY_BUTTON_CLASS(klazz);
+
+        /* entry button vtable hookup */
+        e_class->update = brisk_dash_entry_button_update;
 
         /* gobject vtable hookup */
         obj_class->constructed = brisk_dash_entry_button_constructed;
@@ -97,6 +105,7 @@ static void brisk_dash_entry_button_init(BriskDashEntryButton *self)
         /* Display label */
         label = gtk_label_new("");
         self->label = label;
+        BRISK_MENU_ENTRY_BUTTON(self)->highlight_label = GTK_LABEL(label);
         gtk_label_set_lines(GTK_LABEL(label), 2);
         gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
         gtk_label_set_max_width_chars(GTK_LABEL(label), 15);
@@ -15,6 +15,7 @@
 #include "util.h"
 
 BRISK_BEGIN_PEDANTIC
+#include "../monitor-cache.h"
 #include "category-button.h"
 #include "dash-entry-button.h"
 #include "dash-window.h"
@@ -65,13 +66,12 @@ static const gchar *brisk_dash_window_get_display_name(__brisk_unused__ BriskMen
 
 static void brisk_dash_window_update_screen_position(BriskMenuWindow *self)
 {
-        GdkScreen *screen = NULL;
+        const BriskMenuMonitor *monitor = NULL;
         GtkAllocation relative_alloc = { 0 };
         GdkWindow *window = NULL;
         GdkRectangle geom = { 0 };
         gint relative_x, relative_y = 0;      /* Real X, Y of the applet, on screen */
         gint window_width, window_height = 0; /* Window width & height */
-        gint mon = 0;                         /* Monitor to display on */
         gint window_x, window_y = 0;          /* Target X, Y */
 
         if (!self->relative_to) {
@@ -96,9 +96,8 @@ static void brisk_dash_window_update_screen_position(BriskMenuWindow *self)
         gdk_window_get_origin(window, &relative_x, &relative_y);
 
         /* Grab the geometry for the monitor we're currently on */
-        screen = gtk_widget_get_screen(self->relative_to);
-        mon = gdk_screen_get_monitor_at_point(screen, relative_x, relative_y);
-        gdk_screen_get_monitor_geometry(screen, mon, &geom);
+        monitor = brisk_menu_monitor_get_at_point(GTK_WIDGET(self), relative_x, relative_y);
+        geom = monitor->geometry;
 
         switch (self->position) {
         case GTK_POS_LEFT:
@@ -150,6 +149,7 @@ static void brisk_dash_window_add_item(BriskMenuWindow *self, BriskItem *item,
                                  self);
         gtk_container_add(GTK_CONTAINER(BRISK_DASH_WINDOW(self)->apps), GTK_WIDGET(button));
         gtk_widget_show_all(GTK_WIDGET(button));
+        g_ptr_array_add(self->entries, button);
 
         g_hash_table_insert(self->item_store, g_strdup(item_id), GTK_WIDGET(button));
 }
@@ -178,6 +178,7 @@ static void brisk_dash_window_add_section(BriskMenuWindow *self, BriskSection *s
         gtk_box_pack_start(GTK_BOX(box_target), button, FALSE, FALSE, 0);
         brisk_dash_window_associate_category(self, button);
         gtk_widget_show_all(button);
+        g_ptr_array_add(self->categories, button);
 
         /* Avoid new dupes */
         g_hash_table_insert(self->item_store, g_strdup(section_id), button);
@@ -191,6 +192,7 @@ static void brisk_dash_window_add_section(BriskMenuWindow *self, BriskSection *s
 static void brisk_dash_window_invalidate_filter(BriskMenuWindow *self,
                                                 __brisk_unused__ BriskBackend *backend)
 {
+        brisk_menu_window_reset_results(self);
         gtk_flow_box_invalidate_filter(GTK_FLOW_BOX(BRISK_DASH_WINDOW(self)->apps));
         gtk_flow_box_invalidate_sort(GTK_FLOW_BOX(BRISK_DASH_WINDOW(self)->apps));
 }
@@ -200,50 +202,7 @@ static void brisk_dash_window_invalidate_filter(BriskMenuWindow *self,
  */
 static void brisk_dash_window_reset(BriskMenuWindow *self, BriskBackend *backend)
 {
-        GtkWidget *box_target = NULL;
-        GList *kids = NULL, *elem = NULL;
-        const gchar *backend_id = NULL;
-
-        backend_id = brisk_backend_get_id(backend);
-
-        box_target = brisk_menu_window_get_section_box(self, backend);
-        gtk_container_foreach(GTK_CONTAINER(box_target),
-                              (GtkCallback)brisk_menu_window_remove_category,
-                              self);
-
-        /* Manual work for the items */
-        kids = gtk_container_get_children(GTK_CONTAINER(BRISK_DASH_WINDOW(self)->apps));
-        for (elem = kids; elem; elem = elem->next) {
-                GtkWidget *row = elem->data;
-                GtkWidget *child = NULL;
-                BriskItem *item = NULL;
-                const gchar *local_backend_id = NULL;
-                const gchar *local_id = NULL;
-
-                if (!GTK_IS_BIN(GTK_BIN(row))) {
-                        continue;
-                }
-
-                child = gtk_bin_get_child(GTK_BIN(row));
-                if (!BRISK_IS_MENU_ENTRY_BUTTON(child)) {
-                        continue;
-                }
-
-                g_object_get(child, "item", &item, NULL);
-                if (!item) {
-                        g_warning("missing item for entry in backend '%s'", backend_id);
-                        continue;
-                }
-
-                local_backend_id = brisk_item_get_backend_id(item);
-                if (!g_str_equal(backend_id, local_backend_id)) {
-                        continue;
-                }
-                local_id = brisk_item_get_id(item);
-                g_hash_table_remove(self->item_store, local_id);
-                gtk_widget_destroy(row);
-        }
-        g_list_free(kids);
+        brisk_menu_window_purge_backend(self, backend);
 }
 
 /**
@@ -499,6 +458,7 @@ static void brisk_dash_window_on_toggled(BriskMenuWindow *self, GtkWidget *butto
 
         cat = BRISK_DASH_CATEGORY_BUTTON(button);
         g_object_get(cat, "section", &self->active_section, NULL);
+        brisk_menu_window_section_activated(self);
 
         /* Start the filter. */
         brisk_dash_window_invalidate_filter(self, NULL);
@@ -573,26 +533,7 @@ static void brisk_dash_window_load_css(GtkSettings *settings, const gchar *key,
 
 static void brisk_dash_window_key_activate(BriskDashWindow *self, __brisk_unused__ gpointer v)
 {
-        autofree(GList) *kids = NULL;
-        GList *elem = NULL;
-        BriskMenuEntryButton *button = NULL;
-
-        kids = gtk_container_get_children(GTK_CONTAINER(self->apps));
-
-        for (elem = kids; elem; elem = elem->next) {
-                GtkWidget *widget = elem->data;
-
-                if (!gtk_widget_get_visible(widget) || !gtk_widget_get_child_visible(widget)) {
-                        continue;
-                }
-
-                button = BRISK_MENU_ENTRY_BUTTON(gtk_bin_get_child(GTK_BIN(widget)));
-                break;
-        }
-        if (!button) {
-                return;
-        }
-        brisk_menu_entry_button_launch(button);
+        brisk_menu_window_launch_result(BRISK_MENU_WINDOW(self), 0);
 }
 
 static void brisk_dash_window_activated(__brisk_unused__ BriskMenuWindow *self,
@@ -618,6 +559,7 @@ static void brisk_dash_window_activated(__brisk_unused__ BriskMenuWindow *self,
 static void brisk_dash_window_set_filters_enabled(BriskDashWindow *self, gboolean enabled)
 {
         BRISK_MENU_WINDOW(self)->filtering = enabled;
+        brisk_menu_window_reset_results(BRISK_MENU_WINDOW(self));
         if (enabled) {
                 gtk_flow_box_set_filter_func(GTK_FLOW_BOX(self->apps),
                                              brisk_dash_window_filter_apps,
@@ -639,10 +581,11 @@ static void brisk_dash_window_set_filters_enabled(BriskDashWindow *self, gboolea
  * Responsible for filtering the selection based on active group or search
  * term.
  */
-__brisk_pure__ static gboolean brisk_dash_window_filter_apps(GtkFlowBoxChild *row, gpointer v)
+static gboolean brisk_dash_window_filter_apps(GtkFlowBoxChild *row, gpointer v)
 {
         BriskMenuWindow *self = NULL;
         GtkWidget *child = NULL;
+        gboolean visible = FALSE;
 
         self = BRISK_MENU_WINDOW(v);
 
@@ -652,16 +595,16 @@ __brisk_pure__ static gboolean brisk_dash_window_filter_apps(GtkFlowBoxChild *ro
 
         /* Grab our Entry widget */
         child = gtk_bin_get_child(GTK_BIN(row));
+        visible = brisk_menu_window_filter_apps(self, child);
 
-        return brisk_menu_window_filter_apps(self, child);
+        /* Keep the visible results up to date for keyboard navigation */
+        brisk_menu_window_track_result(self, BRISK_MENU_ENTRY_BUTTON(child), visible);
+        return visible;
 }
 
 static gint brisk_dash_window_sort(GtkFlowBoxChild *row1, GtkFlowBoxChild *row2, gpointer v)
 {
         GtkWidget *child1, *child2 = NULL;
-        BriskItem *itemA, *itemB = NULL;
-        autofree(gchar) *nameA = NULL;
-        autofree(gchar) *nameB = NULL;
         BriskMenuWindow *self = NULL;
 
         self = BRISK_MENU_WINDOW(v);
@@ -669,10 +612,9 @@ static gint brisk_dash_window_sort(GtkFlowBoxChild *row1, GtkFlowBoxChild *row2,
         child1 = gtk_bin_get_child(GTK_BIN(row1));
         child2 = gtk_bin_get_child(GTK_BIN(row2));
 
-        g_object_get(child1, "item", &itemA, NULL);
-        g_object_get(child2, "item", &itemB, NULL);
-
-        return brisk_menu_window_sort(self, itemA, itemB);
+        return brisk_menu_window_sort(self,
+                                      BRISK_MENU_ENTRY_BUTTON(child1),
+                                      BRISK_MENU_ENTRY_BUTTON(child2));
 }
 
 /*
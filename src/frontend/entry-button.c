@@ -21,12 +21,30 @@ BRISK_BEGIN_PEDANTIC
 #include <gtk/gtk.h>
 BRISK_END_PEDANTIC
 
+#include <string.h>
+
+DEF_AUTOFREE(gchar, g_free)
+
 static void brisk_menu_entry_drag_begin(GtkWidget *widget, GdkDragContext *context);
 static void brisk_menu_entry_drag_end(GtkWidget *widget, GdkDragContext *context);
 static void brisk_menu_entry_drag_data(GtkWidget *widget, GdkDragContext *context,
                                        GtkSelectionData *data, guint info, guint time);
+static gboolean brisk_menu_entry_drag_motion(GtkWidget *widget, GdkDragContext *context, gint x,
+                                             gint y, guint time);
+static gboolean brisk_menu_entry_drag_drop(GtkWidget *widget, GdkDragContext *context, gint x,
+                                           gint y, guint time);
+static void brisk_menu_entry_drag_data_received(GtkWidget *widget, GdkDragContext *context, gint x,
+                                                gint y, GtkSelectionData *data, guint info,
+                                                guint time);
 static gboolean brisk_menu_entry_button_release_event(GtkWidget *wid, GdkEventButton *event);
 
+/**
+ * Drag targets. Items are only ever reordered within the same process.
+ */
+#define BRISK_ITEM_TARGET "application/x-brisk-item"
+
+enum { DRAG_INFO_EXTERNAL = 0, DRAG_INFO_ITEM };
+
 /**
  * IDs for our signals
  */
@@ -53,6 +71,8 @@ static void brisk_menu_entry_button_dispose(GObject *obj)
 
         self = BRISK_MENU_ENTRY_BUTTON(obj);
         g_clear_object(&self->item);
+        g_clear_pointer(&self->label_offsets, g_array_unref);
+        g_clear_pointer(&self->highlight, pango_attr_list_unref);
 
         G_OBJECT_CLASS(brisk_menu_entry_button_parent_class)->dispose(obj);
 }
@@ -112,6 +132,9 @@ static void brisk_menu_entry_button_class_init(BriskMenuEntryButtonClass *klazz)
         wid_class->drag_data_get = brisk_menu_entry_drag_data;
         wid_class->drag_begin = brisk_menu_entry_drag_begin;
         wid_class->drag_end = brisk_menu_entry_drag_end;
+        wid_class->drag_motion = brisk_menu_entry_drag_motion;
+        wid_class->drag_drop = brisk_menu_entry_drag_drop;
+        wid_class->drag_data_received = brisk_menu_entry_drag_data_received;
         wid_class->button_release_event = brisk_menu_entry_button_release_event;
 
         /**
@@ -152,12 +175,19 @@ static void brisk_menu_entry_button_class_init(BriskMenuEntryButtonClass *klazz)
 static void brisk_menu_entry_button_init(BriskMenuEntryButton *self)
 {
         static const GtkTargetEntry drag_targets[] = {
-                { "text/uri-list", 0, 0 },
-                { "application/x-desktop", 0, 0 },
+                { "text/uri-list", 0, DRAG_INFO_EXTERNAL },
+                { "application/x-desktop", 0, DRAG_INFO_EXTERNAL },
+                { BRISK_ITEM_TARGET, GTK_TARGET_SAME_APP, DRAG_INFO_ITEM },
+        };
+        static const GtkTargetEntry drop_targets[] = {
+                { BRISK_ITEM_TARGET, GTK_TARGET_SAME_APP, DRAG_INFO_ITEM },
         };
 
         /* Hook up drag so users can drag .desktop from here elsewhere */
-        gtk_drag_source_set(GTK_WIDGET(self), GDK_BUTTON1_MASK, drag_targets, 2, GDK_ACTION_COPY);
+        gtk_drag_source_set(GTK_WIDGET(self), GDK_BUTTON1_MASK, drag_targets, 3, GDK_ACTION_COPY);
+
+        /* Accept our own items for reordering, the window decides when that's allowed */
+        gtk_drag_dest_set(GTK_WIDGET(self), 0, drop_targets, 1, GDK_ACTION_COPY);
 }
 
 /**
@@ -199,11 +229,18 @@ static gboolean hide_toplevel(GtkWidget *widget)
 /**
  * Clean up the ref'd icon
  */
-static void brisk_menu_entry_drag_end(__brisk_unused__ GtkWidget *widget, GdkDragContext *context)
+static void brisk_menu_entry_drag_end(GtkWidget *widget, GdkDragContext *context)
 {
         GIcon *icon = NULL;
+        GdkWindow *dest = NULL;
+        GtkWidget *toplevel = NULL;
 
-        g_idle_add((GSourceFunc)hide_toplevel, widget);
+        /* Stay open when the user was just reordering items within the menu */
+        dest = gdk_drag_context_get_dest_window(context);
+        toplevel = gtk_widget_get_toplevel(widget);
+        if (!dest || gdk_window_get_toplevel(dest) != gtk_widget_get_window(toplevel)) {
+                g_idle_add((GSourceFunc)hide_toplevel, widget);
+        }
 
         icon = g_object_get_data(G_OBJECT(context), "_drag_icon_brisk");
         if (!icon) {
@@ -213,12 +250,24 @@ static void brisk_menu_entry_drag_end(__brisk_unused__ GtkWidget *widget, GdkDra
 }
 
 static void brisk_menu_entry_drag_data(GtkWidget *widget, __brisk_unused__ GdkDragContext *context,
-                                       GtkSelectionData *data, __brisk_unused__ guint info,
+                                       GtkSelectionData *data, guint info,
                                        __brisk_unused__ guint time)
 {
         BriskMenuEntryButton *self = BRISK_MENU_ENTRY_BUTTON(widget);
         const gchar *uris[2];
         autofree(gchar) *uri = NULL;
+        const gchar *id = NULL;
+
+        /* Internal reordering only needs to know who we are */
+        if (info == DRAG_INFO_ITEM) {
+                id = brisk_item_get_id(self->item);
+                gtk_selection_data_set(data,
+                                       gtk_selection_data_get_target(data),
+                                       8,
+                                       (const guchar *)id,
+                                       (gint)strlen(id));
+                return;
+        }
 
         uri = brisk_item_get_uri(self->item);
         if (!uri) {
@@ -230,6 +279,82 @@ static void brisk_menu_entry_drag_data(GtkWidget *widget, __brisk_unused__ GdkDr
         gtk_selection_data_set_uris(data, (gchar **)uris);
 }
 
+/**
+ * Determine whether the window we live in currently allows reordering
+ */
+static gboolean brisk_menu_entry_can_reorder(GtkWidget *widget)
+{
+        GtkWidget *toplevel = gtk_widget_get_toplevel(widget);
+
+        if (!BRISK_IS_MENU_WINDOW(toplevel)) {
+                return FALSE;
+        }
+        return brisk_menu_window_can_reorder(BRISK_MENU_WINDOW(toplevel));
+}
+
+static gboolean brisk_menu_entry_drag_motion(GtkWidget *widget, GdkDragContext *context,
+                                             __brisk_unused__ gint x, __brisk_unused__ gint y,
+                                             guint time)
+{
+        if (!brisk_menu_entry_can_reorder(widget)) {
+                return FALSE;
+        }
+
+        /* Refuse anything that isn't one of our own items */
+        if (gtk_drag_dest_find_target(widget, context, NULL) == GDK_NONE) {
+                gdk_drag_status(context, 0, time);
+                return FALSE;
+        }
+
+        gdk_drag_status(context, GDK_ACTION_COPY, time);
+        return TRUE;
+}
+
+static gboolean brisk_menu_entry_drag_drop(GtkWidget *widget, GdkDragContext *context,
+                                           __brisk_unused__ gint x, __brisk_unused__ gint y,
+                                           guint time)
+{
+        GdkAtom target = GDK_NONE;
+
+        if (!brisk_menu_entry_can_reorder(widget)) {
+                return FALSE;
+        }
+
+        target = gtk_drag_dest_find_target(widget, context, NULL);
+        if (target == GDK_NONE) {
+                return FALSE;
+        }
+
+        gtk_drag_get_data(widget, context, target, time);
+        return TRUE;
+}
+
+/**
+ * Another item was dropped onto us, so ask the window to move it here
+ */
+static void brisk_menu_entry_drag_data_received(GtkWidget *widget, GdkDragContext *context, gint x,
+                                                gint y, GtkSelectionData *data,
+                                                __brisk_unused__ guint info, guint time)
+{
+        GtkWidget *toplevel = NULL;
+        const guchar *raw = NULL;
+        gint len = 0;
+        autofree(gchar) *id = NULL;
+        gboolean success = FALSE;
+
+        raw = gtk_selection_data_get_data(data);
+        len = gtk_selection_data_get_length(data);
+        toplevel = gtk_widget_get_toplevel(widget);
+
+        if (raw && len > 0 && BRISK_IS_MENU_WINDOW(toplevel)) {
+                id = g_strndup((const gchar *)raw, (gsize)len);
+                success =
+                    brisk_menu_window_drop_item(BRISK_MENU_WINDOW(toplevel), widget, id, x, y);
+        }
+
+        gtk_drag_finish(context, success, FALSE, time);
+}
+
 static gboolean brisk_menu_entry_button_release_event(GtkWidget *widget,
                                                       GdkEventButton *event_button)
 {
@@ -260,6 +385,159 @@ void brisk_menu_entry_button_launch(BriskMenuEntryButton *self)
         brisk_menu_launcher_start_item(self->launcher, GTK_WIDGET(self), self->item);
 }
 
+/**
+ * brisk_menu_entry_button_update:
+ *
+ * The item changed how it wants to be displayed, so bring the button up to date
+ */
+void brisk_menu_entry_button_update(BriskMenuEntryButton *self)
+{
+        BriskMenuEntryButtonClass *klazz = BRISK_MENU_ENTRY_BUTTON_GET_CLASS(self);
+
+        if (klazz->update) {
+                klazz->update(self);
+        }
+}
+
+/**
+ * brisk_menu_entry_button_set_label:
+ *
+ * Set the text of the label, dropping any highlight within the old text
+ */
+void brisk_menu_entry_button_set_label(BriskMenuEntryButton *self, const gchar *text)
+{
+        if (!self->highlight_label) {
+                return;
+        }
+
+        gtk_label_set_label(self->highlight_label, text);
+        gtk_label_set_attributes(self->highlight_label, NULL);
+        g_clear_pointer(&self->label_offsets, g_array_unref);
+        self->highlight_start = self->highlight_end = 0;
+}
+
+/**
+ * Map every byte of the folded label back to the label itself. Folding one
+ * character at a time gives the same result as folding the whole string,
+ * short of the whitespace trimmed from either end, so that is left until the
+ * whole label has been mapped. This only has to happen once per label.
+ */
+static GArray *brisk_menu_entry_button_map_label(BriskMenuEntryButton *self)
+{
+        const gchar *text = gtk_label_get_text(self->highlight_label);
+        GArray *offsets = g_array_new(FALSE, FALSE, sizeof(guint));
+        GString *folded = g_string_sized_new(strlen(text));
+        guint offset = 0;
+        gsize lead = 0, trail = 0;
+
+        for (const gchar *c = text; *c; c = g_utf8_next_char(c)) {
+                autofree(gchar) *ch = NULL;
+                autofree(gchar) *fold = NULL;
+                gsize len = 0;
+
+                offset = (guint)(c - text);
+
+                if ((guchar)*c < 0x80) {
+                        g_string_append_c(folded, g_ascii_tolower(*c));
+                        g_array_append_val(offsets, offset);
+                        continue;
+                }
+
+                ch = g_strndup(c, (gsize)(g_utf8_next_char(c) - c));
+                fold = brisk_search_fold_unstripped(ch);
+                len = strlen(fold);
+
+                g_string_append_len(folded, fold, (gssize)len);
+                for (gsize i = 0; i < len; i++) {
+                        g_array_append_val(offsets, offset);
+                }
+        }
+
+        /* Same trim as brisk_search_fold, on the folded form */
+        while (lead < folded->len && g_ascii_isspace(folded->str[lead])) {
+                lead++;
+        }
+        while (trail < folded->len - lead &&
+               g_ascii_isspace(folded->str[folded->len - trail - 1])) {
+                trail++;
+        }
+        g_array_set_size(offsets, offsets->len - (guint)trail);
+        g_array_remove_range(offsets, 0, (guint)lead);
+        g_string_free(folded, TRUE);
+
+        /* End of the label, for spans running up to it */
+        offset = (guint)strlen(text);
+        g_array_append_val(offsets, offset);
+
+        return offsets;
+}
+
+static gboolean brisk_menu_entry_button_drop_attr(__brisk_unused__ PangoAttribute *attr,
+                                                  __brisk_unused__ gpointer v)
+{
+        return TRUE;
+}
+
+/**
+ * brisk_menu_entry_button_highlight:
+ *
+ * Embolden the part of the label the search term matched, straight from the
+ * span found while filtering. The attribute list is kept and reused, and
+ * nothing happens at all when the span didn't change.
+ */
+void brisk_menu_entry_button_highlight(BriskMenuEntryButton *self, const BriskSearchMatch *match)
+{
+        PangoAttribute *attr = NULL;
+        PangoAttrList *dropped = NULL;
+        guint start = 0, end = 0;
+
+        if (!self->highlight_label) {
+                return;
+        }
+
+        /* The name is always the first key */
+        if (match && match->key == 0 && match->length > 0) {
+                if (!self->label_offsets) {
+                        self->label_offsets = brisk_menu_entry_button_map_label(self);
+                }
+                if (match->offset + match->length < self->label_offsets->len) {
+                        start = g_array_index(self->label_offsets, guint, match->offset);
+                        end = g_array_index(self->label_offsets,
+                                            guint,
+                                            match->offset + match->length);
+                }
+        }
+
+        if (start == self->highlight_start && end == self->highlight_end) {
+                return;
+        }
+        self->highlight_start = start;
+        self->highlight_end = end;
+
+        if (start == end) {
+                gtk_label_set_attributes(self->highlight_label, NULL);
+                return;
+        }
+
+        if (!self->highlight) {
+                self->highlight = pango_attr_list_new();
+        } else {
+                dropped = pango_attr_list_filter(self->highlight,
+                                                 brisk_menu_entry_button_drop_attr,
+                                                 NULL);
+                if (dropped) {
+                        pango_attr_list_unref(dropped);
+                }
+        }
+
+        attr = pango_attr_weight_new(PANGO_WEIGHT_BOLD);
+        attr->start_index = start;
+        attr->end_index = end;
+        pango_attr_list_insert(self->highlight, attr);
+
+        gtk_label_set_attributes(self->highlight_label, self->highlight);
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
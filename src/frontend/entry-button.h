@@ -25,6 +25,9 @@ typedef struct _BriskMenuEntryButtonClass BriskMenuEntryButtonClass;
 struct _BriskMenuEntryButtonClass {
         GtkButtonClass parent_class;
         void (*show_context_menu)(BriskMenuEntryButton *button, BriskItem *item);
+
+        /* Refresh the label and icon from the item */
+        void (*update)(BriskMenuEntryButton *button);
 };
 
 /**
@@ -34,6 +37,20 @@ struct _BriskMenuEntryButton {
         GtkButton parent;
         BriskMenuLauncher *launcher;
         BriskItem *item;
+
+        /* Where the current search term matched the item, and how well */
+        BriskSearchMatch match;
+
+        /* Position within the window's visible results, when in_results is set */
+        guint result_index;
+        gboolean in_results;
+
+        /* Set by subclasses, matches within the name are highlighted here */
+        GtkLabel *highlight_label;
+        GArray *label_offsets; /**<Folded byte offset to label byte offset */
+        PangoAttrList *highlight;
+        guint highlight_start;
+        guint highlight_end;
 };
 
 #define BRISK_TYPE_MENU_ENTRY_BUTTON brisk_menu_entry_button_get_type()
@@ -49,6 +66,9 @@ struct _BriskMenuEntryButton {
         (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_MENU_ENTRY_BUTTON, BriskMenuEntryButtonClass))
 
 void brisk_menu_entry_button_launch(BriskMenuEntryButton *button);
+void brisk_menu_entry_button_update(BriskMenuEntryButton *button);
+void brisk_menu_entry_button_set_label(BriskMenuEntryButton *button, const gchar *text);
+void brisk_menu_entry_button_highlight(BriskMenuEntryButton *button, const BriskSearchMatch *match);
 
 GType brisk_menu_entry_button_get_type(void);
 
@@ -16,9 +16,14 @@
 BRISK_BEGIN_PEDANTIC
 #include "launcher.h"
 #include "menu-private.h"
+#include <gio/gdesktopappinfo.h>
 #include <gtk/gtk.h>
 BRISK_END_PEDANTIC
 
+#include <string.h>
+
+DEF_AUTOFREE(GKeyFile, g_key_file_unref)
+
 struct _BriskMenuLauncherClass {
         GObjectClass parent_class;
 };
@@ -34,6 +39,10 @@ struct _BriskMenuLauncher {
 
 G_DEFINE_TYPE(BriskMenuLauncher, brisk_menu_launcher, G_TYPE_OBJECT)
 
+enum { LAUNCHER_SIGNAL_ITEM_LAUNCHED = 0, LAUNCHER_SIGNAL_LAUNCH_TIMED, N_SIGNALS };
+
+static guint launcher_signals[N_SIGNALS] = { 0 };
+
 static void brisk_menu_launcher_app_launched(BriskMenuLauncher *self, GAppInfo *info,
                                              GVariant *data, GAppLaunchContext *context);
 static void brisk_menu_launcher_app_failed(BriskMenuLauncher *self, gchar *startup_id,
@@ -75,6 +84,46 @@ static void brisk_menu_launcher_class_init(BriskMenuLauncherClass *klazz)
 
         /* gobject vtable hookup */
         obj_class->dispose = brisk_menu_launcher_dispose;
+
+        /**
+         * BriskMenuLauncher::item-launched
+         * @launcher: The launcher that started the item
+         * @item: The item that was launched
+         *
+         * Emitted once an item has been successfully launched by the user
+         */
+        launcher_signals[LAUNCHER_SIGNAL_ITEM_LAUNCHED] =
+            g_signal_new("item-launched",
+                         BRISK_TYPE_MENU_LAUNCHER,
+                         G_SIGNAL_RUN_LAST,
+                         0,
+                         NULL,
+                         NULL,
+                         NULL,
+                         G_TYPE_NONE,
+                         1,
+                         BRISK_TYPE_ITEM);
+
+        /**
+         * BriskMenuLauncher::launch-timed
+         * @launcher: The launcher that started the app
+         * @method: How it was started, "spawn", "D-Bus" or "item"
+         * @latency: Microseconds from the request until the launch went through
+         *
+         * Emitted for every successful launch, whichever way it went
+         */
+        launcher_signals[LAUNCHER_SIGNAL_LAUNCH_TIMED] =
+            g_signal_new("launch-timed",
+                         BRISK_TYPE_MENU_LAUNCHER,
+                         G_SIGNAL_RUN_LAST,
+                         0,
+                         NULL,
+                         NULL,
+                         NULL,
+                         G_TYPE_NONE,
+                         2,
+                         G_TYPE_STRING,
+                         G_TYPE_INT64);
 }
 
 /**
@@ -100,7 +149,7 @@ static void brisk_menu_launcher_init(BriskMenuLauncher *self)
 }
 
 static void brisk_menu_launcher_init_context(BriskMenuLauncher *self, GtkWidget *parent,
-                                             GIcon *icon)
+                                             GIcon *icon, guint32 timestamp)
 {
         GdkScreen *screen = NULL;
         GtkWidget *toplevel = NULL;
@@ -112,6 +161,7 @@ static void brisk_menu_launcher_init_context(BriskMenuLauncher *self, GtkWidget
         }
 
         gdk_app_launch_context_set_screen(self->context, screen);
+        gdk_app_launch_context_set_timestamp(self->context, timestamp);
         if (icon) {
                 gdk_app_launch_context_set_icon(self->context, icon);
         }
@@ -119,28 +169,373 @@ static void brisk_menu_launcher_init_context(BriskMenuLauncher *self, GtkWidget
         self->display = gdk_screen_get_display(screen);
 
         /* Hide the menu before kicking off the launch */
+        if (!parent) {
+                return;
+        }
         toplevel = gtk_widget_get_toplevel(parent);
         if (BRISK_IS_MENU_WINDOW(toplevel)) {
                 gtk_widget_hide(toplevel);
         }
 }
 
+/**
+ * A launch in flight on a worker thread
+ */
+typedef struct BriskLaunch {
+        BriskMenuLauncher *launcher; /**<Only held while waiting on D-Bus */
+        GAppInfo *info;
+        BriskItem *item;
+        GAppLaunchContext *context;
+        gchar *startup_id;
+        gint64 start_time;
+} BriskLaunch;
+
+static void brisk_launch_free(BriskLaunch *launch)
+{
+        g_clear_object(&launch->launcher);
+        g_clear_object(&launch->info);
+        g_clear_object(&launch->item);
+        g_clear_object(&launch->context);
+        g_free(launch->startup_id);
+        g_slice_free(BriskLaunch, launch);
+}
+
+/**
+ * GLib activates a DBusActivatable entry over D-Bus by itself, never running
+ * Exec, and reports success whether or not anything answers. Having got here
+ * we already know activation failed, so load the entry again without the key
+ * and without a filename, which leaves GLib no app ID to activate.
+ */
+static GAppInfo *brisk_launch_get_spawnable(GAppInfo *info, GError **error)
+{
+        autofree(GKeyFile) *keyfile = NULL;
+        GDesktopAppInfo *spawnable = NULL;
+        const gchar *filename = NULL;
+
+        if (!G_IS_DESKTOP_APP_INFO(info) ||
+            !g_desktop_app_info_get_boolean(G_DESKTOP_APP_INFO(info), "DBusActivatable")) {
+                return g_object_ref(info);
+        }
+
+        filename = g_desktop_app_info_get_filename(G_DESKTOP_APP_INFO(info));
+        if (!filename) {
+                return g_object_ref(info);
+        }
+
+        keyfile = g_key_file_new();
+        if (!g_key_file_load_from_file(keyfile, filename, G_KEY_FILE_NONE, error)) {
+                return NULL;
+        }
+        g_key_file_remove_key(keyfile, G_KEY_FILE_DESKTOP_GROUP, "DBusActivatable", NULL);
+
+        spawnable = g_desktop_app_info_new_from_keyfile(keyfile);
+        if (!spawnable) {
+                g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Unusable entry %s", filename);
+                return NULL;
+        }
+        return G_APP_INFO(spawnable);
+}
+
+/**
+ * Runs on the worker thread. Only the plain GAppLaunchContext is touched here,
+ * as nothing belonging to GDK may be used away from the main thread.
+ */
+static void brisk_menu_launcher_launch_thread(GTask *task, __brisk_unused__ gpointer source,
+                                              BriskLaunch *launch,
+                                              __brisk_unused__ GCancellable *cancellable)
+{
+        autofree(GAppInfo) *info = NULL;
+        GError *error = NULL;
+
+        info = brisk_launch_get_spawnable(launch->info, &error);
+        if (!info) {
+                g_task_return_error(task, error);
+                return;
+        }
+
+        /* We may support DnD URIs onto the icons at some point, not for now. */
+        if (!g_app_info_launch(info, NULL, launch->context, &error)) {
+                g_task_return_error(task, error);
+                return;
+        }
+        g_task_return_boolean(task, TRUE);
+}
+
+/**
+ * The launch went through, whichever way it was started. Every path ends up
+ * here so that they're all timed the same way.
+ */
+static void brisk_menu_launcher_launched(BriskMenuLauncher *self, const gchar *id,
+                                         BriskItem *item, const gchar *method,
+                                         gint64 start_time)
+{
+        gint64 latency = g_get_monotonic_time() - start_time;
+
+        g_debug("Launched %s via %s in %.2fms", id, method, (gdouble)latency / 1000.0);
+        g_signal_emit(self, launcher_signals[LAUNCHER_SIGNAL_LAUNCH_TIMED], 0, method, latency);
+
+        if (item) {
+                g_signal_emit(self, launcher_signals[LAUNCHER_SIGNAL_ITEM_LAUNCHED], 0, item);
+        }
+}
+
+/**
+ * Back on the main thread once the launch completed
+ */
+static void brisk_menu_launcher_launch_done(BriskMenuLauncher *self, GAsyncResult *result,
+                                            __brisk_unused__ gpointer v)
+{
+        GTask *task = G_TASK(result);
+        BriskLaunch *launch = g_task_get_task_data(task);
+        autofree(GError) *error = NULL;
+
+        if (!g_task_propagate_boolean(task, &error)) {
+                g_message("Failed to launch %s: %s",
+                          g_app_info_get_id(launch->info),
+                          error->message);
+                if (launch->startup_id) {
+                        brisk_menu_launcher_app_failed(self, launch->startup_id, NULL);
+                }
+                return;
+        }
+
+        /* Same as our "launched" handling for the GdkAppLaunchContext */
+        if (launch->startup_id) {
+                gdk_display_notify_startup_complete(self->display, launch->startup_id);
+        }
+
+        brisk_menu_launcher_launched(self,
+                                     g_app_info_get_id(launch->info),
+                                     launch->item,
+                                     "spawn",
+                                     launch->start_time);
+}
+
+/**
+ * Hand the fork & exec over to a worker thread so the panel never blocks on it.
+ * Takes ownership of the launch.
+ */
+static void brisk_menu_launcher_spawn(BriskMenuLauncher *self, BriskLaunch *launch)
+{
+        GTask *task = NULL;
+
+        task = g_task_new(self, NULL, (GAsyncReadyCallback)brisk_menu_launcher_launch_done, NULL);
+        g_task_set_task_data(task, launch, (GDestroyNotify)brisk_launch_free);
+        g_task_run_in_thread(task, (GTaskThreadFunc)brisk_menu_launcher_launch_thread);
+        g_object_unref(task);
+}
+
+/**
+ * Determine the D-Bus application ID for the launch, if the .desktop file
+ * asks to be activated over D-Bus and is named appropriately for it.
+ */
+static gchar *brisk_launch_get_dbus_app_id(BriskLaunch *launch)
+{
+        const gchar *id = NULL;
+        gchar *app_id = NULL;
+
+        if (!G_IS_DESKTOP_APP_INFO(launch->info) ||
+            !g_desktop_app_info_get_boolean(G_DESKTOP_APP_INFO(launch->info), "DBusActivatable")) {
+                return NULL;
+        }
+
+        id = g_app_info_get_id(launch->info);
+        if (!id || !g_str_has_suffix(id, ".desktop")) {
+                return NULL;
+        }
+
+        app_id = g_strndup(id, strlen(id) - strlen(".desktop"));
+        if (!g_dbus_is_name(app_id) || g_dbus_is_unique_name(app_id)) {
+                g_free(app_id);
+                return NULL;
+        }
+        return app_id;
+}
+
+/**
+ * Per the Desktop Entry specification, org.example.App-Name is found at
+ * /org/example/App_Name
+ */
+static gchar *brisk_launch_get_dbus_object_path(const gchar *app_id)
+{
+        gchar *path = g_strconcat("/", app_id, NULL);
+
+        for (gchar *c = path; *c; c++) {
+                if (*c == '.') {
+                        *c = '/';
+                } else if (*c == '-') {
+                        *c = '_';
+                }
+        }
+        return path;
+}
+
+/**
+ * The application answered (or failed to answer) our Activate call. If it
+ * couldn't be activated then we just fall back to spawning it.
+ */
+static void brisk_menu_launcher_activate_done(GDBusConnection *bus, GAsyncResult *result,
+                                              BriskLaunch *launch)
+{
+        BriskMenuLauncher *self = launch->launcher;
+        autofree(GError) *error = NULL;
+        GVariant *ret = NULL;
+
+        /* Spawning doesn't need to keep the launcher alive */
+        launch->launcher = NULL;
+
+        ret = g_dbus_connection_call_finish(bus, result, &error);
+        if (!ret) {
+                g_message("D-Bus activation of %s failed, spawning instead: %s",
+                          g_app_info_get_id(launch->info),
+                          error->message);
+                brisk_menu_launcher_spawn(self, launch);
+                g_object_unref(self);
+                return;
+        }
+        g_variant_unref(ret);
+
+        /* The application itself completes startup notification when activated */
+        brisk_menu_launcher_launched(self,
+                                     g_app_info_get_id(launch->info),
+                                     launch->item,
+                                     "D-Bus",
+                                     launch->start_time);
+        brisk_launch_free(launch);
+        g_object_unref(self);
+}
+
+/**
+ * Ask an org.freedesktop.Application to activate itself. If it's already
+ * running this skips process startup entirely, otherwise the bus will start
+ * it for us. Takes ownership of the launch.
+ */
+static void brisk_menu_launcher_activate(BriskMenuLauncher *self, BriskLaunch *launch,
+                                         const gchar *app_id)
+{
+        autofree(gchar) *object_path = NULL;
+        GDBusConnection *bus = NULL;
+        GVariantBuilder builder;
+
+        /* The session bus is set up by the panel long before we get here */
+        bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, NULL);
+        if (!bus) {
+                brisk_menu_launcher_spawn(self, launch);
+                return;
+        }
+
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+        if (launch->startup_id) {
+                g_variant_builder_add(&builder,
+                                      "{sv}",
+                                      "desktop-startup-id",
+                                      g_variant_new_string(launch->startup_id));
+        }
+
+        launch->launcher = g_object_ref(self);
+
+        object_path = brisk_launch_get_dbus_object_path(app_id);
+        g_dbus_connection_call(bus,
+                               app_id,
+                               object_path,
+                               "org.freedesktop.Application",
+                               "Activate",
+                               g_variant_new("(a{sv})", &builder),
+                               NULL,
+                               G_DBUS_CALL_FLAGS_NONE,
+                               -1,
+                               NULL,
+                               (GAsyncReadyCallback)brisk_menu_launcher_activate_done,
+                               launch);
+        g_object_unref(bus);
+}
+
+/**
+ * Prepare everything that needs GDK on the main thread, i.e. the startup
+ * notification, and then either activate the application over D-Bus or
+ * spawn it on a worker thread.
+ */
+static void brisk_menu_launcher_launch_async(BriskMenuLauncher *self, GAppInfo *info,
+                                             BriskItem *item, gint64 start_time)
+{
+        BriskLaunch *launch = NULL;
+        autofree(gchar) *app_id = NULL;
+
+        launch = g_slice_new0(BriskLaunch);
+        launch->info = g_object_ref(info);
+        launch->item = item ? g_object_ref(item) : NULL;
+        launch->start_time = start_time;
+        launch->context = g_app_launch_context_new();
+
+        g_app_launch_context_setenv(launch->context,
+                                    "DISPLAY",
+                                    gdk_display_get_name(self->display));
+
+        launch->startup_id =
+            g_app_launch_context_get_startup_notify_id(G_APP_LAUNCH_CONTEXT(self->context),
+                                                       info,
+                                                       NULL);
+        if (launch->startup_id) {
+                g_app_launch_context_setenv(launch->context,
+                                            "DESKTOP_STARTUP_ID",
+                                            launch->startup_id);
+        }
+
+        app_id = brisk_launch_get_dbus_app_id(launch);
+        if (app_id) {
+                brisk_menu_launcher_activate(self, launch, app_id);
+                return;
+        }
+
+        brisk_menu_launcher_spawn(self, launch);
+}
+
 void brisk_menu_launcher_start_item(BriskMenuLauncher *self, GtkWidget *parent, BriskItem *item)
 {
-        brisk_menu_launcher_init_context(self, parent, (GIcon *)brisk_item_get_icon(item));
+        brisk_menu_launcher_start_item_at(self, parent, item, GDK_CURRENT_TIME);
+}
+
+void brisk_menu_launcher_start_item_at(BriskMenuLauncher *self, GtkWidget *parent,
+                                       BriskItem *item, guint32 timestamp)
+{
+        gint64 start_time = g_get_monotonic_time();
+        GAppInfo *info = NULL;
+
+        brisk_menu_launcher_init_context(self,
+                                         parent,
+                                         (GIcon *)brisk_item_get_icon(item),
+                                         timestamp);
+
+        /* Get the menu off screen before anything else happens */
+        gdk_display_flush(self->display);
+
+        info = brisk_item_get_app_info(item);
+        if (info) {
+                brisk_menu_launcher_launch_async(self, info, item, start_time);
+                return;
+        }
 
         /* The item itself will basically do similar to g_app_info_launch using our
          * context now it's prepared.
          */
-        brisk_item_launch(item, G_APP_LAUNCH_CONTEXT(self->context));
+        if (!brisk_item_launch(item, G_APP_LAUNCH_CONTEXT(self->context))) {
+                return;
+        }
+
+        brisk_menu_launcher_launched(self, brisk_item_get_id(item), item, "item", start_time);
 }
 
 void brisk_menu_launcher_start(BriskMenuLauncher *self, GtkWidget *parent, GAppInfo *app_info)
 {
-        brisk_menu_launcher_init_context(self, parent, g_app_info_get_icon(app_info));
+        gint64 start_time = g_get_monotonic_time();
 
-        /* We may support DnD URIs onto the icons at some point, not for now. */
-        g_app_info_launch(app_info, NULL, G_APP_LAUNCH_CONTEXT(self->context), NULL);
+        brisk_menu_launcher_init_context(self,
+                                         parent,
+                                         g_app_info_get_icon(app_info),
+                                         GDK_CURRENT_TIME);
+        gdk_display_flush(self->display);
+
+        brisk_menu_launcher_launch_async(self, app_info, NULL, start_time);
 }
 
 /**
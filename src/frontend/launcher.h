@@ -50,6 +50,13 @@ void brisk_menu_launcher_start(BriskMenuLauncher *self, GtkWidget *parent, GAppI
  */
 void brisk_menu_launcher_start_item(BriskMenuLauncher *self, GtkWidget *parent, BriskItem *item);
 
+/**
+ * Start a given Brisk item on behalf of someone else, i.e. over D-Bus, with
+ * the timestamp of the event that asked for it. parent may be NULL.
+ */
+void brisk_menu_launcher_start_item_at(BriskMenuLauncher *self, GtkWidget *parent,
+                                       BriskItem *item, guint32 timestamp);
+
 G_END_DECLS
 
 /*
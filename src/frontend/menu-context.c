@@ -24,49 +24,47 @@ BRISK_END_PEDANTIC
 DEF_AUTOFREE(GMenu, g_object_unref)
 
 /**
- * brisk_menu_window_context_hide:
+ * Cached models may be NULL when an item has no actions at all
+ */
+static void brisk_menu_window_model_unref(gpointer model)
+{
+        if (model) {
+                g_object_unref(model);
+        }
+}
+
+/**
+ * brisk_menu_window_context_detach:
  *
- * Existing menu has gone bye-bye, so clear it up. Typically this only happens
- * when the new menu is about to be inserted, and not when the menu is actually
- * closed.
+ * Existing menu has gone bye-bye, typically because the model it was built
+ * from is no longer valid. The action group stays put as it's shared by
+ * every context menu.
  */
-static void brisk_menu_window_context_hide(GtkWidget *attached, GtkMenu *menu)
+static void brisk_menu_window_context_detach(GtkWidget *attached, __brisk_unused__ GtkMenu *menu)
 {
         BriskMenuWindow *self = BRISK_MENU_WINDOW(attached);
 
-        /* Pop any existing action group */
-        gtk_widget_insert_action_group(attached, BRISK_ACTION_GROUP, NULL);
-        gtk_widget_destroy(GTK_WIDGET(menu));
-        self->context_group = NULL;
+        self->context_menu = NULL;
+        self->context_model = NULL;
 }
 
 /**
- * brisk_menu_window_show_context:
- *
- * Menu button has requested a context menu be shown for the given item
+ * brisk_menu_window_build_context:
  *
- * WARNING: this is leaky right now and is a port of the original PR behaviour
+ * Ask every backend for its actions on the given item and combine them into
+ * a single model
  */
-void brisk_menu_window_show_context(BriskMenuWindow *self, BriskItem *item,
-                                    __brisk_unused__ BriskMenuEntryButton *button)
+static GMenuModel *brisk_menu_window_build_context(BriskMenuWindow *self, BriskItem *item)
 {
         GHashTableIter iter = { 0 };
-        __brisk_unused__ gpointer key;
         BriskBackend *backend = NULL;
-        GSimpleActionGroup *group = NULL;
-        autofree(GMenu) *simple_menu = NULL;
-
-        g_clear_pointer(&self->context_menu, gtk_widget_destroy);
+        GMenu *simple_menu = NULL;
 
-        group = g_simple_action_group_new();
-        self->context_group = G_ACTION_GROUP(group);
-
-        /* For now, iterate all the backends and stick the actions in */
         g_hash_table_iter_init(&iter, self->backends);
-        while (g_hash_table_iter_next(&iter, (void **)&key, (void **)&backend)) {
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&backend)) {
                 autofree(GMenu) *section = NULL;
 
-                section = brisk_backend_get_item_actions(backend, item, G_ACTION_GROUP(group));
+                section = brisk_backend_get_item_actions(backend, item);
                 if (!section) {
                         continue;
                 }
@@ -79,18 +77,45 @@ void brisk_menu_window_show_context(BriskMenuWindow *self, BriskItem *item,
                 g_menu_append_section(simple_menu, NULL, G_MENU_MODEL(section));
         }
 
-        /* No sense displaying an empty menu */
-        if (!simple_menu) {
+        return G_MENU_MODEL(simple_menu);
+}
+
+/**
+ * brisk_menu_window_show_context:
+ *
+ * Menu button has requested a context menu be shown for the given item
+ */
+void brisk_menu_window_show_context(BriskMenuWindow *self, BriskItem *item,
+                                    __brisk_unused__ BriskMenuEntryButton *button)
+{
+        const gchar *id = brisk_item_get_id(item);
+        GMenuModel *model = NULL;
+
+        if (!id) {
                 return;
         }
 
-        /* Push in the action group for invokables */
-        gtk_widget_insert_action_group(GTK_WIDGET(self), BRISK_ACTION_GROUP, G_ACTION_GROUP(group));
+        /* Only build the model the first time around. NULL is cached too, so
+         * items without any actions don't keep asking the backends. */
+        if (!g_hash_table_lookup_extended(self->context_cache, id, NULL, (void **)&model)) {
+                model = brisk_menu_window_build_context(self, item);
+                g_hash_table_insert(self->context_cache, g_strdup(id), model);
+        }
+
+        /* No sense displaying an empty menu */
+        if (!model) {
+                return;
+        }
 
-        self->context_menu = gtk_menu_new_from_model(G_MENU_MODEL(simple_menu));
-        gtk_menu_attach_to_widget(GTK_MENU(self->context_menu),
-                                  GTK_WIDGET(self),
-                                  brisk_menu_window_context_hide);
+        /* Reuse the widget when it's the same item as last time */
+        if (!self->context_menu || self->context_model != model) {
+                g_clear_pointer(&self->context_menu, gtk_widget_destroy);
+                self->context_menu = gtk_menu_new_from_model(model);
+                self->context_model = model;
+                gtk_menu_attach_to_widget(GTK_MENU(self->context_menu),
+                                          GTK_WIDGET(self),
+                                          brisk_menu_window_context_detach);
+        }
 
         /* Show it now */
         gtk_menu_popup(GTK_MENU(self->context_menu),
@@ -102,14 +127,53 @@ void brisk_menu_window_show_context(BriskMenuWindow *self, BriskItem *item,
                        GDK_CURRENT_TIME);
 }
 
+/**
+ * brisk_menu_window_actions_changed:
+ *
+ * A backend told us that the actions for the given item, or all items when
+ * id is NULL, are now different. Just drop the cached models and they'll be
+ * rebuilt when next needed.
+ */
+void brisk_menu_window_actions_changed(BriskMenuWindow *self, const gchar *id,
+                                       __brisk_unused__ BriskBackend *backend)
+{
+        /* The menu may well be active right now, it'll be replaced on next show */
+        if (!id) {
+                self->context_model = NULL;
+                g_hash_table_remove_all(self->context_cache);
+                return;
+        }
+
+        if (self->context_model &&
+            g_hash_table_lookup(self->context_cache, id) == self->context_model) {
+                self->context_model = NULL;
+        }
+        g_hash_table_remove(self->context_cache, id);
+}
+
+/**
+ * brisk_menu_window_register_actions:
+ *
+ * Let the backend add its parameterized actions to our shared group
+ */
+void brisk_menu_window_register_actions(BriskMenuWindow *self, BriskBackend *backend)
+{
+        brisk_backend_register_actions(backend, G_ACTION_MAP(self->context_group));
+}
+
 /**
  * brisk_menu_window_configure_context:
  *
  * Set up the basics for handling context menus
  */
-void brisk_menu_window_configure_context(__brisk_unused__ BriskMenuWindow *self)
+void brisk_menu_window_configure_context(BriskMenuWindow *self)
 {
-        /* TODO: Init bits */
+        self->context_cache =
+            g_hash_table_new_full(g_str_hash, g_str_equal, g_free, brisk_menu_window_model_unref);
+
+        /* One group for the lifetime of the window, targets tell items apart */
+        self->context_group = G_ACTION_GROUP(g_simple_action_group_new());
+        gtk_widget_insert_action_group(GTK_WIDGET(self), BRISK_ACTION_GROUP, self->context_group);
 }
 
 /*
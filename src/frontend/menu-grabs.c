@@ -71,6 +71,7 @@ static gboolean brisk_menu_window_map(GtkWidget *widget, __brisk_unused__ gpoint
         gtk_widget_grab_focus(self->search);
 
         brisk_menu_window_grab(self);
+        brisk_menu_window_prefetch_frequent(self);
 
         return GDK_EVENT_STOP;
 }
@@ -80,7 +81,9 @@ static gboolean brisk_menu_window_map(GtkWidget *widget, __brisk_unused__ gpoint
  */
 static gboolean brisk_menu_window_unmap(GtkWidget *widget, __brisk_unused__ gpointer udata)
 {
-        brisk_menu_window_ungrab(BRISK_MENU_WINDOW(widget));
+        BriskMenuWindow *self = BRISK_MENU_WINDOW(widget);
+
+        brisk_menu_window_ungrab(self);
         return GDK_EVENT_STOP;
 }
 
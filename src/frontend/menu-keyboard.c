@@ -11,13 +11,29 @@
 
 #include "util.h"
 
+#include <string.h>
+
 BRISK_BEGIN_PEDANTIC
+#include "backend/favourites/favourites-backend.h"
+#include "entry-button.h"
 #include "menu-private.h"
 BRISK_END_PEDANTIC
 
+/**
+ * A BriskMenuShortcut is bound for each entry in the "shortcuts" setting.
+ * The binder belongs to the window, so the window is only held weakly.
+ */
+typedef struct BriskMenuShortcut {
+        GWeakRef window;
+        gchar *action;
+} BriskMenuShortcut;
+
+DEF_AUTOFREE(GVariant, g_variant_unref)
+DEF_AUTOFREE(GHashTable, g_hash_table_unref)
+
 /**
  * Handle hiding the menu when it comes to the shortcut key only.
- * i.e. the Super_L key.
+ * i.e. the Super_L key. Anything else may be a navigation key.
  */
 gboolean brisk_menu_window_key_press(BriskMenuWindow *self, GdkEvent *event,
                                      __brisk_unused__ gpointer v)
@@ -25,12 +41,12 @@ gboolean brisk_menu_window_key_press(BriskMenuWindow *self, GdkEvent *event,
         autofree(gchar) *accel_name = NULL;
 
         if (!self->shortcut) {
-                return GDK_EVENT_PROPAGATE;
+                return brisk_menu_window_navigate(self, &event->key);
         }
 
         accel_name = gtk_accelerator_name(event->key.keyval, event->key.state);
         if (!accel_name || g_ascii_strcasecmp(self->shortcut, accel_name) != 0) {
-                return GDK_EVENT_PROPAGATE;
+                return brisk_menu_window_navigate(self, &event->key);
         }
 
         gtk_widget_hide(GTK_WIDGET(self));
@@ -50,20 +66,33 @@ gboolean brisk_menu_window_key_release(BriskMenuWindow *self, GdkEvent *event,
         return GDK_EVENT_PROPAGATE;
 }
 
+/**
+ * Put the window on screen in the right place, if it isn't already there
+ */
+static void show_menu(BriskMenuWindow *self)
+{
+        if (gtk_widget_get_visible(GTK_WIDGET(self))) {
+                return;
+        }
+
+        /* Cheap trick to ensure we reset our active position */
+        brisk_menu_window_set_parent_position(self, self->position);
+        /* Ensure we're in the appropriate place */
+        brisk_menu_window_update_screen_position(self);
+
+        gtk_widget_show(GTK_WIDGET(self));
+}
+
 /**
  * Called in idle once back out of the event
  */
 static gboolean toggle_menu(BriskMenuWindow *self)
 {
-        gboolean vis = !gtk_widget_get_visible(GTK_WIDGET(self));
-        if (vis) {
-                /* Cheap trick to ensure we reset our active position */
-                brisk_menu_window_set_parent_position(self, self->position);
-                /* Ensure we're in the appropriate place */
-                brisk_menu_window_update_screen_position(self);
+        if (gtk_widget_get_visible(GTK_WIDGET(self))) {
+                gtk_widget_hide(GTK_WIDGET(self));
+        } else {
+                show_menu(self);
         }
-
-        gtk_widget_set_visible(GTK_WIDGET(self), vis);
         return FALSE;
 }
 
@@ -93,6 +122,185 @@ void brisk_menu_window_update_hotkey(BriskMenuWindow *self, gchar *key)
         self->shortcut = g_strdup(key);
 }
 
+static BriskMenuShortcut *brisk_menu_shortcut_new(BriskMenuWindow *window, const gchar *action)
+{
+        BriskMenuShortcut *shortcut = g_slice_new0(BriskMenuShortcut);
+        g_weak_ref_init(&shortcut->window, window);
+        shortcut->action = g_strdup(action);
+        return shortcut;
+}
+
+static void brisk_menu_shortcut_free(BriskMenuShortcut *shortcut)
+{
+        g_weak_ref_clear(&shortcut->window);
+        g_free(shortcut->action);
+        g_slice_free(BriskMenuShortcut, shortcut);
+}
+
+/**
+ * Launch the favourite at the given (1-based) position without showing the
+ * menu at all
+ */
+static void brisk_menu_window_launch_favourite(BriskMenuWindow *self, const gchar *index)
+{
+        BriskBackend *backend = NULL;
+        GtkWidget *button = NULL;
+        const gchar *id = NULL;
+        gchar *end = NULL;
+        guint64 n;
+
+        n = g_ascii_strtoull(index, &end, 10);
+        if (end == index || *end != '\0' || n < 1 || n > G_MAXUINT) {
+                g_message("Invalid favourite index in shortcut: '%s'", index);
+                return;
+        }
+
+        backend = g_hash_table_lookup(self->backends, "favourites");
+        if (!backend || !BRISK_IS_FAVOURITES_BACKEND(backend)) {
+                return;
+        }
+
+        id = brisk_favourites_backend_get_nth(BRISK_FAVOURITES_BACKEND(backend), (guint)n - 1);
+        if (!id) {
+                return;
+        }
+
+        button = g_hash_table_lookup(self->item_store, id);
+        if (!button || !BRISK_IS_MENU_ENTRY_BUTTON(button)) {
+                return;
+        }
+
+        brisk_menu_launcher_start_item(self->launcher,
+                                       GTK_WIDGET(self),
+                                       BRISK_MENU_ENTRY_BUTTON(button)->item);
+}
+
+/**
+ * Perform the action configured for the shortcut
+ */
+static void brisk_menu_shortcut_run(BriskMenuWindow *self, const gchar *action)
+{
+        GtkWidget *button = NULL;
+
+        if (g_str_has_prefix(action, "favourite:")) {
+                brisk_menu_window_launch_favourite(self, action + strlen("favourite:"));
+                return;
+        }
+
+        if (g_str_has_prefix(action, "section:")) {
+                button = g_hash_table_lookup(self->item_store, action + strlen("section:"));
+                if (!button || !GTK_IS_TOGGLE_BUTTON(button)) {
+                        g_message("Unknown section in shortcut: '%s'", action);
+                        return;
+                }
+                show_menu(self);
+                gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(button), TRUE);
+                return;
+        }
+
+        if (g_str_has_prefix(action, "search:")) {
+                show_menu(self);
+                gtk_entry_set_text(GTK_ENTRY(self->search), action + strlen("search:"));
+                gtk_widget_grab_focus(self->search);
+                gtk_editable_set_position(GTK_EDITABLE(self->search), -1);
+                return;
+        }
+
+        g_message("Unknown shortcut action: '%s'", action);
+}
+
+/**
+ * Called in idle once back out of the event, unless the window is gone
+ */
+static gboolean brisk_menu_shortcut_activate(BriskMenuShortcut *shortcut)
+{
+        BriskMenuWindow *self = g_weak_ref_get(&shortcut->window);
+
+        /* The window went away before we got to idle */
+        if (!self) {
+                return FALSE;
+        }
+
+        brisk_menu_shortcut_run(self, shortcut->action);
+        g_object_unref(self);
+        return FALSE;
+}
+
+/**
+ * Handle one of the configurable global shortcuts. The binding may well be
+ * gone by the time we're idle, so take a copy along.
+ */
+static void shortcut_cb(__brisk_unused__ GdkEvent *event, gpointer v)
+{
+        BriskMenuShortcut *shortcut = v;
+        BriskMenuWindow *window = g_weak_ref_get(&shortcut->window);
+
+        if (!window) {
+                return;
+        }
+
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                        (GSourceFunc)brisk_menu_shortcut_activate,
+                        brisk_menu_shortcut_new(window, shortcut->action),
+                        (GDestroyNotify)brisk_menu_shortcut_free);
+        g_object_unref(window);
+}
+
+/**
+ * Update the configurable shortcuts in accordance with settings.
+ *
+ * Only bindings that were added, removed or changed are touched, so that the
+ * remaining shortcuts keep working throughout the update.
+ */
+void brisk_menu_window_update_shortcuts(BriskMenuWindow *self)
+{
+        autofree(GVariant) *value = NULL;
+        autofree(GHashTable) *wanted = NULL;
+        GHashTableIter iter = { 0 };
+        GVariantIter viter = { 0 };
+        const gchar *accel = NULL;
+        const gchar *action = NULL;
+
+        wanted = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+        value = g_settings_get_value(self->settings, "shortcuts");
+        g_variant_iter_init(&viter, value);
+        while (g_variant_iter_next(&viter, "{&s&s}", &accel, &action)) {
+                g_hash_table_insert(wanted, g_strdup(accel), g_strdup(action));
+        }
+
+        /* Drop everything that went away or now does something else */
+        g_hash_table_iter_init(&iter, self->shortcuts);
+        while (g_hash_table_iter_next(&iter, (void **)&accel, (void **)&action)) {
+                const gchar *new_action = g_hash_table_lookup(wanted, accel);
+                if (new_action && g_str_equal(new_action, action)) {
+                        g_hash_table_remove(wanted, accel);
+                        continue;
+                }
+                brisk_key_binder_unbind(self->binder, accel);
+                g_hash_table_iter_remove(&iter);
+        }
+
+        /* Whatever is left over is new */
+        g_hash_table_iter_init(&iter, wanted);
+        while (g_hash_table_iter_next(&iter, (void **)&accel, (void **)&action)) {
+                BriskMenuShortcut *shortcut = brisk_menu_shortcut_new(self, action);
+
+                if (!brisk_key_binder_bind_full(self->binder,
+                                                accel,
+                                                shortcut_cb,
+                                                shortcut,
+                                                (GDestroyNotify)brisk_menu_shortcut_free)) {
+                        g_message("Failed to bind keyboard shortcut: '%s'", accel);
+                        brisk_menu_shortcut_free(shortcut);
+                        continue;
+                }
+
+                /* Steal the strings over to our own table */
+                g_hash_table_iter_steal(&iter);
+                g_hash_table_insert(self->shortcuts, (gchar *)accel, (gchar *)action);
+        }
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
@@ -14,11 +14,9 @@
 #include <stdlib.h>
 
 BRISK_BEGIN_PEDANTIC
-#include "backend/all-items/all-backend.h"
-#include "backend/apps/apps-backend.h"
-#include "backend/favourites/favourites-backend.h"
 #include "entry-button.h"
 #include "menu-private.h"
+#include "registry.h"
 #include <gtk/gtk.h>
 BRISK_END_PEDANTIC
 
@@ -39,26 +37,112 @@ static void brisk_menu_window_hide(BriskMenuWindow *self, __brisk_unused__ Brisk
 }
 
 /**
- * Load the menus and place them into the window regions
+ * A single item changed its ordering, visibility or appearance, so only update its row
+ * rather than sorting and filtering the entire view again
  */
-gboolean brisk_menu_window_load_menus(BriskMenuWindow *self)
+static void brisk_menu_window_item_changed(BriskMenuWindow *self, const gchar *id,
+                                           __brisk_unused__ BriskBackend *backend)
+{
+        GtkWidget *button = NULL;
+        GtkWidget *parent = NULL;
+
+        button = g_hash_table_lookup(self->item_store, id);
+        if (!button) {
+                return;
+        }
+
+        brisk_menu_entry_button_update(BRISK_MENU_ENTRY_BUTTON(button));
+
+        parent = gtk_widget_get_parent(button);
+        if (GTK_IS_LIST_BOX_ROW(parent)) {
+                gtk_list_box_row_changed(GTK_LIST_BOX_ROW(parent));
+        } else if (GTK_IS_FLOW_BOX_CHILD(parent)) {
+                gtk_flow_box_child_changed(GTK_FLOW_BOX_CHILD(parent));
+        }
+}
+
+/**
+ * Only the window that searched last gets to show search results, as the
+ * backends producing them are shared by every window
+ */
+static gboolean brisk_menu_window_wants_items(BriskMenuWindow *self, BriskBackend *backend)
+{
+        guint flags = brisk_backend_get_flags(backend);
+
+        if ((flags & BRISK_BACKEND_SEARCH) != BRISK_BACKEND_SEARCH) {
+                return TRUE;
+        }
+        return brisk_menu_registry_is_searcher(self->registry, self);
+}
+
+/**
+ * A backend has a new item for us, unless it's answering another window
+ */
+static void brisk_menu_window_item_added(BriskMenuWindow *self, BriskItem *item,
+                                         BriskBackend *backend)
+{
+        if (!brisk_menu_window_wants_items(self, backend)) {
+                return;
+        }
+        brisk_menu_window_add_item(self, item, backend);
+}
+
+/**
+ * A backend withdrew an item, so drop its button from the view
+ */
+static void brisk_menu_window_item_removed(BriskMenuWindow *self, const gchar *id,
+                                           BriskBackend *backend)
+{
+        GtkWidget *button = NULL;
+        GtkWidget *parent = NULL;
+        BriskItem *item = NULL;
+
+        /* Sections share the store, so make sure it's really that item */
+        button = g_hash_table_lookup(self->item_store, id);
+        if (!button || !BRISK_IS_MENU_ENTRY_BUTTON(button)) {
+                return;
+        }
+        item = BRISK_MENU_ENTRY_BUTTON(button)->item;
+        if (!item || !g_str_equal(brisk_item_get_backend_id(item), brisk_backend_get_id(backend))) {
+                return;
+        }
+
+        brisk_menu_window_actions_changed(self, id, backend);
+        g_hash_table_remove(self->item_store, id);
+        g_ptr_array_remove_fast(self->entries, button);
+        brisk_menu_window_track_result(self, BRISK_MENU_ENTRY_BUTTON(button), FALSE);
+
+        parent = gtk_widget_get_parent(button);
+        if (GTK_IS_LIST_BOX_ROW(parent) || GTK_IS_FLOW_BOX_CHILD(parent)) {
+                gtk_widget_destroy(parent);
+        } else {
+                gtk_widget_destroy(button);
+        }
+}
+
+/**
+ * Let every backend know that the user launched an item, so that they may
+ * learn from it
+ */
+static void brisk_menu_window_item_launched(BriskMenuWindow *self, BriskItem *item,
+                                            __brisk_unused__ BriskMenuLauncher *launcher)
 {
         GHashTableIter iter;
-        gchar *backend_id = NULL;
         BriskBackend *backend = NULL;
 
-        /* We only call load() on backends exposing BRISK_BACKEND_SOURCE */
         g_hash_table_iter_init(&iter, self->backends);
-        while (g_hash_table_iter_next(&iter, (void **)&backend_id, (void **)&backend)) {
-                guint flags = brisk_backend_get_flags(backend);
-                if ((flags & BRISK_BACKEND_SOURCE) != BRISK_BACKEND_SOURCE) {
-                        continue;
-                }
-                if (!brisk_backend_load(backend)) {
-                        g_warning("Failed to load source backend: '%s'", backend_id);
-                }
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&backend)) {
+                brisk_backend_item_launched(backend, item);
         }
+}
 
+/**
+ * Load the menus and place them into the window regions. The backends are
+ * shared, so only the first window to get here actually loads anything.
+ */
+gboolean brisk_menu_window_load_menus(BriskMenuWindow *self)
+{
+        brisk_menu_registry_load(self->registry);
         return G_SOURCE_REMOVE;
 }
 
@@ -79,7 +163,15 @@ static void brisk_menu_window_init_backend(BriskMenuWindow *self, BriskBackend *
         /* Hook up the signals first */
         g_signal_connect_swapped(backend,
                                  "item-added",
-                                 G_CALLBACK(brisk_menu_window_add_item),
+                                 G_CALLBACK(brisk_menu_window_item_added),
+                                 self);
+        g_signal_connect_swapped(backend,
+                                 "item-removed",
+                                 G_CALLBACK(brisk_menu_window_item_removed),
+                                 self);
+        g_signal_connect_swapped(backend,
+                                 "item-changed",
+                                 G_CALLBACK(brisk_menu_window_item_changed),
                                  self);
         g_signal_connect_swapped(backend,
                                  "section-added",
@@ -91,6 +183,12 @@ static void brisk_menu_window_init_backend(BriskMenuWindow *self, BriskBackend *
                                  self);
         g_signal_connect_swapped(backend, "hide-menu", G_CALLBACK(brisk_menu_window_hide), self);
         g_signal_connect_swapped(backend, "reset", G_CALLBACK(brisk_menu_window_reset), self);
+        g_signal_connect_swapped(backend,
+                                 "actions-changed",
+                                 G_CALLBACK(brisk_menu_window_actions_changed),
+                                 self);
+
+        brisk_menu_window_register_actions(self, backend);
 
         box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
         gtk_box_pack_start(GTK_BOX(self->section_box_holder), box, FALSE, FALSE, 0);
@@ -103,49 +201,164 @@ static void brisk_menu_window_init_backend(BriskMenuWindow *self, BriskBackend *
                               (gint)g_hash_table_size(self->backends));
 
         g_hash_table_insert(self->section_boxes, (gchar *)backend_id, box);
+        if (!self->section_box_first) {
+                self->section_box_first = box;
+        }
 }
 
 /**
- * Utility to insert a single backend
+ * Utility to insert a single backend, catching up on anything it emitted
+ * before we were around
  */
-static inline void brisk_menu_window_insert_backend(BriskMenuWindow *self, BriskBackend *backend)
+static void brisk_menu_window_insert_backend(BriskMenuWindow *self, BriskBackend *backend)
 {
         const gchar *backend_id = brisk_backend_get_id(backend);
-        g_hash_table_insert(self->backends, (gchar *)backend_id, backend);
+        GPtrArray *sections = NULL;
+        GPtrArray *items = NULL;
+
+        g_hash_table_insert(self->backends, (gchar *)backend_id, g_object_ref(backend));
         brisk_menu_window_init_backend(self, backend);
+
+        sections = brisk_menu_registry_get_sections(self->registry, backend);
+        for (guint i = 0; sections && i < sections->len; i++) {
+                brisk_menu_window_add_section(self, sections->pdata[i], backend);
+        }
+
+        items = brisk_menu_registry_get_items(self->registry, backend);
+        for (guint i = 0; items && i < items->len; i++) {
+                brisk_menu_window_item_added(self, items->pdata[i], backend);
+        }
 }
 
 /**
- * Handle deletion for children in the sidebar
+ * The search backends changed hands. The window losing them drops the
+ * results it was shown, the window gaining them catches up on the current
+ * ones, which its own term is about to replace.
  */
-void brisk_menu_window_remove_category(GtkWidget *widget, BriskMenuWindow *self)
+static void brisk_menu_window_searcher_changed(BriskMenuWindow *self,
+                                               __brisk_unused__ BriskMenuRegistry *registry)
 {
-        BriskSection *section = NULL;
-        const gchar *section_id = NULL;
+        GHashTableIter iter;
+        BriskBackend *backend = NULL;
 
-        if (!GTK_IS_RADIO_BUTTON(widget)) {
-                return;
+        g_hash_table_iter_init(&iter, self->backends);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&backend)) {
+                guint flags = brisk_backend_get_flags(backend);
+                GPtrArray *items = NULL;
+
+                if ((flags & BRISK_BACKEND_SEARCH) != BRISK_BACKEND_SEARCH) {
+                        continue;
+                }
+                if (!brisk_menu_window_wants_items(self, backend)) {
+                        brisk_menu_window_actions_changed(self, NULL, backend);
+                        brisk_menu_window_purge_backend(self, backend);
+                        continue;
+                }
+
+                items = brisk_menu_registry_get_items(self->registry, backend);
+                for (guint i = 0; items && i < items->len; i++) {
+                        brisk_menu_window_add_item(self, items->pdata[i], backend);
+                }
         }
+}
+
+/**
+ * brisk_menu_window_purge_backend:
+ *
+ * Destroy every category and entry button that belongs to the backend
+ */
+void brisk_menu_window_purge_backend(BriskMenuWindow *self, BriskBackend *backend)
+{
+        GtkWidget *box_target = brisk_menu_window_get_section_box(self, backend);
+        const gchar *backend_id = brisk_backend_get_id(backend);
+
+        /* Sidebar first, walking backwards so removal doesn't skip anything */
+        for (guint i = self->categories->len; i > 0; i--) {
+                GtkWidget *button = self->categories->pdata[i - 1];
+                BriskSection *section = NULL;
+
+                if (gtk_widget_get_parent(button) != box_target) {
+                        continue;
+                }
 
-        g_object_get(widget, "section", &section, NULL);
-        if (!section) {
-                g_warning("missing section for category button");
+                g_object_get(button, "section", &section, NULL);
+                if (!section) {
+                        g_warning("missing section for category button");
+                } else {
+                        g_hash_table_remove(self->item_store, brisk_section_get_id(section));
+                }
+
+                g_ptr_array_remove_index(self->categories, i - 1);
+                gtk_widget_destroy(button);
         }
 
-        section_id = brisk_section_get_id(section);
+        /* Then the items, which may be in any order */
+        for (guint i = self->entries->len; i > 0; i--) {
+                BriskMenuEntryButton *button = self->entries->pdata[i - 1];
+                GtkWidget *parent = NULL;
+
+                if (!button->item) {
+                        g_warning("missing item for entry in backend '%s'", backend_id);
+                        continue;
+                }
+                if (!g_str_equal(backend_id, brisk_item_get_backend_id(button->item))) {
+                        continue;
+                }
+
+                g_hash_table_remove(self->item_store, brisk_item_get_id(button->item));
+                g_ptr_array_remove_index_fast(self->entries, i - 1);
 
-        g_hash_table_remove(self->item_store, section_id);
-        gtk_widget_destroy(widget);
+                parent = gtk_widget_get_parent(GTK_WIDGET(button));
+                if (GTK_IS_LIST_BOX_ROW(parent) || GTK_IS_FLOW_BOX_CHILD(parent)) {
+                        gtk_widget_destroy(parent);
+                } else {
+                        gtk_widget_destroy(GTK_WIDGET(button));
+                }
+        }
 }
 
 /**
- * Bring up the initial backends
+ * brisk_menu_window_section_activated:
+ *
+ * Let the owning backend know the active section was just opened, so that
+ * lazily loaded backends may populate it
+ */
+void brisk_menu_window_section_activated(BriskMenuWindow *self)
+{
+        BriskBackend *backend = NULL;
+
+        if (!self->active_section) {
+                return;
+        }
+
+        backend = g_hash_table_lookup(self->backends,
+                                      brisk_section_get_backend_id(self->active_section));
+        if (backend) {
+                brisk_backend_section_activated(backend, self->active_section);
+        }
+}
+
+/**
+ * Attach to the backends shared by every window in the process
  */
 void brisk_menu_window_init_backends(BriskMenuWindow *self)
 {
-        brisk_menu_window_insert_backend(self, brisk_all_items_backend_new());
-        brisk_menu_window_insert_backend(self, brisk_favourites_backend_new());
-        brisk_menu_window_insert_backend(self, brisk_apps_backend_new());
+        GPtrArray *backends = NULL;
+
+        self->registry = brisk_menu_registry_get_default();
+        backends = brisk_menu_registry_get_backends(self->registry);
+        for (guint i = 0; i < backends->len; i++) {
+                brisk_menu_window_insert_backend(self, backends->pdata[i]);
+        }
+        g_signal_connect_swapped(self->registry,
+                                 "searcher-changed",
+                                 G_CALLBACK(brisk_menu_window_searcher_changed),
+                                 self);
+
+        g_signal_connect_swapped(self->launcher,
+                                 "item-launched",
+                                 G_CALLBACK(brisk_menu_window_item_launched),
+                                 self);
 }
 
 /*
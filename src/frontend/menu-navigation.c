@@ -0,0 +1,413 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "entry-button.h"
+#include "launcher.h"
+#include "menu-private.h"
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+/**
+ * The filter pass visits every row in container order and tells us which
+ * ones stay visible. We keep those in an array that is sorted the same way
+ * as the container the first time it's needed, so that moving between
+ * results is plain index arithmetic rather than a walk over every child.
+ */
+
+/**
+ * brisk_menu_window_reset_results:
+ *
+ * Forget all visible results ahead of a full filter pass
+ */
+void brisk_menu_window_reset_results(BriskMenuWindow *self)
+{
+        for (guint i = 0; i < self->results->len; i++) {
+                BRISK_MENU_ENTRY_BUTTON(self->results->pdata[i])->in_results = FALSE;
+        }
+        g_ptr_array_set_size(self->results, 0);
+        self->results_sorted = TRUE;
+}
+
+/**
+ * brisk_menu_window_track_result:
+ *
+ * Record the outcome of filtering a single entry button
+ */
+void brisk_menu_window_track_result(BriskMenuWindow *self, BriskMenuEntryButton *button,
+                                    gboolean visible)
+{
+        /* Scores may have changed even if visibility didn't */
+        self->results_sorted = FALSE;
+
+        if (visible == button->in_results) {
+                return;
+        }
+
+        button->in_results = visible;
+        if (visible) {
+                g_ptr_array_add(self->results, g_object_ref(button));
+        } else {
+                /* Only happens when a single row is filtered again */
+                g_ptr_array_remove(self->results, button);
+        }
+}
+
+static gint brisk_menu_window_compare_results(gconstpointer a, gconstpointer b, gpointer v)
+{
+        return brisk_menu_window_sort(BRISK_MENU_WINDOW(v),
+                                      *(BriskMenuEntryButton **)a,
+                                      *(BriskMenuEntryButton **)b);
+}
+
+/**
+ * Put the results into display order, dropping any button that was
+ * destroyed since the last filter pass
+ */
+static void brisk_menu_window_sort_results(BriskMenuWindow *self)
+{
+        if (self->results_sorted) {
+                return;
+        }
+
+        for (guint i = self->results->len; i > 0; i--) {
+                BriskMenuEntryButton *button = self->results->pdata[i - 1];
+
+                if (!gtk_widget_get_parent(GTK_WIDGET(button))) {
+                        button->in_results = FALSE;
+                        g_ptr_array_remove_index(self->results, i - 1);
+                }
+        }
+
+        g_ptr_array_sort_with_data(self->results, brisk_menu_window_compare_results, self);
+        for (guint i = 0; i < self->results->len; i++) {
+                BRISK_MENU_ENTRY_BUTTON(self->results->pdata[i])->result_index = i;
+        }
+        self->results_sorted = TRUE;
+}
+
+/**
+ * brisk_menu_window_get_result:
+ *
+ * Return the visible entry button at the given position, or NULL
+ */
+BriskMenuEntryButton *brisk_menu_window_get_result(BriskMenuWindow *self, guint index)
+{
+        brisk_menu_window_sort_results(self);
+
+        if (index >= self->results->len) {
+                return NULL;
+        }
+        return self->results->pdata[index];
+}
+
+/**
+ * brisk_menu_window_launch_result:
+ *
+ * Launch the visible entry button at the given position
+ *
+ * Returns TRUE if there was anything to launch
+ */
+gboolean brisk_menu_window_launch_result(BriskMenuWindow *self, guint index)
+{
+        BriskMenuEntryButton *button = brisk_menu_window_get_result(self, index);
+
+        if (!button) {
+                return FALSE;
+        }
+        brisk_menu_entry_button_launch(button);
+        return TRUE;
+}
+
+/**
+ * Find the position of the result holding the keyboard focus
+ *
+ * Returns FALSE if the focus isn't within the results
+ */
+static gboolean brisk_menu_window_get_focus_result(BriskMenuWindow *self, guint *index)
+{
+        GtkWidget *focus = gtk_window_get_focus(GTK_WINDOW(self));
+        BriskMenuEntryButton *button = NULL;
+
+        /* Rows may take the focus themselves rather than the button within */
+        if (focus && !BRISK_IS_MENU_ENTRY_BUTTON(focus) && GTK_IS_BIN(focus)) {
+                focus = gtk_bin_get_child(GTK_BIN(focus));
+        }
+        if (!focus || !BRISK_IS_MENU_ENTRY_BUTTON(focus)) {
+                return FALSE;
+        }
+
+        button = BRISK_MENU_ENTRY_BUTTON(focus);
+        brisk_menu_window_sort_results(self);
+        if (!button->in_results) {
+                return FALSE;
+        }
+
+        *index = button->result_index;
+        return TRUE;
+}
+
+/**
+ * Grids flow horizontally, so count how many results share the first line
+ */
+static guint brisk_menu_window_get_result_columns(BriskMenuWindow *self)
+{
+        GtkAllocation first = { 0 };
+        GtkAllocation alloc = { 0 };
+        GtkWidget *row = NULL;
+        guint columns = 1;
+
+        row = gtk_widget_get_parent(self->results->pdata[0]);
+        if (!GTK_IS_FLOW_BOX_CHILD(row)) {
+                return 1;
+        }
+
+        gtk_widget_get_allocation(row, &first);
+        for (; columns < self->results->len; columns++) {
+                row = gtk_widget_get_parent(self->results->pdata[columns]);
+                gtk_widget_get_allocation(row, &alloc);
+                if (alloc.y != first.y) {
+                        break;
+                }
+        }
+
+        return columns;
+}
+
+/**
+ * Number of results making up one page of the scrolled view
+ */
+static guint brisk_menu_window_get_result_page(BriskMenuWindow *self, guint columns)
+{
+        GtkAllocation alloc = { 0 };
+        GtkWidget *row = NULL;
+        GtkWidget *scroll = NULL;
+        GtkAdjustment *adjustment = NULL;
+        gdouble lines;
+
+        row = gtk_widget_get_parent(self->results->pdata[0]);
+        scroll = gtk_widget_get_ancestor(row, GTK_TYPE_SCROLLED_WINDOW);
+        gtk_widget_get_allocation(row, &alloc);
+        if (!scroll || alloc.height < 1) {
+                return columns;
+        }
+
+        adjustment = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scroll));
+        lines = gtk_adjustment_get_page_size(adjustment) / alloc.height;
+
+        return columns * MAX(1, (guint)lines);
+}
+
+/**
+ * Focus the row of the result at the given position and scroll it into view,
+ * as the containers don't do that for us
+ */
+static void brisk_menu_window_focus_result(BriskMenuWindow *self, guint index)
+{
+        GtkWidget *row = gtk_widget_get_parent(self->results->pdata[index]);
+        GtkWidget *box = gtk_widget_get_parent(row);
+        GtkWidget *scroll = gtk_widget_get_ancestor(row, GTK_TYPE_SCROLLED_WINDOW);
+        GtkAllocation alloc = { 0 };
+        GtkAllocation box_alloc = { 0 };
+        gint y = 0;
+
+        gtk_widget_grab_focus(row);
+
+        if (!scroll || !gtk_widget_translate_coordinates(row, box, 0, 0, NULL, &y)) {
+                return;
+        }
+
+        /* The box itself may sit within margins inside the viewport */
+        gtk_widget_get_allocation(row, &alloc);
+        gtk_widget_get_allocation(box, &box_alloc);
+        y += box_alloc.y;
+
+        gtk_adjustment_clamp_page(gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scroll)),
+                                  y,
+                                  y + alloc.height);
+}
+
+/**
+ * Move the focus onto the button of the active section in the sidebar,
+ * which is only possible while we're not searching
+ */
+static gboolean brisk_menu_window_focus_sidebar(BriskMenuWindow *self)
+{
+        GtkWidget *button = NULL;
+
+        if (self->search_term || !self->active_section) {
+                return FALSE;
+        }
+
+        button = g_hash_table_lookup(self->item_store,
+                                     brisk_section_get_id(self->active_section));
+        if (!button || !gtk_widget_is_sensitive(button) || !gtk_widget_get_visible(button)) {
+                return FALSE;
+        }
+
+        gtk_widget_grab_focus(button);
+        return TRUE;
+}
+
+/**
+ * Launch one of the first nine results directly with Alt+1 through Alt+9
+ */
+static gboolean brisk_menu_window_launch_numbered(BriskMenuWindow *self, guint keyval)
+{
+        guint index;
+
+        if (keyval >= GDK_KEY_1 && keyval <= GDK_KEY_9) {
+                index = keyval - GDK_KEY_1;
+        } else if (keyval >= GDK_KEY_KP_1 && keyval <= GDK_KEY_KP_9) {
+                index = keyval - GDK_KEY_KP_1;
+        } else {
+                return GDK_EVENT_PROPAGATE;
+        }
+
+        brisk_menu_window_launch_result(self, index);
+        return GDK_EVENT_STOP;
+}
+
+/**
+ * brisk_menu_window_navigate:
+ *
+ * Handle the navigation keys ahead of the focused widget. Moving between the
+ * search entry, the results and the sidebar is driven entirely by the sorted
+ * array of visible results, so hidden rows are never stepped over.
+ */
+gboolean brisk_menu_window_navigate(BriskMenuWindow *self, GdkEventKey *event)
+{
+        GdkModifierType state = event->state & gtk_accelerator_get_default_mod_mask();
+        GtkWidget *focus = gtk_window_get_focus(GTK_WINDOW(self));
+        gboolean in_results = FALSE;
+        guint index = 0;
+        guint last, columns, page;
+
+        if (state == GDK_MOD1_MASK) {
+                return brisk_menu_window_launch_numbered(self, event->keyval);
+        }
+        if (state != 0) {
+                return GDK_EVENT_PROPAGATE;
+        }
+
+        in_results = brisk_menu_window_get_focus_result(self, &index);
+
+        /* Tab flips between the sidebar and the results */
+        if (event->keyval == GDK_KEY_Tab) {
+                if (in_results) {
+                        if (!brisk_menu_window_focus_sidebar(self)) {
+                                gtk_widget_grab_focus(self->search);
+                        }
+                        return GDK_EVENT_STOP;
+                }
+                if (!brisk_menu_window_get_result(self, 0)) {
+                        return GDK_EVENT_PROPAGATE;
+                }
+                brisk_menu_window_focus_result(self, 0);
+                return GDK_EVENT_STOP;
+        }
+
+        /* From the search entry, only ever head down into the results. The
+         * sidebar is left to its own focus chain. */
+        if (!in_results) {
+                if (focus != self->search) {
+                        return GDK_EVENT_PROPAGATE;
+                }
+                switch (event->keyval) {
+                case GDK_KEY_Down:
+                case GDK_KEY_KP_Down:
+                case GDK_KEY_Page_Down:
+                case GDK_KEY_KP_Page_Down:
+                        if (!brisk_menu_window_get_result(self, 0)) {
+                                return GDK_EVENT_PROPAGATE;
+                        }
+                        brisk_menu_window_focus_result(self, 0);
+                        return GDK_EVENT_STOP;
+                default:
+                        return GDK_EVENT_PROPAGATE;
+                }
+        }
+
+        last = self->results->len - 1;
+        columns = brisk_menu_window_get_result_columns(self);
+
+        switch (event->keyval) {
+        case GDK_KEY_Return:
+        case GDK_KEY_KP_Enter:
+                brisk_menu_window_launch_result(self, index);
+                return GDK_EVENT_STOP;
+        case GDK_KEY_Up:
+        case GDK_KEY_KP_Up:
+                if (index < columns) {
+                        gtk_widget_grab_focus(self->search);
+                        return GDK_EVENT_STOP;
+                }
+                index -= columns;
+                break;
+        case GDK_KEY_Down:
+        case GDK_KEY_KP_Down:
+                index = MIN(index + columns, last);
+                break;
+        case GDK_KEY_Left:
+        case GDK_KEY_KP_Left:
+                if (columns < 2) {
+                        return GDK_EVENT_PROPAGATE;
+                }
+                index = index > 0 ? index - 1 : 0;
+                break;
+        case GDK_KEY_Right:
+        case GDK_KEY_KP_Right:
+                if (columns < 2) {
+                        return GDK_EVENT_PROPAGATE;
+                }
+                index = MIN(index + 1, last);
+                break;
+        case GDK_KEY_Page_Up:
+        case GDK_KEY_KP_Page_Up:
+                page = brisk_menu_window_get_result_page(self, columns);
+                index = index > page ? index - page : 0;
+                break;
+        case GDK_KEY_Page_Down:
+        case GDK_KEY_KP_Page_Down:
+                page = brisk_menu_window_get_result_page(self, columns);
+                index = MIN(index + page, last);
+                break;
+        case GDK_KEY_Home:
+        case GDK_KEY_KP_Home:
+                index = 0;
+                break;
+        case GDK_KEY_End:
+        case GDK_KEY_KP_End:
+                index = last;
+                break;
+        default:
+                return GDK_EVENT_PROPAGATE;
+        }
+
+        brisk_menu_window_focus_result(self, index);
+        return GDK_EVENT_STOP;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,112 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "backend/frequent/frequent-backend.h"
+#include "entry-button.h"
+#include "menu-private.h"
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+/**
+ * How many of the most frequent items we'll warm up when the menu opens
+ */
+#define BRISK_PREFETCH_FREQUENT 3
+
+/**
+ * brisk_menu_window_set_prefetch:
+ *
+ * Enable or disable prefetching of likely launch targets
+ */
+void brisk_menu_window_set_prefetch(BriskMenuWindow *self, gboolean prefetch)
+{
+        if (!prefetch) {
+                if (self->prefetcher) {
+                        brisk_menu_prefetcher_cancel(self->prefetcher);
+                }
+                g_clear_object(&self->prefetcher);
+                return;
+        }
+
+        if (!self->prefetcher) {
+                self->prefetcher = brisk_menu_prefetcher_new();
+        }
+}
+
+/**
+ * brisk_menu_window_prefetch_item:
+ *
+ * Warm up the page cache for the given item, if it has anything to launch
+ */
+void brisk_menu_window_prefetch_item(BriskMenuWindow *self, BriskItem *item)
+{
+        GAppInfo *info = NULL;
+
+        if (!self->prefetcher || !item) {
+                return;
+        }
+
+        info = brisk_item_get_app_info(item);
+        if (!info) {
+                return;
+        }
+        brisk_menu_prefetcher_queue(self->prefetcher, info);
+}
+
+/**
+ * brisk_menu_window_prefetch_frequent:
+ *
+ * The menu just opened, so the items the user launches most are the best
+ * guess for what they'll launch next.
+ */
+void brisk_menu_window_prefetch_frequent(BriskMenuWindow *self)
+{
+        BriskFrequentBackend *backend = NULL;
+
+        if (!self->prefetcher) {
+                return;
+        }
+
+        backend = g_hash_table_lookup(self->backends, "frequent");
+        if (!backend || !BRISK_IS_FREQUENT_BACKEND(backend)) {
+                return;
+        }
+
+        for (guint i = 0; i < BRISK_PREFETCH_FREQUENT; i++) {
+                BriskMenuEntryButton *button = NULL;
+                const gchar *id = NULL;
+
+                id = brisk_frequent_backend_get_top_id(backend, i);
+                if (!id) {
+                        break;
+                }
+                button = g_hash_table_lookup(self->item_store, id);
+                if (!button) {
+                        continue;
+                }
+                brisk_menu_window_prefetch_item(self, button->item);
+        }
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
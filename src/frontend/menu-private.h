@@ -15,6 +15,8 @@
 #include "entry-button.h"
 #include "key-binder.h"
 #include "launcher.h"
+#include "prefetcher.h"
+#include "registry.h"
 #include "libsaver-glue.h"
 #include "libsession-glue.h"
 #include "menu-window.h"
@@ -71,24 +73,45 @@ struct _BriskMenuWindow {
         /* Control hotkeys */
         BriskKeyBinder *binder;
         gchar *shortcut;
+        GHashTable *shortcuts;
 
+        /* Context menus are built once per item and kept until invalidated */
         GtkWidget *context_menu;
+        GMenuModel *context_model;
         GActionGroup *context_group;
+        GHashTable *context_cache;
 
         /* Each backend gets its own box in the sidebar */
         GHashTable *section_boxes;
+        GtkWidget *section_box_first;
+
+        /* Every category and entry button we added, so that we never need to
+         * ask the containers for a copy of their children */
+        GPtrArray *categories;
+        GPtrArray *entries;
 
         /* Each backend is also plugged into one big map */
         GHashTable *backends;
 
+        /* Owns the backends, shared with every other window in the process */
+        BriskMenuRegistry *registry;
+
         /* Acknowledge a single ID "contains" map */
         GHashTable *item_store;
 
         /* Control launches */
         BriskMenuLauncher *launcher;
 
+        /* Optional page cache warming, NULL when disabled */
+        BriskMenuPrefetcher *prefetcher;
+
         /* Search term, may be null at any point. Used for filtering */
         gchar *search_term;
+        gint search_weights[BRISK_SEARCH_N_FIELDS];
+
+        /* Visible entry buttons, collected by the filter pass and sorted on demand */
+        GPtrArray *results;
+        gboolean results_sorted;
 
         /* The current section used in filtering */
         BriskSection *active_section;
@@ -119,15 +142,29 @@ GtkWidget *brisk_menu_window_find_first_visible_radio(BriskMenuWindow *self);
 /* Loader */
 gboolean brisk_menu_window_load_menus(BriskMenuWindow *self);
 void brisk_menu_window_init_backends(BriskMenuWindow *self);
-void brisk_menu_window_remove_category(GtkWidget *widget, BriskMenuWindow *self);
+void brisk_menu_window_section_activated(BriskMenuWindow *self);
+void brisk_menu_window_purge_backend(BriskMenuWindow *self, BriskBackend *backend);
+
+/* Reordering */
+gboolean brisk_menu_window_can_reorder(BriskMenuWindow *self);
+gboolean brisk_menu_window_drop_item(BriskMenuWindow *self, GtkWidget *target, const gchar *id,
+                                     gint x, gint y);
+
+/* Prefetching */
+void brisk_menu_window_set_prefetch(BriskMenuWindow *self, gboolean prefetch);
+void brisk_menu_window_prefetch_item(BriskMenuWindow *self, BriskItem *item);
+void brisk_menu_window_prefetch_frequent(BriskMenuWindow *self);
 
 /* Sorting */
-gint brisk_menu_window_sort(BriskMenuWindow *self, BriskItem *itemA, BriskItem *itemB);
+gint brisk_menu_window_sort(BriskMenuWindow *self, BriskMenuEntryButton *buttonA,
+                            BriskMenuEntryButton *buttonB);
 
 /* Keyboard */
 gboolean brisk_menu_window_key_press(BriskMenuWindow *self, GdkEvent *event, gpointer v);
+gboolean brisk_menu_window_navigate(BriskMenuWindow *self, GdkEventKey *event);
 gboolean brisk_menu_window_key_release(BriskMenuWindow *self, GdkEvent *event, gpointer v);
 void brisk_menu_window_update_hotkey(BriskMenuWindow *self, gchar *key);
+void brisk_menu_window_update_shortcuts(BriskMenuWindow *self);
 
 /* Global grabs */
 void brisk_menu_window_configure_grabs(BriskMenuWindow *self);
@@ -146,13 +183,24 @@ void brisk_menu_window_pump_settings(BriskMenuWindow *self);
 void brisk_menu_window_show_context(BriskMenuWindow *self, BriskItem *item,
                                     BriskMenuEntryButton *button);
 void brisk_menu_window_configure_context(BriskMenuWindow *self);
+void brisk_menu_window_register_actions(BriskMenuWindow *self, BriskBackend *backend);
+void brisk_menu_window_actions_changed(BriskMenuWindow *self, const gchar *id,
+                                       BriskBackend *backend);
 
 /* Search */
 void brisk_menu_window_clear_search(GtkEntry *entry, GtkEntryIconPosition pos, GdkEvent *event,
                                     gpointer v);
 void brisk_menu_window_search(BriskMenuWindow *self, GtkEntry *entry);
+void brisk_menu_window_update_search_weights(BriskMenuWindow *self);
 gboolean brisk_menu_window_filter_apps(BriskMenuWindow *self, GtkWidget *child);
 
+/* Results */
+void brisk_menu_window_reset_results(BriskMenuWindow *self);
+void brisk_menu_window_track_result(BriskMenuWindow *self, BriskMenuEntryButton *button,
+                                    gboolean visible);
+BriskMenuEntryButton *brisk_menu_window_get_result(BriskMenuWindow *self, guint index);
+gboolean brisk_menu_window_launch_result(BriskMenuWindow *self, guint index);
+
 DEF_AUTOFREE(GtkWidget, gtk_widget_destroy)
 DEF_AUTOFREE(GSList, g_slist_free)
 DEF_AUTOFREE(GList, g_list_free)
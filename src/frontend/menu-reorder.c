@@ -0,0 +1,100 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "backend/favourites/favourites-backend.h"
+#include "entry-button.h"
+#include "menu-private.h"
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+/**
+ * Return the favourites backend if it owns the active section
+ */
+static BriskFavouritesBackend *brisk_menu_window_get_reorder_backend(BriskMenuWindow *self)
+{
+        BriskBackend *backend = NULL;
+
+        /* Search results have their own ordering */
+        if (self->search_term || !self->active_section) {
+                return NULL;
+        }
+
+        backend = g_hash_table_lookup(self->backends,
+                                      brisk_section_get_backend_id(self->active_section));
+        if (!backend || !BRISK_IS_FAVOURITES_BACKEND(backend)) {
+                return NULL;
+        }
+        return BRISK_FAVOURITES_BACKEND(backend);
+}
+
+/**
+ * brisk_menu_window_can_reorder:
+ *
+ * Determine whether items may currently be reordered by drag and drop
+ */
+gboolean brisk_menu_window_can_reorder(BriskMenuWindow *self)
+{
+        return brisk_menu_window_get_reorder_backend(self) != NULL;
+}
+
+/**
+ * brisk_menu_window_drop_item:
+ *
+ * The item with the given ID was dropped onto the target entry button, at the
+ * given position within it. Depending on which half of the button it landed,
+ * the item is moved before or after the target.
+ */
+gboolean brisk_menu_window_drop_item(BriskMenuWindow *self, GtkWidget *target, const gchar *id,
+                                     gint x, gint y)
+{
+        BriskFavouritesBackend *backend = NULL;
+        BriskItem *item = NULL;
+        GtkWidget *parent = NULL;
+        GtkAllocation alloc = { 0 };
+        gboolean after = FALSE;
+
+        backend = brisk_menu_window_get_reorder_backend(self);
+        if (!backend) {
+                return FALSE;
+        }
+
+        item = BRISK_MENU_ENTRY_BUTTON(target)->item;
+        if (!item) {
+                return FALSE;
+        }
+
+        /* Grids flow horizontally, lists vertically */
+        gtk_widget_get_allocation(target, &alloc);
+        parent = gtk_widget_get_parent(target);
+        if (GTK_IS_FLOW_BOX_CHILD(parent)) {
+                after = x > alloc.width / 2;
+        } else {
+                after = y > alloc.height / 2;
+        }
+
+        return brisk_favourites_backend_move(backend, id, brisk_item_get_id(item), after);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 BRISK_BEGIN_PEDANTIC
+#include "backend/search.h"
 #include "menu-private.h"
 #include <gio/gdesktopappinfo.h>
 #include <gtk/gtk.h>
@@ -21,37 +22,12 @@ BRISK_BEGIN_PEDANTIC
 BRISK_END_PEDANTIC
 
 /**
- * Update sensitivity - ignoring non checkboxes
- */
-static void brisk_menu_set_checks_sensitive(GtkWidget *parent, gboolean sensitive)
-{
-        autofree(GList) *kids = NULL;
-        GList *elem = NULL;
-
-        kids = gtk_container_get_children(GTK_CONTAINER(parent));
-        for (elem = kids; elem; elem = elem->next) {
-                GtkWidget *kid = elem->data;
-                if (!GTK_IS_CHECK_BUTTON(kid)) {
-                        continue;
-                }
-                gtk_widget_set_sensitive(kid, sensitive);
-        }
-}
-
-/**
- * Ask all boxes to update their section children
+ * Update sensitivity of every section button in the sidebar
  */
 static void brisk_menu_set_categories_sensitive(BriskMenuWindow *self, gboolean sensitive)
 {
-        brisk_menu_set_checks_sensitive(self->section_box_holder, sensitive);
-        GHashTableIter iter;
-        __attribute__((unused)) gchar *key = NULL;
-        GtkWidget *box = NULL;
-
-        /* Update all sideboxes for search */
-        g_hash_table_iter_init(&iter, self->section_boxes);
-        while (g_hash_table_iter_next(&iter, (void **)&key, (void **)&box)) {
-                brisk_menu_set_checks_sensitive(box, sensitive);
+        for (guint i = 0; i < self->categories->len; i++) {
+                gtk_widget_set_sensitive(self->categories->pdata[i], sensitive);
         }
 }
 
@@ -106,8 +82,8 @@ void brisk_menu_window_search(BriskMenuWindow *self, GtkEntry *entry)
         search_term = gtk_entry_get_text(entry);
         g_clear_pointer(&self->search_term, g_free);
 
-        /* New search term, always lower case for simplicity */
-        self->search_term = g_strstrip(g_ascii_strdown(search_term, -1));
+        /* New search term, folded once here the same way as the search keys */
+        self->search_term = brisk_search_fold(search_term);
 
         /* Reset our search term if it's not valid anymore, or whitespace */
         if (strlen(self->search_term) > 0) {
@@ -117,12 +93,62 @@ void brisk_menu_window_search(BriskMenuWindow *self, GtkEntry *entry)
                 g_clear_pointer(&self->search_term, g_free);
         }
 
-        /* Now filter again */
+        /* Backends searching on demand emit their results ahead of filtering */
+        brisk_menu_registry_search(self->registry, self, self->search_term);
+
         brisk_menu_window_invalidate_filter(self, NULL);
+
+        /* The filter pass is done, so the results now hold exactly what's
+         * visible. A single result is very likely what the user is about to launch */
+        if (self->search_term && self->results->len == 1) {
+                BriskMenuEntryButton *button = self->results->pdata[0];
+
+                brisk_menu_window_prefetch_item(self, button->item);
+        }
 }
 
+/**
+ * brisk_menu_window_update_search_weights:
+ *
+ * Reload the per-field weights and rank any active search again
+ */
+void brisk_menu_window_update_search_weights(BriskMenuWindow *self)
+{
+        brisk_search_weights_load(self->settings, self->search_weights);
+
+        if (self->search_term) {
+                brisk_menu_window_invalidate_filter(self, NULL);
+        }
+}
+
+/**
+ * Sum up the ranking boosts every backend wishes to apply to the item, i.e.
+ * to float frequently launched items to the top of the search results.
+ */
+static gint brisk_menu_window_get_item_boost(BriskMenuWindow *self, BriskItem *item)
+{
+        GHashTableIter iter;
+        BriskBackend *backend = NULL;
+        gint boost = 0;
+
+        g_hash_table_iter_init(&iter, self->backends);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&backend)) {
+                boost += brisk_backend_get_item_boost(backend, item);
+        }
+
+        return boost;
+}
+
+/**
+ * brisk_menu_window_filter_apps:
+ *
+ * Decide whether the entry button should be visible. GTK may ask as often
+ * and in whatever order it likes, so this only ever caches the match for
+ * the sort on the button itself and leaves counting to the caller.
+ */
 __brisk_pure__ gboolean brisk_menu_window_filter_apps(BriskMenuWindow *self, GtkWidget *child)
 {
+        BriskMenuEntryButton *button = BRISK_MENU_ENTRY_BUTTON(child);
         const gchar *item_id = NULL;
         BriskItem *item = NULL;
         GtkWidget *compare_child = NULL;
@@ -147,11 +173,17 @@ __brisk_pure__ gboolean brisk_menu_window_filter_apps(BriskMenuWindow *self, Gtk
 
         /* If we have no search term, filter on the section */
         if (!self->search_term) {
+                brisk_menu_entry_button_highlight(button, NULL);
                 return brisk_menu_window_filter_section(self, item);
         }
 
-        /* Have search term? Filter on that. */
-        return brisk_item_matches_search(item, self->search_term);
+        /* Have search term? Filter on that, scoring it once for the sort */
+        if (!brisk_item_search(item, self->search_term, self->search_weights, &button->match)) {
+                return FALSE;
+        }
+        button->match.score += brisk_menu_window_get_item_boost(self, item);
+        brisk_menu_entry_button_highlight(button, &button->match);
+        return TRUE;
 }
 
 /*
@@ -46,6 +46,9 @@ void brisk_menu_window_pump_settings(BriskMenuWindow *self)
         brisk_menu_window_settings_changed(self->settings, "search-position", self);
         brisk_menu_window_settings_changed(self->settings, "rollover-activate", self);
         brisk_menu_window_settings_changed(self->settings, "hot-key", self);
+        brisk_menu_window_settings_changed(self->settings, "shortcuts", self);
+        brisk_menu_window_settings_changed(self->settings, "prefetch-apps", self);
+        brisk_menu_window_settings_changed(self->settings, "search-weights", self);
 }
 
 static void brisk_menu_window_settings_changed(GSettings *settings, const gchar *key, gpointer v)
@@ -62,6 +65,12 @@ static void brisk_menu_window_settings_changed(GSettings *settings, const gchar
         } else if (g_str_equal(key, "hot-key")) {
                 value = g_settings_get_string(settings, key);
                 brisk_menu_window_update_hotkey(self, value);
+        } else if (g_str_equal(key, "shortcuts")) {
+                brisk_menu_window_update_shortcuts(self);
+        } else if (g_str_equal(key, "prefetch-apps")) {
+                brisk_menu_window_set_prefetch(self, g_settings_get_boolean(settings, key));
+        } else if (g_str_equal(key, "search-weights")) {
+                brisk_menu_window_update_search_weights(self);
         }
 }
 
@@ -20,43 +20,28 @@ BRISK_BEGIN_PEDANTIC
 BRISK_END_PEDANTIC
 
 /**
- * Compute a score for the given entry based on the input term.
+ * brisk_menu_window_sort:
+ *
+ * Search results are ranked by the score computed when filtering them,
+ * everything else by the section order and then by name.
  */
-__brisk_pure__ static gint brisk_get_entry_score(BriskItem *item, const gchar *term)
-{
-        gint score = 0;
-        autofree(gchar) *name = NULL;
-        char *find = NULL;
-
-        name = g_ascii_strdown(brisk_item_get_name(item), -1);
-        if (g_str_equal(name, term)) {
-                score += 100;
-        } else if (g_str_has_prefix(name, term)) {
-                score += 50;
-        }
-
-        find = strstr(name, term);
-        if (find) {
-                score += 20 + (int)strlen(find);
-        }
-
-        score += strcmp(name, term);
-
-        return score;
-}
-
-__brisk_pure__ gint brisk_menu_window_sort(BriskMenuWindow *self, BriskItem *itemA,
-                                           BriskItem *itemB)
+gint brisk_menu_window_sort(BriskMenuWindow *self, BriskMenuEntryButton *buttonA,
+                            BriskMenuEntryButton *buttonB)
 {
+        BriskItem *itemA = buttonA->item;
+        BriskItem *itemB = buttonB->item;
         autofree(gchar) *nameA = NULL;
         autofree(gchar) *nameB = NULL;
         gint sc1 = -1, sc2 = -1;
 
         /* Handle normal searching */
         if (self->search_term) {
-                sc1 = brisk_get_entry_score(itemA, self->search_term);
-                sc2 = brisk_get_entry_score(itemB, self->search_term);
-                return (sc1 > sc2) - (sc1 - sc2);
+                sc1 = buttonA->match.score;
+                sc2 = buttonB->match.score;
+                if (sc1 != sc2) {
+                        return (sc1 < sc2) - (sc1 > sc2);
+                }
+                goto basic_sort;
         }
 
         if (!self->active_section) {
@@ -69,7 +54,7 @@ __brisk_pure__ gint brisk_menu_window_sort(BriskMenuWindow *self, BriskItem *ite
         /* Negative score means the section doesn't support custom ordering */
         if (sc1 >= 0 || sc2 >= 0) {
                 /* Sort based on the sections understanding */
-                return (sc1 > sc2) - (sc1 - sc2);
+                return (sc2 > sc1) - (sc2 < sc1);
         }
 
 basic_sort:
@@ -40,16 +40,40 @@ static void brisk_menu_window_dispose(GObject *obj)
 
         g_clear_object(&self->binder);
         g_clear_pointer(&self->shortcut, g_free);
+        g_clear_pointer(&self->shortcuts, g_hash_table_unref);
         g_clear_pointer(&self->search_term, g_free);
+        g_clear_pointer(&self->results, g_ptr_array_unref);
         g_clear_object(&self->launcher);
+        if (self->prefetcher) {
+                brisk_menu_prefetcher_cancel(self->prefetcher);
+        }
+        g_clear_object(&self->prefetcher);
         g_clear_object(&self->session);
         g_clear_object(&self->saver);
         g_clear_object(&self->settings);
         g_clear_pointer(&self->item_store, g_hash_table_unref);
         g_clear_pointer(&self->section_boxes, g_hash_table_unref);
+        g_clear_pointer(&self->categories, g_ptr_array_unref);
+        g_clear_pointer(&self->entries, g_ptr_array_unref);
+        if (self->backends) {
+                GHashTableIter iter;
+                BriskBackend *backend = NULL;
+
+                /* Backends outlive us when other windows still use them */
+                g_hash_table_iter_init(&iter, self->backends);
+                while (g_hash_table_iter_next(&iter, NULL, (void **)&backend)) {
+                        g_signal_handlers_disconnect_by_data(backend, self);
+                }
+        }
         g_clear_pointer(&self->backends, g_hash_table_unref);
+        if (self->registry) {
+                g_signal_handlers_disconnect_by_data(self->registry, self);
+                brisk_menu_registry_release_search(self->registry, self);
+        }
+        g_clear_object(&self->registry);
         g_clear_pointer(&self->context_menu, gtk_widget_destroy);
         g_clear_object(&self->context_group);
+        g_clear_pointer(&self->context_cache, g_hash_table_unref);
 
         G_OBJECT_CLASS(brisk_menu_window_parent_class)->dispose(obj);
 }
@@ -92,11 +116,19 @@ static void brisk_menu_window_init(BriskMenuWindow *self)
         /* Initialise main tables */
         self->item_store = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
         self->section_boxes = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, NULL);
+        self->categories = g_ptr_array_new();
+        self->entries = g_ptr_array_new();
         self->backends = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, g_object_unref);
+        self->results = g_ptr_array_new_with_free_func(g_object_unref);
+        self->results_sorted = TRUE;
 
         self->binder = brisk_key_binder_new();
+        self->shortcuts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
         self->launcher = brisk_menu_launcher_new();
 
+        /* Backends register their actions as they're inserted */
+        brisk_menu_window_configure_context(self);
+
         brisk_menu_window_init_settings(self);
 }
 
@@ -153,26 +185,27 @@ void brisk_menu_window_select_sections(BriskMenuWindow *self)
         }
 }
 
+/**
+ * brisk_menu_window_find_first_visible_radio:
+ *
+ * Return the first category button within the first section box. Categories
+ * are packed in the order they were added, so that's the first one we find.
+ */
 GtkWidget *brisk_menu_window_find_first_visible_radio(BriskMenuWindow *self)
 {
-        autofree(GList) *box_kids = NULL;
-        autofree(GList) *box_kids2 = NULL;
-        GtkWidget *main_box = NULL;
-        GList *elem = NULL;
-
-        box_kids = gtk_container_get_children(GTK_CONTAINER(self->section_box_holder));
-        for (elem = box_kids; elem; elem = elem->next) {
-                if (!GTK_IS_BOX(elem->data)) {
-                        continue;
-                }
-                main_box = elem->data;
-                break;
-        }
-        if (!main_box) {
+        if (!self->section_box_first) {
                 return NULL;
         }
-        box_kids2 = gtk_container_get_children(GTK_CONTAINER(main_box));
-        return g_list_nth_data(box_kids2, 0);
+
+        for (guint i = 0; i < self->categories->len; i++) {
+                GtkWidget *button = self->categories->pdata[i];
+
+                if (gtk_widget_get_parent(button) == self->section_box_first) {
+                        return button;
+                }
+        }
+
+        return NULL;
 }
 
 /**
@@ -255,7 +288,18 @@ void brisk_menu_window_reset(BriskMenuWindow *window, BriskBackend *backend)
         g_assert(window != NULL);
         BriskMenuWindowClass *klazz = BRISK_MENU_WINDOW_GET_CLASS(window);
         g_assert(klazz->reset != NULL);
+
+        /* Items are going away, so their context menus must too */
+        brisk_menu_window_actions_changed(window, NULL, backend);
         klazz->reset(window, backend);
+
+        /* Anything still queued was picked from the old items */
+        if (window->prefetcher) {
+                brisk_menu_prefetcher_cancel(window->prefetcher);
+        }
+
+        /* Destroyed buttons are dropped from the results when next sorted */
+        window->results_sorted = FALSE;
 }
 
 /*
@@ -0,0 +1,151 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "monitor-cache.h"
+BRISK_END_PEDANTIC
+
+/**
+ * Asking the screen about its monitors may well mean a round trip to the
+ * X server, which we really don't want to do during size negotiation.
+ * Instead we keep a copy of the layout on each GdkScreen and only refresh
+ * it once the screen tells us something changed.
+ */
+typedef struct BriskMenuMonitorCache {
+        BriskMenuMonitor *monitors;
+        gint n_monitors;
+        gboolean valid;
+} BriskMenuMonitorCache;
+
+/**
+ * Attached to the GdkScreen
+ */
+#define BRISK_MENU_MONITOR_CACHE "brisk-menu-monitor-cache"
+
+/**
+ * Attached to the toplevel, remembers which monitor it was last placed on
+ * as index + 1, so that a missing value reads as 0
+ */
+#define BRISK_MENU_MONITOR_INDEX "brisk-menu-monitor-index"
+
+static void brisk_menu_monitor_cache_free(BriskMenuMonitorCache *cache)
+{
+        g_free(cache->monitors);
+        g_slice_free(BriskMenuMonitorCache, cache);
+}
+
+static void brisk_menu_monitor_cache_invalidate(__brisk_unused__ GdkScreen *screen,
+                                                BriskMenuMonitorCache *cache)
+{
+        cache->valid = FALSE;
+}
+
+/**
+ * Return the cache for the screen, refreshing it if needed
+ */
+static BriskMenuMonitorCache *brisk_menu_monitor_cache_get(GdkScreen *screen)
+{
+        BriskMenuMonitorCache *cache = NULL;
+
+        cache = g_object_get_data(G_OBJECT(screen), BRISK_MENU_MONITOR_CACHE);
+        if (!cache) {
+                cache = g_slice_new0(BriskMenuMonitorCache);
+                g_object_set_data_full(G_OBJECT(screen),
+                                       BRISK_MENU_MONITOR_CACHE,
+                                       cache,
+                                       (GDestroyNotify)brisk_menu_monitor_cache_free);
+                g_signal_connect(screen,
+                                 "monitors-changed",
+                                 G_CALLBACK(brisk_menu_monitor_cache_invalidate),
+                                 cache);
+                g_signal_connect(screen,
+                                 "size-changed",
+                                 G_CALLBACK(brisk_menu_monitor_cache_invalidate),
+                                 cache);
+        }
+
+        if (cache->valid) {
+                return cache;
+        }
+
+        cache->n_monitors = MAX(gdk_screen_get_n_monitors(screen), 1);
+        cache->monitors = g_renew(BriskMenuMonitor, cache->monitors, (gsize)cache->n_monitors);
+        for (gint i = 0; i < cache->n_monitors; i++) {
+                gdk_screen_get_monitor_geometry(screen, i, &cache->monitors[i].geometry);
+                gdk_screen_get_monitor_workarea(screen, i, &cache->monitors[i].workarea);
+        }
+        cache->valid = TRUE;
+
+        return cache;
+}
+
+/**
+ * Look up the monitor by index, falling back to the primary monitor
+ */
+static const BriskMenuMonitor *brisk_menu_monitor_get(GdkScreen *screen, gint monitor)
+{
+        BriskMenuMonitorCache *cache = brisk_menu_monitor_cache_get(screen);
+
+        if (monitor < 0 || monitor >= cache->n_monitors) {
+                monitor = CLAMP(gdk_screen_get_primary_monitor(screen), 0, cache->n_monitors - 1);
+        }
+        return &cache->monitors[monitor];
+}
+
+/**
+ * brisk_menu_monitor_get_at_point:
+ *
+ * Return the monitor containing the given point, and remember it on the
+ * toplevel of the window so that its children can find it again later.
+ */
+const BriskMenuMonitor *brisk_menu_monitor_get_at_point(GtkWidget *window, gint x, gint y)
+{
+        GdkScreen *screen = gtk_widget_get_screen(window);
+        gint monitor = gdk_screen_get_monitor_at_point(screen, x, y);
+
+        g_object_set_data(G_OBJECT(gtk_widget_get_toplevel(window)),
+                          BRISK_MENU_MONITOR_INDEX,
+                          GINT_TO_POINTER(monitor + 1));
+
+        return brisk_menu_monitor_get(screen, monitor);
+}
+
+/**
+ * brisk_menu_monitor_get_for_widget:
+ *
+ * Return the monitor that the widget's toplevel was last placed on, or the
+ * primary monitor if it hasn't been placed yet. This never touches the
+ * GdkWindow, so it's safe to use before the widget is realized.
+ */
+const BriskMenuMonitor *brisk_menu_monitor_get_for_widget(GtkWidget *widget)
+{
+        gpointer index = g_object_get_data(G_OBJECT(gtk_widget_get_toplevel(widget)),
+                                           BRISK_MENU_MONITOR_INDEX);
+
+        return brisk_menu_monitor_get(gtk_widget_get_screen(widget), GPOINTER_TO_INT(index) - 1);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
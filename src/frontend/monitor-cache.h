@@ -0,0 +1,42 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Cached layout of a single monitor, in screen coordinates
+ */
+typedef struct BriskMenuMonitor {
+        GdkRectangle geometry;
+        GdkRectangle workarea;
+} BriskMenuMonitor;
+
+const BriskMenuMonitor *brisk_menu_monitor_get_at_point(GtkWidget *window, gint x, gint y);
+const BriskMenuMonitor *brisk_menu_monitor_get_for_widget(GtkWidget *widget);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,458 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "prefetcher.h"
+BRISK_END_PEDANTIC
+
+/**
+ * Don't read the same executable ahead more than once in this many seconds
+ */
+#define BRISK_PREFETCH_COOLDOWN (10 * 60)
+
+/**
+ * Never hold more than this many executables waiting to be prefetched
+ */
+#define BRISK_PREFETCH_MAX_PENDING 8
+
+/**
+ * Sanity limits for the ELF structures we're willing to read
+ */
+#define BRISK_PREFETCH_MAX_PHDRS 64
+#define BRISK_PREFETCH_MAX_DYNAMIC (64 * 1024)
+#define BRISK_PREFETCH_MAX_STRTAB (1024 * 1024)
+
+struct _BriskMenuPrefetcherClass {
+        GObjectClass parent_class;
+};
+
+/**
+ * BriskMenuPrefetcher asks the kernel to read likely launch targets into
+ * the page cache before the user actually launches them.
+ */
+struct _BriskMenuPrefetcher {
+        GObject parent;
+        GHashTable *recent;
+        GPtrArray *pending;
+        GCancellable *cancel;
+        gboolean running;
+};
+
+G_DEFINE_TYPE(BriskMenuPrefetcher, brisk_menu_prefetcher, G_TYPE_OBJECT)
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GHashTable, g_hash_table_unref)
+
+/**
+ * Where we'll look for DT_NEEDED libraries
+ */
+static const gchar *brisk_prefetch_lib_dirs[] = {
+#if defined(__x86_64__)
+        "/usr/lib/x86_64-linux-gnu",
+        "/lib/x86_64-linux-gnu",
+#elif defined(__aarch64__)
+        "/usr/lib/aarch64-linux-gnu",
+        "/lib/aarch64-linux-gnu",
+#elif defined(__i386__)
+        "/usr/lib/i386-linux-gnu",
+        "/lib/i386-linux-gnu",
+#endif
+#if __ELF_NATIVE_CLASS == 64
+        "/usr/lib64",
+        "/lib64",
+#endif
+        "/usr/lib",
+        "/lib",
+};
+
+static void brisk_menu_prefetcher_start(BriskMenuPrefetcher *self);
+
+/**
+ * brisk_menu_prefetcher_new:
+ *
+ * Construct a new BriskMenuPrefetcher object
+ */
+BriskMenuPrefetcher *brisk_menu_prefetcher_new()
+{
+        return g_object_new(BRISK_TYPE_MENU_PREFETCHER, NULL);
+}
+
+/**
+ * brisk_menu_prefetcher_dispose:
+ *
+ * Clean up a BriskMenuPrefetcher instance
+ */
+static void brisk_menu_prefetcher_dispose(GObject *obj)
+{
+        BriskMenuPrefetcher *self = BRISK_MENU_PREFETCHER(obj);
+
+        if (self->cancel) {
+                g_cancellable_cancel(self->cancel);
+        }
+        g_clear_object(&self->cancel);
+        g_clear_pointer(&self->pending, g_ptr_array_unref);
+        g_clear_pointer(&self->recent, g_hash_table_unref);
+
+        G_OBJECT_CLASS(brisk_menu_prefetcher_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_menu_prefetcher_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_menu_prefetcher_class_init(BriskMenuPrefetcherClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_menu_prefetcher_dispose;
+}
+
+/**
+ * brisk_menu_prefetcher_init:
+ *
+ * Handle construction of the BriskMenuPrefetcher
+ */
+static void brisk_menu_prefetcher_init(BriskMenuPrefetcher *self)
+{
+        self->recent = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+        self->pending = g_ptr_array_new_with_free_func(g_free);
+        self->cancel = g_cancellable_new();
+}
+
+/**
+ * Ask the kernel to start reading the whole file in, without waiting for it.
+ * Returns the open descriptor so the caller may inspect the file further.
+ */
+static int brisk_prefetch_file(const gchar *path)
+{
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0) {
+                return -1;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        return fd;
+}
+
+/**
+ * Read exactly len bytes at the given offset
+ */
+static gboolean brisk_prefetch_read(int fd, void *buf, size_t len, off_t offset)
+{
+        ssize_t r = pread(fd, buf, len, offset);
+        return r >= 0 && (size_t)r == len;
+}
+
+/**
+ * Map a virtual address from the dynamic section back to its file offset
+ */
+static gboolean brisk_prefetch_vaddr_to_offset(const ElfW(Phdr) * phdrs, guint n_phdrs,
+                                               ElfW(Addr) vaddr, off_t *offset)
+{
+        for (guint i = 0; i < n_phdrs; i++) {
+                const ElfW(Phdr) *phdr = &phdrs[i];
+
+                if (phdr->p_type != PT_LOAD) {
+                        continue;
+                }
+                if (vaddr >= phdr->p_vaddr && vaddr < phdr->p_vaddr + phdr->p_filesz) {
+                        *offset = (off_t)(vaddr - phdr->p_vaddr + phdr->p_offset);
+                        return TRUE;
+                }
+        }
+        return FALSE;
+}
+
+/**
+ * Collect the DT_NEEDED entries of a native ELF object into the needed table.
+ * Anything that isn't a well formed ELF file (i.e. a script) is ignored.
+ */
+static void brisk_prefetch_collect_needed(int fd, GHashTable *needed)
+{
+        ElfW(Ehdr) ehdr = { 0 };
+        ElfW(Phdr) phdrs[BRISK_PREFETCH_MAX_PHDRS];
+        ElfW(Dyn) *dyn = NULL;
+        gchar *strtab = NULL;
+        const ElfW(Phdr) *dynamic = NULL;
+        ElfW(Addr) strtab_addr = 0;
+        size_t strtab_size = 0;
+        size_t n_dyn = 0;
+        off_t strtab_offset = 0;
+        guint n_phdrs;
+
+        if (!brisk_prefetch_read(fd, &ehdr, sizeof(ehdr), 0)) {
+                return;
+        }
+        if (memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 ||
+            ehdr.e_ident[EI_CLASS] != (__ELF_NATIVE_CLASS == 64 ? ELFCLASS64 : ELFCLASS32) ||
+            ehdr.e_phentsize != sizeof(ElfW(Phdr))) {
+                return;
+        }
+
+        n_phdrs = (guint)MIN(ehdr.e_phnum, BRISK_PREFETCH_MAX_PHDRS);
+        if (!brisk_prefetch_read(fd, phdrs, n_phdrs * sizeof(ElfW(Phdr)), (off_t)ehdr.e_phoff)) {
+                return;
+        }
+
+        for (guint i = 0; i < n_phdrs; i++) {
+                if (phdrs[i].p_type == PT_DYNAMIC) {
+                        dynamic = &phdrs[i];
+                        break;
+                }
+        }
+
+        /* Statically linked */
+        if (!dynamic || dynamic->p_filesz > BRISK_PREFETCH_MAX_DYNAMIC) {
+                return;
+        }
+
+        n_dyn = dynamic->p_filesz / sizeof(ElfW(Dyn));
+        dyn = g_new0(ElfW(Dyn), n_dyn + 1);
+        if (!brisk_prefetch_read(fd, dyn, n_dyn * sizeof(ElfW(Dyn)), (off_t)dynamic->p_offset)) {
+                goto cleanup;
+        }
+
+        for (size_t i = 0; i < n_dyn && dyn[i].d_tag != DT_NULL; i++) {
+                if (dyn[i].d_tag == DT_STRTAB) {
+                        strtab_addr = dyn[i].d_un.d_ptr;
+                } else if (dyn[i].d_tag == DT_STRSZ) {
+                        strtab_size = dyn[i].d_un.d_val;
+                }
+        }
+
+        if (strtab_size == 0 || strtab_size > BRISK_PREFETCH_MAX_STRTAB ||
+            !brisk_prefetch_vaddr_to_offset(phdrs, n_phdrs, strtab_addr, &strtab_offset)) {
+                goto cleanup;
+        }
+
+        /* Always NUL terminated, even if the file is lying to us */
+        strtab = g_malloc0(strtab_size + 1);
+        if (!brisk_prefetch_read(fd, strtab, strtab_size, strtab_offset)) {
+                goto cleanup;
+        }
+
+        for (size_t i = 0; i < n_dyn && dyn[i].d_tag != DT_NULL; i++) {
+                if (dyn[i].d_tag != DT_NEEDED || dyn[i].d_un.d_val >= strtab_size) {
+                        continue;
+                }
+                g_hash_table_add(needed, g_strdup(strtab + dyn[i].d_un.d_val));
+        }
+
+cleanup:
+        g_free(strtab);
+        g_free(dyn);
+}
+
+/**
+ * Prefetch the first library found with the given soname
+ */
+static void brisk_prefetch_library(const gchar *soname)
+{
+        for (size_t i = 0; i < G_N_ELEMENTS(brisk_prefetch_lib_dirs); i++) {
+                autofree(gchar) *path = g_build_filename(brisk_prefetch_lib_dirs[i], soname, NULL);
+                int fd = brisk_prefetch_file(path);
+
+                if (fd >= 0) {
+                        close(fd);
+                        return;
+                }
+        }
+}
+
+/**
+ * Runs on a worker thread, prefetching each executable and its direct
+ * library dependencies in turn
+ */
+static void brisk_menu_prefetcher_thread(GTask *task, __brisk_unused__ gpointer source,
+                                         GPtrArray *executables, GCancellable *cancellable)
+{
+        autofree(GHashTable) *needed = NULL;
+        GHashTableIter iter = { 0 };
+        const gchar *soname = NULL;
+
+        needed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+
+        for (guint i = 0; i < executables->len; i++) {
+                autofree(gchar) *path = NULL;
+                int fd;
+
+                if (g_cancellable_is_cancelled(cancellable)) {
+                        break;
+                }
+
+                path = g_find_program_in_path(executables->pdata[i]);
+                if (!path) {
+                        continue;
+                }
+
+                fd = brisk_prefetch_file(path);
+                if (fd < 0) {
+                        continue;
+                }
+                brisk_prefetch_collect_needed(fd, needed);
+                close(fd);
+        }
+
+        g_hash_table_iter_init(&iter, needed);
+        while (g_hash_table_iter_next(&iter, (void **)&soname, NULL)) {
+                if (g_cancellable_is_cancelled(cancellable)) {
+                        break;
+                }
+                brisk_prefetch_library(soname);
+        }
+
+        g_task_return_boolean(task, TRUE);
+}
+
+static gboolean brisk_menu_prefetcher_expired(__brisk_unused__ gpointer key, gpointer last,
+                                              gpointer now)
+{
+        return GPOINTER_TO_INT(now) - GPOINTER_TO_INT(last) >= BRISK_PREFETCH_COOLDOWN;
+}
+
+/**
+ * Back on the main thread, start the next run if more requests came in.
+ * Only a run that went all the way through counts towards the cooldown, a
+ * cancelled one may have left its executables cold.
+ */
+static void brisk_menu_prefetcher_done(BriskMenuPrefetcher *self, GAsyncResult *result,
+                                       __brisk_unused__ gpointer v)
+{
+        GTask *task = G_TASK(result);
+        GPtrArray *executables = g_task_get_task_data(task);
+        gint now = (gint)(g_get_monotonic_time() / G_USEC_PER_SEC);
+
+        g_task_propagate_boolean(task, NULL);
+
+        /* Nothing older than the cooldown can stop a prefetch, so drop it */
+        g_hash_table_foreach_remove(self->recent,
+                                    brisk_menu_prefetcher_expired,
+                                    GINT_TO_POINTER(now));
+
+        if (!g_cancellable_is_cancelled(g_task_get_cancellable(task))) {
+                for (guint i = 0; i < executables->len; i++) {
+                        g_hash_table_insert(self->recent,
+                                            g_strdup(executables->pdata[i]),
+                                            GINT_TO_POINTER(now));
+                }
+        }
+
+        self->running = FALSE;
+        if (self->pending->len > 0) {
+                brisk_menu_prefetcher_start(self);
+        }
+}
+
+/**
+ * Hand everything pending over to a new worker run
+ */
+static void brisk_menu_prefetcher_start(BriskMenuPrefetcher *self)
+{
+        GTask *task = NULL;
+        GPtrArray *executables = NULL;
+
+        executables = self->pending;
+        self->pending = g_ptr_array_new_with_free_func(g_free);
+        self->running = TRUE;
+
+        task = g_task_new(self,
+                          self->cancel,
+                          (GAsyncReadyCallback)brisk_menu_prefetcher_done,
+                          NULL);
+        g_task_set_task_data(task, executables, (GDestroyNotify)g_ptr_array_unref);
+        g_task_set_priority(task, G_PRIORITY_LOW);
+        g_task_run_in_thread(task, (GTaskThreadFunc)brisk_menu_prefetcher_thread);
+        g_object_unref(task);
+}
+
+/**
+ * brisk_menu_prefetcher_queue:
+ *
+ * Queue the app_info's executable for prefetching, unless we did so recently
+ */
+void brisk_menu_prefetcher_queue(BriskMenuPrefetcher *self, GAppInfo *app_info)
+{
+        const gchar *executable = NULL;
+        gint64 now = g_get_monotonic_time() / G_USEC_PER_SEC;
+        gpointer last = NULL;
+
+        executable = g_app_info_get_executable(app_info);
+        if (!executable || !*executable) {
+                return;
+        }
+
+        if (g_hash_table_lookup_extended(self->recent, executable, NULL, &last) &&
+            now - GPOINTER_TO_INT(last) < BRISK_PREFETCH_COOLDOWN) {
+                return;
+        }
+
+        if (self->pending->len >= BRISK_PREFETCH_MAX_PENDING) {
+                return;
+        }
+
+        /* Recorded as recent once the run completes, until then only once */
+        for (guint i = 0; i < self->pending->len; i++) {
+                if (g_str_equal(self->pending->pdata[i], executable)) {
+                        return;
+                }
+        }
+
+        g_ptr_array_add(self->pending, g_strdup(executable));
+
+        if (!self->running) {
+                brisk_menu_prefetcher_start(self);
+        }
+}
+
+/**
+ * brisk_menu_prefetcher_cancel:
+ *
+ * Stop prefetching, i.e. because the items it was asked for went away
+ */
+void brisk_menu_prefetcher_cancel(BriskMenuPrefetcher *self)
+{
+        g_ptr_array_set_size(self->pending, 0);
+
+        if (!self->running) {
+                return;
+        }
+
+        /* The running task keeps the old cancellable */
+        g_cancellable_cancel(self->cancel);
+        g_clear_object(&self->cancel);
+        self->cancel = g_cancellable_new();
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,64 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef struct _BriskMenuPrefetcher BriskMenuPrefetcher;
+typedef struct _BriskMenuPrefetcherClass BriskMenuPrefetcherClass;
+
+#define BRISK_TYPE_MENU_PREFETCHER brisk_menu_prefetcher_get_type()
+#define BRISK_MENU_PREFETCHER(o)                                                                   \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_MENU_PREFETCHER, BriskMenuPrefetcher))
+#define BRISK_IS_MENU_PREFETCHER(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_MENU_PREFETCHER))
+#define BRISK_MENU_PREFETCHER_CLASS(o)                                                             \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_MENU_PREFETCHER, BriskMenuPrefetcherClass))
+#define BRISK_IS_MENU_PREFETCHER_CLASS(o)                                                          \
+        (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_MENU_PREFETCHER))
+#define BRISK_MENU_PREFETCHER_GET_CLASS(o)                                                         \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_MENU_PREFETCHER, BriskMenuPrefetcherClass))
+
+/**
+ * Construct a new BriskMenuPrefetcher to warm the page cache for apps
+ */
+BriskMenuPrefetcher *brisk_menu_prefetcher_new(void);
+
+GType brisk_menu_prefetcher_get_type(void);
+
+/**
+ * Ask for the executable behind app_info, and the libraries it needs, to be
+ * read ahead in the background. Requests are rate limited per executable.
+ */
+void brisk_menu_prefetcher_queue(BriskMenuPrefetcher *self, GAppInfo *app_info);
+
+/**
+ * Drop any pending requests and stop the current run as soon as possible
+ */
+void brisk_menu_prefetcher_cancel(BriskMenuPrefetcher *self);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,468 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "backend/all-items/all-backend.h"
+#include "backend/apps/apps-backend.h"
+#include "backend/calc/calc-backend.h"
+#include "backend/favourites/favourites-backend.h"
+#include "backend/files/files-backend.h"
+#include "backend/frequent/frequent-backend.h"
+#include "backend/plugin/plugin-backend.h"
+#include "backend/proxy/proxy-backend.h"
+#include "backend/recent/recent-backend.h"
+#include "registry.h"
+#include "search-provider.h"
+BRISK_END_PEDANTIC
+
+struct _BriskMenuRegistryClass {
+        GObjectClass parent_class;
+};
+
+/**
+ * Everything a backend has told us about so far
+ */
+typedef struct BriskMenuRegistryModel {
+        BriskMenuRegistry *registry;
+        BriskBackend *backend;
+        GPtrArray *sections;
+        GPtrArray *items; /**<In emission order, IDs may repeat across sections */
+} BriskMenuRegistryModel;
+
+/**
+ * BriskMenuRegistry owns the backends for the whole panel process, so that
+ * each applet instance doesn't load and hold its own copy of every item.
+ * It mirrors the backend signals into a model that late windows can be
+ * brought up to date from.
+ */
+struct _BriskMenuRegistry {
+        GObject parent;
+        GSettings *settings;
+        GPtrArray *backends;  /**<Registration order */
+        GHashTable *models;   /**<Backend ID to BriskMenuRegistryModel */
+        GHashTable *lookup;   /**<Item ID to the last item added with it */
+        BriskMenuSearchProvider *provider;
+        gpointer searcher; /**<Window the search backends currently answer */
+        gboolean loaded;
+};
+
+G_DEFINE_TYPE(BriskMenuRegistry, brisk_menu_registry, G_TYPE_OBJECT)
+
+enum { REGISTRY_SIGNAL_SEARCHER_CHANGED = 0, N_SIGNALS };
+
+static guint registry_signals[N_SIGNALS] = { 0 };
+
+/**
+ * Only ever one registry alive at a time, dropped with the last window
+ */
+static BriskMenuRegistry *default_registry = NULL;
+
+static void brisk_menu_registry_init_backends(BriskMenuRegistry *self);
+
+static void brisk_menu_registry_model_free(BriskMenuRegistryModel *model)
+{
+        g_signal_handlers_disconnect_by_data(model->backend, model);
+        g_ptr_array_unref(model->sections);
+        g_ptr_array_unref(model->items);
+        g_slice_free(BriskMenuRegistryModel, model);
+}
+
+/**
+ * brisk_menu_registry_dispose:
+ *
+ * Clean up a BriskMenuRegistry instance
+ */
+static void brisk_menu_registry_dispose(GObject *obj)
+{
+        BriskMenuRegistry *self = BRISK_MENU_REGISTRY(obj);
+
+        g_clear_object(&self->provider);
+        g_clear_pointer(&self->lookup, g_hash_table_unref);
+        g_clear_pointer(&self->models, g_hash_table_unref);
+        g_clear_pointer(&self->backends, g_ptr_array_unref);
+        g_clear_object(&self->settings);
+
+        G_OBJECT_CLASS(brisk_menu_registry_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_menu_registry_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_menu_registry_class_init(BriskMenuRegistryClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_menu_registry_dispose;
+
+        /**
+         * BriskMenuRegistry::searcher-changed
+         * @registry: The registry owning the backends
+         *
+         * Another window is about to search, so the items of the search
+         * backends now belong to it
+         */
+        registry_signals[REGISTRY_SIGNAL_SEARCHER_CHANGED] =
+            g_signal_new("searcher-changed",
+                         BRISK_TYPE_MENU_REGISTRY,
+                         G_SIGNAL_RUN_LAST,
+                         0,
+                         NULL,
+                         NULL,
+                         NULL,
+                         G_TYPE_NONE,
+                         0);
+}
+
+/**
+ * brisk_menu_registry_init:
+ *
+ * Handle construction of the BriskMenuRegistry
+ */
+static void brisk_menu_registry_init(BriskMenuRegistry *self)
+{
+        self->settings = g_settings_new("com.solus-project.brisk-menu");
+        self->backends = g_ptr_array_new_with_free_func(g_object_unref);
+
+        /* Keys are owned by the backend */
+        self->models = g_hash_table_new_full(g_str_hash,
+                                             g_str_equal,
+                                             NULL,
+                                             (GDestroyNotify)brisk_menu_registry_model_free);
+
+        /* Keys are owned by the items, which the models own */
+        self->lookup = g_hash_table_new(g_str_hash, g_str_equal);
+
+        brisk_menu_registry_init_backends(self);
+
+        /* Other processes may search our catalogue if allowed to */
+        if (g_settings_get_boolean(self->settings, "search-provider")) {
+                self->provider = brisk_menu_search_provider_new(self);
+                brisk_menu_search_provider_own_name(self->provider);
+        }
+}
+
+/**
+ * brisk_menu_registry_get_default:
+ *
+ * Return a new reference to the shared registry
+ */
+BriskMenuRegistry *brisk_menu_registry_get_default(void)
+{
+        if (default_registry) {
+                return g_object_ref(default_registry);
+        }
+
+        default_registry = g_object_new(BRISK_TYPE_MENU_REGISTRY, NULL);
+        g_object_add_weak_pointer(G_OBJECT(default_registry), (gpointer *)&default_registry);
+        return default_registry;
+}
+
+static void brisk_menu_registry_item_added(BriskMenuRegistryModel *model, BriskItem *item,
+                                           BriskBackend *backend)
+{
+        const gchar *id = brisk_item_get_id(item);
+        guint flags = brisk_backend_get_flags(backend);
+
+        g_ptr_array_add(model->items, g_object_ref_sink(item));
+
+        /* Search results are kept for handing over, not for looking up */
+        if ((flags & BRISK_BACKEND_SEARCH) == BRISK_BACKEND_SEARCH) {
+                return;
+        }
+        if (id) {
+                g_hash_table_insert(model->registry->lookup, (gchar *)id, item);
+        }
+}
+
+/**
+ * Forget the item within the lookup table, if it's the one in there
+ */
+static void brisk_menu_registry_unlink(BriskMenuRegistryModel *model, BriskItem *item)
+{
+        const gchar *id = brisk_item_get_id(item);
+
+        if (id && g_hash_table_lookup(model->registry->lookup, id) == item) {
+                g_hash_table_remove(model->registry->lookup, id);
+        }
+}
+
+/**
+ * Drop every copy of the item, walking backwards so removal is safe
+ */
+static void brisk_menu_registry_item_removed(BriskMenuRegistryModel *model, const gchar *id,
+                                             __brisk_unused__ BriskBackend *backend)
+{
+        for (guint i = model->items->len; i > 0; i--) {
+                BriskItem *item = model->items->pdata[i - 1];
+
+                if (g_strcmp0(brisk_item_get_id(item), id) == 0) {
+                        brisk_menu_registry_unlink(model, item);
+                        g_ptr_array_remove_index(model->items, i - 1);
+                }
+        }
+}
+
+static void brisk_menu_registry_section_added(BriskMenuRegistryModel *model,
+                                              BriskSection *section,
+                                              __brisk_unused__ BriskBackend *backend)
+{
+        g_ptr_array_add(model->sections, g_object_ref_sink(section));
+}
+
+static void brisk_menu_registry_section_removed(BriskMenuRegistryModel *model, const gchar *id,
+                                                __brisk_unused__ BriskBackend *backend)
+{
+        for (guint i = model->sections->len; i > 0; i--) {
+                BriskSection *section = model->sections->pdata[i - 1];
+
+                if (g_strcmp0(brisk_section_get_id(section), id) == 0) {
+                        g_ptr_array_remove_index(model->sections, i - 1);
+                }
+        }
+}
+
+/**
+ * The backend is about to emit everything again
+ */
+static void brisk_menu_registry_reset(BriskMenuRegistryModel *model,
+                                      __brisk_unused__ BriskBackend *backend)
+{
+        for (guint i = 0; i < model->items->len; i++) {
+                brisk_menu_registry_unlink(model, model->items->pdata[i]);
+        }
+        g_ptr_array_set_size(model->sections, 0);
+        g_ptr_array_set_size(model->items, 0);
+}
+
+/**
+ * Take ownership of the backend and start mirroring it. We connect ahead of
+ * any window, so the model is always current by the time they see a signal.
+ */
+static void brisk_menu_registry_insert(BriskMenuRegistry *self, BriskBackend *backend)
+{
+        BriskMenuRegistryModel *model = NULL;
+
+        model = g_slice_new0(BriskMenuRegistryModel);
+        model->registry = self;
+        model->backend = backend;
+        model->sections = g_ptr_array_new_with_free_func(g_object_unref);
+        model->items = g_ptr_array_new_with_free_func(g_object_unref);
+
+        g_signal_connect_swapped(backend,
+                                 "item-added",
+                                 G_CALLBACK(brisk_menu_registry_item_added),
+                                 model);
+        g_signal_connect_swapped(backend,
+                                 "item-removed",
+                                 G_CALLBACK(brisk_menu_registry_item_removed),
+                                 model);
+        g_signal_connect_swapped(backend,
+                                 "section-added",
+                                 G_CALLBACK(brisk_menu_registry_section_added),
+                                 model);
+        g_signal_connect_swapped(backend,
+                                 "section-removed",
+                                 G_CALLBACK(brisk_menu_registry_section_removed),
+                                 model);
+        g_signal_connect_swapped(backend, "reset", G_CALLBACK(brisk_menu_registry_reset), model);
+
+        g_ptr_array_add(self->backends, backend);
+        g_hash_table_insert(self->models, (gchar *)brisk_backend_get_id(backend), model);
+}
+
+/**
+ * Add a wrapper for every installed plugin. Built-in backends always win, as
+ * the frontend has no way to tell two backends with the same ID apart.
+ */
+static void brisk_menu_registry_init_plugins(BriskMenuRegistry *self)
+{
+        GList *plugins = brisk_plugin_backend_discover();
+
+        for (GList *elem = plugins; elem; elem = elem->next) {
+                BriskBackend *backend = elem->data;
+                const gchar *backend_id = brisk_backend_get_id(backend);
+
+                if (g_hash_table_contains(self->models, backend_id)) {
+                        g_message("Ignoring plugin '%s' as the ID is already in use", backend_id);
+                        g_object_unref(backend);
+                        continue;
+                }
+                brisk_menu_registry_insert(self, backend);
+        }
+
+        g_list_free(plugins);
+}
+
+/**
+ * Bring up the backends enabled in the settings
+ */
+static void brisk_menu_registry_init_backends(BriskMenuRegistry *self)
+{
+        brisk_menu_registry_insert(self, brisk_all_items_backend_new());
+        brisk_menu_registry_insert(self, brisk_favourites_backend_new());
+        brisk_menu_registry_insert(self, brisk_frequent_backend_new());
+
+        /* Keep menu parsing and monitoring out of the panel if asked to */
+        if (g_settings_get_boolean(self->settings, "backend-host")) {
+                brisk_menu_registry_insert(self, brisk_proxy_backend_new("apps"));
+        } else {
+                brisk_menu_registry_insert(self, brisk_apps_backend_new());
+        }
+
+        /* Indexing files is opt-in */
+        if (g_settings_get_boolean(self->settings, "file-search")) {
+                brisk_menu_registry_insert(self, brisk_files_backend_new());
+        }
+
+        if (g_settings_get_boolean(self->settings, "calculator")) {
+                brisk_menu_registry_insert(self, brisk_calc_backend_new());
+        }
+
+        if (g_settings_get_boolean(self->settings, "recent-documents")) {
+                brisk_menu_registry_insert(self, brisk_recent_backend_new());
+        }
+
+        /* Plugins only cost us their description until first use */
+        brisk_menu_registry_init_plugins(self);
+}
+
+/**
+ * brisk_menu_registry_get_backends:
+ *
+ * Returns: (transfer none): the registered backends
+ */
+GPtrArray *brisk_menu_registry_get_backends(BriskMenuRegistry *self)
+{
+        return self->backends;
+}
+
+/**
+ * brisk_menu_registry_load:
+ *
+ * We only call load() on backends exposing BRISK_BACKEND_SOURCE, and only
+ * for the first window asking
+ */
+void brisk_menu_registry_load(BriskMenuRegistry *self)
+{
+        if (self->loaded) {
+                return;
+        }
+        self->loaded = TRUE;
+
+        for (guint i = 0; i < self->backends->len; i++) {
+                BriskBackend *backend = self->backends->pdata[i];
+                guint flags = brisk_backend_get_flags(backend);
+
+                if ((flags & BRISK_BACKEND_SOURCE) != BRISK_BACKEND_SOURCE) {
+                        continue;
+                }
+                if (!brisk_backend_load(backend)) {
+                        g_warning("Failed to load source backend: '%s'",
+                                  brisk_backend_get_id(backend));
+                }
+        }
+}
+
+/**
+ * brisk_menu_registry_get_sections:
+ *
+ * Returns: (transfer none): the sections currently exposed by the backend
+ */
+GPtrArray *brisk_menu_registry_get_sections(BriskMenuRegistry *self, BriskBackend *backend)
+{
+        BriskMenuRegistryModel *model = NULL;
+
+        model = g_hash_table_lookup(self->models, brisk_backend_get_id(backend));
+        return model ? model->sections : NULL;
+}
+
+/**
+ * brisk_menu_registry_lookup_item:
+ *
+ * Returns: (transfer none): the item known by the given ID, or NULL
+ */
+BriskItem *brisk_menu_registry_lookup_item(BriskMenuRegistry *self, const gchar *id)
+{
+        return g_hash_table_lookup(self->lookup, id);
+}
+
+/**
+ * brisk_menu_registry_get_items:
+ *
+ * Returns: (transfer none): the items currently exposed by the backend
+ */
+GPtrArray *brisk_menu_registry_get_items(BriskMenuRegistry *self, BriskBackend *backend)
+{
+        BriskMenuRegistryModel *model = NULL;
+
+        model = g_hash_table_lookup(self->models, brisk_backend_get_id(backend));
+        return model ? model->items : NULL;
+}
+
+/**
+ * brisk_menu_registry_search:
+ *
+ * Hand the search backends over to the searcher if it isn't already theirs,
+ * then let every backend know about the new term
+ */
+void brisk_menu_registry_search(BriskMenuRegistry *self, gpointer searcher, const gchar *term)
+{
+        if (self->searcher != searcher) {
+                self->searcher = searcher;
+                g_signal_emit(self, registry_signals[REGISTRY_SIGNAL_SEARCHER_CHANGED], 0);
+        }
+
+        for (guint i = 0; i < self->backends->len; i++) {
+                brisk_backend_search_changed(self->backends->pdata[i], term);
+        }
+}
+
+/**
+ * brisk_menu_registry_is_searcher:
+ *
+ * Returns: TRUE if the search backends are answering the given window
+ */
+gboolean brisk_menu_registry_is_searcher(BriskMenuRegistry *self, gpointer searcher)
+{
+        return self->searcher == searcher;
+}
+
+/**
+ * brisk_menu_registry_release_search:
+ *
+ * The window is going away, so forget it was ever searching
+ */
+void brisk_menu_registry_release_search(BriskMenuRegistry *self, gpointer searcher)
+{
+        if (self->searcher == searcher) {
+                self->searcher = NULL;
+        }
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
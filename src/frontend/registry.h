@@ -0,0 +1,82 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+#include "backend/backend.h"
+
+G_BEGIN_DECLS
+
+typedef struct _BriskMenuRegistry BriskMenuRegistry;
+typedef struct _BriskMenuRegistryClass BriskMenuRegistryClass;
+
+#define BRISK_TYPE_MENU_REGISTRY brisk_menu_registry_get_type()
+#define BRISK_MENU_REGISTRY(o)                                                                     \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_MENU_REGISTRY, BriskMenuRegistry))
+#define BRISK_IS_MENU_REGISTRY(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_MENU_REGISTRY))
+#define BRISK_MENU_REGISTRY_CLASS(o)                                                               \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_MENU_REGISTRY, BriskMenuRegistryClass))
+#define BRISK_IS_MENU_REGISTRY_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_MENU_REGISTRY))
+#define BRISK_MENU_REGISTRY_GET_CLASS(o)                                                           \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_MENU_REGISTRY, BriskMenuRegistryClass))
+
+/**
+ * Return a new reference to the registry shared by every window within the
+ * process, creating it (and all backends) if this is the first.
+ */
+BriskMenuRegistry *brisk_menu_registry_get_default(void);
+
+GType brisk_menu_registry_get_type(void);
+
+/**
+ * Backends in the order they were registered
+ */
+GPtrArray *brisk_menu_registry_get_backends(BriskMenuRegistry *self);
+
+/**
+ * Load every source backend, only the first call does anything
+ */
+void brisk_menu_registry_load(BriskMenuRegistry *self);
+
+/**
+ * Sections and items the backend has emitted so far, for bringing a newly
+ * attached window up to date
+ */
+GPtrArray *brisk_menu_registry_get_sections(BriskMenuRegistry *self, BriskBackend *backend);
+GPtrArray *brisk_menu_registry_get_items(BriskMenuRegistry *self, BriskBackend *backend);
+BriskItem *brisk_menu_registry_lookup_item(BriskMenuRegistry *self, const gchar *id);
+
+/**
+ * Pass a window's search term on to every backend. Backends flagged with
+ * BRISK_BACKEND_SEARCH answer one term at a time, so their items are only
+ * meant for the window that searched last.
+ */
+void brisk_menu_registry_search(BriskMenuRegistry *self, gpointer searcher, const gchar *term);
+gboolean brisk_menu_registry_is_searcher(BriskMenuRegistry *self, gpointer searcher);
+void brisk_menu_registry_release_search(BriskMenuRegistry *self, gpointer searcher);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
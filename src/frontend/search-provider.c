@@ -0,0 +1,517 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "backend/search.h"
+#include "launcher.h"
+#include "libsearch-glue.h"
+#include "search-provider.h"
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GHashTable, g_hash_table_unref)
+
+/**
+ * Only applications are worth handing out, everything else is either a
+ * grouping or tied to the search within our own window
+ */
+#define BRISK_SEARCH_PROVIDER_BACKEND "apps"
+
+struct _BriskMenuSearchProviderClass {
+        GObjectClass parent_class;
+};
+
+/**
+ * BriskMenuSearchProvider answers org.gnome.Shell.SearchProvider2 queries
+ * straight from the catalogue the menu already holds, so that other
+ * launchers don't have to parse the .desktop files all over again.
+ */
+struct _BriskMenuSearchProvider {
+        GObject parent;
+        BriskMenuRegistry *registry; /**<Owns us */
+        BriskMenuLauncher *launcher;
+        BriskSearchProvider2 *skeleton;
+        guint owner_id;
+        GSettings *settings;
+        gint weights[BRISK_SEARCH_N_FIELDS];
+};
+
+/**
+ * A single result, ranked like the search within the menu
+ */
+typedef struct BriskSearchResult {
+        BriskItem *item;
+        gint score;
+} BriskSearchResult;
+
+G_DEFINE_TYPE(BriskMenuSearchProvider, brisk_menu_search_provider, G_TYPE_OBJECT)
+
+/**
+ * brisk_menu_search_provider_dispose:
+ *
+ * Clean up a BriskMenuSearchProvider instance
+ */
+static void brisk_menu_search_provider_dispose(GObject *obj)
+{
+        BriskMenuSearchProvider *self = BRISK_MENU_SEARCH_PROVIDER(obj);
+
+        if (self->owner_id > 0) {
+                g_bus_unown_name(self->owner_id);
+                self->owner_id = 0;
+        }
+        if (self->skeleton) {
+                g_dbus_interface_skeleton_unexport(G_DBUS_INTERFACE_SKELETON(self->skeleton));
+        }
+        g_clear_object(&self->skeleton);
+        g_clear_object(&self->settings);
+        g_clear_object(&self->launcher);
+
+        G_OBJECT_CLASS(brisk_menu_search_provider_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_menu_search_provider_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_menu_search_provider_class_init(BriskMenuSearchProviderClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_menu_search_provider_dispose;
+}
+
+/**
+ * Fold the terms the same way the menu folds its own search term, dropping
+ * any that end up empty
+ */
+static gchar **brisk_menu_search_provider_fold_terms(const gchar *const *terms)
+{
+        GPtrArray *folded = g_ptr_array_new();
+
+        for (guint i = 0; terms && terms[i]; i++) {
+                gchar *term = brisk_search_fold(terms[i]);
+
+                if (*term == '\0') {
+                        g_free(term);
+                        continue;
+                }
+                g_ptr_array_add(folded, term);
+        }
+        g_ptr_array_add(folded, NULL);
+
+        return (gchar **)g_ptr_array_free(folded, FALSE);
+}
+
+/**
+ * Every term has to match for the item to be a result, and it is ranked by
+ * how well the first term matched
+ */
+static gboolean brisk_menu_search_provider_matches(BriskMenuSearchProvider *self, BriskItem *item,
+                                                   gchar **terms, gint *score)
+{
+        BriskSearchMatch match = { 0 };
+
+        if (!terms[0]) {
+                return FALSE;
+        }
+        if (!brisk_item_search(item, terms[0], self->weights, &match)) {
+                return FALSE;
+        }
+        for (guint i = 1; terms[i]; i++) {
+                if (!brisk_item_matches_search(item, terms[i])) {
+                        return FALSE;
+                }
+        }
+        *score = match.score;
+        return TRUE;
+}
+
+static gint brisk_menu_search_provider_compare(gconstpointer a, gconstpointer b)
+{
+        const BriskSearchResult *ma = a;
+        const BriskSearchResult *mb = b;
+
+        if (ma->score != mb->score) {
+                return mb->score - ma->score;
+        }
+        return g_utf8_collate(brisk_item_get_name(ma->item), brisk_item_get_name(mb->item));
+}
+
+/**
+ * Only hand out items owned by the applications backend
+ */
+static BriskItem *brisk_menu_search_provider_lookup(BriskMenuSearchProvider *self,
+                                                    const gchar *id)
+{
+        BriskItem *item = brisk_menu_registry_lookup_item(self->registry, id);
+
+        if (!item || g_strcmp0(brisk_item_get_backend_id(item), BRISK_SEARCH_PROVIDER_BACKEND)) {
+                return NULL;
+        }
+        return item;
+}
+
+/**
+ * Add the item as a match unless we've already seen its ID, as the same
+ * application may be listed within several sections
+ */
+static void brisk_menu_search_provider_add(BriskMenuSearchProvider *self, GArray *matches,
+                                           GHashTable *seen, BriskItem *item, gchar **terms)
+{
+        const gchar *id = brisk_item_get_id(item);
+        BriskSearchResult result = { 0 };
+
+        if (!id || g_hash_table_contains(seen, id)) {
+                return;
+        }
+        if (!brisk_menu_search_provider_matches(self, item, terms, &result.score)) {
+                return;
+        }
+
+        g_hash_table_add(seen, (gchar *)id);
+        result.item = item;
+        g_array_append_val(matches, result);
+}
+
+/**
+ * Turn the ranked matches into the result set
+ */
+static const gchar **brisk_menu_search_provider_finish(GArray *matches)
+{
+        const gchar **ret = NULL;
+
+        g_array_sort(matches, brisk_menu_search_provider_compare);
+
+        ret = g_new0(const gchar *, matches->len + 1);
+        for (guint i = 0; i < matches->len; i++) {
+                ret[i] = brisk_item_get_id(g_array_index(matches, BriskSearchResult, i).item);
+        }
+        g_array_free(matches, TRUE);
+        return ret;
+}
+
+static gboolean brisk_menu_search_provider_handle_initial(BriskSearchProvider2 *skeleton,
+                                                          GDBusMethodInvocation *invocation,
+                                                          const gchar *const *terms,
+                                                          BriskMenuSearchProvider *self)
+{
+        autofree(GHashTable) *seen = g_hash_table_new(g_str_hash, g_str_equal);
+        GArray *matches = g_array_new(FALSE, FALSE, sizeof(BriskSearchResult));
+        gchar **folded = brisk_menu_search_provider_fold_terms(terms);
+        GPtrArray *backends = brisk_menu_registry_get_backends(self->registry);
+        const gchar **results = NULL;
+
+        for (guint i = 0; i < backends->len; i++) {
+                BriskBackend *backend = backends->pdata[i];
+                GPtrArray *items = NULL;
+
+                if (!g_str_equal(brisk_backend_get_id(backend), BRISK_SEARCH_PROVIDER_BACKEND)) {
+                        continue;
+                }
+
+                items = brisk_menu_registry_get_items(self->registry, backend);
+                for (guint j = 0; items && j < items->len; j++) {
+                        BriskItem *item = items->pdata[j];
+
+                        brisk_menu_search_provider_add(self, matches, seen, item, folded);
+                }
+        }
+
+        results = brisk_menu_search_provider_finish(matches);
+        brisk_search_provider2_complete_get_initial_result_set(skeleton, invocation, results);
+
+        g_free(results);
+        g_strfreev(folded);
+        return TRUE;
+}
+
+/**
+ * The terms only ever got longer, so just narrow the previous results down
+ */
+static gboolean brisk_menu_search_provider_handle_subsearch(BriskSearchProvider2 *skeleton,
+                                                            GDBusMethodInvocation *invocation,
+                                                            const gchar *const *previous,
+                                                            const gchar *const *terms,
+                                                            BriskMenuSearchProvider *self)
+{
+        autofree(GHashTable) *seen = g_hash_table_new(g_str_hash, g_str_equal);
+        GArray *matches = g_array_new(FALSE, FALSE, sizeof(BriskSearchResult));
+        gchar **folded = brisk_menu_search_provider_fold_terms(terms);
+        const gchar **results = NULL;
+
+        for (guint i = 0; previous && previous[i]; i++) {
+                BriskItem *item = brisk_menu_search_provider_lookup(self, previous[i]);
+
+                if (item) {
+                        brisk_menu_search_provider_add(self, matches, seen, item, folded);
+                }
+        }
+
+        results = brisk_menu_search_provider_finish(matches);
+        brisk_search_provider2_complete_get_subsearch_result_set(skeleton, invocation, results);
+
+        g_free(results);
+        g_strfreev(folded);
+        return TRUE;
+}
+
+static gboolean brisk_menu_search_provider_handle_metas(BriskSearchProvider2 *skeleton,
+                                                        GDBusMethodInvocation *invocation,
+                                                        const gchar *const *ids,
+                                                        BriskMenuSearchProvider *self)
+{
+        GVariantBuilder metas;
+
+        g_variant_builder_init(&metas, G_VARIANT_TYPE("aa{sv}"));
+
+        for (guint i = 0; ids && ids[i]; i++) {
+                BriskItem *item = brisk_menu_search_provider_lookup(self, ids[i]);
+                const gchar *summary = NULL;
+                const GIcon *icon = NULL;
+                GVariantBuilder meta;
+
+                if (!item) {
+                        continue;
+                }
+
+                g_variant_builder_init(&meta, G_VARIANT_TYPE("a{sv}"));
+                g_variant_builder_add(&meta, "{sv}", "id", g_variant_new_string(ids[i]));
+                g_variant_builder_add(&meta,
+                                      "{sv}",
+                                      "name",
+                                      g_variant_new_string(brisk_item_get_display_name(item)));
+
+                summary = brisk_item_get_summary(item);
+                if (summary) {
+                        g_variant_builder_add(&meta,
+                                              "{sv}",
+                                              "description",
+                                              g_variant_new_string(summary));
+                }
+
+                icon = brisk_item_get_icon(item);
+                if (icon) {
+                        autofree(gchar) *str = g_icon_to_string((GIcon *)icon);
+                        GVariant *serialized = g_icon_serialize((GIcon *)icon);
+
+                        if (serialized) {
+                                g_variant_builder_add(&meta, "{sv}", "icon", serialized);
+                                g_variant_unref(serialized);
+                        }
+                        if (str) {
+                                g_variant_builder_add(&meta,
+                                                      "{sv}",
+                                                      "gicon",
+                                                      g_variant_new_string(str));
+                        }
+                }
+
+                g_variant_builder_add_value(&metas, g_variant_builder_end(&meta));
+        }
+
+        brisk_search_provider2_complete_get_result_metas(skeleton,
+                                                         invocation,
+                                                         g_variant_builder_end(&metas));
+        return TRUE;
+}
+
+/**
+ * Launch the result the same way the menu does, without blocking on it
+ */
+static gboolean brisk_menu_search_provider_handle_activate(
+    BriskSearchProvider2 *skeleton, GDBusMethodInvocation *invocation, const gchar *id,
+    __brisk_unused__ const gchar *const *terms, guint timestamp, BriskMenuSearchProvider *self)
+{
+        BriskItem *item = brisk_menu_search_provider_lookup(self, id);
+
+        if (!item) {
+                g_dbus_method_invocation_return_error(invocation,
+                                                      G_DBUS_ERROR,
+                                                      G_DBUS_ERROR_INVALID_ARGS,
+                                                      "Unknown result '%s'",
+                                                      id);
+                return TRUE;
+        }
+
+        /* Answer straight away, the launch finishes in the background */
+        brisk_menu_launcher_start_item_at(self->launcher, NULL, item, timestamp);
+        brisk_search_provider2_complete_activate_result(skeleton, invocation);
+        return TRUE;
+}
+
+/**
+ * We have no window of our own to show the search in
+ */
+static gboolean brisk_menu_search_provider_handle_launch_search(
+    BriskSearchProvider2 *skeleton, GDBusMethodInvocation *invocation,
+    __brisk_unused__ const gchar *const *terms, __brisk_unused__ guint timestamp,
+    __brisk_unused__ BriskMenuSearchProvider *self)
+{
+        brisk_search_provider2_complete_launch_search(skeleton, invocation);
+        return TRUE;
+}
+
+/**
+ * brisk_menu_search_provider_init:
+ *
+ * Handle construction of the BriskMenuSearchProvider
+ */
+static void brisk_menu_search_provider_weights_changed(GSettings *settings,
+                                                       __brisk_unused__ const gchar *key,
+                                                       BriskMenuSearchProvider *self)
+{
+        brisk_search_weights_load(settings, self->weights);
+}
+
+/**
+ * Let the backends learn from the launch, exactly as if it had been launched
+ * from the menu
+ */
+static void brisk_menu_search_provider_item_launched(BriskMenuSearchProvider *self,
+                                                     BriskItem *item,
+                                                     __brisk_unused__ BriskMenuLauncher *launcher)
+{
+        GPtrArray *backends = brisk_menu_registry_get_backends(self->registry);
+
+        for (guint i = 0; i < backends->len; i++) {
+                brisk_backend_item_launched(backends->pdata[i], item);
+        }
+}
+
+static void brisk_menu_search_provider_init(BriskMenuSearchProvider *self)
+{
+        self->settings = g_settings_new("com.solus-project.brisk-menu");
+        g_signal_connect(self->settings,
+                         "changed::search-weights",
+                         G_CALLBACK(brisk_menu_search_provider_weights_changed),
+                         self);
+        brisk_search_weights_load(self->settings, self->weights);
+
+        self->launcher = brisk_menu_launcher_new();
+        g_signal_connect_swapped(self->launcher,
+                                 "item-launched",
+                                 G_CALLBACK(brisk_menu_search_provider_item_launched),
+                                 self);
+
+        self->skeleton = brisk_search_provider2_skeleton_new();
+
+        g_signal_connect(self->skeleton,
+                         "handle-get-initial-result-set",
+                         G_CALLBACK(brisk_menu_search_provider_handle_initial),
+                         self);
+        g_signal_connect(self->skeleton,
+                         "handle-get-subsearch-result-set",
+                         G_CALLBACK(brisk_menu_search_provider_handle_subsearch),
+                         self);
+        g_signal_connect(self->skeleton,
+                         "handle-get-result-metas",
+                         G_CALLBACK(brisk_menu_search_provider_handle_metas),
+                         self);
+        g_signal_connect(self->skeleton,
+                         "handle-activate-result",
+                         G_CALLBACK(brisk_menu_search_provider_handle_activate),
+                         self);
+        g_signal_connect(self->skeleton,
+                         "handle-launch-search",
+                         G_CALLBACK(brisk_menu_search_provider_handle_launch_search),
+                         self);
+}
+
+/**
+ * brisk_menu_search_provider_export:
+ *
+ * Export the provider on the connection
+ */
+gboolean brisk_menu_search_provider_export(BriskMenuSearchProvider *self,
+                                           GDBusConnection *connection, GError **error)
+{
+        return g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(self->skeleton),
+                                                connection,
+                                                BRISK_SEARCH_PROVIDER_OBJECT_PATH,
+                                                error);
+}
+
+static void brisk_menu_search_provider_bus_acquired(GDBusConnection *connection,
+                                                    __brisk_unused__ const gchar *name,
+                                                    BriskMenuSearchProvider *self)
+{
+        GError *error = NULL;
+
+        if (!brisk_menu_search_provider_export(self, connection, &error)) {
+                g_warning("Failed to export search provider: %s", error->message);
+                g_error_free(error);
+        }
+}
+
+/**
+ * Only one panel process gets to serve searches, the rest stay quiet
+ */
+static void brisk_menu_search_provider_name_lost(__brisk_unused__ GDBusConnection *connection,
+                                                 const gchar *name,
+                                                 __brisk_unused__ BriskMenuSearchProvider *self)
+{
+        g_message("Not serving searches, %s is owned elsewhere", name);
+}
+
+/**
+ * brisk_menu_search_provider_own_name:
+ *
+ * Claim the well known name on the session bus. DBUS_SESSION_BUS_ADDRESS is
+ * honoured, so this works just as well on a private bus.
+ */
+void brisk_menu_search_provider_own_name(BriskMenuSearchProvider *self)
+{
+        if (self->owner_id > 0) {
+                return;
+        }
+        self->owner_id =
+            g_bus_own_name(G_BUS_TYPE_SESSION,
+                           BRISK_SEARCH_PROVIDER_BUS_NAME,
+                           G_BUS_NAME_OWNER_FLAGS_NONE,
+                           (GBusAcquiredCallback)brisk_menu_search_provider_bus_acquired,
+                           NULL,
+                           (GBusNameLostCallback)brisk_menu_search_provider_name_lost,
+                           self,
+                           NULL);
+}
+
+/**
+ * brisk_menu_search_provider_new:
+ *
+ * Construct a new BriskMenuSearchProvider object
+ */
+BriskMenuSearchProvider *brisk_menu_search_provider_new(BriskMenuRegistry *registry)
+{
+        BriskMenuSearchProvider *self = g_object_new(BRISK_TYPE_MENU_SEARCH_PROVIDER, NULL);
+
+        self->registry = registry;
+        return self;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,78 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+#include "registry.h"
+
+G_BEGIN_DECLS
+
+/**
+ * Where we may be found on the session bus
+ */
+#define BRISK_SEARCH_PROVIDER_BUS_NAME "com.solus_project.Brisk.SearchProvider"
+#define BRISK_SEARCH_PROVIDER_OBJECT_PATH "/com/solus_project/Brisk/SearchProvider"
+
+typedef struct _BriskMenuSearchProvider BriskMenuSearchProvider;
+typedef struct _BriskMenuSearchProviderClass BriskMenuSearchProviderClass;
+
+#define BRISK_TYPE_MENU_SEARCH_PROVIDER brisk_menu_search_provider_get_type()
+#define BRISK_MENU_SEARCH_PROVIDER(o)                                                              \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_MENU_SEARCH_PROVIDER, BriskMenuSearchProvider))
+#define BRISK_IS_MENU_SEARCH_PROVIDER(o)                                                           \
+        (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_MENU_SEARCH_PROVIDER))
+#define BRISK_MENU_SEARCH_PROVIDER_CLASS(o)                                                        \
+        (G_TYPE_CHECK_CLASS_CAST((o),                                                              \
+                                 BRISK_TYPE_MENU_SEARCH_PROVIDER,                                  \
+                                 BriskMenuSearchProviderClass))
+#define BRISK_IS_MENU_SEARCH_PROVIDER_CLASS(o)                                                     \
+        (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_MENU_SEARCH_PROVIDER))
+#define BRISK_MENU_SEARCH_PROVIDER_GET_CLASS(o)                                                    \
+        (G_TYPE_INSTANCE_GET_CLASS((o),                                                            \
+                                   BRISK_TYPE_MENU_SEARCH_PROVIDER,                                \
+                                   BriskMenuSearchProviderClass))
+
+/**
+ * Construct a new BriskMenuSearchProvider serving the applications within
+ * the registry, which must outlive it
+ */
+BriskMenuSearchProvider *brisk_menu_search_provider_new(BriskMenuRegistry *registry);
+
+GType brisk_menu_search_provider_get_type(void);
+
+/**
+ * Claim our well known name on the session bus and export once we have it
+ */
+void brisk_menu_search_provider_own_name(BriskMenuSearchProvider *self);
+
+/**
+ * Export on the given connection directly, i.e. a private bus
+ */
+gboolean brisk_menu_search_provider_export(BriskMenuSearchProvider *self,
+                                           GDBusConnection *connection, GError **error);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,649 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+BRISK_BEGIN_PEDANTIC
+#include "backend/apps/apps-backend.h"
+#include "backend/apps/apps-item.h"
+#include "backend/proxy/proxy-protocol.h"
+#include "backend/search.h"
+#include "host-server.h"
+#include "libhost-glue.h"
+#include <gio/gdesktopappinfo.h>
+BRISK_END_PEDANTIC
+
+/**
+ * Backends that may run within the host
+ */
+static const struct {
+        const gchar *id;
+        BriskBackend *(*create)(void);
+} brisk_host_factories[] = {
+        { "apps", brisk_apps_backend_new },
+};
+
+/**
+ * A single backend running within the host, and the current view of its
+ * items and sections which we hand out as snapshots
+ */
+typedef struct BriskHostedBackend {
+        BriskHostServer *server;
+        BriskBackend *backend;
+        GHashTable *items;
+        GPtrArray *sections;
+        guint changed_id;
+        gboolean loaded;
+} BriskHostedBackend;
+
+struct _BriskHostServerClass {
+        GObjectClass parent_class;
+};
+
+/**
+ * BriskHostServer exposes the backends within brisk-backend-host to the
+ * proxy backends within the applet.
+ */
+struct _BriskHostServer {
+        GObject parent;
+        GDBusConnection *connection;
+        BriskBackendHost *skeleton;
+        GSimpleActionGroup *actions;
+        guint actions_id;
+        GHashTable *backends;
+};
+
+G_DEFINE_TYPE(BriskHostServer, brisk_host_server, G_TYPE_OBJECT)
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GMenuModel, g_object_unref)
+
+static void brisk_hosted_backend_free(BriskHostedBackend *hosted);
+
+/**
+ * brisk_host_server_dispose:
+ *
+ * Clean up a BriskHostServer instance
+ */
+static void brisk_host_server_dispose(GObject *obj)
+{
+        BriskHostServer *self = BRISK_HOST_SERVER(obj);
+
+        if (self->actions_id > 0) {
+                g_dbus_connection_unexport_action_group(self->connection, self->actions_id);
+                self->actions_id = 0;
+        }
+        if (self->skeleton) {
+                g_dbus_interface_skeleton_unexport(G_DBUS_INTERFACE_SKELETON(self->skeleton));
+        }
+        g_clear_pointer(&self->backends, g_hash_table_unref);
+        g_clear_object(&self->skeleton);
+        g_clear_object(&self->actions);
+        g_clear_object(&self->connection);
+
+        G_OBJECT_CLASS(brisk_host_server_parent_class)->dispose(obj);
+}
+
+/**
+ * brisk_host_server_class_init:
+ *
+ * Handle class initialisation
+ */
+static void brisk_host_server_class_init(BriskHostServerClass *klazz)
+{
+        GObjectClass *obj_class = G_OBJECT_CLASS(klazz);
+
+        /* gobject vtable hookup */
+        obj_class->dispose = brisk_host_server_dispose;
+}
+
+/**
+ * brisk_host_server_init:
+ *
+ * Handle construction of the BriskHostServer
+ */
+static void brisk_host_server_init(BriskHostServer *self)
+{
+        self->skeleton = brisk_backend_host_skeleton_new();
+        self->actions = g_simple_action_group_new();
+        self->backends = g_hash_table_new_full(g_str_hash,
+                                               g_str_equal,
+                                               NULL,
+                                               (GDestroyNotify)brisk_hosted_backend_free);
+}
+
+/**
+ * Empty strings stand in for NULL on the wire
+ */
+static inline const gchar *brisk_host_string(const gchar *str)
+{
+        return str ? str : "";
+}
+
+/**
+ * Serialise an icon, sending an empty string when there is none.
+ * Always returns a new, non floating reference.
+ */
+static GVariant *brisk_host_serialize_icon(const GIcon *icon)
+{
+        GVariant *ret = NULL;
+
+        if (icon) {
+                ret = g_icon_serialize((GIcon *)icon);
+        }
+        return ret ? ret : g_variant_ref_sink(g_variant_new_string(""));
+}
+
+/**
+ * Items from other backends don't keep search keys, so fold their fields
+ * here and the applet doesn't have to
+ */
+static GArray *brisk_host_build_search(BriskItem *item, GAppInfo *info)
+{
+        GArray *keys = brisk_search_keys_new();
+
+        /* Name first, the applet highlights matches within it */
+        brisk_search_keys_add(keys, BRISK_SEARCH_FIELD_NAME, brisk_item_get_name(item), FALSE);
+        brisk_search_keys_add(keys,
+                              BRISK_SEARCH_FIELD_NAME,
+                              brisk_item_get_display_name(item),
+                              FALSE);
+        brisk_search_keys_add(keys,
+                              BRISK_SEARCH_FIELD_DESCRIPTION,
+                              brisk_item_get_summary(item),
+                              FALSE);
+        if (info) {
+                brisk_search_keys_add(keys,
+                                      BRISK_SEARCH_FIELD_EXEC,
+                                      g_app_info_get_executable(info),
+                                      FALSE);
+        }
+        if (info && G_IS_DESKTOP_APP_INFO(info)) {
+                const gchar *const *keywords = NULL;
+
+                keywords = g_desktop_app_info_get_keywords(G_DESKTOP_APP_INFO(info));
+                for (guint i = 0; keywords && keywords[i]; i++) {
+                        brisk_search_keys_add(keys,
+                                              BRISK_SEARCH_FIELD_KEYWORDS,
+                                              keywords[i],
+                                              FALSE);
+                }
+        }
+        return keys;
+}
+
+static void brisk_host_add_search(GVariantBuilder *builder, GArray *keys)
+{
+        for (guint i = 0; i < keys->len; i++) {
+                BriskSearchKey *key = &g_array_index(keys, BriskSearchKey, i);
+
+                g_variant_builder_add(builder, "(us)", (guint32)key->field, key->text);
+        }
+}
+
+/**
+ * Flatten a (single level) context menu into (label, action, target)
+ */
+static void brisk_host_add_actions(GVariantBuilder *builder, GMenuModel *menu)
+{
+        gint n_items = menu ? g_menu_model_get_n_items(menu) : 0;
+
+        for (gint i = 0; i < n_items; i++) {
+                autofree(gchar) *label = NULL;
+                autofree(gchar) *action = NULL;
+                GVariant *target = NULL;
+
+                g_menu_model_get_item_attribute(menu, i, G_MENU_ATTRIBUTE_LABEL, "s", &label);
+                g_menu_model_get_item_attribute(menu, i, G_MENU_ATTRIBUTE_ACTION, "s", &action);
+                if (!label || !action) {
+                        continue;
+                }
+
+                target =
+                    g_menu_model_get_item_attribute_value(menu, i, G_MENU_ATTRIBUTE_TARGET, NULL);
+                g_variant_builder_add(builder,
+                                      "(ssv)",
+                                      label,
+                                      action,
+                                      target ? target : g_variant_new("()"));
+                if (target) {
+                        g_variant_unref(target);
+                }
+        }
+}
+
+static GVariant *brisk_hosted_backend_serialize_section(BriskSection *section)
+{
+        GVariant *icon = NULL;
+        GVariant *ret = NULL;
+
+        icon = brisk_host_serialize_icon(brisk_section_get_icon(section));
+        ret = g_variant_new(BRISK_HOST_SECTION_TYPE,
+                            brisk_host_string(brisk_section_get_id(section)),
+                            brisk_host_string(brisk_section_get_name(section)),
+                            icon);
+        g_variant_unref(icon);
+
+        return ret;
+}
+
+/**
+ * Serialise everything the applet needs to display, search, sort and launch
+ * the item without asking us again
+ */
+static GVariant *brisk_hosted_backend_serialize_item(BriskHostedBackend *hosted, BriskItem *item)
+{
+        GVariantBuilder search, sections, actions;
+        autofree(gchar) *uri = NULL;
+        autofree(GMenuModel) *menu = NULL;
+        GAppInfo *info = NULL;
+        const gchar *filename = NULL;
+        GVariant *icon = NULL;
+        GVariant *ret = NULL;
+        GArray *keys = NULL;
+
+        info = brisk_item_get_app_info(item);
+
+        g_variant_builder_init(&search, G_VARIANT_TYPE(BRISK_HOST_SEARCH_TYPE));
+        if (BRISK_IS_APPS_ITEM(item)) {
+                /* Already folded, along with any romanised forms */
+                keys = g_array_ref(brisk_apps_item_get_search_keys(BRISK_APPS_ITEM(item)));
+        } else {
+                keys = brisk_host_build_search(item, info);
+        }
+        brisk_host_add_search(&search, keys);
+        g_array_unref(keys);
+
+        if (info && G_IS_DESKTOP_APP_INFO(info)) {
+                filename = g_desktop_app_info_get_filename(G_DESKTOP_APP_INFO(info));
+        }
+
+        /* Sections only exist here, so membership is decided here */
+        g_variant_builder_init(&sections, G_VARIANT_TYPE_STRING_ARRAY);
+        for (guint i = 0; i < hosted->sections->len; i++) {
+                BriskSection *section = hosted->sections->pdata[i];
+
+                if (brisk_section_can_show_item(section, item)) {
+                        g_variant_builder_add(&sections, "s", brisk_section_get_id(section));
+                }
+        }
+
+        g_variant_builder_init(&actions, G_VARIANT_TYPE(BRISK_HOST_ACTIONS_TYPE));
+        menu = (GMenuModel *)brisk_backend_get_item_actions(hosted->backend, item);
+        brisk_host_add_actions(&actions, menu);
+
+        uri = brisk_item_get_uri(item);
+        icon = brisk_host_serialize_icon(brisk_item_get_icon(item));
+
+        ret = g_variant_new(BRISK_HOST_ITEM_TYPE,
+                            brisk_host_string(brisk_item_get_id(item)),
+                            brisk_host_string(brisk_item_get_name(item)),
+                            brisk_host_string(brisk_item_get_display_name(item)),
+                            brisk_host_string(brisk_item_get_summary(item)),
+                            brisk_host_string(uri),
+                            icon,
+                            &search,
+                            &sections,
+                            &actions,
+                            brisk_host_string(filename));
+        g_variant_unref(icon);
+
+        return ret;
+}
+
+/**
+ * Tell the applet to fetch a new snapshot once the backend settles down
+ */
+static gboolean brisk_hosted_backend_emit_changed(BriskHostedBackend *hosted)
+{
+        hosted->changed_id = 0;
+        brisk_backend_host_emit_changed(hosted->server->skeleton,
+                                        brisk_backend_get_id(hosted->backend));
+        return G_SOURCE_REMOVE;
+}
+
+/**
+ * Backends emit changes one item at a time, i.e. hundreds of them for a
+ * reload, so coalesce them into a single notification
+ */
+static void brisk_hosted_backend_queue_changed(BriskHostedBackend *hosted)
+{
+        if (hosted->changed_id > 0) {
+                return;
+        }
+        hosted->changed_id = g_idle_add_full(G_PRIORITY_LOW,
+                                             (GSourceFunc)brisk_hosted_backend_emit_changed,
+                                             hosted,
+                                             NULL);
+}
+
+static void brisk_hosted_backend_item_added(__brisk_unused__ BriskBackend *backend,
+                                            BriskItem *item, BriskHostedBackend *hosted)
+{
+        const gchar *id = brisk_item_get_id(item);
+
+        /* Can't be referenced again, so can't be proxied */
+        if (!id) {
+                g_object_ref_sink(item);
+                g_object_unref(item);
+                return;
+        }
+
+        g_hash_table_insert(hosted->items, g_strdup(id), g_object_ref_sink(item));
+        brisk_hosted_backend_queue_changed(hosted);
+}
+
+static void brisk_hosted_backend_item_removed(__brisk_unused__ BriskBackend *backend,
+                                              const gchar *id, BriskHostedBackend *hosted)
+{
+        if (g_hash_table_remove(hosted->items, id)) {
+                brisk_hosted_backend_queue_changed(hosted);
+        }
+}
+
+static void brisk_hosted_backend_section_added(__brisk_unused__ BriskBackend *backend,
+                                               BriskSection *section, BriskHostedBackend *hosted)
+{
+        g_ptr_array_add(hosted->sections, g_object_ref_sink(section));
+        brisk_hosted_backend_queue_changed(hosted);
+}
+
+static void brisk_hosted_backend_section_removed(__brisk_unused__ BriskBackend *backend,
+                                                 const gchar *id, BriskHostedBackend *hosted)
+{
+        for (guint i = 0; i < hosted->sections->len; i++) {
+                if (g_strcmp0(brisk_section_get_id(hosted->sections->pdata[i]), id) == 0) {
+                        g_ptr_array_remove_index(hosted->sections, i);
+                        brisk_hosted_backend_queue_changed(hosted);
+                        return;
+                }
+        }
+}
+
+static void brisk_hosted_backend_reset(__brisk_unused__ BriskBackend *backend,
+                                       BriskHostedBackend *hosted)
+{
+        g_hash_table_remove_all(hosted->items);
+        g_ptr_array_set_size(hosted->sections, 0);
+        brisk_hosted_backend_queue_changed(hosted);
+}
+
+/**
+ * Context menus are part of the snapshot
+ */
+static void brisk_hosted_backend_actions_changed(__brisk_unused__ BriskBackend *backend,
+                                                 __brisk_unused__ const gchar *id,
+                                                 BriskHostedBackend *hosted)
+{
+        brisk_hosted_backend_queue_changed(hosted);
+}
+
+static void brisk_hosted_backend_item_changed(BriskBackend *backend, const gchar *id,
+                                              BriskHostedBackend *hosted)
+{
+        brisk_backend_host_emit_item_changed(hosted->server->skeleton,
+                                             brisk_backend_get_id(backend),
+                                             id);
+}
+
+static void brisk_hosted_backend_invalidate_filter(BriskBackend *backend,
+                                                   BriskHostedBackend *hosted)
+{
+        brisk_backend_host_emit_invalidate_filter(hosted->server->skeleton,
+                                                  brisk_backend_get_id(backend));
+}
+
+static void brisk_hosted_backend_hide_menu(BriskBackend *backend, BriskHostedBackend *hosted)
+{
+        brisk_backend_host_emit_hide_menu(hosted->server->skeleton, brisk_backend_get_id(backend));
+}
+
+static BriskHostedBackend *brisk_hosted_backend_new(BriskHostServer *server, BriskBackend *backend)
+{
+        BriskHostedBackend *hosted = g_slice_new0(BriskHostedBackend);
+
+        hosted->server = server;
+        hosted->backend = backend;
+        hosted->items = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+        hosted->sections = g_ptr_array_new_with_free_func(g_object_unref);
+
+        g_signal_connect(backend,
+                         "item-added",
+                         G_CALLBACK(brisk_hosted_backend_item_added),
+                         hosted);
+        g_signal_connect(backend,
+                         "item-removed",
+                         G_CALLBACK(brisk_hosted_backend_item_removed),
+                         hosted);
+        g_signal_connect(backend,
+                         "item-changed",
+                         G_CALLBACK(brisk_hosted_backend_item_changed),
+                         hosted);
+        g_signal_connect(backend,
+                         "actions-changed",
+                         G_CALLBACK(brisk_hosted_backend_actions_changed),
+                         hosted);
+        g_signal_connect(backend,
+                         "section-added",
+                         G_CALLBACK(brisk_hosted_backend_section_added),
+                         hosted);
+        g_signal_connect(backend,
+                         "section-removed",
+                         G_CALLBACK(brisk_hosted_backend_section_removed),
+                         hosted);
+        g_signal_connect(backend,
+                         "invalidate-filter",
+                         G_CALLBACK(brisk_hosted_backend_invalidate_filter),
+                         hosted);
+        g_signal_connect(backend, "hide-menu", G_CALLBACK(brisk_hosted_backend_hide_menu), hosted);
+        g_signal_connect(backend, "reset", G_CALLBACK(brisk_hosted_backend_reset), hosted);
+
+        /* Host wide action group, the proxies pick out their own actions */
+        brisk_backend_register_actions(backend, G_ACTION_MAP(server->actions));
+
+        return hosted;
+}
+
+static void brisk_hosted_backend_free(BriskHostedBackend *hosted)
+{
+        if (hosted->changed_id > 0) {
+                g_source_remove(hosted->changed_id);
+        }
+        g_signal_handlers_disconnect_by_data(hosted->backend, hosted);
+        g_hash_table_unref(hosted->items);
+        g_ptr_array_unref(hosted->sections);
+        g_object_unref(hosted->backend);
+        g_slice_free(BriskHostedBackend, hosted);
+}
+
+/**
+ * Find the backend by ID, constructing it on first use
+ */
+static BriskHostedBackend *brisk_host_server_get_backend(BriskHostServer *self, const gchar *id)
+{
+        BriskHostedBackend *hosted = NULL;
+
+        hosted = g_hash_table_lookup(self->backends, id);
+        if (hosted) {
+                return hosted;
+        }
+
+        for (size_t i = 0; i < G_N_ELEMENTS(brisk_host_factories); i++) {
+                BriskBackend *backend = NULL;
+
+                if (!g_str_equal(brisk_host_factories[i].id, id)) {
+                        continue;
+                }
+
+                backend = brisk_host_factories[i].create();
+                hosted = brisk_hosted_backend_new(self, backend);
+                g_hash_table_insert(self->backends, (gchar *)brisk_backend_get_id(backend), hosted);
+                return hosted;
+        }
+
+        return NULL;
+}
+
+/**
+ * Load is idempotent, so every panel in the applet may ask for it
+ */
+static gboolean brisk_host_server_handle_load(BriskBackendHost *skeleton,
+                                              GDBusMethodInvocation *invocation,
+                                              const gchar *backend_id, BriskHostServer *self)
+{
+        BriskHostedBackend *hosted = NULL;
+        guint flags;
+
+        hosted = brisk_host_server_get_backend(self, backend_id);
+        if (!hosted) {
+                brisk_backend_host_complete_load(skeleton, invocation, FALSE);
+                return TRUE;
+        }
+
+        if (!hosted->loaded) {
+                flags = brisk_backend_get_flags(hosted->backend);
+                if ((flags & BRISK_BACKEND_SOURCE) == BRISK_BACKEND_SOURCE) {
+                        hosted->loaded = brisk_backend_load(hosted->backend);
+                } else {
+                        hosted->loaded = TRUE;
+                }
+        }
+
+        brisk_backend_host_complete_load(skeleton, invocation, hosted->loaded);
+        return TRUE;
+}
+
+static gboolean brisk_host_server_handle_get_snapshot(BriskBackendHost *skeleton,
+                                                      GDBusMethodInvocation *invocation,
+                                                      const gchar *backend_id,
+                                                      BriskHostServer *self)
+{
+        BriskHostedBackend *hosted = NULL;
+        GVariantBuilder sections, items;
+        GHashTableIter iter;
+        BriskItem *item = NULL;
+
+        hosted = g_hash_table_lookup(self->backends, backend_id);
+        if (!hosted) {
+                g_dbus_method_invocation_return_error(invocation,
+                                                      G_DBUS_ERROR,
+                                                      G_DBUS_ERROR_INVALID_ARGS,
+                                                      "Backend '%s' is not loaded",
+                                                      backend_id);
+                return TRUE;
+        }
+
+        g_variant_builder_init(&sections, G_VARIANT_TYPE("a" BRISK_HOST_SECTION_TYPE));
+        for (guint i = 0; i < hosted->sections->len; i++) {
+                BriskSection *section = hosted->sections->pdata[i];
+
+                g_variant_builder_add_value(&sections,
+                                            brisk_hosted_backend_serialize_section(section));
+        }
+
+        g_variant_builder_init(&items, G_VARIANT_TYPE("a" BRISK_HOST_ITEM_TYPE));
+        g_hash_table_iter_init(&iter, hosted->items);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&item)) {
+                g_variant_builder_add_value(&items,
+                                            brisk_hosted_backend_serialize_item(hosted, item));
+        }
+
+        brisk_backend_host_complete_get_snapshot(skeleton,
+                                                 invocation,
+                                                 brisk_backend_get_display_name(hosted->backend),
+                                                 g_variant_builder_end(&sections),
+                                                 g_variant_builder_end(&items));
+        return TRUE;
+}
+
+static gboolean brisk_host_server_handle_item_launched(BriskBackendHost *skeleton,
+                                                       GDBusMethodInvocation *invocation,
+                                                       const gchar *backend_id,
+                                                       const gchar *item_id,
+                                                       BriskHostServer *self)
+{
+        BriskHostedBackend *hosted = NULL;
+        BriskItem *item = NULL;
+
+        hosted = g_hash_table_lookup(self->backends, backend_id);
+        if (hosted) {
+                item = g_hash_table_lookup(hosted->items, item_id);
+        }
+        if (item) {
+                brisk_backend_item_launched(hosted->backend, item);
+        }
+
+        brisk_backend_host_complete_item_launched(skeleton, invocation);
+        return TRUE;
+}
+
+/**
+ * brisk_host_server_start:
+ *
+ * Export ourselves on the connection. Message processing should still be
+ * delayed at this point, so that no call can arrive before we're ready.
+ */
+gboolean brisk_host_server_start(BriskHostServer *self, GError **error)
+{
+        g_signal_connect(self->skeleton,
+                         "handle-load",
+                         G_CALLBACK(brisk_host_server_handle_load),
+                         self);
+        g_signal_connect(self->skeleton,
+                         "handle-get-snapshot",
+                         G_CALLBACK(brisk_host_server_handle_get_snapshot),
+                         self);
+        g_signal_connect(self->skeleton,
+                         "handle-item-launched",
+                         G_CALLBACK(brisk_host_server_handle_item_launched),
+                         self);
+
+        if (!g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(self->skeleton),
+                                              self->connection,
+                                              BRISK_HOST_OBJECT_PATH,
+                                              error)) {
+                return FALSE;
+        }
+
+        self->actions_id = g_dbus_connection_export_action_group(self->connection,
+                                                                 BRISK_HOST_ACTIONS_PATH,
+                                                                 G_ACTION_GROUP(self->actions),
+                                                                 error);
+        return self->actions_id > 0;
+}
+
+/**
+ * brisk_host_server_new:
+ *
+ * Construct a new BriskHostServer object
+ */
+BriskHostServer *brisk_host_server_new(GDBusConnection *connection)
+{
+        BriskHostServer *self = g_object_new(BRISK_TYPE_HOST_SERVER, NULL);
+
+        self->connection = g_object_ref(connection);
+        return self;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
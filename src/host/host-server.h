@@ -0,0 +1,57 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#pragma once
+
+#include <gio/gio.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef struct _BriskHostServer BriskHostServer;
+typedef struct _BriskHostServerClass BriskHostServerClass;
+
+#define BRISK_TYPE_HOST_SERVER brisk_host_server_get_type()
+#define BRISK_HOST_SERVER(o)                                                                       \
+        (G_TYPE_CHECK_INSTANCE_CAST((o), BRISK_TYPE_HOST_SERVER, BriskHostServer))
+#define BRISK_IS_HOST_SERVER(o) (G_TYPE_CHECK_INSTANCE_TYPE((o), BRISK_TYPE_HOST_SERVER))
+#define BRISK_HOST_SERVER_CLASS(o)                                                                 \
+        (G_TYPE_CHECK_CLASS_CAST((o), BRISK_TYPE_HOST_SERVER, BriskHostServerClass))
+#define BRISK_IS_HOST_SERVER_CLASS(o) (G_TYPE_CHECK_CLASS_TYPE((o), BRISK_TYPE_HOST_SERVER))
+#define BRISK_HOST_SERVER_GET_CLASS(o)                                                             \
+        (G_TYPE_INSTANCE_GET_CLASS((o), BRISK_TYPE_HOST_SERVER, BriskHostServerClass))
+
+/**
+ * Construct a new BriskHostServer to serve backends over the connection
+ */
+BriskHostServer *brisk_host_server_new(GDBusConnection *connection);
+
+GType brisk_host_server_get_type(void);
+
+/**
+ * Export the BackendHost interface and backend actions on the connection
+ */
+gboolean brisk_host_server_start(BriskHostServer *self, GError **error);
+
+G_END_DECLS
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
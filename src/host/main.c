@@ -0,0 +1,128 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "config.h"
+#include "util.h"
+
+#include <locale.h>
+#include <stdlib.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "host-server.h"
+#include <gio/gio.h>
+#include <glib/gi18n.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GMainLoop, g_main_loop_unref)
+DEF_AUTOFREE(GOptionContext, g_option_context_free)
+DEF_AUTOFREE(GDBusConnection, g_object_unref)
+DEF_AUTOFREE(GSocket, g_object_unref)
+DEF_AUTOFREE(GSocketConnection, g_object_unref)
+DEF_AUTOFREE(BriskHostServer, g_object_unref)
+DEF_AUTOFREE(gchar, g_free)
+
+/**
+ * The applet hands us one end of a socket pair
+ */
+static gint host_fd = -1;
+
+static GOptionEntry brisk_host_options[] = {
+        { "fd", 0, 0, G_OPTION_ARG_INT, &host_fd, N_("Connected socket to serve on"), "FD" },
+        { NULL, 0, 0, 0, NULL, NULL, NULL },
+};
+
+/**
+ * brisk-backend-host runs backends on behalf of the applet, and lives exactly
+ * as long as the connection to it does
+ */
+int main(int argc, char **argv)
+{
+        autofree(GOptionContext) *context = NULL;
+        autofree(GError) *error = NULL;
+        autofree(GSocket) *socket = NULL;
+        autofree(GSocketConnection) *stream = NULL;
+        autofree(GDBusConnection) *connection = NULL;
+        autofree(BriskHostServer) *server = NULL;
+        autofree(GMainLoop) *loop = NULL;
+        autofree(gchar) *guid = NULL;
+        GDBusConnectionFlags flags;
+
+        /* Item names come from .desktop files, so honour the locale */
+        setlocale(LC_ALL, "");
+        bindtextdomain(GETTEXT_PACKAGE, MATELOCALEDIR);
+        bind_textdomain_codeset(GETTEXT_PACKAGE, "UTF-8");
+        textdomain(GETTEXT_PACKAGE);
+
+        context = g_option_context_new(NULL);
+        g_option_context_add_main_entries(context, brisk_host_options, GETTEXT_PACKAGE);
+        if (!g_option_context_parse(context, &argc, &argv, &error)) {
+                g_printerr("%s\n", error->message);
+                return EXIT_FAILURE;
+        }
+
+        if (host_fd < 0) {
+                g_printerr("%s\n", _("This program is started by Brisk Menu, and requires --fd"));
+                return EXIT_FAILURE;
+        }
+
+        socket = g_socket_new_from_fd(host_fd, &error);
+        if (!socket) {
+                g_printerr("Invalid socket: %s\n", error->message);
+                return EXIT_FAILURE;
+        }
+        stream = g_socket_connection_factory_create_connection(socket);
+
+        /* Don't dispatch anything until we're exported */
+        flags = G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_SERVER |
+                G_DBUS_CONNECTION_FLAGS_DELAY_MESSAGE_PROCESSING;
+        guid = g_dbus_generate_guid();
+        connection = g_dbus_connection_new_sync(G_IO_STREAM(stream),
+                                                guid,
+                                                flags,
+                                                NULL,
+                                                NULL,
+                                                &error);
+        if (!connection) {
+                g_printerr("Failed to connect to applet: %s\n", error->message);
+                return EXIT_FAILURE;
+        }
+
+        server = brisk_host_server_new(connection);
+        if (!brisk_host_server_start(server, &error)) {
+                g_printerr("Failed to export backend host: %s\n", error->message);
+                return EXIT_FAILURE;
+        }
+
+        /* The applet went away, so must we */
+        loop = g_main_loop_new(NULL, FALSE);
+        g_signal_connect_swapped(connection, "closed", G_CALLBACK(g_main_loop_quit), loop);
+
+        g_dbus_connection_start_message_processing(connection);
+        g_main_loop_run(loop);
+
+        return EXIT_SUCCESS;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
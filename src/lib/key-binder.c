@@ -34,8 +34,11 @@ struct _BriskKeyBinderClass {
 struct _BriskKeyBinder {
         GObject parent;
         GdkWindow *root_window;
+        GdkKeymap *keymap;
         GHashTable *bindings;
-        gboolean wait_for_release;
+        GHashTable *index;
+        struct KeyBinding *pending;
+        KeyCode super_keycode;
 };
 
 /**
@@ -44,13 +47,16 @@ struct _BriskKeyBinder {
  */
 typedef struct KeyBinding {
         const gchar *accelerator;
+        guint keysym;
         KeyCode keycode;
-        GdkModifierType mods;
+        guint mods; /**<Real X11 modifiers, without any lock keys */
         BinderFunc func;
         gpointer udata;
+        GDestroyNotify destroy;
 } KeyBinding;
 
 static GdkFilterReturn brisk_key_binder_filter(GdkXEvent *xevent, GdkEvent *event, gpointer v);
+static void brisk_key_binder_keys_changed(BriskKeyBinder *self, GdkKeymap *keymap);
 static void free_keybinding(KeyBinding *binding);
 
 /**
@@ -66,8 +72,22 @@ static GdkModifierType _modifiers[] = { 0,
                                         GDK_LOCK_MASK | GDK_MOD5_MASK,
                                         GDK_MOD2_MASK | GDK_LOCK_MASK | GDK_MOD5_MASK };
 
+/**
+ * Only the real modifiers (Shift through Mod5) are reported by X
+ */
+#define BRISK_REAL_MODS_MASK 0xFF
+
 G_DEFINE_TYPE(BriskKeyBinder, brisk_key_binder, G_TYPE_OBJECT)
 
+/**
+ * Bindings are indexed by keycode and cleaned modifiers, which both fit
+ * comfortably within a pointer-sized key
+ */
+static inline gpointer brisk_key_binder_index_key(guint keycode, guint mods)
+{
+        return GUINT_TO_POINTER((keycode << 8) | (mods & BRISK_REAL_MODS_MASK));
+}
+
 /**
  * brisk_key_binder_new:
  *
@@ -94,7 +114,14 @@ static void brisk_key_binder_dispose(GObject *obj)
                 self->root_window = NULL;
         }
 
+        if (self->keymap) {
+                g_signal_handlers_disconnect_by_data(self->keymap, self);
+                self->keymap = NULL;
+        }
+
         /* Will automatically clean up all bindings too */
+        self->pending = NULL;
+        g_clear_pointer(&self->index, g_hash_table_unref);
         g_clear_pointer(&self->bindings, g_hash_table_unref);
 
         G_OBJECT_CLASS(brisk_key_binder_parent_class)->dispose(obj);
@@ -124,6 +151,8 @@ static void brisk_key_binder_init(BriskKeyBinder *self)
 
         self->bindings =
             g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)free_keybinding);
+        /* Values are owned by the bindings table */
+        self->index = g_hash_table_new(g_direct_hash, g_direct_equal);
 
         root = gdk_get_default_root_window();
         if (!root) {
@@ -131,9 +160,33 @@ static void brisk_key_binder_init(BriskKeyBinder *self)
                 return;
         }
         self->root_window = root;
+
+        /* Keycodes are only valid for the current keymap */
+        self->keymap = gdk_keymap_get_for_display(gdk_window_get_display(root));
+        g_signal_connect_swapped(self->keymap,
+                                 "keys-changed",
+                                 G_CALLBACK(brisk_key_binder_keys_changed),
+                                 self);
+        self->super_keycode = XKeysymToKeycode(GDK_WINDOW_XDISPLAY(root), GDK_KEY_Super_L);
+
         gdk_window_add_filter(root, brisk_key_binder_filter, self);
 }
 
+/**
+ * Pass the event back up the window hierarchy so that it may be part of
+ * some other shortcut sequence (e.g. <Mod4>a)
+ */
+static void brisk_key_binder_replay(BriskKeyBinder *self, Display *display, XEvent *xev)
+{
+        XSendEvent(display,
+                   GDK_WINDOW_XID(self->root_window),
+                   TRUE,
+                   KeyPressMask | KeyReleaseMask,
+                   xev);
+        XAllowEvents(display, ReplayKeyboard, xev->xkey.time);
+        self->pending = NULL;
+}
+
 /**
  * Handle global events (eventually)
  */
@@ -141,17 +194,35 @@ static GdkFilterReturn brisk_key_binder_filter(GdkXEvent *xevent, GdkEvent *even
 {
         BriskKeyBinder *self = NULL;
         XEvent *xev = xevent;
-        GHashTableIter iter = { 0 };
-        const gchar *key = NULL;
-        const KeyBinding *binding = NULL;
+        KeyBinding *binding = NULL;
         guint mods;
         Display *display = NULL;
-        KeySym keysym;
+
+        if (xev->type != KeyRelease && xev->type != KeyPress) {
+                return GDK_FILTER_CONTINUE;
+        }
 
         self = BRISK_KEY_BINDER(v);
         display = GDK_WINDOW_XDISPLAY(self->root_window);
 
-        if (xev->type != KeyRelease && xev->type != KeyPress) {
+        /* capture release within same shortcut sequence */
+        if (self->pending) {
+                if (xev->xkey.keycode != self->pending->keycode) {
+                        brisk_key_binder_replay(self, display, xev);
+                        return GDK_FILTER_CONTINUE;
+                }
+                binding = self->pending;
+                if (xev->type == KeyRelease) {
+                        self->pending = NULL;
+                        binding->func(event, binding->udata);
+                }
+                XAllowEvents(display, AsyncKeyboard, xev->xkey.time);
+                return GDK_FILTER_CONTINUE;
+        }
+
+        /* Nothing to start on a stray release */
+        if (xev->type != KeyPress) {
+                brisk_key_binder_replay(self, display, xev);
                 return GDK_FILTER_CONTINUE;
         }
 
@@ -159,88 +230,158 @@ static GdkFilterReturn brisk_key_binder_filter(GdkXEvent *xevent, GdkEvent *even
         mods = xev->xkey.state & ~(_modifiers[7]);
 
         /* unset mask of Mod4 if using Super_L key as hotkey */
-        keysym = XkbKeycodeToKeysym(display, (KeyCode)xev->xkey.keycode, 0, 0);
-        if (keysym == GDK_KEY_Super_L) {
+        if (xev->xkey.keycode == self->super_keycode) {
                 mods = mods & ~((guint)GDK_MOD4_MASK);
         }
 
-        g_hash_table_iter_init(&iter, self->bindings);
-
-        /* Find a matching binding */
-        while (g_hash_table_iter_next(&iter, (void **)&key, (void **)&binding)) {
-                /* capture initial key press */
-                if (xev->xkey.keycode == binding->keycode && xev->type == KeyPress &&
-                    !self->wait_for_release) {
-                        if (mods == binding->mods) {
-                                self->wait_for_release = TRUE;
-                                XAllowEvents(display, AsyncKeyboard, xev->xkey.time);
-                        }
-                } else if (xev->xkey.keycode == binding->keycode && self->wait_for_release) {
-                        /* capture release within same shortcut sequence */
-                        if (xev->type == KeyRelease) {
-                                self->wait_for_release = FALSE;
-                                binding->func(event, binding->udata);
-                        }
-                        XAllowEvents(display, AsyncKeyboard, xev->xkey.time);
-                } else {
-                        /* when breaking the shortcut sequence, send the event up the window
-                         * hierarchy in case it's part of a different shortcut sequence
-                         * (e.g. <Mod4>a) */
-                        XSendEvent(display,
-                                   GDK_WINDOW_XID(self->root_window),
-                                   TRUE,
-                                   KeyPressMask | KeyReleaseMask,
-                                   xev);
-                        XAllowEvents(display, ReplayKeyboard, xev->xkey.time);
-                        self->wait_for_release = FALSE;
-                }
+        /* capture initial key press */
+        binding = g_hash_table_lookup(self->index,
+                                      brisk_key_binder_index_key(xev->xkey.keycode, mods));
+        if (!binding) {
+                brisk_key_binder_replay(self, display, xev);
+                return GDK_FILTER_CONTINUE;
         }
 
+        self->pending = binding;
+        XAllowEvents(display, AsyncKeyboard, xev->xkey.time);
         return GDK_FILTER_CONTINUE;
 }
 
+/**
+ * Establish the passive grabs for the binding, for every combination of lock
+ * keys, and make it findable from the event filter
+ */
+static void brisk_key_binder_grab(BriskKeyBinder *self, KeyBinding *binding)
+{
+        Display *display = GDK_WINDOW_XDISPLAY(self->root_window);
+        Window id = GDK_WINDOW_XID(self->root_window);
+
+        binding->keycode = XKeysymToKeycode(display, binding->keysym);
+        if (binding->keycode == 0) {
+                return;
+        }
+
+        gdk_error_trap_push();
+        for (size_t i = 0; i < G_N_ELEMENTS(_modifiers); i++) {
+                XGrabKey(display,
+                         binding->keycode,
+                         binding->mods | _modifiers[i],
+                         id,
+                         TRUE,
+                         GrabModeAsync,
+                         GrabModeAsync);
+        }
+        gdk_flush();
+        gdk_error_trap_pop_ignored();
+
+        g_hash_table_insert(self->index,
+                            brisk_key_binder_index_key(binding->keycode, binding->mods),
+                            binding);
+}
+
+/**
+ * Drop every passive grab previously established by brisk_key_binder_grab
+ */
+static void brisk_key_binder_ungrab(KeyBinding *binding)
+{
+        Display *display = NULL;
+        Window id;
+        GdkWindow *window = NULL;
+
+        if (binding->keycode == 0) {
+                return;
+        }
+
+        window = gdk_get_default_root_window();
+        if (!window) {
+                g_warning("Could not find root window to XUngrabKey");
+                return;
+        }
+
+        display = GDK_WINDOW_XDISPLAY(window);
+        id = GDK_WINDOW_XID(window);
+
+        gdk_error_trap_push();
+        for (size_t i = 0; i < G_N_ELEMENTS(_modifiers); i++) {
+                XUngrabKey(display, binding->keycode, binding->mods | _modifiers[i], id);
+        }
+        gdk_flush();
+        gdk_error_trap_pop_ignored();
+}
+
+/**
+ * The keyboard layout changed, so our keycodes may now point elsewhere.
+ * Resolve every binding again and rebuild the index.
+ */
+static void brisk_key_binder_keys_changed(BriskKeyBinder *self,
+                                          __brisk_unused__ GdkKeymap *keymap)
+{
+        GHashTableIter iter = { 0 };
+        KeyBinding *binding = NULL;
+
+        self->pending = NULL;
+        self->super_keycode =
+            XKeysymToKeycode(GDK_WINDOW_XDISPLAY(self->root_window), GDK_KEY_Super_L);
+
+        g_hash_table_remove_all(self->index);
+
+        g_hash_table_iter_init(&iter, self->bindings);
+        while (g_hash_table_iter_next(&iter, NULL, (void **)&binding)) {
+                brisk_key_binder_ungrab(binding);
+                brisk_key_binder_grab(self, binding);
+        }
+}
+
 /**
  * Bind a shortcut with the appropriate callback
  */
 gboolean brisk_key_binder_bind(BriskKeyBinder *self, const gchar *shortcut, BinderFunc func,
                                gpointer v)
+{
+        return brisk_key_binder_bind_full(self, shortcut, func, v, NULL);
+}
+
+/**
+ * Bind a shortcut with the appropriate callback, and hand ownership of the
+ * user data to the binding. If the bind fails, the data is not consumed.
+ */
+gboolean brisk_key_binder_bind_full(BriskKeyBinder *self, const gchar *shortcut, BinderFunc func,
+                                    gpointer v, GDestroyNotify destroy)
 {
         guint keysym;
         GdkModifierType mod;
-        Display *display = NULL;
-        Window id;
-        KeyCode key;
         KeyBinding *bind = NULL;
+        gchar *accelerator = NULL;
 
-        if (g_hash_table_contains(self->bindings, shortcut)) {
+        if (!self->root_window || g_hash_table_contains(self->bindings, shortcut)) {
                 return FALSE;
         }
 
         gtk_accelerator_parse(shortcut, &keysym, &mod);
-        display = GDK_WINDOW_XDISPLAY(self->root_window);
-        id = GDK_WINDOW_XID(self->root_window);
-
-        key = XKeysymToKeycode(display, keysym);
-        if (key == 0) {
+        if (keysym == 0) {
                 return FALSE;
         }
 
+        /* X only knows about the real modifiers, i.e. Mod4 rather than Super */
+        gdk_keymap_map_virtual_modifiers(self->keymap, &mod);
+
+        accelerator = g_strdup(shortcut);
         bind = g_new0(KeyBinding, 1);
-        *bind = (KeyBinding){ .accelerator = shortcut,
-                              .keycode = key,
-                              .mods = mod,
+        *bind = (KeyBinding){ .accelerator = accelerator,
+                              .keysym = keysym,
+                              .mods = (guint)mod & BRISK_REAL_MODS_MASK & ~(guint)_modifiers[7],
                               .func = func,
-                              .udata = v };
-
-        g_hash_table_insert(self->bindings, g_strdup(shortcut), bind);
+                              .udata = v,
+                              .destroy = destroy };
 
-        gdk_error_trap_push();
-        for (size_t i = 0; i < G_N_ELEMENTS(_modifiers); i++) {
-                GdkModifierType m = _modifiers[i];
-                XGrabKey(display, key, mod | m, id, TRUE, GrabModeAsync, GrabModeAsync);
+        brisk_key_binder_grab(self, bind);
+        if (bind->keycode == 0) {
+                g_free(accelerator);
+                g_free(bind);
+                return FALSE;
         }
-        gdk_flush();
 
+        g_hash_table_insert(self->bindings, accelerator, bind);
         return TRUE;
 }
 
@@ -249,6 +390,22 @@ gboolean brisk_key_binder_bind(BriskKeyBinder *self, const gchar *shortcut, Bind
  */
 gboolean brisk_key_binder_unbind(BriskKeyBinder *self, const gchar *shortcut)
 {
+        KeyBinding *binding = NULL;
+        gpointer key;
+
+        binding = g_hash_table_lookup(self->bindings, shortcut);
+        if (!binding) {
+                return FALSE;
+        }
+
+        key = brisk_key_binder_index_key(binding->keycode, binding->mods);
+        if (g_hash_table_lookup(self->index, key) == binding) {
+                g_hash_table_remove(self->index, key);
+        }
+        if (self->pending == binding) {
+                self->pending = NULL;
+        }
+
         return g_hash_table_remove(self->bindings, shortcut);
 }
 
@@ -257,19 +414,10 @@ gboolean brisk_key_binder_unbind(BriskKeyBinder *self, const gchar *shortcut)
  */
 static void free_keybinding(KeyBinding *binding)
 {
-        Display *display = NULL;
-        Window id;
-        GdkWindow *window = NULL;
-
-        window = gdk_get_default_root_window();
-        if (window) {
-                display = GDK_WINDOW_XDISPLAY(window);
-                id = GDK_WINDOW_XID(window);
-                XUngrabKey(display, binding->keycode, binding->mods, id);
-        } else {
-                g_warning("Could not find root window to XUngrabKey");
+        brisk_key_binder_ungrab(binding);
+        if (binding->destroy) {
+                binding->destroy(binding->udata);
         }
-
         g_free(binding);
 }
 
@@ -42,6 +42,8 @@ typedef void (*BinderFunc)(GdkEvent *event, gpointer v);
 
 gboolean brisk_key_binder_bind(BriskKeyBinder *self, const gchar *shortcut, BinderFunc func,
                                gpointer v);
+gboolean brisk_key_binder_bind_full(BriskKeyBinder *self, const gchar *shortcut, BinderFunc func,
+                                    gpointer v, GDestroyNotify destroy);
 gboolean brisk_key_binder_unbind(BriskKeyBinder *self, const gchar *shortcut);
 
 G_END_DECLS
@@ -51,7 +51,9 @@ static void brisk_menu_applet_notify_fail(const gchar *title, const gchar *body)
 /* Helpers */
 static GtkPositionType convert_mate_position(MatePanelAppletOrient orient);
 static void brisk_menu_applet_adapt_layout(BriskMenuApplet *self);
-static GtkWidget *brisk_menu_applet_automatic_window_type(BriskMenuApplet *self);
+static WindowType brisk_menu_applet_resolve_window_type(BriskMenuApplet *self);
+static void brisk_menu_applet_window_type_changed(GSettings *settings, const gchar *key,
+                                                  BriskMenuApplet *self);
 
 /**
  * brisk_menu_applet_dispose:
@@ -102,6 +104,10 @@ void brisk_menu_applet_init_settings(BriskMenuApplet *self)
                          "changed::label-text",
                          G_CALLBACK(brisk_menu_applet_settings_changed),
                          self);
+        g_signal_connect(self->settings,
+                         "changed::window-type",
+                         G_CALLBACK(brisk_menu_applet_window_type_changed),
+                         self);
 }
 
 /**
@@ -177,22 +183,25 @@ static gboolean brisk_menu_applet_startup(BriskMenuApplet *self)
         return G_SOURCE_REMOVE;
 }
 
+/**
+ * Construct the menu window, replacing any existing one. The backends are
+ * shared through the registry, so swapping the window only rebuilds the view
+ * and never reloads the data behind it.
+ */
 static void brisk_menu_applet_create_window(BriskMenuApplet *self)
 {
         GtkWidget *menu = NULL;
+        GtkWidget *old_menu = self->menu;
 
         /* Now show all content */
         gtk_widget_show_all(self->toggle);
 
         /* Construct our menu */
-        WindowType window_type = g_settings_get_enum(self->settings, "window-type");
-        switch (window_type) {
+        self->window_type = brisk_menu_applet_resolve_window_type(self);
+        switch (self->window_type) {
         case WINDOW_TYPE_DASH:
                 menu = GTK_WIDGET(brisk_dash_window_new(GTK_WIDGET(self)));
                 break;
-        case WINDOW_TYPE_AUTOMATIC:
-                menu = brisk_menu_applet_automatic_window_type(self);
-                break;
         case WINDOW_TYPE_CLASSIC:
         default:
                 menu = GTK_WIDGET(brisk_classic_window_new(GTK_WIDGET(self)));
@@ -201,6 +210,14 @@ static void brisk_menu_applet_create_window(BriskMenuApplet *self)
 
         self->menu = menu;
 
+        /* The new window holds the registry by now, so the old one can go
+         * without taking the backends with it. Do it before the settings are
+         * pumped so that the hot key is free to be grabbed again. */
+        if (old_menu) {
+                gtk_widget_hide(old_menu);
+                gtk_widget_destroy(old_menu);
+        }
+
         /* Render "active" toggle only when the window is open, automatically. */
         g_object_bind_property(menu, "visible", self->toggle, "active", G_BINDING_DEFAULT);
 
@@ -215,6 +232,28 @@ static void brisk_menu_applet_create_window(BriskMenuApplet *self)
         brisk_menu_applet_change_menu_orient(self);
 }
 
+/**
+ * Swap the menu for another type if the settings or panel orientation no
+ * longer agree with the current one
+ */
+static void brisk_menu_applet_update_window(BriskMenuApplet *self)
+{
+        if (!self->menu) {
+                return;
+        }
+        if (brisk_menu_applet_resolve_window_type(self) == self->window_type) {
+                return;
+        }
+        brisk_menu_applet_create_window(self);
+}
+
+static void brisk_menu_applet_window_type_changed(__brisk_unused__ GSettings *settings,
+                                                  __brisk_unused__ const gchar *key,
+                                                  BriskMenuApplet *self)
+{
+        brisk_menu_applet_update_window(self);
+}
+
 /**
  * Toggle the menu visibility on a button press
  */
@@ -278,6 +317,12 @@ static void brisk_menu_applet_change_orient(MatePanelApplet *applet, MatePanelAp
                 return;
         }
 
+        /* Automatic mode may want the other window type now */
+        if (brisk_menu_applet_resolve_window_type(self) != self->window_type) {
+                brisk_menu_applet_create_window(self);
+                return;
+        }
+
         brisk_menu_applet_change_menu_orient(self);
 }
 
@@ -433,16 +478,30 @@ static void brisk_menu_applet_adapt_layout(BriskMenuApplet *self)
         }
 }
 
-static GtkWidget *brisk_menu_applet_automatic_window_type(BriskMenuApplet *self)
+/**
+ * Determine the window type we should be showing, picking one for the panel
+ * orientation in automatic mode
+ */
+static WindowType brisk_menu_applet_resolve_window_type(BriskMenuApplet *self)
 {
+        WindowType window_type = g_settings_get_enum(self->settings, "window-type");
+
+        if (window_type == WINDOW_TYPE_DASH) {
+                return WINDOW_TYPE_DASH;
+        }
+        if (window_type != WINDOW_TYPE_AUTOMATIC) {
+                return WINDOW_TYPE_CLASSIC;
+        }
+
         switch (self->orient) {
         case MATE_PANEL_APPLET_ORIENT_LEFT:
         case MATE_PANEL_APPLET_ORIENT_RIGHT:
-                return GTK_WIDGET(brisk_dash_window_new(GTK_WIDGET(self)));
+                return WINDOW_TYPE_DASH;
         default:
-                return GTK_WIDGET(brisk_classic_window_new(GTK_WIDGET(self)));
+                return WINDOW_TYPE_CLASSIC;
         }
 }
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
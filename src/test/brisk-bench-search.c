@@ -0,0 +1,328 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "brisk-resources.h"
+#include "classic/classic-window.h"
+#include "menu-private.h"
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+static inline void brisk_bench_string_free(GString *str)
+{
+        g_string_free(str, TRUE);
+}
+
+DEF_AUTOFREE(GString, brisk_bench_string_free)
+
+/**
+ * Size of the fixed catalogue, roughly a well stocked desktop
+ */
+#define BRISK_BENCH_N_APPS 400
+
+/**
+ * Each term is typed one character at a time, as a user would
+ */
+static const gchar *brisk_bench_terms[] = {
+        "text editor", "terminal", "office", "net", "écran", "zzzz", "image viewer", "mus",
+};
+
+static const gchar *brisk_bench_words[] = {
+        "Text",  "Image",  "Music",   "Video",  "Office", "Network", "Terminal", "Archive",
+        "Photo", "Screen", "Disk",    "System", "Mail",   "Chat",    "Map",      "Clock",
+        "Font",  "Game",   "Printer", "Scan",   "Écran",  "Notes",   "Calendar", "Weather",
+};
+
+static const gchar *brisk_bench_kinds[] = {
+        "Editor", "Viewer", "Manager", "Player", "Monitor", "Browser", "Tool", "Recorder",
+};
+
+static const gchar *brisk_bench_categories[] = {
+        "Office", "Graphics", "AudioVideo", "Network", "System", "Utility", "Game", "Development",
+};
+
+/**
+ * g_mem_set_vtable() does nothing since GLib 2.46, so count calls to the C
+ * allocator instead. Only the main thread counts, as the workers and the
+ * GDBus thread would otherwise add noise to the numbers.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static _Thread_local gboolean brisk_bench_counting = FALSE;
+static guint64 brisk_bench_allocs = 0;
+static guint64 brisk_bench_bytes = 0;
+
+void *malloc(size_t size)
+{
+        if (brisk_bench_counting) {
+                brisk_bench_allocs++;
+                brisk_bench_bytes += size;
+        }
+        return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+        if (brisk_bench_counting) {
+                brisk_bench_allocs++;
+                brisk_bench_bytes += nmemb * size;
+        }
+        return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+        if (brisk_bench_counting) {
+                brisk_bench_allocs++;
+                brisk_bench_bytes += size;
+        }
+        return __libc_realloc(ptr, size);
+}
+
+static void brisk_bench_set_dir(const gchar *variable, const gchar *root, const gchar *leaf)
+{
+        autofree(gchar) *path = g_build_filename(root, leaf, NULL);
+
+        g_setenv(variable, path, TRUE);
+}
+
+/**
+ * Write out the catalogue, along with a menu file placing each of them into
+ * a category, and point the XDG directories at it
+ */
+static gboolean brisk_bench_write_catalogue(const gchar *root)
+{
+        autofree(gchar) *apps = g_build_filename(root, "data", "applications", NULL);
+        autofree(gchar) *menus = g_build_filename(root, "config", "menus", NULL);
+        autofree(gchar) *menu_path = g_build_filename(menus, "mate-applications.menu", NULL);
+        autofree(GString) *menu = g_string_new(NULL);
+
+        if (g_mkdir_with_parents(apps, 00700) != 0 || g_mkdir_with_parents(menus, 00700) != 0) {
+                return FALSE;
+        }
+
+        for (guint i = 0; i < BRISK_BENCH_N_APPS; i++) {
+                const gchar *word = brisk_bench_words[i % G_N_ELEMENTS(brisk_bench_words)];
+                const gchar *kind =
+                    brisk_bench_kinds[(i / G_N_ELEMENTS(brisk_bench_words)) %
+                                      G_N_ELEMENTS(brisk_bench_kinds)];
+                const gchar *category =
+                    brisk_bench_categories[i % G_N_ELEMENTS(brisk_bench_categories)];
+                autofree(gchar) *name = g_strdup_printf("brisk-bench-%03u.desktop", i);
+                autofree(gchar) *path = g_build_filename(apps, name, NULL);
+                autofree(gchar) *contents = NULL;
+
+                contents = g_strdup_printf(
+                    "[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=%s %s %u\n"
+                    "GenericName=%s %s\n"
+                    "Comment=Work with %s files\n"
+                    "Keywords=%s;%s;bench;\n"
+                    "Exec=true %s-%u\n"
+                    "Icon=application-x-executable\n"
+                    "Categories=%s;\n",
+                    word, kind, i, word, kind, word, word, kind, word, i, category);
+
+                if (!g_file_set_contents(path, contents, -1, NULL)) {
+                        return FALSE;
+                }
+        }
+
+        g_string_append(menu,
+                        "<!DOCTYPE Menu PUBLIC \"-//freedesktop//DTD Menu 1.0//EN\"\n"
+                        " \"http://www.freedesktop.org/standards/menu-spec/1.0/menu.dtd\">\n"
+                        "<Menu>\n  <Name>Applications</Name>\n  <DefaultAppDirs/>\n");
+        for (guint i = 0; i < G_N_ELEMENTS(brisk_bench_categories); i++) {
+                g_string_append_printf(menu,
+                                       "  <Menu><Name>%s</Name><Include><Category>%s"
+                                       "</Category></Include></Menu>\n",
+                                       brisk_bench_categories[i],
+                                       brisk_bench_categories[i]);
+        }
+        g_string_append(menu, "</Menu>\n");
+
+        if (!g_file_set_contents(menu_path, menu->str, (gssize)menu->len, NULL)) {
+                return FALSE;
+        }
+
+        brisk_bench_set_dir("XDG_DATA_DIRS", root, "data");
+        brisk_bench_set_dir("XDG_CONFIG_DIRS", root, "config");
+        brisk_bench_set_dir("XDG_DATA_HOME", root, "home/data");
+        brisk_bench_set_dir("XDG_CONFIG_HOME", root, "home/config");
+        brisk_bench_set_dir("XDG_CACHE_HOME", root, "home/cache");
+        return TRUE;
+}
+
+/**
+ * How many apps the apps backend has emitted so far. The window is told of
+ * each one within the same emission, and unlike its item store this doesn't
+ * count the sections.
+ */
+static guint brisk_bench_n_apps(BriskMenuWindow *window)
+{
+        GPtrArray *backends = brisk_menu_registry_get_backends(window->registry);
+
+        for (guint i = 0; i < backends->len; i++) {
+                GPtrArray *items = NULL;
+
+                if (!g_str_equal(brisk_backend_get_id(backends->pdata[i]), "apps")) {
+                        continue;
+                }
+                items = brisk_menu_registry_get_items(window->registry, backends->pdata[i]);
+                return items ? items->len : 0;
+        }
+        return 0;
+}
+
+/**
+ * Spin until every app in the catalogue has been added to the window, or give up
+ */
+static gboolean brisk_bench_wait_loaded(BriskMenuWindow *window)
+{
+        gint64 deadline = g_get_monotonic_time() + 30 * G_USEC_PER_SEC;
+
+        while (brisk_bench_n_apps(window) < BRISK_BENCH_N_APPS) {
+                if (g_get_monotonic_time() > deadline) {
+                        return FALSE;
+                }
+                g_main_context_iteration(NULL, TRUE);
+        }
+
+        /* Let anything queued behind the load settle before measuring */
+        while (g_main_context_iteration(NULL, FALSE)) {
+                ;
+        }
+        return TRUE;
+}
+
+/**
+ * Type out the term, counting only what brisk_menu_window_search allocates
+ * for each keystroke. The entry's own handler is blocked while the text is
+ * set, so the search runs exactly once per keystroke.
+ */
+static void brisk_bench_type(BriskMenuWindow *window, const gchar *term, guint64 *allocs,
+                             guint64 *bytes, gint64 *elapsed)
+{
+        GtkEntry *entry = GTK_ENTRY(window->search);
+        guint64 term_allocs = 0, term_bytes = 0;
+        gint64 term_elapsed = 0;
+        guint n_keys = 0;
+
+        for (const gchar *c = term; *c; c = g_utf8_next_char(c)) {
+                autofree(gchar) *typed = g_strndup(term, (gsize)(g_utf8_next_char(c) - term));
+                gint64 start;
+
+                g_signal_handlers_block_by_func(entry, brisk_menu_window_search, window);
+                gtk_entry_set_text(entry, typed);
+                g_signal_handlers_unblock_by_func(entry, brisk_menu_window_search, window);
+
+                brisk_bench_allocs = brisk_bench_bytes = 0;
+                start = g_get_monotonic_time();
+                brisk_bench_counting = TRUE;
+                brisk_menu_window_search(window, entry);
+                brisk_bench_counting = FALSE;
+                term_elapsed += g_get_monotonic_time() - start;
+                term_allocs += brisk_bench_allocs;
+                term_bytes += brisk_bench_bytes;
+                n_keys++;
+        }
+
+        printf("%-14s %3u keys %9" G_GUINT64_FORMAT " allocs %11" G_GUINT64_FORMAT
+               " bytes %8.2f ms\n",
+               term,
+               n_keys,
+               term_allocs,
+               term_bytes,
+               (gdouble)term_elapsed / 1000.0);
+
+        *allocs += term_allocs;
+        *bytes += term_bytes;
+        *elapsed += term_elapsed;
+
+        /* Back to the full list between terms */
+        g_signal_handlers_block_by_func(entry, brisk_menu_window_search, window);
+        gtk_entry_set_text(entry, "");
+        g_signal_handlers_unblock_by_func(entry, brisk_menu_window_search, window);
+        brisk_menu_window_search(window, entry);
+}
+
+int main(int argc, char **argv)
+{
+        autofree(gchar) *root = NULL;
+        BriskMenuWindow *window = NULL;
+        guint64 allocs = 0, bytes = 0;
+        gint64 elapsed = 0;
+
+        /* Slices must come from malloc to be counted */
+        g_setenv("G_SLICE", "always-malloc", TRUE);
+        g_setenv("GSETTINGS_BACKEND", "memory", TRUE);
+
+        root = g_dir_make_tmp("brisk-bench-XXXXXX", NULL);
+        if (!root || !brisk_bench_write_catalogue(root)) {
+                fputs("Failed to write the catalogue\n", stderr);
+                return EXIT_FAILURE;
+        }
+
+        /* Needs a display, skip rather than fail without one */
+        if (!gtk_init_check(&argc, &argv)) {
+                fputs("No display, skipping\n", stderr);
+                return 77;
+        }
+        brisk_resources_register_resource();
+
+        window = brisk_classic_window_new(NULL);
+        brisk_menu_window_load_menus(window);
+        if (!brisk_bench_wait_loaded(window)) {
+                fprintf(stderr,
+                        "Only %u of %u apps loaded\n",
+                        brisk_bench_n_apps(window),
+                        BRISK_BENCH_N_APPS);
+                return EXIT_FAILURE;
+        }
+
+        printf("Searching %u apps\n", brisk_bench_n_apps(window));
+        for (guint i = 0; i < G_N_ELEMENTS(brisk_bench_terms); i++) {
+                brisk_bench_type(window, brisk_bench_terms[i], &allocs, &bytes, &elapsed);
+        }
+        printf("%-14s %14" G_GUINT64_FORMAT " allocs %11" G_GUINT64_FORMAT " bytes %8.2f ms\n",
+               "total",
+               allocs,
+               bytes,
+               (gdouble)elapsed / 1000.0);
+
+        gtk_widget_destroy(GTK_WIDGET(window));
+        brisk_resources_unregister_resource();
+        return EXIT_SUCCESS;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,300 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <stdlib.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "launcher.h"
+#include <gio/gdesktopappinfo.h>
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GAppInfo, g_object_unref)
+DEF_AUTOFREE(BriskMenuLauncher, g_object_unref)
+
+#define TEST_APP_ID "org.brisk.TestApp"
+#define TEST_APP_PATH "/org/brisk/TestApp"
+#define TEST_MISSING_ID "org.brisk.MissingApp"
+
+/**
+ * Just enough of org.freedesktop.Application to see what the launcher sends
+ */
+static const gchar test_app_xml[] =
+    "<node>"
+    "  <interface name='org.freedesktop.Application'>"
+    "    <method name='Activate'>"
+    "      <arg type='a{sv}' name='platform_data' direction='in'/>"
+    "    </method>"
+    "    <method name='Open'>"
+    "      <arg type='as' name='uris' direction='in'/>"
+    "      <arg type='a{sv}' name='platform_data' direction='in'/>"
+    "    </method>"
+    "    <method name='ActivateAction'>"
+    "      <arg type='s' name='action_name' direction='in'/>"
+    "      <arg type='av' name='parameter' direction='in'/>"
+    "      <arg type='a{sv}' name='platform_data' direction='in'/>"
+    "    </method>"
+    "  </interface>"
+    "</node>";
+
+typedef struct TestApp {
+        guint n_activated;
+        gboolean activated;
+        GVariant *platform_data;
+        gboolean name_acquired;
+} TestApp;
+
+/**
+ * What the launcher told us about its launches
+ */
+typedef struct TestTiming {
+        guint n_timed;
+        gchar *method;
+        gint64 latency;
+} TestTiming;
+
+static gchar *test_root = NULL;
+
+static void test_app_method_call(__brisk_unused__ GDBusConnection *connection,
+                                 __brisk_unused__ const gchar *sender,
+                                 __brisk_unused__ const gchar *path,
+                                 __brisk_unused__ const gchar *interface, const gchar *method,
+                                 GVariant *parameters, GDBusMethodInvocation *invocation,
+                                 gpointer v)
+{
+        TestApp *app = v;
+
+        if (g_str_equal(method, "Activate")) {
+                app->n_activated++;
+                app->activated = TRUE;
+                g_clear_pointer(&app->platform_data, g_variant_unref);
+                g_variant_get(parameters, "(@a{sv})", &app->platform_data);
+        }
+        g_dbus_method_invocation_return_value(invocation, NULL);
+}
+
+static const GDBusInterfaceVTable test_app_vtable = {
+        test_app_method_call,
+        NULL,
+        NULL,
+        { 0 },
+};
+
+static void test_app_name_acquired(__brisk_unused__ GDBusConnection *connection,
+                                   __brisk_unused__ const gchar *name, gpointer v)
+{
+        ((TestApp *)v)->name_acquired = TRUE;
+}
+
+static void test_launch_timed(__brisk_unused__ BriskMenuLauncher *launcher, const gchar *method,
+                              gint64 latency, gpointer v)
+{
+        TestTiming *timing = v;
+
+        timing->n_timed++;
+        g_free(timing->method);
+        timing->method = g_strdup(method);
+        timing->latency = latency;
+}
+
+/**
+ * Spin the main loop until the condition holds, or fail after a few seconds
+ */
+static void test_wait_for(gboolean *condition)
+{
+        gint64 deadline = g_get_monotonic_time() + 5 * G_USEC_PER_SEC;
+
+        while (!*condition) {
+                g_assert_cmpint(g_get_monotonic_time(), <, deadline);
+                g_main_context_iteration(NULL, FALSE);
+                g_usleep(1000);
+        }
+}
+
+/**
+ * Write a D-Bus activatable .desktop file into our private data directory
+ */
+static GAppInfo *test_app_info_new(const gchar *app_id, const gchar *exec)
+{
+        autofree(gchar) *name = g_strconcat(app_id, ".desktop", NULL);
+        autofree(gchar) *path = g_build_filename(test_root, "applications", name, NULL);
+        autofree(gchar) *contents = NULL;
+        GDesktopAppInfo *info = NULL;
+
+        contents = g_strdup_printf(
+            "[Desktop Entry]\n"
+            "Type=Application\n"
+            "Name=Test App\n"
+            "Exec=%s\n"
+            "DBusActivatable=true\n",
+            exec);
+        g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+
+        info = g_desktop_app_info_new(name);
+        g_assert_nonnull(info);
+        return G_APP_INFO(info);
+}
+
+/**
+ * A running application is asked to activate itself, and is never spawned
+ */
+static void test_launcher_activate(void)
+{
+        autofree(GError) *error = NULL;
+        autofree(GAppInfo) *info = NULL;
+        autofree(BriskMenuLauncher) *launcher = NULL;
+        autofree(gchar) *marker = g_build_filename(test_root, "activate-spawned", NULL);
+        autofree(gchar) *exec = g_strdup_printf("touch %s", marker);
+        GDBusConnection *bus = NULL;
+        GDBusNodeInfo *node = NULL;
+        TestApp app = { 0 };
+        TestTiming timing = { 0 };
+        guint object_id, owner_id;
+
+        bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, &error);
+        g_assert_no_error(error);
+
+        node = g_dbus_node_info_new_for_xml(test_app_xml, &error);
+        g_assert_no_error(error);
+        object_id = g_dbus_connection_register_object(bus,
+                                                      TEST_APP_PATH,
+                                                      node->interfaces[0],
+                                                      &test_app_vtable,
+                                                      &app,
+                                                      NULL,
+                                                      &error);
+        g_assert_no_error(error);
+        owner_id = g_bus_own_name_on_connection(bus,
+                                                TEST_APP_ID,
+                                                G_BUS_NAME_OWNER_FLAGS_NONE,
+                                                test_app_name_acquired,
+                                                NULL,
+                                                &app,
+                                                NULL);
+        test_wait_for(&app.name_acquired);
+
+        info = test_app_info_new(TEST_APP_ID, exec);
+        launcher = brisk_menu_launcher_new();
+        g_signal_connect(launcher, "launch-timed", G_CALLBACK(test_launch_timed), &timing);
+        brisk_menu_launcher_start(launcher, NULL, info);
+
+        test_wait_for(&app.activated);
+        g_assert_cmpuint(app.n_activated, ==, 1);
+        g_assert_nonnull(app.platform_data);
+        g_assert_true(g_variant_is_of_type(app.platform_data, G_VARIANT_TYPE_VARDICT));
+
+        /* Let any spawn fallback have its chance to run, it must not */
+        for (guint i = 0; i < 100; i++) {
+                g_main_context_iteration(NULL, FALSE);
+                g_usleep(1000);
+        }
+        g_assert_false(g_file_test(marker, G_FILE_TEST_EXISTS));
+
+        /* Timed once, as an activation */
+        g_assert_cmpuint(timing.n_timed, ==, 1);
+        g_assert_cmpstr(timing.method, ==, "D-Bus");
+        g_assert_cmpint(timing.latency, >=, 0);
+        g_free(timing.method);
+
+        g_bus_unown_name(owner_id);
+        g_dbus_connection_unregister_object(bus, object_id);
+        g_dbus_node_info_unref(node);
+        g_clear_pointer(&app.platform_data, g_variant_unref);
+        g_object_unref(bus);
+}
+
+/**
+ * Nobody owns the name, so the launcher has to fall back to spawning
+ */
+static void test_launcher_fallback(void)
+{
+        autofree(GAppInfo) *info = NULL;
+        autofree(BriskMenuLauncher) *launcher = NULL;
+        autofree(gchar) *marker = g_build_filename(test_root, "fallback-spawned", NULL);
+        autofree(gchar) *exec = g_strdup_printf("touch %s", marker);
+        gint64 deadline = g_get_monotonic_time() + 5 * G_USEC_PER_SEC;
+        TestTiming timing = { 0 };
+
+        info = test_app_info_new(TEST_MISSING_ID, exec);
+        launcher = brisk_menu_launcher_new();
+        g_signal_connect(launcher, "launch-timed", G_CALLBACK(test_launch_timed), &timing);
+        brisk_menu_launcher_start(launcher, NULL, info);
+
+        while (!g_file_test(marker, G_FILE_TEST_EXISTS) || timing.n_timed == 0) {
+                g_assert_cmpint(g_get_monotonic_time(), <, deadline);
+                g_main_context_iteration(NULL, FALSE);
+                g_usleep(1000);
+        }
+
+        /* Activation failed, so only the spawn is timed */
+        g_assert_cmpuint(timing.n_timed, ==, 1);
+        g_assert_cmpstr(timing.method, ==, "spawn");
+        g_assert_cmpint(timing.latency, >=, 0);
+        g_free(timing.method);
+}
+
+int main(int argc, char **argv)
+{
+        autofree(gchar) *apps = NULL;
+        GTestDBus *bus = NULL;
+        int ret;
+
+        g_test_init(&argc, &argv, NULL);
+
+        /* Our .desktop files must be the only ones found */
+        test_root = g_dir_make_tmp("brisk-test-launcher-XXXXXX", NULL);
+        g_assert_nonnull(test_root);
+        apps = g_build_filename(test_root, "applications", NULL);
+        g_assert_cmpint(g_mkdir_with_parents(apps, 00700), ==, 0);
+        g_setenv("XDG_DATA_DIRS", test_root, TRUE);
+        g_setenv("XDG_DATA_HOME", test_root, TRUE);
+
+        /* The launcher needs GDK for startup notification. Connect before the
+         * test bus comes up, as that unsets DISPLAY. */
+        g_setenv("NO_AT_BRIDGE", "1", TRUE);
+        if (!gtk_init_check(&argc, &argv)) {
+                g_printerr("No display, skipping\n");
+                return 77;
+        }
+
+        /* Private session bus, nothing else is on it */
+        bus = g_test_dbus_new(G_TEST_DBUS_NONE);
+        g_test_dbus_up(bus);
+
+        g_test_add_func("/launcher/activate", test_launcher_activate);
+        g_test_add_func("/launcher/fallback", test_launcher_fallback);
+        ret = g_test_run();
+
+        g_test_dbus_down(bus);
+        g_object_unref(bus);
+        g_free(test_root);
+        return ret;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */
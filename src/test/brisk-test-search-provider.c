@@ -0,0 +1,403 @@
+/*
+ * This file is part of brisk-menu.
+ *
+ * Copyright © 2017-2018 Brisk Menu Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ */
+
+#define _GNU_SOURCE
+
+#include "util.h"
+
+#include <stdlib.h>
+
+BRISK_BEGIN_PEDANTIC
+#include "registry.h"
+#include "search-provider.h"
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+BRISK_END_PEDANTIC
+
+DEF_AUTOFREE(gchar, g_free)
+DEF_AUTOFREE(GError, g_error_free)
+DEF_AUTOFREE(GVariant, g_variant_unref)
+DEF_AUTOFREE(GSettings, g_object_unref)
+
+#define TEST_EDITOR_ID "brisk-test-editor.desktop"
+#define TEST_VIEWER_ID "brisk-test-viewer.desktop"
+#define TEST_PLAYER_ID "brisk-test-player.desktop"
+#define TEST_N_APPS 3
+
+#define TEST_PROVIDER_IFACE "org.gnome.Shell.SearchProvider2"
+
+/**
+ * The catalogue we serve, each launch touches a marker named after the app
+ */
+static const gchar *test_apps[][2] = {
+        { "brisk-test-editor", "Brisk Test Editor" },
+        { "brisk-test-viewer", "Brisk Test Viewer" },
+        { "brisk-test-player", "Brisk Test Player" },
+};
+
+static gchar *test_root = NULL;
+static BriskMenuRegistry *test_registry = NULL;
+static GDBusConnection *test_bus = NULL;
+
+/**
+ * A call in flight, answered on the main loop as the provider lives there too
+ */
+typedef struct TestCall {
+        gboolean done;
+        GVariant *reply;
+        GError *error;
+} TestCall;
+
+static void test_call_done(GDBusConnection *bus, GAsyncResult *result, TestCall *call)
+{
+        call->reply = g_dbus_connection_call_finish(bus, result, &call->error);
+        call->done = TRUE;
+}
+
+/**
+ * Spin the main loop until the condition holds, or fail after a few seconds
+ */
+static void test_wait_for(gboolean *condition)
+{
+        gint64 deadline = g_get_monotonic_time() + 5 * G_USEC_PER_SEC;
+
+        while (!*condition) {
+                g_assert_cmpint(g_get_monotonic_time(), <, deadline);
+                g_main_context_iteration(NULL, FALSE);
+                g_usleep(1000);
+        }
+}
+
+/**
+ * Call the provider over the session bus, as another process would
+ */
+static GVariant *test_call(const gchar *method, GVariant *parameters, const GVariantType *type,
+                           GError **error)
+{
+        TestCall call = { 0 };
+
+        g_dbus_connection_call(test_bus,
+                               BRISK_SEARCH_PROVIDER_BUS_NAME,
+                               BRISK_SEARCH_PROVIDER_OBJECT_PATH,
+                               TEST_PROVIDER_IFACE,
+                               method,
+                               parameters,
+                               type,
+                               G_DBUS_CALL_FLAGS_NONE,
+                               -1,
+                               NULL,
+                               (GAsyncReadyCallback)test_call_done,
+                               &call);
+        test_wait_for(&call.done);
+
+        if (call.error) {
+                g_propagate_error(error, call.error);
+        }
+        return call.reply;
+}
+
+static gint test_compare_ids(gconstpointer a, gconstpointer b)
+{
+        return g_strcmp0(*(gchar *const *)a, *(gchar *const *)b);
+}
+
+/**
+ * Unpack the result set into a sorted list of IDs, for comparing
+ */
+static gchar **test_get_ids(GVariant *reply)
+{
+        gchar **ids = NULL;
+
+        g_variant_get(reply, "(^as)", &ids);
+        qsort(ids, g_strv_length(ids), sizeof(gchar *), test_compare_ids);
+        return ids;
+}
+
+static gchar *test_get_marker(const gchar *app)
+{
+        autofree(gchar) *name = g_strconcat(app, ".launched", NULL);
+
+        return g_build_filename(test_root, name, NULL);
+}
+
+/**
+ * Every term has to match, in any order
+ */
+static void test_provider_initial(void)
+{
+        const gchar *all[] = { "brisk", "test", NULL };
+        const gchar *editor[] = { "EDITOR", "brisk", NULL };
+        const gchar *none[] = { "brisk", "nothing", NULL };
+        autofree(GError) *error = NULL;
+        autofree(GVariant) *reply = NULL;
+        gchar **ids = NULL;
+
+        reply = test_call("GetInitialResultSet",
+                          g_variant_new("(^as)", all),
+                          G_VARIANT_TYPE("(as)"),
+                          &error);
+        g_assert_no_error(error);
+        ids = test_get_ids(reply);
+        g_assert_cmpuint(g_strv_length(ids), ==, TEST_N_APPS);
+        g_assert_cmpstr(ids[0], ==, TEST_EDITOR_ID);
+        g_assert_cmpstr(ids[1], ==, TEST_PLAYER_ID);
+        g_assert_cmpstr(ids[2], ==, TEST_VIEWER_ID);
+        g_strfreev(ids);
+        g_clear_pointer(&reply, g_variant_unref);
+
+        reply = test_call("GetInitialResultSet",
+                          g_variant_new("(^as)", editor),
+                          G_VARIANT_TYPE("(as)"),
+                          &error);
+        g_assert_no_error(error);
+        ids = test_get_ids(reply);
+        g_assert_cmpuint(g_strv_length(ids), ==, 1);
+        g_assert_cmpstr(ids[0], ==, TEST_EDITOR_ID);
+        g_strfreev(ids);
+        g_clear_pointer(&reply, g_variant_unref);
+
+        reply = test_call("GetInitialResultSet",
+                          g_variant_new("(^as)", none),
+                          G_VARIANT_TYPE("(as)"),
+                          &error);
+        g_assert_no_error(error);
+        ids = test_get_ids(reply);
+        g_assert_cmpuint(g_strv_length(ids), ==, 0);
+        g_strfreev(ids);
+}
+
+/**
+ * Narrowing only ever looks at the previous results, unknown IDs are dropped
+ */
+static void test_provider_subsearch(void)
+{
+        const gchar *previous[] = { TEST_EDITOR_ID, TEST_VIEWER_ID, "missing.desktop", NULL };
+        const gchar *view[] = { "brisk", "view", NULL };
+        const gchar *play[] = { "brisk", "play", NULL };
+        autofree(GError) *error = NULL;
+        autofree(GVariant) *reply = NULL;
+        gchar **ids = NULL;
+
+        reply = test_call("GetSubsearchResultSet",
+                          g_variant_new("(^as^as)", previous, view),
+                          G_VARIANT_TYPE("(as)"),
+                          &error);
+        g_assert_no_error(error);
+        ids = test_get_ids(reply);
+        g_assert_cmpuint(g_strv_length(ids), ==, 1);
+        g_assert_cmpstr(ids[0], ==, TEST_VIEWER_ID);
+        g_strfreev(ids);
+        g_clear_pointer(&reply, g_variant_unref);
+
+        /* The player matches, but wasn't among the previous results */
+        reply = test_call("GetSubsearchResultSet",
+                          g_variant_new("(^as^as)", previous, play),
+                          G_VARIANT_TYPE("(as)"),
+                          &error);
+        g_assert_no_error(error);
+        ids = test_get_ids(reply);
+        g_assert_cmpuint(g_strv_length(ids), ==, 0);
+        g_strfreev(ids);
+}
+
+/**
+ * Activating a result launches that application, and only that one
+ */
+static void test_provider_activate(void)
+{
+        const gchar *terms[] = { "brisk", "editor", NULL };
+        autofree(gchar) *editor = test_get_marker(test_apps[0][0]);
+        autofree(gchar) *viewer = test_get_marker(test_apps[1][0]);
+        autofree(GError) *error = NULL;
+        autofree(GVariant) *reply = NULL;
+        gint64 deadline = g_get_monotonic_time() + 5 * G_USEC_PER_SEC;
+
+        reply = test_call("ActivateResult",
+                          g_variant_new("(s^asu)", TEST_EDITOR_ID, terms, 0),
+                          NULL,
+                          &error);
+        g_assert_no_error(error);
+
+        while (!g_file_test(editor, G_FILE_TEST_EXISTS)) {
+                g_assert_cmpint(g_get_monotonic_time(), <, deadline);
+                g_main_context_iteration(NULL, FALSE);
+                g_usleep(1000);
+        }
+        g_assert_false(g_file_test(viewer, G_FILE_TEST_EXISTS));
+        g_clear_pointer(&reply, g_variant_unref);
+
+        /* Nothing by that name, which the caller is told about */
+        reply = test_call("ActivateResult",
+                          g_variant_new("(s^asu)", "missing.desktop", terms, 0),
+                          NULL,
+                          &error);
+        g_assert_null(reply);
+        g_assert_error(error, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS);
+}
+
+/**
+ * Write out the catalogue and a menu file holding all of it, and point the
+ * XDG directories at them
+ */
+static void test_write_catalogue(void)
+{
+        autofree(gchar) *apps = g_build_filename(test_root, "data", "applications", NULL);
+        autofree(gchar) *menus = g_build_filename(test_root, "config", "menus", NULL);
+        autofree(gchar) *menu = g_build_filename(menus, "mate-applications.menu", NULL);
+        autofree(gchar) *dir = NULL;
+
+        g_assert_cmpint(g_mkdir_with_parents(apps, 00700), ==, 0);
+        g_assert_cmpint(g_mkdir_with_parents(menus, 00700), ==, 0);
+
+        for (guint i = 0; i < G_N_ELEMENTS(test_apps); i++) {
+                autofree(gchar) *name = g_strconcat(test_apps[i][0], ".desktop", NULL);
+                autofree(gchar) *path = g_build_filename(apps, name, NULL);
+                autofree(gchar) *marker = test_get_marker(test_apps[i][0]);
+                autofree(gchar) *contents = NULL;
+
+                contents = g_strdup_printf(
+                    "[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=%s\n"
+                    "Exec=touch %s\n"
+                    "Categories=Utility;\n",
+                    test_apps[i][1],
+                    marker);
+                g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+        }
+
+        g_assert_true(g_file_set_contents(
+            menu,
+            "<!DOCTYPE Menu PUBLIC \"-//freedesktop//DTD Menu 1.0//EN\"\n"
+            " \"http://www.freedesktop.org/standards/menu-spec/1.0/menu.dtd\">\n"
+            "<Menu>\n  <Name>Applications</Name>\n  <DefaultAppDirs/>\n"
+            "  <Menu><Name>Utility</Name><Include><Category>Utility</Category>"
+            "</Include></Menu>\n"
+            "</Menu>\n",
+            -1,
+            NULL));
+
+        dir = g_build_filename(test_root, "data", NULL);
+        g_setenv("XDG_DATA_DIRS", dir, TRUE);
+        g_free(dir);
+        dir = g_build_filename(test_root, "config", NULL);
+        g_setenv("XDG_CONFIG_DIRS", dir, TRUE);
+        g_free(dir);
+        dir = g_build_filename(test_root, "home", NULL);
+        g_setenv("XDG_DATA_HOME", dir, TRUE);
+        g_setenv("XDG_CONFIG_HOME", dir, TRUE);
+        g_setenv("XDG_CACHE_HOME", dir, TRUE);
+}
+
+/**
+ * How many apps the registry holds so far
+ */
+static guint test_n_apps(void)
+{
+        GPtrArray *backends = brisk_menu_registry_get_backends(test_registry);
+
+        for (guint i = 0; i < backends->len; i++) {
+                GPtrArray *items = NULL;
+
+                if (!g_str_equal(brisk_backend_get_id(backends->pdata[i]), "apps")) {
+                        continue;
+                }
+                items = brisk_menu_registry_get_items(test_registry, backends->pdata[i]);
+                return items ? items->len : 0;
+        }
+        return 0;
+}
+
+static void test_name_appeared(__brisk_unused__ GDBusConnection *bus,
+                               __brisk_unused__ const gchar *name,
+                               __brisk_unused__ const gchar *owner, gpointer v)
+{
+        *(gboolean *)v = TRUE;
+}
+
+int main(int argc, char **argv)
+{
+        autofree(GError) *error = NULL;
+        autofree(GSettings) *settings = NULL;
+        gint64 deadline;
+        gboolean owned = FALSE;
+        guint watch_id;
+        int ret;
+
+        g_test_init(&argc, &argv, NULL);
+
+        /* Settings only live as long as we do, set before anything reads them */
+        g_setenv("GSETTINGS_BACKEND", "memory", TRUE);
+
+        /* The provider launches through GDK for startup notification */
+        g_setenv("NO_AT_BRIDGE", "1", TRUE);
+        if (!gtk_init_check(&argc, &argv)) {
+                g_printerr("No display, skipping\n");
+                return 77;
+        }
+
+        /* Meant to run under dbus-run-session, never on a real session bus */
+        test_bus = g_bus_get_sync(G_BUS_TYPE_SESSION, NULL, &error);
+        if (!test_bus) {
+                g_printerr("No session bus, skipping: %s\n", error->message);
+                return 77;
+        }
+
+        test_root = g_dir_make_tmp("brisk-test-provider-XXXXXX", NULL);
+        g_assert_nonnull(test_root);
+        test_write_catalogue();
+
+        /* The provider is opt-in */
+        settings = g_settings_new("com.solus-project.brisk-menu");
+        g_settings_set_boolean(settings, "search-provider", TRUE);
+
+        watch_id = g_bus_watch_name_on_connection(test_bus,
+                                                  BRISK_SEARCH_PROVIDER_BUS_NAME,
+                                                  G_BUS_NAME_WATCHER_FLAGS_NONE,
+                                                  test_name_appeared,
+                                                  NULL,
+                                                  &owned,
+                                                  NULL);
+
+        test_registry = brisk_menu_registry_get_default();
+        brisk_menu_registry_load(test_registry);
+
+        deadline = g_get_monotonic_time() + 30 * G_USEC_PER_SEC;
+        while (!owned || test_n_apps() < TEST_N_APPS) {
+                g_assert_cmpint(g_get_monotonic_time(), <, deadline);
+                g_main_context_iteration(NULL, FALSE);
+                g_usleep(1000);
+        }
+        g_bus_unwatch_name(watch_id);
+
+        g_test_add_func("/search-provider/initial", test_provider_initial);
+        g_test_add_func("/search-provider/subsearch", test_provider_subsearch);
+        g_test_add_func("/search-provider/activate", test_provider_activate);
+        ret = g_test_run();
+
+        g_object_unref(test_registry);
+        g_object_unref(test_bus);
+        g_free(test_root);
+        return ret;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 expandtab:
+ * :indentSize=8:tabSize=8:noTabs=true:
+ */